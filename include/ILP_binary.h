@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <memory>
+
+// versioned binary format of ILP_input.
+// A header with array sizes is followed by the arrays below, each padded to a multiple of 8 bytes:
+//   objective (double, nr_variables), variable permutation (uint64, nr_variables),
+//   variable name offsets (uint64, nr_variables+1) and names (char blob),
+//   constraint identifier offsets (uint64, nr_constraints+1) and identifiers (char blob),
+//   inequality types (uint8, nr_constraints), right hand sides (int32, nr_constraints),
+//   constraint offsets into monomials (uint64, nr_constraints+1), coefficients (int32, nr_monomials),
+//   monomial offsets into monomial variables (uint64, nr_monomials+1), monomial variables (uint64),
+//   constraint group offsets (uint64, nr_constraint_groups+1) and constraint group entries (uint64).
+// Numbers are stored in native byte order, files are read through a memory mapping without copying.
+// All sizes and offsets are validated when a file is opened, so that corrupt or truncated files are rejected.
+
+namespace LPMP {
+
+    class ILP_input;
+    class mmap_file;
+
+    namespace ILP_binary {
+
+        constexpr char magic[8] = {'L','P','M','P','I','L','P','B'};
+        constexpr uint32_t version = 1;
+        constexpr uint32_t byte_order_mark = 0x01020304;
+
+        struct header {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order_mark;
+            uint64_t nr_variables;
+            uint64_t nr_constraints;
+            uint64_t nr_monomials;
+            uint64_t nr_monomial_variables;
+            uint64_t variable_names_size;
+            uint64_t identifiers_size;
+            uint64_t nr_constraint_groups;
+            uint64_t nr_constraint_group_entries;
+            double constant;
+        };
+        static_assert(sizeof(header) % 8 == 0);
+        static_assert(sizeof(size_t) == sizeof(uint64_t));
+
+        inline size_t padding(const size_t nr_bytes) { return (8 - nr_bytes % 8) % 8; }
+
+        // zero-copy access to the arrays of a memory mapped binary file
+        class view {
+            public:
+                // throws if the file is not a valid binary ILP file
+                view(const std::string& filename);
+                ~view();
+
+                size_t nr_variables() const { return header_->nr_variables; }
+                size_t nr_constraints() const { return header_->nr_constraints; }
+                size_t nr_constraint_groups() const { return header_->nr_constraint_groups; }
+                double constant() const { return header_->constant; }
+
+                const double* objective() const { return objective_; }
+                const size_t* variable_permutation() const { return variable_permutation_; }
+                std::string_view variable_name(const size_t i) const { return std::string_view(variable_names_ + variable_name_offsets_[i], variable_name_offsets_[i+1] - variable_name_offsets_[i]); }
+                std::string_view identifier(const size_t c) const { return std::string_view(identifiers_ + identifier_offsets_[c], identifier_offsets_[c+1] - identifier_offsets_[c]); }
+
+                // inequality type as ILP_input::inequality_type value
+                uint8_t inequality_type(const size_t c) const { return inequality_types_[c]; }
+                int right_hand_side(const size_t c) const { return right_hand_sides_[c]; }
+
+                // monomials of constraint c are [constraint_offsets()[c], constraint_offsets()[c+1]),
+                // variables of monomial m are monomial_variables()[monomial_offsets()[m] ... monomial_offsets()[m+1]]
+                const size_t* constraint_offsets() const { return constraint_offsets_; }
+                const int32_t* coefficients() const { return coefficients_; }
+                const size_t* monomial_offsets() const { return monomial_offsets_; }
+                const size_t* monomial_variables() const { return monomial_variables_; }
+
+                const size_t* constraint_group_begin(const size_t g) const { return constraint_group_entries_ + constraint_group_offsets_[g]; }
+                const size_t* constraint_group_end(const size_t g) const { return constraint_group_entries_ + constraint_group_offsets_[g+1]; }
+
+            private:
+                void validate(const std::string& filename) const;
+
+                std::unique_ptr<mmap_file> file_;
+                const header* header_;
+                const double* objective_;
+                const size_t* variable_permutation_;
+                const size_t* variable_name_offsets_;
+                const char* variable_names_;
+                const size_t* identifier_offsets_;
+                const char* identifiers_;
+                const uint8_t* inequality_types_;
+                const int32_t* right_hand_sides_;
+                const size_t* constraint_offsets_;
+                const int32_t* coefficients_;
+                const size_t* monomial_offsets_;
+                const size_t* monomial_variables_;
+                const size_t* constraint_group_offsets_;
+                const size_t* constraint_group_entries_;
+        };
+
+        bool is_binary_file(const std::string& filename);
+
+        ILP_input parse_file(const std::string& filename);
+
+    }
+
+}
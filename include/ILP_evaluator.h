@@ -0,0 +1,128 @@
+#pragma once
+
+#include "ILP_input.h"
+#include "two_dimensional_variable_array.hxx"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace LPMP {
+
+    // keeps a solution of an ILP together with the activities of all constraints, the set of violated constraints and the objective.
+    // Flipping a variable updates them in time proportional to the number of monomials containing the variable instead of checking all constraints.
+    // The ILP must not be changed while the evaluator is in use.
+    class ILP_evaluator {
+        public:
+            // starts with all variables set to zero
+            ILP_evaluator(const ILP_input& ilp);
+
+            template<typename ITERATOR>
+                void set_solution(ITERATOR begin, ITERATOR end);
+            void flip(const size_t var);
+
+            size_t nr_variables() const { return x_.size(); }
+            size_t nr_constraints() const { return activity_.size(); }
+            char value(const size_t var) const { assert(var < x_.size()); return x_[var]; }
+            const std::vector<char>& solution() const { return x_; }
+
+            bool feasible() const { return violated_.empty(); }
+            // infinity if the solution is not feasible
+            double evaluate() const { return feasible() ? objective_value_ : std::numeric_limits<double>::infinity(); }
+            double objective() const { return objective_value_; }
+            const std::vector<size_t>& violated_constraints() const { return violated_; }
+
+            int activity(const size_t c) const { assert(c < activity_.size()); return activity_[c]; }
+            bool feasible(const size_t c, const int activity) const;
+            const auto& variable_constraints() const { return var_constraints_; }
+
+            // calls f(constraint, activity change) for all monomials changing their value when all given variables are flipped simultaneously.
+            // The same constraint can be reported several times. The state is not changed.
+            template<typename ITERATOR, typename FUNC>
+                void flip_deltas(ITERATOR vars_begin, ITERATOR vars_end, FUNC&& f) const;
+
+            // objectives of complete solutions, infinity for infeasible ones. Solutions are evaluated in parallel and independently of the current state.
+            std::vector<double> evaluate(const std::vector<std::vector<char>>& solutions) const;
+
+        private:
+            template<typename ITERATOR>
+                char monomial_value(const size_t monomial, ITERATOR flipped_begin, ITERATOR flipped_end) const;
+            void update_violated(const size_t c);
+
+            std::vector<char> x_;
+            std::vector<double> objective_;
+            double constant_;
+            double objective_value_ = 0.0;
+
+            std::vector<size_t> constraint_begin_; // monomials of constraint c are constraint_begin_[c], ..., constraint_begin_[c+1]-1
+            std::vector<ILP_input::inequality_type> ineq_;
+            std::vector<int> rhs_;
+            std::vector<int> coefficient_;
+            std::vector<size_t> monomial_constraint_;
+            two_dim_variable_array<size_t> monomial_vars_;
+            two_dim_variable_array<size_t> var_monomials_;
+            two_dim_variable_array<size_t> var_constraints_;
+
+            std::vector<char> monomial_value_;
+            std::vector<int> activity_;
+            std::vector<size_t> violated_;
+            std::vector<size_t> violated_pos_; // position in violated_ or no_pos
+            static constexpr size_t no_pos = std::numeric_limits<size_t>::max();
+    };
+
+    template<typename ITERATOR>
+        void ILP_evaluator::set_solution(ITERATOR begin, ITERATOR end)
+        {
+            if(std::distance(begin, end) != x_.size())
+                throw std::runtime_error("solution size does not match number of variables");
+            objective_value_ = constant_;
+            for(size_t i=0; i<x_.size(); ++i, ++begin)
+            {
+                assert(*begin == 0 || *begin == 1);
+                x_[i] = *begin;
+                objective_value_ += objective_[i] * x_[i];
+            }
+
+            for(size_t c=0; c<activity_.size(); ++c)
+            {
+                activity_[c] = 0;
+                for(size_t m=constraint_begin_[c]; m<constraint_begin_[c+1]; ++m)
+                {
+                    char val = 1;
+                    for(const size_t var : monomial_vars_[m])
+                        val &= x_[var];
+                    monomial_value_[m] = val;
+                    activity_[c] += coefficient_[m] * val;
+                }
+                update_violated(c);
+            }
+        }
+
+    template<typename ITERATOR>
+        char ILP_evaluator::monomial_value(const size_t monomial, ITERATOR flipped_begin, ITERATOR flipped_end) const
+        {
+            char val = 1;
+            for(const size_t var : monomial_vars_[monomial])
+                val &= x_[var] ^ char(std::find(flipped_begin, flipped_end, var) != flipped_end);
+            return val;
+        }
+
+    template<typename ITERATOR, typename FUNC>
+        void ILP_evaluator::flip_deltas(ITERATOR vars_begin, ITERATOR vars_end, FUNC&& f) const
+        {
+            for(auto it=vars_begin; it!=vars_end; ++it)
+            {
+                for(const size_t m : var_monomials_[*it])
+                {
+                    // monomials containing several flipped variables are reported for the first one
+                    const auto& vars = monomial_vars_[m];
+                    if(std::any_of(vars_begin, it, [&](const size_t v) { return std::find(vars.begin(), vars.end(), v) != vars.end(); }))
+                        continue;
+                    const int d = coefficient_[m] * (monomial_value(m, vars_begin, vars_end) - monomial_value_[m]);
+                    if(d != 0)
+                        f(monomial_constraint_[m], d);
+                }
+            }
+        }
+
+}
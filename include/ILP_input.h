@@ -4,8 +4,10 @@
 #include <string>
 #include <cassert>
 #include <algorithm>
+#include <stdexcept>
 #include "two_dimensional_variable_array.hxx"
 #include "permutation.hxx"
+#include "ILP_binary.h"
 #include <tsl/robin_map.h>
 #include <tsl/robin_set.h>
 #include <Eigen/SparseCore>
@@ -33,6 +35,9 @@ namespace LPMP {
             static bool monomials_cmp(const two_dim_variable_array<size_t>& monomials, const size_t idx1, const size_t idx2);
         };
 
+        ILP_input() {}
+        ILP_input(const ILP_binary::view& binary);
+
         enum class variable_order { input, bfs, cuthill, mindegree } variable_order_{variable_order::input};
 
         std::vector<size_t> variables(const size_t ineq_nr) const;
@@ -80,6 +85,10 @@ namespace LPMP {
         template<typename STREAM>
             void write_mps(STREAM& s) const;
 
+        // see ILP_binary.h for the format
+        template<typename STREAM>
+            void write_binary(STREAM& s) const;
+
         bool preprocess();
         void normalize();
         bool is_normalized() const;
@@ -399,5 +408,98 @@ namespace LPMP {
 
             s << "ENDDATA\n";
         }
+
+    template<typename STREAM>
+        void ILP_input::write_binary(STREAM& s) const
+        {
+            auto write = [&](const auto* data, const size_t n) {
+                const size_t nr_bytes = n * sizeof(*data);
+                s.write(reinterpret_cast<const char*>(data), nr_bytes);
+                return nr_bytes;
+            };
+            auto pad = [&](const size_t nr_bytes) {
+                constexpr char zeros[8] = {};
+                s.write(zeros, ILP_binary::padding(nr_bytes));
+            };
+            auto write_section = [&](const auto* data, const size_t n) { pad(write(data, n)); };
+
+            ILP_binary::header h;
+            std::copy(std::begin(ILP_binary::magic), std::end(ILP_binary::magic), h.magic);
+            h.version = ILP_binary::version;
+            h.byte_order_mark = ILP_binary::byte_order_mark;
+            h.nr_variables = nr_variables();
+            h.nr_constraints = nr_constraints();
+            h.nr_monomials = 0;
+            h.nr_monomial_variables = 0;
+            for(const auto& constr : constraints())
+            {
+                h.nr_monomials += constr.monomials.size();
+                h.nr_monomial_variables += constr.monomials.data().size();
+            }
+            h.variable_names_size = 0;
+            for(const auto& var : var_index_to_name())
+                h.variable_names_size += var.size();
+            h.identifiers_size = 0;
+            for(const auto& constr : constraints())
+                h.identifiers_size += constr.identifier.size();
+            h.nr_constraint_groups = nr_constraint_groups();
+            h.nr_constraint_group_entries = coalesce_sets_.data().size();
+            h.constant = constant();
+            write(&h, 1);
+
+            write_section(objective().data(), nr_variables());
+            assert(var_permutation_.size() == nr_variables());
+            write_section(var_permutation_.data(), nr_variables());
+
+            std::vector<size_t> offsets = {0};
+            for(const auto& var : var_index_to_name())
+                offsets.push_back(offsets.back() + var.size());
+            write_section(offsets.data(), offsets.size());
+            for(const auto& var : var_index_to_name())
+                write(var.data(), var.size());
+            pad(h.variable_names_size);
+
+            offsets = {0};
+            for(const auto& constr : constraints())
+                offsets.push_back(offsets.back() + constr.identifier.size());
+            write_section(offsets.data(), offsets.size());
+            for(const auto& constr : constraints())
+                write(constr.identifier.data(), constr.identifier.size());
+            pad(h.identifiers_size);
+
+            std::vector<uint8_t> ineqs;
+            std::vector<int32_t> rhs;
+            for(const auto& constr : constraints())
+            {
+                ineqs.push_back(static_cast<uint8_t>(constr.ineq));
+                rhs.push_back(constr.right_hand_side);
+            }
+            write_section(ineqs.data(), ineqs.size());
+            write_section(rhs.data(), rhs.size());
+
+            offsets = {0};
+            for(const auto& constr : constraints())
+                offsets.push_back(offsets.back() + constr.monomials.size());
+            write_section(offsets.data(), offsets.size());
+            for(const auto& constr : constraints())
+                write(constr.coefficients.data(), constr.coefficients.size());
+            pad(h.nr_monomials * sizeof(int32_t));
+
+            offsets = {0};
+            for(const auto& constr : constraints())
+                for(size_t m=0; m<constr.monomials.size(); ++m)
+                    offsets.push_back(offsets.back() + constr.monomials.size(m));
+            write_section(offsets.data(), offsets.size());
+            for(const auto& constr : constraints())
+                write(constr.monomials.data().data(), constr.monomials.data().size());
+
+            offsets = {0};
+            for(size_t g=0; g<nr_constraint_groups(); ++g)
+                offsets.push_back(offsets.back() + coalesce_sets_.size(g));
+            write_section(offsets.data(), offsets.size());
+            write_section(coalesce_sets_.data().data(), coalesce_sets_.data().size());
+            if(!s)
+                throw std::runtime_error("could not write binary ILP");
+        }
 }
 
@@ -6,6 +6,10 @@ namespace LPMP {
 
         ILP_input parse_file(const std::string& filename);
         ILP_input parse_string(const std::string& input);
+        // memory maps the file and parses constraints in parallel with a hand-written parser
+        ILP_input parse_file_parallel(const std::string& filename);
+
+        void print_ILP_diagnostics(const ILP_input& ilp);
 
     }
 
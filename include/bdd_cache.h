@@ -0,0 +1,43 @@
+#pragma once
+
+#include "bdd_collection/bdd_collection.h"
+#include "ILP_input.h"
+#include "two_dimensional_variable_array.hxx"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// on-disk cache of BDD collections compiled from ILPs.
+// Entries are keyed by the constraints and the conversion parameters, costs do not enter the key.
+// Each entry is a binary file named after a hash of the key, holding a header, the key, the bdd instructions, the bdd delimiters and the mapping from inequalities to BDDs,
+// and is loaded through a memory mapping with bulk copies of the arrays.
+
+namespace LPMP {
+
+    class bdd_cache {
+        public:
+            bdd_cache(const std::string& directory);
+
+            struct key_type {
+                size_t hash = 0; // names the cache file
+                size_t nr_variables = 0;
+                size_t nr_constraints = 0;
+                // conversion parameters and constraints, stored in the cache file and compared on load so that hash collisions and stale entries are detected
+                std::vector<int64_t> data;
+
+                bool operator==(const key_type& o) const { return hash == o.hash && nr_variables == o.nr_variables && nr_constraints == o.nr_constraints && data == o.data; }
+                bool operator!=(const key_type& o) const { return !(*this == o); }
+            };
+
+            static key_type key(const ILP_input& ilp, const bool normalize, const bool split_long_bdds, const bool add_split_implication_bdd, const size_t split_length);
+
+            // return false if no entry for key exists
+            bool load(const key_type& key, BDD::bdd_collection& bdd_col, two_dim_variable_array<size_t>& ineq_to_bdd_nrs) const;
+            void store(const key_type& key, const BDD::bdd_collection& bdd_col, const two_dim_variable_array<size_t>& ineq_to_bdd_nrs) const;
+
+        private:
+            std::string filename(const size_t hash) const;
+            std::string directory_;
+    };
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <cstddef>
+#include <cassert>
+
+namespace BDD {
+
+    // open addressing hash table with linear probing that stores indices into external key arrays.
+    // Keys are compared and rehashed through callbacks, hence they are not duplicated and no per-element allocation takes place.
+    class index_hash_table {
+        public:
+            constexpr static size_t empty = std::numeric_limits<size_t>::max();
+
+            // remove all elements, afterwards at least nr_elements can be inserted without growing
+            void clear(const size_t nr_elements)
+            {
+                size_t capacity = 16;
+                while(capacity < 2*nr_elements)
+                    capacity *= 2;
+                slots_.assign(capacity, empty);
+                nr_elements_ = 0;
+            }
+
+            // return index of element equal to the key described by hash and equal, otherwise insert new_index and return it
+            template<typename EQUAL, typename HASH_OF>
+                size_t find_or_insert(const size_t hash, const size_t new_index, EQUAL&& equal, HASH_OF&& hash_of)
+                {
+                    assert(new_index != empty);
+                    if(2*(nr_elements_+1) > slots_.size())
+                        grow(hash_of);
+                    const size_t mask = slots_.size()-1;
+                    for(size_t s=hash & mask;; s=(s+1) & mask)
+                    {
+                        if(slots_[s] == empty)
+                        {
+                            slots_[s] = new_index;
+                            ++nr_elements_;
+                            return new_index;
+                        }
+                        if(equal(slots_[s]))
+                            return slots_[s];
+                    }
+                }
+
+            size_t size() const { return nr_elements_; }
+
+            static size_t hash_combine(size_t h, const size_t x)
+            {
+                h ^= x + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+                return h;
+            }
+
+            // spread bits such that consecutive indices do not end up in consecutive slots
+            static size_t finalize(size_t h)
+            {
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdull;
+                h ^= h >> 33;
+                h *= 0xc4ceb9fe1a85ec53ull;
+                h ^= h >> 33;
+                return h;
+            }
+
+        private:
+            template<typename HASH_OF>
+                void grow(HASH_OF&& hash_of)
+                {
+                    std::vector<size_t> old_slots(2*slots_.size(), empty);
+                    std::swap(old_slots, slots_);
+                    const size_t mask = slots_.size()-1;
+                    for(const size_t idx : old_slots)
+                    {
+                        if(idx == empty)
+                            continue;
+                        size_t s = hash_of(idx) & mask;
+                        while(slots_[s] != empty)
+                            s = (s+1) & mask;
+                        slots_[s] = idx;
+                    }
+                }
+
+            std::vector<size_t> slots_ = std::vector<size_t>(16, empty);
+            size_t nr_elements_ = 0;
+    };
+
+    // reusable memory for bdd_collection::bdd_and.
+    // A request is a tuple of instruction indices, one for each operand BDD. Requests are expanded level by level from the root tuple (breadth-first),
+    // afterwards the result of every request is reduced level by level from the bottom. No recursion takes place.
+    // Results refer to nodes in the output stack: 0 is the botsink, 1 the topsink, the remaining nodes are created bottom-up.
+    struct bdd_and_arena {
+        size_t width = 0; // number of operands
+        std::vector<size_t> request_nodes; // width entries per request
+        std::vector<std::array<size_t,2>> request_children; // lo and hi request of each request, terminal requests are 0 and 1
+        std::vector<size_t> request_results;
+        index_hash_table request_table;
+
+        std::vector<size_t> variables; // sorted variables of all operands, the position of a variable is its level
+        std::vector<std::vector<size_t>> level_requests;
+
+        std::vector<std::array<size_t,3>> stack; // lo, hi and variable of result nodes
+        index_hash_table node_table;
+
+        std::vector<size_t> scratch; // request currently expanded
+
+        void clear()
+        {
+            request_nodes.clear();
+            request_children.clear();
+            request_results.clear();
+            variables.clear();
+            for(auto& r : level_requests)
+                r.clear();
+            stack.clear();
+            scratch.clear();
+        }
+    };
+
+}
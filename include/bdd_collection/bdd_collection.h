@@ -1,7 +1,10 @@
 #pragma once
 
 #include "../bdd_manager/bdd_mgr.h"
+#include "bdd_and_arena.h"
+#include "bdd_instruction_vector.h"
 #include <vector>
+#include <tuple>
 #include <iterator>
 #include <unordered_map> // TODO: replace with faster hash map
 #include <unordered_set> // TODO: replace with faster hash map
@@ -11,30 +14,6 @@
 
 namespace BDD {
 
-    struct bdd_instruction {
-        size_t lo = temp_undefined_index;
-        size_t hi = temp_undefined_index;
-        size_t index = temp_undefined_index;
-
-        constexpr static  size_t botsink_index = std::numeric_limits<size_t>::max()-1;
-        bool is_botsink() const { return index == botsink_index; }
-        static bdd_instruction botsink() { return {botsink_index, botsink_index, botsink_index}; }
-
-        constexpr static  size_t topsink_index = std::numeric_limits<size_t>::max();
-        bool is_topsink() const { return index == topsink_index; }
-        static bdd_instruction topsink() { return {topsink_index, topsink_index, topsink_index}; }
-
-        bool is_terminal() const { return is_botsink() || is_topsink(); }
-
-        bool operator==(const bdd_instruction& o) const { return lo == o.lo && hi == o.hi && index == o.index; }
-        bool operator!=(const bdd_instruction& o) const { return !(*this == o); }
-
-        // temporary values for building up
-        constexpr static size_t temp_botsink_index = std::numeric_limits<size_t>::max();
-        constexpr static size_t temp_topsink_index = std::numeric_limits<size_t>::max()-1;
-        constexpr static size_t temp_undefined_index = std::numeric_limits<size_t>::max()-2;
-    };
-
     struct bdd_instruction_hasher {
         size_t operator()(const bdd_instruction& bdd) const { return std::hash<size_t>()(bdd.lo) ^ std::hash<size_t>()(bdd.hi) ^ std::hash<size_t>()(bdd.index); }
     };
@@ -150,17 +129,20 @@ namespace BDD {
             size_t nr_bdd_nodes(const size_t bdd_nr) const;
             size_t nr_bdd_nodes(const size_t bdd_nr, const size_t variable) const;
 
-            bdd_instruction* begin(const size_t bdd_nr);
-            bdd_instruction* end(const size_t bdd_nr);
-            const bdd_instruction* cbegin(const size_t bdd_nr) const;
-            const bdd_instruction* cend(const size_t bdd_nr) const;
-            std::reverse_iterator<bdd_instruction*> rbegin(const size_t bdd_nr);
-            std::reverse_iterator<bdd_instruction*> rend(const size_t bdd_nr);
+            // iterate over the non-terminal instructions of a bdd
+            using const_iterator = bdd_instruction_vector::const_iterator;
+            const_iterator begin(const size_t bdd_nr) const;
+            const_iterator end(const size_t bdd_nr) const;
+            const_iterator cbegin(const size_t bdd_nr) const { return begin(bdd_nr); }
+            const_iterator cend(const size_t bdd_nr) const { return end(bdd_nr); }
+            std::reverse_iterator<const_iterator> rbegin(const size_t bdd_nr) const;
+            std::reverse_iterator<const_iterator> rend(const size_t bdd_nr) const;
 
             size_t botsink_index(const size_t bdd_nr) const;
             size_t topsink_index(const size_t bdd_nr) const;
 
-            size_t offset(const bdd_instruction& instr) const;
+            size_t offset(const const_iterator it) const { assert(it.position() < bdd_instructions.size()); return it.position(); }
+            size_t offset(const std::reverse_iterator<const_iterator> it) const { return offset(std::prev(it.base())); }
             size_t offset(const size_t bdd_nr) const { assert(bdd_nr < nr_bdds()); return bdd_delimiters[bdd_nr]; }
             template<typename ITERATOR>
                 bool evaluate(const size_t bdd_nr, ITERATOR var_begin, ITERATOR var_end) const;
@@ -198,7 +180,7 @@ namespace BDD {
 
             bdd_collection_entry operator[](const size_t bdd_nr);
             bdd_instruction operator()(const size_t bdd_nr, const size_t offset) const;
-            const bdd_instruction& get_bdd_instruction(const size_t i) const;
+            bdd_instruction get_bdd_instruction(const size_t i) const;
 
             template<typename STREAM>
                 void export_graphviz(const size_t bdd_nr, STREAM& s) const;
@@ -245,15 +227,25 @@ namespace BDD {
 
             // merge BDDs from another bdd_collection
             void append(const bdd_collection& o);
+            // merge BDDs from several bdd_collections in order, copying them in parallel
+            void append(const std::vector<bdd_collection>& cols);
+            // split into collections of BDDs that do not share variables, ordered by decreasing number of bdd nodes.
+            // Variables of each collection are renumbered contiguously, the original variables are returned in increasing order.
+            std::tuple<std::vector<bdd_collection>, std::vector<std::vector<size_t>>> connected_components() const;
+
+            // raw arrays of all BDDs, e.g. for serialization
+            const bdd_instruction_vector& instructions() const { return bdd_instructions; }
+            const std::vector<size_t>& delimiters() const { return bdd_delimiters; }
+            void assign(bdd_instruction_vector&& instructions, std::vector<size_t>&& delimiters)
+            {
+                assert(delimiters.size() > 0 && delimiters.front() == 0 && delimiters.back() == instructions.size());
+                bdd_instructions = std::move(instructions);
+                bdd_delimiters = std::move(delimiters);
+            }
 
         private:
-            size_t bdd_and_impl(const size_t i, const size_t j, bdd_collection& o);
-            template<size_t N>
-                size_t bdd_and(const std::array<size_t,N>& bdds);
-            template<size_t N>
-                size_t bdd_and(const std::array<size_t,N>& bdds, bdd_collection& o);
-            template<size_t N>
-            size_t bdd_and_impl(const std::array<size_t,N>& bdds, std::unordered_map<std::array<size_t,N>,size_t,array_hasher<N>>& generated_nodes, bdd_collection& o);
+            // conjunction of n BDDs, written to o
+            size_t bdd_and_impl(const size_t* bdd_nrs, const size_t n, bdd_collection& o);
 
             size_t splitting_variable(const bdd_instruction& k, const bdd_instruction& l) const;
             size_t add_bdd_impl(node_ref bdd);
@@ -268,14 +260,11 @@ namespace BDD {
             void remove_dead_nodes(const std::vector<char>& remove);
             std::vector<char> reachable_nodes(const size_t bdd_nr) const;
 
-            std::vector<bdd_instruction> bdd_instructions;
+            bdd_instruction_vector bdd_instructions;
             std::vector<size_t> bdd_delimiters = {0};
 
             // temporary memory for bdd synthesis
-            std::vector<bdd_instruction> stack; // for computing bdd meld;
-
-            std::unordered_map<std::array<size_t,2>,size_t, array_hasher<2>> generated_nodes; // given nodes of left and right bdd, has melded template be generated?
-            std::unordered_map<bdd_instruction,size_t,bdd_instruction_hasher> reduction; // for generating a restricted graph. Given a variable index and left and right descendant, has node been generated?
+            bdd_and_arena and_arena;
 
             // node_ref -> index in bdd_instructions
             std::unordered_map<node_ref, size_t> node_ref_hash;
@@ -314,9 +303,9 @@ namespace BDD {
             assert(bdd_nr < nr_bdds());
             for(size_t i=bdd_delimiters[bdd_nr]; i<bdd_delimiters[bdd_nr+1]; ++i)
             {
-                bdd_instruction& bdd = bdd_instructions[i];
+                auto bdd = bdd_instructions[i];
                 assert(bdd.index < std::distance(var_map_begin, var_map_end) || bdd.is_terminal());
-                const size_t rebase_index = [&]() {
+                const size_t rebase_index = [&]() -> size_t {
                     if(bdd.is_terminal())
                         return bdd.index;
                     else
@@ -332,8 +321,8 @@ namespace BDD {
             assert(bdd_nr < nr_bdds());
             for(size_t i=bdd_delimiters[bdd_nr]; i<bdd_delimiters[bdd_nr+1]; ++i)
             {
-                bdd_instruction& bdd = bdd_instructions[i];
-                const size_t rebase_index = [&]() {
+                auto bdd = bdd_instructions[i];
+                const size_t rebase_index = [&]() -> size_t {
                     if(bdd.is_terminal())
                         return bdd.index;
                     else
@@ -388,15 +377,9 @@ namespace BDD {
                 }
                 else // move bdd
                 {
-                    for(size_t bdd_idx_from=bdd_delimiters[bdd_nr]; bdd_idx_from<bdd_delimiters[bdd_nr+1]; ++bdd_idx_from, ++bdd_idx_to)
-                    {
-                        bdd_instructions[bdd_idx_to] = bdd_instructions[bdd_idx_from];
-                        if(!bdd_instructions[bdd_idx_to].is_terminal())
-                        {
-                            bdd_instructions[bdd_idx_to].lo -= bdd_idx_from - bdd_idx_to;
-                            bdd_instructions[bdd_idx_to].hi -= bdd_idx_from - bdd_idx_to;
-                        }
-                    }
+                    // arcs are relative, hence moving the bdd keeps them intact
+                    bdd_instructions.copy(bdd_instructions, bdd_delimiters[bdd_nr], bdd_delimiters[bdd_nr+1], bdd_idx_to);
+                    bdd_idx_to += bdd_delimiters[bdd_nr+1] - bdd_delimiters[bdd_nr];
                     ++bdd_nr_counter;
                     bdd_delimiters[bdd_nr_counter] = bdd_idx_to;
                 }
@@ -475,17 +458,6 @@ namespace BDD {
         }
         */
 
-    template<size_t N, typename ITERATOR>
-        std::array<size_t,N> construct_array(ITERATOR begin, ITERATOR end)
-        {
-            assert(std::distance(begin,end) == N);
-            std::array<size_t,N> a;
-            auto it = begin;
-            for(size_t i=0; i<N; ++i, ++it)
-                a[i] = *it;
-            return a;
-        }
-
     template<typename BDD_ITERATOR>
         size_t bdd_collection::bdd_and(BDD_ITERATOR bdd_begin, BDD_ITERATOR bdd_end)
         {
@@ -497,7 +469,7 @@ namespace BDD {
         {
             const size_t nr_bdds = std::distance(bdd_begin, bdd_end);
 
-            constexpr static size_t bdd_and_th = 49; // can be up to 49
+            constexpr static size_t bdd_and_th = 49; // more BDDs are conjoined in chunks to keep requests of bdd_and_impl short
 
             // TODO: possibly do recursive bipartitioning for intersection of many BDDs
             if(nr_bdds > bdd_and_th)
@@ -539,58 +511,12 @@ namespace BDD {
                 return this->nr_bdds() - 1;
             }
 
-            switch(nr_bdds) {
-                case 1: return *bdd_begin;
-                case 2: { const size_t i = *bdd_begin; ++bdd_begin; const size_t j = *bdd_begin; return bdd_and(i, j, o); }
-                case 3: { auto b = construct_array<3>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 4: { auto b = construct_array<4>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 5: { auto b = construct_array<5>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 6: { auto b = construct_array<6>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 7: { auto b = construct_array<7>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 8: { auto b = construct_array<8>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 9: { auto b = construct_array<9>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 10: { auto b = construct_array<10>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 11: { auto b = construct_array<11>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 12: { auto b = construct_array<12>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 13: { auto b = construct_array<13>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 14: { auto b = construct_array<14>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 15: { auto b = construct_array<15>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 16: { auto b = construct_array<16>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 17: { auto b = construct_array<17>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 18: { auto b = construct_array<18>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 19: { auto b = construct_array<19>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 20: { auto b = construct_array<20>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 21: { auto b = construct_array<21>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 22: { auto b = construct_array<22>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 23: { auto b = construct_array<23>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 24: { auto b = construct_array<24>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 25: { auto b = construct_array<25>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 26: { auto b = construct_array<26>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 27: { auto b = construct_array<27>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 28: { auto b = construct_array<28>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 29: { auto b = construct_array<29>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 30: { auto b = construct_array<30>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 31: { auto b = construct_array<31>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 32: { auto b = construct_array<32>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 33: { auto b = construct_array<33>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 34: { auto b = construct_array<34>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 35: { auto b = construct_array<35>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 36: { auto b = construct_array<36>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 37: { auto b = construct_array<37>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 38: { auto b = construct_array<38>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 39: { auto b = construct_array<39>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 40: { auto b = construct_array<40>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 41: { auto b = construct_array<41>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 42: { auto b = construct_array<42>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 43: { auto b = construct_array<43>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 44: { auto b = construct_array<44>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 45: { auto b = construct_array<45>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 46: { auto b = construct_array<46>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 47: { auto b = construct_array<47>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 48: { auto b = construct_array<48>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                case 49: { auto b = construct_array<49>(bdd_begin, bdd_end); return bdd_and(b, o); }
-                default: throw std::runtime_error("generic and not implemented.");
-            }
+            if(nr_bdds == 0)
+                throw std::runtime_error("conjunction of zero BDDs not implemented.");
+            if(nr_bdds == 1)
+                return *bdd_begin;
+            const std::vector<size_t> bdd_nrs(bdd_begin, bdd_end);
+            return bdd_and_impl(bdd_nrs.data(), bdd_nrs.size(), o);
         }
 
     template<typename VAR_SET>
@@ -598,16 +524,8 @@ namespace BDD {
         {
             assert(i < nr_bdds());
             // copy old bdd instructions
-            for(size_t idx=bdd_delimiters[i]; idx<bdd_delimiters[i+1]; ++idx)
-            {
-                bdd_instruction instr = bdd_instructions[idx];
-                if(!instr.is_terminal())
-                {
-                    instr.lo += bdd_delimiters.back() - bdd_delimiters[i];
-                    instr.hi += bdd_delimiters.back() - bdd_delimiters[i];
-                }
-                bdd_instructions.push_back(instr);
-            }
+            bdd_instructions.resize(bdd_delimiters.back() + nr_bdd_nodes(i));
+            bdd_instructions.copy(bdd_instructions, bdd_delimiters[i], bdd_delimiters[i+1], bdd_delimiters.back());
             bdd_delimiters.push_back(bdd_instructions.size());
 
             assert(bdd_instructions.back().is_terminal());
@@ -622,7 +540,7 @@ namespace BDD {
             // reroute arcs to topsink for instructions that cover positive or negative variables
             for(size_t idx=bdd_delimiters[new_bdd_nr]; idx<bdd_delimiters[new_bdd_nr+1]-2; ++idx)
             {
-                auto& instr = bdd_instructions[idx];
+                auto instr = bdd_instructions[idx];
                 assert(!instr.is_terminal());
                 assert(!(positive_variables.count(instr.index) > 0 && negative_variables.count(instr.index) > 0));
                 if(positive_variables.count(instr.index) > 0)
@@ -831,9 +749,9 @@ namespace BDD {
             std::unordered_set<size_t> vars(var_begin, var_end);
             for(size_t bdd_idx=bdd_delimiters[bdd_nr]; bdd_idx<bdd_delimiters[bdd_nr+1]-2; ++bdd_idx)
             {
-                auto& bdd_instr = bdd_instructions[bdd_idx];
+                const bdd_instruction bdd_instr = bdd_instructions[bdd_idx];
                 if(vars.count(bdd_instr.index) > 0)
-                    std::swap(bdd_instr.lo, bdd_instr.hi);
+                    bdd_instructions.set(bdd_idx, {bdd_instr.hi, bdd_instr.lo, bdd_instr.index});
             }
         }
 
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace BDD {
+
+    struct bdd_instruction {
+        size_t lo = temp_undefined_index;
+        size_t hi = temp_undefined_index;
+        size_t index = temp_undefined_index;
+
+        constexpr static  size_t botsink_index = std::numeric_limits<size_t>::max()-1;
+        bool is_botsink() const { return index == botsink_index; }
+        static bdd_instruction botsink() { return {botsink_index, botsink_index, botsink_index}; }
+
+        constexpr static  size_t topsink_index = std::numeric_limits<size_t>::max();
+        bool is_topsink() const { return index == topsink_index; }
+        static bdd_instruction topsink() { return {topsink_index, topsink_index, topsink_index}; }
+
+        bool is_terminal() const { return is_botsink() || is_topsink(); }
+
+        bool operator==(const bdd_instruction& o) const { return lo == o.lo && hi == o.hi && index == o.index; }
+        bool operator!=(const bdd_instruction& o) const { return !(*this == o); }
+
+        // temporary values for building up
+        constexpr static size_t temp_botsink_index = std::numeric_limits<size_t>::max();
+        constexpr static size_t temp_topsink_index = std::numeric_limits<size_t>::max()-1;
+        constexpr static size_t temp_undefined_index = std::numeric_limits<size_t>::max()-2;
+    };
+
+    // bdd_instruction in 12 bytes: arcs are 32-bit offsets relative to the position of the instruction, variables are 32-bit.
+    // Relative arcs do not change when a whole BDD is moved, so BDDs can be copied between positions and collections verbatim.
+    struct compact_bdd_instruction {
+        uint32_t lo;
+        uint32_t hi;
+        uint32_t index;
+    };
+    static_assert(sizeof(compact_bdd_instruction) == 12);
+
+    // Stores bdd instructions as compact_bdd_instruction. Instructions whose arcs or variable do not fit into 32 bits are kept uncompressed in a second array the compact entry refers to.
+    // Reading returns bdd_instruction with absolute arcs, non-const operator[] returns a proxy through which the fields lo, hi and index can be assigned as for bdd_instruction.
+    class bdd_instruction_vector {
+        public:
+            template<size_t FIELD> class field_reference;
+            class reference;
+            class const_iterator;
+
+            bdd_instruction_vector() = default;
+            bdd_instruction_vector(std::vector<compact_bdd_instruction>&& compact, std::vector<bdd_instruction>&& uncompressed);
+
+            size_t size() const { return compact_.size(); }
+            bool empty() const { return compact_.empty(); }
+            void reserve(const size_t n) { compact_.reserve(n); }
+            void clear();
+            void resize(const size_t n);
+            void push_back(const bdd_instruction& instr);
+
+            bdd_instruction operator[](const size_t i) const { return get(i); }
+            reference operator[](const size_t i);
+            bdd_instruction back() const { assert(!empty()); return get(size()-1); }
+            reference back();
+
+            const_iterator begin() const;
+            const_iterator end() const;
+
+            bdd_instruction get(const size_t i) const;
+            void set(const size_t i, const bdd_instruction& instr);
+
+            size_t lo(const size_t i) const { return field<0>(i); }
+            size_t hi(const size_t i) const { return field<1>(i); }
+            size_t index(const size_t i) const { return field<2>(i); }
+            bool is_botsink(const size_t i) const { assert(i < size()); return compact_[i].index == index_code(bdd_instruction::botsink_index); }
+            bool is_topsink(const size_t i) const { assert(i < size()); return compact_[i].index == index_code(bdd_instruction::topsink_index); }
+            bool is_terminal(const size_t i) const { return is_botsink(i) || is_topsink(i); }
+
+            // copy instructions [first,last) of o to the existing positions [dest,dest+last-first).
+            // Arcs of copied instructions move along, so arcs within the range point to the copies afterwards. Copies into disjoint ranges may run concurrently if neither vector has uncompressed instructions.
+            void copy(const bdd_instruction_vector& o, const size_t first, const size_t last, const size_t dest);
+
+            // number of instructions stored in the uncompressed array
+            size_t nr_uncompressed() const { return uncompressed_.size() - free_uncompressed_.size(); }
+            size_t memory_usage() const { return compact_.capacity() * sizeof(compact_bdd_instruction) + uncompressed_.capacity() * sizeof(bdd_instruction) + free_uncompressed_.capacity() * sizeof(size_t); }
+
+            // raw arrays, e.g. for serialization
+            const std::vector<compact_bdd_instruction>& compact_instructions() const { return compact_; }
+            const std::vector<bdd_instruction>& uncompressed_instructions() const { return uncompressed_; }
+
+            bool operator==(const bdd_instruction_vector& o) const;
+            bool operator!=(const bdd_instruction_vector& o) const { return !(*this == o); }
+
+        private:
+            // the absolute values max-2,...,max are used for terminals and temporary arcs. For arcs they are encoded by the three smallest 32-bit offsets, for variables by the three largest 32-bit values.
+            constexpr static size_t special_begin = std::numeric_limits<size_t>::max()-2;
+            constexpr static uint32_t special_arc = 0x80000000u;
+            constexpr static int64_t min_arc_offset = int64_t(std::numeric_limits<int32_t>::min()) + 3;
+            constexpr static int64_t max_arc_offset = std::numeric_limits<int32_t>::max();
+            // index of compact instructions stored in the uncompressed array. lo and hi hold the lower and upper half of the position there.
+            constexpr static uint32_t uncompressed_index = std::numeric_limits<uint32_t>::max()-3;
+
+            constexpr static uint32_t index_code(const size_t special) { return std::numeric_limits<uint32_t>::max() - uint32_t(std::numeric_limits<size_t>::max() - special); }
+
+            static bool encode_arc(const size_t arc, const size_t pos, uint32_t& code)
+            {
+                if(arc >= special_begin)
+                {
+                    code = special_arc + uint32_t(std::numeric_limits<size_t>::max() - arc);
+                    return true;
+                }
+                const int64_t offset = int64_t(arc - pos);
+                if(offset < min_arc_offset || offset > max_arc_offset)
+                    return false;
+                code = uint32_t(int32_t(offset));
+                return true;
+            }
+
+            static size_t decode_arc(const uint32_t code, const size_t pos)
+            {
+                if(code - special_arc < 3)
+                    return std::numeric_limits<size_t>::max() - (code - special_arc);
+                return pos + size_t(int64_t(int32_t(code)));
+            }
+
+            static bool encode_index(const size_t index, uint32_t& code)
+            {
+                if(index >= special_begin)
+                {
+                    code = index_code(index);
+                    return true;
+                }
+                if(index >= uncompressed_index)
+                    return false;
+                code = uint32_t(index);
+                return true;
+            }
+
+            static size_t decode_index(const uint32_t code)
+            {
+                if(code > uncompressed_index)
+                    return std::numeric_limits<size_t>::max() - (std::numeric_limits<uint32_t>::max() - code);
+                return code;
+            }
+
+            static size_t uncompressed_pos(const compact_bdd_instruction& c) { assert(c.index == uncompressed_index); return size_t(c.lo) | (size_t(c.hi) << 32); }
+            bool is_uncompressed(const size_t i) const { return compact_[i].index == uncompressed_index; }
+
+            template<size_t FIELD>
+                size_t field(const size_t i) const
+                {
+                    assert(i < size());
+                    const compact_bdd_instruction& c = compact_[i];
+                    if(c.index == uncompressed_index)
+                    {
+                        const bdd_instruction& instr = uncompressed_[uncompressed_pos(c)];
+                        return FIELD == 0 ? instr.lo : FIELD == 1 ? instr.hi : instr.index;
+                    }
+                    if constexpr(FIELD == 0)
+                        return decode_arc(c.lo, i);
+                    else if constexpr(FIELD == 1)
+                        return decode_arc(c.hi, i);
+                    else
+                        return decode_index(c.index);
+                }
+
+            // write instr to position i, which must not refer to the uncompressed array
+            void encode(const size_t i, const bdd_instruction& instr);
+            void release_uncompressed(const size_t i);
+
+            std::vector<compact_bdd_instruction> compact_;
+            std::vector<bdd_instruction> uncompressed_;
+            std::vector<size_t> free_uncompressed_;
+    };
+
+    // assignable field of an instruction in bdd_instruction_vector. Cannot be copied, so that auto x = instr.lo yields a value.
+    template<size_t FIELD>
+        class bdd_instruction_vector::field_reference {
+            public:
+                operator size_t() const { return v_.field<FIELD>(i_); }
+                field_reference& operator=(const size_t x)
+                {
+                    bdd_instruction instr = v_.get(i_);
+                    (FIELD == 0 ? instr.lo : FIELD == 1 ? instr.hi : instr.index) = x;
+                    v_.set(i_, instr);
+                    return *this;
+                }
+                field_reference& operator=(const field_reference& o) { return *this = size_t(o); }
+                field_reference& operator+=(const size_t x) { return *this = size_t(*this) + x; }
+                field_reference& operator-=(const size_t x) { return *this = size_t(*this) - x; }
+
+            private:
+                friend class reference;
+                field_reference(bdd_instruction_vector& v, const size_t i) : v_(v), i_(i) {}
+                field_reference(const field_reference&) = default;
+
+                bdd_instruction_vector& v_;
+                const size_t i_;
+        };
+
+    class bdd_instruction_vector::reference {
+        public:
+            field_reference<0> lo;
+            field_reference<1> hi;
+            field_reference<2> index;
+
+            operator bdd_instruction() const { return lo.v_.get(lo.i_); }
+            reference& operator=(const bdd_instruction& instr) { lo.v_.set(lo.i_, instr); return *this; }
+            reference& operator=(const reference& o) { return *this = bdd_instruction(o); }
+
+            bool is_botsink() const { return lo.v_.is_botsink(lo.i_); }
+            bool is_topsink() const { return lo.v_.is_topsink(lo.i_); }
+            bool is_terminal() const { return lo.v_.is_terminal(lo.i_); }
+
+            bool operator==(const bdd_instruction& o) const { return bdd_instruction(*this) == o; }
+            bool operator!=(const bdd_instruction& o) const { return !(*this == o); }
+
+        private:
+            friend class bdd_instruction_vector;
+            reference(bdd_instruction_vector& v, const size_t i) : lo(v, i), hi(v, i), index(v, i) {}
+    };
+
+    class bdd_instruction_vector::const_iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = bdd_instruction;
+            using difference_type = std::ptrdiff_t;
+            using reference = bdd_instruction;
+            struct pointer {
+                bdd_instruction instr;
+                const bdd_instruction* operator->() const { return &instr; }
+            };
+
+            const_iterator() = default;
+            const_iterator(const bdd_instruction_vector* v, const size_t i) : v_(v), i_(i) {}
+
+            bdd_instruction operator*() const { return v_->get(i_); }
+            pointer operator->() const { return {**this}; }
+            bdd_instruction operator[](const difference_type n) const { return v_->get(i_ + n); }
+
+            // position of the instruction in the vector
+            size_t position() const { return i_; }
+
+            const_iterator& operator++() { ++i_; return *this; }
+            const_iterator operator++(int) { const_iterator it = *this; ++i_; return it; }
+            const_iterator& operator--() { --i_; return *this; }
+            const_iterator operator--(int) { const_iterator it = *this; --i_; return it; }
+            const_iterator& operator+=(const difference_type n) { i_ += n; return *this; }
+            const_iterator& operator-=(const difference_type n) { i_ -= n; return *this; }
+            const_iterator operator+(const difference_type n) const { return const_iterator(v_, i_ + n); }
+            const_iterator operator-(const difference_type n) const { return const_iterator(v_, i_ - n); }
+            friend const_iterator operator+(const difference_type n, const const_iterator it) { return it + n; }
+            difference_type operator-(const const_iterator o) const { assert(v_ == o.v_); return difference_type(i_) - difference_type(o.i_); }
+
+            bool operator==(const const_iterator o) const { assert(v_ == o.v_); return i_ == o.i_; }
+            bool operator!=(const const_iterator o) const { return !(*this == o); }
+            bool operator<(const const_iterator o) const { assert(v_ == o.v_); return i_ < o.i_; }
+            bool operator>(const const_iterator o) const { return o < *this; }
+            bool operator<=(const const_iterator o) const { return !(o < *this); }
+            bool operator>=(const const_iterator o) const { return !(*this < o); }
+
+        private:
+            const bdd_instruction_vector* v_ = nullptr;
+            size_t i_ = 0;
+    };
+
+    inline bdd_instruction_vector::bdd_instruction_vector(std::vector<compact_bdd_instruction>&& compact, std::vector<bdd_instruction>&& uncompressed)
+        : compact_(std::move(compact)),
+        uncompressed_(std::move(uncompressed))
+    {
+        // positions of the uncompressed array not referred to anymore are free
+        std::vector<char> used(uncompressed_.size(), false);
+        for(const compact_bdd_instruction& c : compact_)
+            if(c.index == uncompressed_index)
+            {
+                assert(uncompressed_pos(c) < uncompressed_.size());
+                used[uncompressed_pos(c)] = true;
+            }
+        for(size_t i=0; i<used.size(); ++i)
+            if(!used[i])
+                free_uncompressed_.push_back(i);
+    }
+
+    inline void bdd_instruction_vector::clear()
+    {
+        compact_.clear();
+        uncompressed_.clear();
+        free_uncompressed_.clear();
+    }
+
+    inline void bdd_instruction_vector::resize(const size_t n)
+    {
+        if(nr_uncompressed() > 0)
+            for(size_t i=n; i<size(); ++i)
+                if(is_uncompressed(i))
+                    release_uncompressed(i);
+        constexpr uint32_t undefined_arc = special_arc + uint32_t(std::numeric_limits<size_t>::max() - bdd_instruction::temp_undefined_index);
+        compact_.resize(n, {undefined_arc, undefined_arc, index_code(bdd_instruction::temp_undefined_index)});
+    }
+
+    inline void bdd_instruction_vector::push_back(const bdd_instruction& instr)
+    {
+        compact_.emplace_back();
+        encode(compact_.size()-1, instr);
+    }
+
+    inline bdd_instruction_vector::reference bdd_instruction_vector::operator[](const size_t i)
+    {
+        assert(i < size());
+        return reference(*this, i);
+    }
+
+    inline bdd_instruction_vector::reference bdd_instruction_vector::back()
+    {
+        assert(!empty());
+        return reference(*this, size()-1);
+    }
+
+    inline bdd_instruction_vector::const_iterator bdd_instruction_vector::begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    inline bdd_instruction_vector::const_iterator bdd_instruction_vector::end() const
+    {
+        return const_iterator(this, size());
+    }
+
+    inline bdd_instruction bdd_instruction_vector::get(const size_t i) const
+    {
+        assert(i < size());
+        const compact_bdd_instruction& c = compact_[i];
+        if(c.index == uncompressed_index)
+            return uncompressed_[uncompressed_pos(c)];
+        return {decode_arc(c.lo, i), decode_arc(c.hi, i), decode_index(c.index)};
+    }
+
+    inline void bdd_instruction_vector::set(const size_t i, const bdd_instruction& instr)
+    {
+        assert(i < size());
+        if(is_uncompressed(i))
+            release_uncompressed(i);
+        encode(i, instr);
+    }
+
+    inline void bdd_instruction_vector::encode(const size_t i, const bdd_instruction& instr)
+    {
+        compact_bdd_instruction& c = compact_[i];
+        if(encode_arc(instr.lo, i, c.lo) && encode_arc(instr.hi, i, c.hi) && encode_index(instr.index, c.index))
+            return;
+
+        size_t pos;
+        if(free_uncompressed_.empty())
+        {
+            pos = uncompressed_.size();
+            uncompressed_.push_back(instr);
+        }
+        else
+        {
+            pos = free_uncompressed_.back();
+            free_uncompressed_.pop_back();
+            uncompressed_[pos] = instr;
+        }
+        c = {uint32_t(pos), uint32_t(pos >> 32), uncompressed_index};
+    }
+
+    inline void bdd_instruction_vector::release_uncompressed(const size_t i)
+    {
+        free_uncompressed_.push_back(uncompressed_pos(compact_[i]));
+        if(free_uncompressed_.size() == uncompressed_.size())
+        {
+            uncompressed_.clear();
+            free_uncompressed_.clear();
+        }
+    }
+
+    inline void bdd_instruction_vector::copy(const bdd_instruction_vector& o, const size_t first, const size_t last, const size_t dest)
+    {
+        assert(first <= last && last <= o.size());
+        assert(dest + (last - first) <= size());
+        assert(&o != this || dest <= first || dest >= last);
+
+        if(o.nr_uncompressed() == 0 && nr_uncompressed() == 0)
+        {
+            std::copy(o.compact_.begin() + first, o.compact_.begin() + last, compact_.begin() + dest);
+            return;
+        }
+
+        // positions overwritten when copying within the same vector have been read before, hence releasing them does not affect instructions still to be copied
+        for(size_t k=0; k<last-first; ++k)
+        {
+            const compact_bdd_instruction c = o.compact_[first + k];
+            if(is_uncompressed(dest + k))
+                release_uncompressed(dest + k);
+            if(c.index != uncompressed_index)
+            {
+                compact_[dest + k] = c;
+                continue;
+            }
+            bdd_instruction instr = o.uncompressed_[uncompressed_pos(c)];
+            if(instr.lo < special_begin)
+                instr.lo += dest - first;
+            if(instr.hi < special_begin)
+                instr.hi += dest - first;
+            encode(dest + k, instr);
+        }
+    }
+
+    inline bool bdd_instruction_vector::operator==(const bdd_instruction_vector& o) const
+    {
+        if(size() != o.size())
+            return false;
+        for(size_t i=0; i<size(); ++i)
+            if(get(i) != o.get(i))
+                return false;
+        return true;
+    }
+
+}
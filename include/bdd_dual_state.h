@@ -0,0 +1,38 @@
+#pragma once
+
+#include "bdd_collection/bdd_collection.h"
+#include <array>
+#include <string>
+#include <vector>
+
+// dual state of a BDD solver stored on disk for warm starting subsequent runs on the same BDDs.
+// It holds the low and high costs of all bdd branch nodes in the internal order of the solver together with the objective they were obtained for.
+// Since the node order depends on the BDDs and on the solver, files are keyed by the bdd collection and the solver type.
+// Files are binary, consisting of a header, the key, the objective and the node costs.
+
+namespace LPMP {
+
+    struct bdd_dual_state {
+        struct key_type {
+            size_t hash = 0;
+            size_t solver_type = 0;
+            // raw arrays of the bdd collection, stored in the file and compared on load so that hash collisions are detected
+            std::vector<BDD::compact_bdd_instruction> instructions;
+            std::vector<BDD::bdd_instruction> uncompressed_instructions;
+            std::vector<size_t> delimiters;
+
+            bool operator==(const key_type& o) const;
+            bool operator!=(const key_type& o) const { return !(*this == o); }
+        };
+
+        static key_type key(const BDD::bdd_collection& bdd_col, const size_t solver_type);
+
+        // return false if the file does not exist or was written for another key
+        bool load(const std::string& filename, const key_type& key);
+        void store(const std::string& filename, const key_type& key) const;
+
+        std::vector<double> objective;
+        std::vector<std::array<double,2>> node_costs;
+    };
+
+}
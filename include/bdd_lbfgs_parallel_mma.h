@@ -16,16 +16,33 @@ namespace LPMP {
             bdd_lbfgs_parallel_mma(BDD::bdd_collection& bdd_col, ITERATOR cost_begin, ITERATOR cost_end,
                 const int _history_size, const double _init_step_size = 1e-6, const double _req_rel_lb_increase = 1e-6, 
                 const double _step_size_decrease_factor = 0.8, const double _step_size_increase_factor = 1.1);
+            // copies all bdd branch nodes, afterwards copies can be synchronized cheaply through set_node_costs
+            bdd_lbfgs_parallel_mma(const bdd_lbfgs_parallel_mma&);
             bdd_lbfgs_parallel_mma(bdd_lbfgs_parallel_mma&&);
             bdd_lbfgs_parallel_mma& operator=(bdd_lbfgs_parallel_mma&&);
             ~bdd_lbfgs_parallel_mma();
             template<typename ITERATOR>
                 void update_costs(ITERATOR cost_lo_begin, ITERATOR cost_lo_end, ITERATOR cost_hi_begin, ITERATOR cost_hi_end);
+            // add costs per variable and BDD covering it, same layout as min_marginals()
+            void update_costs(const two_dim_variable_array<std::array<double,2>>& delta);
             double lower_bound();
             size_t nr_variables();
             two_dim_variable_array<std::array<double,2>> min_marginals();
+            // for each variable and each BDD covering it whether the BDD accepts the solution, same layout as min_marginals()
+            template<typename ITERATOR>
+                two_dim_variable_array<char> bdd_feasibility(ITERATOR sol_begin, ITERATOR sol_end);
             void iteration();
             void backward_run(); 
+            void tighten();
+
+            // low and high costs of all bdd branch nodes in internal order, for checkpointing the dual state
+            std::vector<std::array<double,2>> node_costs() const;
+            void set_node_costs(const std::vector<std::array<double,2>>& costs);
+
+            // accumulate min-marginal differences contention-free through per-BDD slots instead of atomic operations
+            void set_atomic_free_delta_aggregation(const bool atomic_free);
+            // make iterations independent of number of threads
+            void set_deterministic(const bool deterministic);
 
             std::vector<char> incremental_mm_agreement_rounding(const double init_delta, const double delta_grwoth_rate, const int num_itr_lb, const int num_rounds = 500);
 
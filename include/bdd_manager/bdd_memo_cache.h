@@ -3,8 +3,8 @@
 #include "bdd_node.h"
 #include "bdd_node_cache.h"
 #include <vector>
-#include <unordered_map>
 #include <array>
+#include <mutex>
 
 namespace BDD {
 
@@ -25,7 +25,7 @@ namespace BDD {
 
         template<typename T>
         constexpr static node* xor_symb_impl() { return static_cast<T*>(nullptr) + 3; }
-        constexpr static node* xor_symb() { return or_symb_impl<node>(); }
+        constexpr static node* xor_symb() { return xor_symb_impl<node>(); }
 
         bool operator==(const memo_struct& m) const;
         bool operator!=(const memo_struct& m) const;
@@ -35,40 +35,74 @@ namespace BDD {
 
     using memo = memo_struct;
 
+    struct memo_cache_statistics {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t inserts = 0;
+        size_t evictions = 0; // valid entries overwritten by inserts
+        size_t memory = 0; // bytes currently allocated for entries
+
+        memo_cache_statistics& operator+=(const memo_cache_statistics& o);
+        double hit_rate() const;
+    };
+
+    // Computed table with a fixed memory budget.
+    // Entries are grouped into sets of memo_cache::associativity many, an entry can only be stored in the set its hash points to.
+    // The table doubles while it is below its budget. Afterwards inserting into a full set overwrites the least recently used entry.
     class memo_cache {
         public:
-            memo_cache(bdd_node_cache& _node_cache);
+            constexpr static size_t associativity = 4;
+            constexpr static size_t default_max_memory = static_cast<size_t>(1) << 27; // 128 MiB
+
+            memo_cache(bdd_node_cache& _node_cache, const size_t max_memory = default_max_memory);
             node* cache_lookup(node* f, node* g, node* h);
             void cache_insert(node* f, node* g, node* h, node* r);
-            memo_struct& get_memo(const size_t slot);
 
             void purge();
+            // changing the budget empties the cache
+            void set_max_memory(const size_t max_memory);
+            size_t max_memory() const { return max_nr_sets * associativity * sizeof(memo_struct); }
+            const memo_cache_statistics& statistics() const { return stats; }
+
+            static size_t cache_hash(node* f, node* g, node* h);
 
         private:
-            size_t cache_hash(node* f, node* g, node* h);
             void init_cache();
             void double_cache();
-            size_t choose_cache_size(const size_t items) const;
+            memo_struct* get_set(const size_t hash);
+            size_t nr_sets() const { return memos.size() / associativity; }
             size_t nr_occupied_slots() const;
 
-            std::vector<memo_struct> memos;
-            size_t memos_mask = 0;
-            size_t cache_inserts = 0; // nr of times we have inserted into cache
+            std::vector<memo_struct> memos; // sets are stored contiguously, within a set entries are ordered from most to least recently used
+            size_t sets_mask = 0;
+            size_t max_nr_sets = 1;
+            size_t cache_inserts = 0; // nr of times we have inserted into cache since the last doubling
             size_t threshold = 0; // nr of inserts that triggers cache doubling
+            memo_cache_statistics stats;
 
-            struct array_hasher {
-                std::size_t operator()(const std::array<node*, 3>& a) const {
-                    size_t h = 0;
-                    for (auto e : a) {
-                        h ^= std::hash<node*>{}(e)  + 0x9e3779b9 + (h << 6) + (h >> 2); 
-                    }
-                    return h;
-                }   
-            };
-            std::unordered_map<std::array<node*,3>, std::tuple<node*,size_t>, array_hasher> memos2;
             bdd_node_cache& node_cache;
-            size_t insert_time_stamp = 0;
+    };
+
+    // memo cache of a concurrent bdd_mgr.
+    // Entries are distributed over shards by hash, every shard is an ordinary memo cache guarded by its own lock.
+    class concurrent_memo_cache {
+        public:
+            // max_memory is divided evenly among the shards
+            concurrent_memo_cache(bdd_node_cache& _node_cache, const size_t max_memory = memo_cache::default_max_memory);
+            node* cache_lookup(node* f, node* g, node* h);
+            void cache_insert(node* f, node* g, node* h, node* r);
+
+            void purge();
+            void set_max_memory(const size_t max_memory);
+            memo_cache_statistics statistics() const;
+
+        private:
+            constexpr static size_t log_nr_shards = 6;
+            constexpr static size_t nr_shards = static_cast<size_t>(1) << log_nr_shards;
+            static size_t shard(node* f, node* g, node* h);
 
+            std::vector<memo_cache> shards_;
+            mutable std::array<std::mutex, nr_shards> mutexes_;
     };
 
 }
@@ -9,6 +9,9 @@
 #include <unordered_map>
 #include <tuple>
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <functional>
 #include <cassert>
 
 namespace BDD {
@@ -17,9 +20,15 @@ namespace BDD {
 
     class bdd_mgr {
         public:
-            bdd_mgr();
+            // A concurrent bdd_mgr can be used by several threads at once: unique tables are locked per variable,
+            // nodes are reserved from per thread arenas and the memo cache is split into independently locked shards.
+            // Garbage collection must not run concurrently with other operations.
+            bdd_mgr(const bool concurrent = false);
             ~bdd_mgr();
+            bool concurrent() const { return concurrent_; }
             size_t add_variable();
+            // add variables until there are at least nr_vars many
+            void add_variables(const size_t nr_vars);
             size_t nr_variables() const { return vars.size(); }
             size_t nr_nodes() const { return node_cache_.nr_nodes(); }
             node_ref projection(const size_t var);
@@ -52,6 +61,19 @@ namespace BDD {
 
             // f is if-condition, g is for 1-outcome, h is for lo outcome
             node_ref ite_rec(node_ref f, node_ref g, node_ref h);
+
+            // Task parallel apply for concurrent managers: the lo and hi recursions are spawned as OpenMP tasks up to parallel_apply_depth.
+            // Deeper recursions and non-concurrent managers use the sequential apply.
+            // The conjunction, disjunction and parity of ranges of BDDs are computed by a balanced tree of parallel applies in concurrent managers.
+            node_ref and_rec_parallel(node_ref f, node_ref g);
+            node_ref or_rec_parallel(node_ref f, node_ref g);
+            node_ref xor_rec_parallel(node_ref f, node_ref g);
+            node_ref ite_rec_parallel(node_ref f, node_ref g, node_ref h);
+            void set_parallel_apply_depth(const size_t depth) { parallel_apply_depth_ = depth; }
+
+            // bound memory of the memo cache, results computed so far are dropped
+            void set_memo_cache_memory(const size_t bytes);
+            memo_cache_statistics memo_cache_stats() const;
             //node_ref ite_non_rec(node_ref f, node_ref g, node_ref h, std::stack<>& stack);
 
             // make a copy of bdd rooted at node to variables given
@@ -93,11 +115,27 @@ namespace BDD {
             node_ref add_bdd(bdd_collection& bdd_col, const size_t bdd_nr);
 
         private:
+            node* memo_lookup(node* f, node* g, node* h);
+            void memo_insert(node* f, node* g, node* h, node* r);
+
+            // op is one of memo_struct::and_symb(), or_symb() and xor_symb()
+            node_ref apply(node* op, node_ref f, node_ref g);
+            node_ref apply_parallel(node* op, node_ref f, node_ref g, const size_t depth);
+            node_ref ite_parallel(node_ref f, node_ref g, node_ref h, const size_t depth);
+            node_ref reduce_parallel(node* op, node_ref* nodes, const size_t n);
+            template<class ITERATOR>
+                node_ref reduce_parallel(node* op, ITERATOR nodes_begin, ITERATOR nodes_end);
+            // run f inside a parallel region, so that tasks spawned by f are executed by all threads
+            void run_parallel(const std::function<void()>& f);
+            size_t parallel_apply_depth_ = 10;
 
+            const bool concurrent_;
             bdd_node_cache node_cache_;
             unique_table_page_caches page_cache_;
             memo_cache memo_;
-            std::vector<var_struct> vars; // vars must be after node cache und page cache for correct destructor calling order
+            std::unique_ptr<concurrent_memo_cache> concurrent_memo_; // replaces memo_ in concurrent mode
+            std::mutex vars_mutex_; // serializes adding variables in concurrent mode
+            var_storage vars; // vars must be after node cache und page cache for correct destructor calling order
 
     }; 
 
@@ -107,8 +145,7 @@ namespace BDD {
         size_t last_var = 0;
         for(const auto [x,y] : var_map)
             last_var = std::max(y, last_var);
-        for(size_t i=nr_variables(); i<=last_var; ++i)
-            add_variable();
+        add_variables(last_var+1);
 
         // copy nodes one by one in postordering
         const auto postorder = p.address()->nodes_postorder();
@@ -136,8 +173,7 @@ namespace BDD {
         const size_t nr_vars = std::distance(var_map_begin, var_map_end);
         assert(p.variables().back() <= nr_vars);
         const size_t last_var = *std::max_element(var_map_begin, var_map_end);
-        for(size_t i=nr_variables(); i<=last_var; ++i)
-            add_variable();
+        add_variables(last_var+1);
 
         const auto postorder = p.address()->nodes_postorder();
         std::unordered_map<node*, node*> node_map;
@@ -159,11 +195,20 @@ namespace BDD {
     }
 
     //remplate<class... NODES, class = std::conjunction<std::is_same<node*, NODES>...>
+    template<class ITERATOR>
+        node_ref bdd_mgr::reduce_parallel(node* op, ITERATOR nodes_begin, ITERATOR nodes_end)
+        {
+            std::vector<node_ref> nodes(nodes_begin, nodes_end);
+            node_ref r;
+            run_parallel([&]() { r = reduce_parallel(op, nodes.data(), nodes.size()); });
+            return r;
+        }
+
     template<class... NODES>
         node_ref bdd_mgr::and_rec(node_ref p, NODES... tail)
         {
-            node_ref and_tail(and_rec(tail...));
-            return and_rec(p, and_tail); 
+            std::array<node_ref, 1 + sizeof...(NODES)> nodes = {p, tail...};
+            return and_rec(nodes.begin(), nodes.end());
         }
 
     template<class ITERATOR>
@@ -171,6 +216,8 @@ namespace BDD {
         {
             const size_t n = std::distance(nodes_begin, nodes_end);
             assert(n >= 2);
+            if(concurrent_)
+                return reduce_parallel(memo_struct::and_symb(), nodes_begin, nodes_end);
             if(n == 2)
                 return and_rec(*nodes_begin, *(nodes_begin+1));
             else if(n == 3)
@@ -184,14 +231,16 @@ namespace BDD {
     template<class... NODES>
         node_ref bdd_mgr::or_rec(node_ref p, NODES... tail)
         {
-            node_ref or_tail(or_rec(tail...));
-            return or_rec(p, or_tail); 
+            std::array<node_ref, 1 + sizeof...(NODES)> nodes = {p, tail...};
+            return or_rec(nodes.begin(), nodes.end());
         }
     template<class ITERATOR>
         node_ref bdd_mgr::or_rec(ITERATOR nodes_begin, ITERATOR nodes_end)
         {
             const size_t n = std::distance(nodes_begin, nodes_end);
             assert(n >= 2);
+            if(concurrent_)
+                return reduce_parallel(memo_struct::or_symb(), nodes_begin, nodes_end);
             if(n == 2)
                 return or_rec(*nodes_begin, *(nodes_begin+1));
             else if(n == 3)
@@ -205,14 +254,16 @@ namespace BDD {
     template<class... NODES>
         node_ref bdd_mgr::xor_rec(node_ref p, NODES... tail)
         {
-            node_ref xor_tail(xor_rec(tail...));
-            return xor_rec(p, xor_tail); 
+            std::array<node_ref, 1 + sizeof...(NODES)> nodes = {p, tail...};
+            return xor_rec(nodes.begin(), nodes.end());
         }
     template<class ITERATOR>
         node_ref bdd_mgr::xor_rec(ITERATOR nodes_begin, ITERATOR nodes_end)
         {
             const size_t n = std::distance(nodes_begin, nodes_end);
             assert(n >= 2);
+            if(concurrent_)
+                return reduce_parallel(memo_struct::xor_symb(), nodes_begin, nodes_end);
             if(n == 2)
                 return xor_rec(*nodes_begin, *(nodes_begin+1));
             else if(n == 3)
@@ -5,6 +5,7 @@
 #include <vector>
 #include <functional>
 #include <unordered_map>
+#include <atomic>
 
 namespace BDD {
 
@@ -61,7 +62,7 @@ class node_struct
     std::size_t hash_key : unique_table_hash_size; // make const
     std::size_t marked_ : 1;
     //std::size_t large_subtree : 1; // subtree is large enough so that recursively visiting nodes would exceed stack
-	int xref = 0;
+    std::atomic<int> xref = 0; // atomic, since nodes of a concurrent bdd_mgr are referenced from several threads
 
     constexpr static size_t botsink_index = (static_cast<size_t>(1) << logvarsize) - 1; //std::pow(2,logvarsize)-1;
     constexpr static size_t topsink_index = (static_cast<size_t>(1) << logvarsize) - 2; //std::pow(2,logvarsize)-2;
@@ -77,6 +78,11 @@ class node_struct
     size_t nr_nodes_impl();
     void variables_impl(std::vector<size_t>&);
     void nodes_postorder_impl(std::vector<node_struct*>&);
+    // nodes of a concurrent bdd_mgr may be traversed by several threads at once, hence they cannot be marked.
+    // Traversals then record visited nodes in a hash set instead.
+    bool in_concurrent_mgr();
+    std::vector<node_struct*> nodes_postorder_unmarked();
+    std::vector<node_struct*> nodes_bfs_unmarked();
     size_t nr_solutions_impl(std::unordered_map<node_struct*, size_t>& nr_map, std::unordered_map<size_t,size_t>& var_order);
     // depth first search bdd to find terminal node, where link to bdd mgr is stored
 
@@ -2,6 +2,9 @@
 
 #include <memory>
 #include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
 #include "bdd_node.h"
 
 namespace BDD {
@@ -16,13 +19,22 @@ struct bdd_node_page
 
 class bdd_mgr;
 
+// lock m only if the guarded data structure is shared between threads
+inline std::unique_lock<std::mutex> lock_if_concurrent(std::mutex& m, const bool concurrent)
+{
+    if(concurrent)
+        return std::unique_lock<std::mutex>(m);
+    return std::unique_lock<std::mutex>(m, std::defer_lock);
+}
+
 class bdd_node_cache
 {
     public:
-        bdd_node_cache(bdd_mgr* mgr);
+        // in concurrent mode nodes can be reserved from several threads at once
+        bdd_node_cache(bdd_mgr* mgr, const bool concurrent = false);
         node* reserve_node(void);
         void free_node(node*p);
-        size_t nr_nodes() const { return total_nodes; }
+        size_t nr_nodes() const;
         node* botsink() const { return botsink_; }
         node* topsink() const { return topsink_; }
 
@@ -37,6 +49,22 @@ class bdd_node_cache
         node* topsink_; 
         size_t total_nodes = 2; // nr nodes currently in use
         size_t deadnodes = 0; // nr nodes currently having xref < 0
+
+        // In concurrent mode every thread reserves nodes from its own arena without locking.
+        // Only refilling an exhausted arena with a fresh page or with freed nodes takes the lock.
+        struct alignas(64) arena {
+            node* next = nullptr; // next unused node of the current page
+            node* end = nullptr;
+            node* avail = nullptr; // stack of freed nodes handed to this arena
+            std::atomic<size_t> nr_reserved = 0;
+        };
+        arena& local_arena();
+        void refill(arena& a);
+
+        const bool concurrent_;
+        const size_t id_; // distinguishes node caches in thread local arena lookup
+        mutable std::mutex mutex_;
+        std::deque<arena> arenas_;
 };
 
 }
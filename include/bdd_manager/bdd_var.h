@@ -3,6 +3,9 @@
 #include <memory>
 #include <array>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <new>
 #include "bdd_node.h"
 #include "bdd_node_cache.h"
 
@@ -67,6 +70,8 @@ class unique_table_page_caches {
         unique_table_page_cache<262144,4> cache_262144;
         unique_table_page_cache<524288,2> cache_524288;
         unique_table_page_cache<1048576,1> cache_1048576;
+
+        std::mutex mutex; // guards all page caches if the bdd_mgr is concurrent
 };
 
 class bdd_mgr; // forward declaration
@@ -83,6 +88,7 @@ class var_struct {
         std::size_t hash_code(node* l, node* r) const;
         size_t nr_free_slots_debug() const;
         node* unique_table_lookup(node* l, node* h);
+        // thread safe if the bdd_mgr is concurrent
         node* unique_find(const std::size_t index, node* l,node* h); 
         node* unique_find(node* l,node* h); 
         //node* projection() const;
@@ -93,6 +99,7 @@ class var_struct {
         double occupied_rate() const;
         double occupied_rate(const size_t new_nr_pages) const;
         void initialize_unique_table();
+        node* unique_find_impl(const std::size_t index, node* l, node* h);
 
         node** new_page(const size_t new_mask);
         void free_page(node** p, const size_t mask);
@@ -137,10 +144,61 @@ class var_struct {
         struct var_struct *up, *down; // the neighboring active variables
 
         bdd_mgr& bdd_mgr_;
+        std::mutex mutex_; // guards the unique table if the bdd_mgr is concurrent
 };
 
 using var = var_struct;
 
+// Variables are stored in segments of doubling size that are never moved.
+// Hence references to variables stay valid when new variables are added and lookups need no lock.
+class var_storage {
+    public:
+        var_storage() = default;
+        var_storage(const var_storage&) = delete;
+        ~var_storage();
+        std::size_t size() const { return size_.load(std::memory_order_acquire); }
+        var_struct& operator[](const std::size_t i);
+        var_struct& back() { assert(size() > 0); return (*this)[size()-1]; }
+        // not thread safe, concurrent calls must be serialized
+        void emplace_back(bdd_mgr& _bdd_mgr);
+
+    private:
+        constexpr static std::size_t log_first_segment_size = 10;
+        constexpr static std::size_t nr_segments = logvarsize - log_first_segment_size + 1;
+        static std::size_t segment(const std::size_t i) { return 63 - __builtin_clzll((i >> log_first_segment_size) + 1); }
+        static std::size_t segment_begin(const std::size_t s) { return ((static_cast<std::size_t>(1) << s) - 1) << log_first_segment_size; }
+        static std::size_t segment_size(const std::size_t s) { return static_cast<std::size_t>(1) << (s + log_first_segment_size); }
+
+        std::array<std::atomic<var_struct*>, nr_segments> segments_ = {};
+        std::atomic<std::size_t> size_ = 0;
+};
+
+inline var_storage::~var_storage()
+{
+    for(std::size_t i=0; i<size(); ++i)
+        (*this)[i].~var_struct();
+    for(auto& s : segments_)
+        ::operator delete(s.load());
+}
+
+inline var_struct& var_storage::operator[](const std::size_t i)
+{
+    assert(i < size());
+    const std::size_t s = segment(i);
+    return segments_[s].load(std::memory_order_acquire)[i - segment_begin(s)];
+}
+
+inline void var_storage::emplace_back(bdd_mgr& _bdd_mgr)
+{
+    const std::size_t i = size_.load(std::memory_order_relaxed);
+    const std::size_t s = segment(i);
+    assert(s < nr_segments);
+    if(i == segment_begin(s))
+        segments_[s].store(static_cast<var_struct*>(::operator new(segment_size(s) * sizeof(var_struct))), std::memory_order_release);
+    new (segments_[s].load(std::memory_order_relaxed) + (i - segment_begin(s))) var_struct(i, _bdd_mgr);
+    size_.store(i+1, std::memory_order_release);
+}
+
     template<size_t PAGE_SIZE, size_t NR_SIMUL_ALLOC>
 unique_table_page_cache<PAGE_SIZE, NR_SIMUL_ALLOC>::unique_table_page_cache()
 {
@@ -14,6 +14,8 @@ namespace LPMP {
             bdd_mma(BDD::bdd_collection& bdd_col);
             template<typename ITERATOR>
             bdd_mma(BDD::bdd_collection& bdd_col, ITERATOR cost_begin, ITERATOR cost_end);
+            // copies all bdd branch nodes, afterwards copies can be synchronized cheaply through set_node_costs
+            bdd_mma(const bdd_mma&);
             bdd_mma(bdd_mma&&);
             bdd_mma& operator=(bdd_mma&&);
             ~bdd_mma();
@@ -34,6 +36,10 @@ namespace LPMP {
             void fix_variable(const size_t var, const bool value);
 
             void tighten();
+
+            // low and high costs of all bdd branch nodes in internal order, for checkpointing the dual state
+            std::vector<std::array<double,2>> node_costs() const;
+            void set_node_costs(const std::vector<std::array<double,2>>& costs);
         private:
 
             class impl;
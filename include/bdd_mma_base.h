@@ -75,6 +75,11 @@ namespace LPMP {
                 template<typename REAL>
                     void update_costs(const two_dim_variable_array<std::array<REAL,2>>& delta);
 
+                // low and high costs of all bdd branch nodes in internal order, i.e. the complete dual state apart from the constant
+                std::vector<std::array<value_type,2>> node_costs() const;
+                template<typename ITERATOR>
+                    void set_node_costs(ITERATOR begin, ITERATOR end);
+
                 void add_to_constant(const double c) { constant_ += c; }
                 double constant() const { return constant_; }
 
@@ -503,6 +508,36 @@ namespace LPMP {
         return costs; 
     }
 
+    template<typename BDD_BRANCH_NODE>
+    std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>> bdd_mma_base<BDD_BRANCH_NODE>::node_costs() const
+    {
+        std::vector<std::array<value_type,2>> costs;
+        costs.reserve(bdd_branch_nodes_.size());
+        for(const auto& bdd : bdd_branch_nodes_)
+            costs.push_back({bdd.low_cost, bdd.high_cost});
+        return costs;
+    }
+
+    template<typename BDD_BRANCH_NODE>
+    template<typename ITERATOR>
+        void bdd_mma_base<BDD_BRANCH_NODE>::set_node_costs(ITERATOR begin, ITERATOR end)
+        {
+            if(std::distance(begin, end) != bdd_branch_nodes_.size())
+                throw std::runtime_error("number of node costs does not match number of bdd branch nodes");
+
+            lower_bound_ = -std::numeric_limits<double>::infinity();
+            lower_bound_state_ = lower_bound_state::invalid;
+            message_passing_state_ = message_passing_state::none;
+
+            auto it = begin;
+            for(auto& bdd : bdd_branch_nodes_)
+            {
+                bdd.low_cost = (*it)[0];
+                bdd.high_cost = (*it)[1];
+                ++it;
+            }
+        }
+
     template<typename BDD_BRANCH_NODE>
     template<typename COST_ITERATOR, typename VARIABLE_ITERATOR>
         void bdd_mma_base<BDD_BRANCH_NODE>::update_bdd_costs(const size_t bdd_nr,
@@ -1423,8 +1458,8 @@ namespace LPMP {
                     if(bdd_counter + nr_bdds() >= std::numeric_limits<uint32_t>::max())
                         throw std::runtime_error("bdd indices exceed 2^32"); // TODO: write alternative mechanism for this case
                     new_bdd_branch_nodes_[bdd_branch_index].bdd_index = nr_bdds() + bdd_counter;
-                    assert(stored_bdd_index_to_bdd_offset.count(bdd_col.offset(*bdd_it)) == 0);
-                    stored_bdd_index_to_bdd_offset[bdd_col.offset(*bdd_it)] = &new_bdd_branch_nodes_[bdd_branch_index];
+                    assert(stored_bdd_index_to_bdd_offset.count(bdd_col.offset(bdd_it)) == 0);
+                    stored_bdd_index_to_bdd_offset[bdd_col.offset(bdd_it)] = &new_bdd_branch_nodes_[bdd_branch_index];
                 }
 
                 assert(cur_first_bdd_node_indices.size() > 0);
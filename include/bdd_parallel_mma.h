@@ -12,12 +12,16 @@ namespace LPMP {
             bdd_parallel_mma(BDD::bdd_collection& bdd_col);
             template<typename ITERATOR>
             bdd_parallel_mma(BDD::bdd_collection& bdd_col, ITERATOR cost_begin, ITERATOR cost_end);
+            // copies all bdd branch nodes, afterwards copies can be synchronized cheaply through set_node_costs
+            bdd_parallel_mma(const bdd_parallel_mma&);
             bdd_parallel_mma(bdd_parallel_mma&&);
             bdd_parallel_mma& operator=(bdd_parallel_mma&&);
             ~bdd_parallel_mma();
 
             template<typename ITERATOR>
                 void update_costs(ITERATOR cost_lo_begin, ITERATOR cost_lo_end, ITERATOR cost_hi_begin, ITERATOR cost_hi_end);
+            // add costs per variable and BDD covering it, same layout as min_marginals()
+            void update_costs(const two_dim_variable_array<std::array<double,2>>& delta);
             void add_to_constant(const double c);
 
             size_t nr_variables() const;
@@ -27,11 +31,23 @@ namespace LPMP {
             void distribute_delta();
             void backward_run(); 
             two_dim_variable_array<std::array<double,2>> min_marginals();
+            // for each variable and each BDD covering it whether the BDD accepts the solution, same layout as min_marginals()
+            template<typename ITERATOR>
+                two_dim_variable_array<char> bdd_feasibility(ITERATOR sol_begin, ITERATOR sol_end);
             void fix_variable(const size_t var, const bool value);
             template<typename ITERATOR>
                 void fix_variables(ITERATOR zero_fixations_begin, ITERATOR zero_fixations_end, ITERATOR one_fixations_begin, ITERATOR one_fixations_end);
 
             void tighten();
+
+            // low and high costs of all bdd branch nodes in internal order, for checkpointing the dual state
+            std::vector<std::array<double,2>> node_costs() const;
+            void set_node_costs(const std::vector<std::array<double,2>>& costs);
+
+            // accumulate min-marginal differences contention-free through per-BDD slots instead of atomic operations
+            void set_atomic_free_delta_aggregation(const bool atomic_free);
+            // make iterations independent of number of threads
+            void set_deterministic(const bool deterministic);
         private:
 
             class impl;
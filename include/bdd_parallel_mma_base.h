@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <array>
+#include <numeric>
 #include <Eigen/SparseCore>
 #include "bdd_collection/bdd_collection.h"
 #include "two_dimensional_variable_array.hxx"
@@ -25,13 +26,20 @@ namespace LPMP {
             bdd_parallel_mma_base(const BDD::bdd_collection& bdd_col) { add_bdds(bdd_col); }
 
             void add_bdds(const BDD::bdd_collection& bdd_col);
+            // remove BDDs in place, remaining BDDs keep their costs and their relative order.
+            // Costs of removed BDDs are averaged onto the remaining BDDs covering the same variables, for variables not covered anymore the cheaper cost enters the constant.
+            template<typename ITERATOR>
+                void remove_bdds(ITERATOR bdd_nr_begin, ITERATOR bdd_nr_end);
 
             size_t nr_bdds() const;
             size_t nr_bdds(const size_t var) const;
             size_t nr_variables() const;
             size_t nr_variables(const size_t bdd_nr) const;
             size_t variable(const size_t bdd_nr, const size_t bdd_index) const;
+            std::vector<size_t> variables(const size_t bdd_nr) const;
             size_t nr_bdd_variables() const;
+            // simplex BDDs (exactly one variable is true) are handled by specialized kernels in forward_mm/backward_mm
+            size_t nr_simplex_bdds() const;
 
             double lower_bound();
             using vector_type = Eigen::Matrix<typename BDD_BRANCH_NODE::value_type, Eigen::Dynamic, 1>;
@@ -45,6 +53,9 @@ namespace LPMP {
             using min_marginal_type = Eigen::Matrix<typename BDD_BRANCH_NODE::value_type, Eigen::Dynamic, 2>;
             std::tuple<min_marginal_type, std::vector<char>> min_marginals_stacked();
             std::tuple<std::vector<value_type>, std::vector<value_type>> min_marginals_vec(); // returns primal variables, lo mms, hi mms
+            // for each variable and each BDD covering it whether the BDD accepts the given solution. Entries of a BDD are either all true or all false.
+            template<typename ITERATOR>
+                two_dim_variable_array<char> bdd_feasibility(ITERATOR sol_begin, ITERATOR sol_end) const;
 
             template<typename COST_ITERATOR>
                 void update_costs(COST_ITERATOR cost_lo_begin, COST_ITERATOR cost_lo_end, COST_ITERATOR cost_hi_begin, COST_ITERATOR cost_hi_end);
@@ -52,6 +63,16 @@ namespace LPMP {
             void update_costs(const two_dim_variable_array<std::array<value_type,2>>& delta);
             void update_costs(const min_marginal_type& delta);
             vector_type get_costs();
+            // costs of low and high arcs of a single BDD, one entry per BDD variable
+            std::vector<std::array<value_type,2>> get_costs(const size_t bdd_nr) const;
+            template<typename COST_ITERATOR>
+                void update_costs(const size_t bdd_nr, COST_ITERATOR cost_begin, COST_ITERATOR cost_end);
+            // low and high costs of all bdd branch nodes in bdd order with pending deltas included, i.e. the complete dual state apart from the constant
+            std::vector<std::array<value_type,2>> node_costs() const;
+            template<typename ITERATOR>
+                void set_node_costs(ITERATOR begin, ITERATOR end);
+            // append BDD to bdd_col, returns its bdd number in bdd_col
+            size_t export_bdd(BDD::bdd_collection& bdd_col, const size_t bdd_nr) const;
             void update_costs(const vector_type& delta);
             void add_to_constant(const double c);
             /////////////////////////
@@ -72,6 +93,16 @@ namespace LPMP {
             double backward_mm(const value_type omega, std::vector<std::array<value_type,2>>& delta);
             void distribute_delta();
 
+            // how min-marginal differences of individual BDDs are accumulated into per-variable deltas in forward_mm/backward_mm:
+            // atomic: every BDD adds its contribution directly into the shared delta vector with atomic operations.
+            // gather: every BDD writes into its own slot, slots are afterwards summed up per variable in fixed order. Contention-free and bitwise deterministic.
+            enum class delta_aggregation { atomic, gather };
+            void set_delta_aggregation(const delta_aggregation a) { delta_aggregation_ = a; }
+            delta_aggregation get_delta_aggregation() const { return delta_aggregation_; }
+            // results of iterations do not depend on number of threads and scheduling: deltas are gathered and lower bounds of BDDs are summed up in fixed order
+            void set_deterministic(const bool deterministic) { deterministic_ = deterministic; }
+            bool deterministic() const { return deterministic_; }
+
             // Both operations below are inverses of each other
             // Given elements in order bdd_nr/bdd_index, transpose to variable/bdd_index with same variable.
             template<typename T>
@@ -123,6 +154,25 @@ namespace LPMP {
             std::array<size_t,2> bdd_range(const size_t bdd_nr) const;
             std::array<size_t,2> bdd_index_range(const size_t bdd_nr, const size_t bdd_idx) const;
 
+            template<typename DELTA_OUT_FUNC>
+                void forward_mm_impl(const size_t bdd_nr, const value_type omega, DELTA_OUT_FUNC delta_out_func, const std::vector<std::array<value_type,2>>& delta_in);
+            template<typename DELTA_OUT_FUNC>
+                value_type backward_mm_impl(const size_t bdd_nr, const value_type omega, DELTA_OUT_FUNC delta_out_func, const std::vector<std::array<value_type,2>>& delta_in);
+            bool gather_deltas() const { return deterministic_ || delta_aggregation_ == delta_aggregation::gather; }
+            void init_gather_plan();
+            void gather_delta(std::vector<std::array<value_type,2>>& delta_out) const;
+            // adds the delta of one bdd to delta_out when bdds write their deltas concurrently into it. Infinite deltas are stored, not added.
+            static void atomic_add_delta(std::vector<std::array<value_type,2>>& delta_out, const size_t var, const std::array<value_type,2> d);
+
+            // a simplex BDD consists of the root followed by two nodes per subsequent variable: the node reached when all previous variables are zero and the node reached when one of them was one.
+            bool is_simplex_bdd(const size_t bdd_nr) const;
+            template<typename DELTA_OUT_FUNC>
+                void simplex_forward_mm(const size_t bdd_nr, const value_type omega, DELTA_OUT_FUNC delta_out_func, const std::vector<std::array<value_type,2>>& delta_in);
+            template<typename DELTA_OUT_FUNC>
+                value_type simplex_backward_mm(const size_t bdd_nr, const value_type omega, DELTA_OUT_FUNC delta_out_func, const std::vector<std::array<value_type,2>>& delta_in);
+            static std::array<value_type,2> min_marginal_delta(const std::array<value_type,2> cur_mm, const value_type omega);
+            static void update_node_costs(BDD_BRANCH_NODE& node, const std::array<value_type,2> cur_mm, const value_type omega, const std::array<value_type,2> delta_in);
+
             std::vector<BDD_BRANCH_NODE> bdd_branch_nodes_;
 
             // holds ranges of bdd branch instructions of specific bdd with specific variable
@@ -136,6 +186,17 @@ namespace LPMP {
             // for parallel mma
             std::vector<std::array<value_type,2>> delta_out_;
             std::vector<std::array<value_type,2>> delta_in_;
+
+            // for gather delta aggregation
+            delta_aggregation delta_aggregation_ = delta_aggregation::atomic;
+            std::vector<size_t> bdd_slot_offsets_; // first slot of each bdd, slots are numbered consecutively by bdd_nr/bdd_index
+            two_dim_variable_array<size_t> variable_slots_; // slots holding the deltas of each variable, in increasing bdd_nr order
+            std::vector<std::array<value_type,2>> slot_delta_;
+
+            bool deterministic_ = false;
+            std::vector<value_type> lb_per_bdd_;
+
+            std::vector<char> simplex_bdd_;
         };
 
     ////////////////////
@@ -178,37 +239,69 @@ namespace LPMP {
                 return bdd_variables_(bdd_nr, bdd_index).variable; 
             }
 
+    template<typename BDD_BRANCH_NODE>
+        std::vector<size_t> bdd_parallel_mma_base<BDD_BRANCH_NODE>::variables(const size_t bdd_nr) const
+        {
+            assert(bdd_nr < nr_bdds());
+            std::vector<size_t> vars;
+            vars.reserve(nr_variables(bdd_nr));
+            for(size_t bdd_idx=0; bdd_idx<nr_variables(bdd_nr); ++bdd_idx)
+                vars.push_back(variable(bdd_nr, bdd_idx));
+            return vars;
+        }
+
     template<typename BDD_BRANCH_NODE>
         size_t bdd_parallel_mma_base<BDD_BRANCH_NODE>::nr_bdd_variables() const
         {
             return std::accumulate(nr_bdds_per_variable_.begin(), nr_bdds_per_variable_.end(), 0); 
         }
 
+    template<typename BDD_BRANCH_NODE>
+        size_t bdd_parallel_mma_base<BDD_BRANCH_NODE>::nr_simplex_bdds() const
+        {
+            return std::count(simplex_bdd_.begin(), simplex_bdd_.end(), 1);
+        }
+
     template<typename BDD_BRANCH_NODE>
         void bdd_parallel_mma_base<BDD_BRANCH_NODE>::add_bdds(const BDD::bdd_collection& bdd_col)
         {
             message_passing_state_ = message_passing_state::none;
-            assert(bdd_branch_nodes_.size() == 0); // currently does not support incremental addition of BDDs
-            bdd_log << "[bdd parallel mma base] # bdds = " << bdd_col.nr_bdds() << "\n";
-            bdd_branch_nodes_.clear();
+            lower_bound_state_ = lower_bound_state::invalid;
+            // BDDs are appended to already present ones. Pending deltas are averaged w.r.t. the current number of BDDs per variable, hence distribute them first.
+            if(delta_in_.size() > 0)
+                distribute_delta();
+            const size_t nr_prev_bdds = bdd_variables_.size() > 0 ? nr_bdds() : 0;
+            if(nr_prev_bdds > 0)
+                bdd_log << "[bdd parallel mma base] add " << bdd_col.nr_bdds() << " bdds to " << nr_prev_bdds << " present ones\n";
+            else
+                bdd_log << "[bdd parallel mma base] # bdds = " << bdd_col.nr_bdds() << "\n";
             const size_t total_nr_bdd_nodes = [&]() {
-                size_t i=0;
+                size_t i=bdd_branch_nodes_.size();
                 for(size_t bdd_nr=0; bdd_nr<bdd_col.nr_bdds(); ++bdd_nr)
                     i += bdd_col.nr_bdd_nodes(bdd_nr)-2; // do not count terminal nodes
                 return i;
             }();
             bdd_log << "[bdd parallel mma base] # total bdd nodes = " << total_nr_bdd_nodes << "\n";
-            bdd_branch_nodes_.reserve(total_nr_bdd_nodes);
-            bdd_variables_.clear();
-            nr_bdds_per_variable_.clear();
+            // leave slack when adding to present BDDs so that repeated additions do not copy all nodes each time
+            if(total_nr_bdd_nodes > bdd_branch_nodes_.capacity())
+                bdd_branch_nodes_.reserve(nr_prev_bdds > 0 ? std::max(total_nr_bdd_nodes, bdd_branch_nodes_.capacity() + bdd_branch_nodes_.capacity()/2) : total_nr_bdd_nodes);
+            if(nr_prev_bdds > 0)
+                bdd_variables_.pop_back(); // extra delimiter at the end is added again below
+            bdd_slot_offsets_.clear();
+            variable_slots_.clear();
+            slot_delta_.clear();
             const size_t nr_vars = [&]() {
-                size_t max_v=0;
+                size_t max_v=nr_bdds_per_variable_.size();
                 for(size_t bdd_nr=0; bdd_nr<bdd_col.nr_bdds(); ++bdd_nr)
                     max_v = std::max(max_v, bdd_col.min_max_variables(bdd_nr)[1]+1);
                 return max_v;
             }();
             bdd_log << "[bdd parallel mma base] # vars = " << nr_vars << "\n";
             nr_bdds_per_variable_.resize(nr_vars, 0);
+            if(delta_in_.size() > 0)
+                delta_in_.resize(nr_vars, {0.0, 0.0});
+            if(delta_out_.size() > 0)
+                delta_out_.resize(nr_vars, {0.0, 0.0});
 
             for(size_t bdd_nr=0; bdd_nr<bdd_col.nr_bdds(); ++bdd_nr)
             {
@@ -224,7 +317,8 @@ namespace LPMP {
                 cur_bdd_variables.push_back({bdd_branch_nodes_.size(), bdd_col.root_variable(bdd_nr)});
                 for(auto bdd_it=bdd_col.cbegin(bdd_nr); bdd_it!=bdd_col.cend(bdd_nr); ++bdd_it)
                 {
-                    const BDD::bdd_instruction& stored_bdd = *bdd_it;
+                    const BDD::bdd_instruction stored_bdd = *bdd_it;
+                    const size_t stored_bdd_offset = bdd_col.offset(bdd_it);
                     assert(!stored_bdd.is_terminal());
                     BDD_BRANCH_NODE bdd;
 
@@ -234,8 +328,8 @@ namespace LPMP {
                         bdd.offset_low = BDD_BRANCH_NODE::terminal_1_offset;
                     else
                     {
-                        assert(bdd_col.offset(stored_bdd) < stored_bdd.lo);
-                        bdd.offset_low = stored_bdd.lo - bdd_col.offset(stored_bdd);
+                        assert(stored_bdd_offset < stored_bdd.lo);
+                        bdd.offset_low = stored_bdd.lo - stored_bdd_offset;
                     }
 
                     if(bdd_col.get_bdd_instruction(stored_bdd.hi).is_botsink()) 
@@ -244,8 +338,8 @@ namespace LPMP {
                         bdd.offset_high = BDD_BRANCH_NODE::terminal_1_offset;
                     else
                     {
-                        assert(bdd_col.offset(stored_bdd) < stored_bdd.hi);
-                        bdd.offset_high = stored_bdd.hi - bdd_col.offset(stored_bdd);
+                        assert(stored_bdd_offset < stored_bdd.hi);
+                        bdd.offset_high = stored_bdd.hi - stored_bdd_offset;
                     }
 
                     if(bdd.offset_low == BDD_BRANCH_NODE::terminal_0_offset)
@@ -264,7 +358,7 @@ namespace LPMP {
                 // assert(cur_bdd_variables.back().variable == bdd_col.min_max_variables(bdd_nr)[1]); // need not hold true, we accept differently ordered BDDs.
                 cur_bdd_variables.push_back({bdd_branch_nodes_.size(), std::numeric_limits<size_t>::max()}); // For extra delimiter at the end
                 bdd_variables_.push_back(cur_bdd_variables.begin(), cur_bdd_variables.end());
-                assert(bdd_variables_.size(bdd_nr) == bdd_col.variables(bdd_nr).size()+1);
+                assert(bdd_variables_.size(nr_prev_bdds + bdd_nr) == bdd_col.variables(bdd_nr).size()+1);
 
                 for(const auto [offset, v] : cur_bdd_variables)
                 {
@@ -279,6 +373,129 @@ namespace LPMP {
             std::vector<bdd_variable> tmp_bdd_variables;
             tmp_bdd_variables.push_back({bdd_branch_nodes_.size(), std::numeric_limits<size_t>::max()});
             bdd_variables_.push_back(tmp_bdd_variables.begin(), tmp_bdd_variables.end());
+
+            simplex_bdd_.resize(nr_bdds());
+            for(size_t bdd_nr=nr_prev_bdds; bdd_nr<nr_bdds(); ++bdd_nr)
+                simplex_bdd_[bdd_nr] = is_simplex_bdd(bdd_nr);
+            bdd_log << "[bdd parallel mma base] # simplex bdds = " << nr_simplex_bdds() << "\n";
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename ITERATOR>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::remove_bdds(ITERATOR bdd_nr_begin, ITERATOR bdd_nr_end)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            message_passing_state_ = message_passing_state::none;
+            lower_bound_state_ = lower_bound_state::invalid;
+            if(delta_in_.size() > 0)
+                distribute_delta();
+            else
+                delta_in_.resize(nr_variables(), {0.0, 0.0});
+
+            std::vector<char> remove(nr_bdds(), false);
+            for(auto it=bdd_nr_begin; it!=bdd_nr_end; ++it)
+            {
+                assert(*it < nr_bdds());
+                remove[*it] = true;
+            }
+            const size_t nr_remove = std::count(remove.begin(), remove.end(), true);
+            if(nr_remove == 0)
+                return;
+            bdd_log << "[bdd parallel mma base] remove " << nr_remove << " of " << nr_bdds() << " bdds\n";
+
+            // collect costs of removed BDDs
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+            {
+                if(!remove[bdd_nr])
+                    continue;
+                const auto costs = get_costs(bdd_nr);
+                for(size_t idx=0; idx<nr_variables(bdd_nr); ++idx)
+                {
+                    const size_t var = variable(bdd_nr, idx);
+                    delta_in_[var][0] += costs[idx][0];
+                    delta_in_[var][1] += costs[idx][1];
+                    assert(nr_bdds_per_variable_[var] > 0);
+                    nr_bdds_per_variable_[var]--;
+                }
+            }
+
+            // move nodes of remaining BDDs to the front, node offsets are relative and stay valid
+            two_dim_variable_array<bdd_variable> new_bdd_variables;
+            std::vector<char> new_simplex_bdd;
+            new_simplex_bdd.reserve(nr_bdds() - nr_remove);
+            size_t nr_nodes = 0;
+            std::vector<bdd_variable> cur_bdd_variables;
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+            {
+                if(remove[bdd_nr])
+                    continue;
+                const auto [first, last] = bdd_range(bdd_nr);
+                cur_bdd_variables.clear();
+                for(size_t idx=0; idx<bdd_variables_.size(bdd_nr); ++idx)
+                    cur_bdd_variables.push_back({bdd_variables_(bdd_nr, idx).offset - first + nr_nodes, bdd_variables_(bdd_nr, idx).variable});
+                new_bdd_variables.push_back(cur_bdd_variables.begin(), cur_bdd_variables.end());
+                new_simplex_bdd.push_back(simplex_bdd_[bdd_nr]);
+                if(first != nr_nodes)
+                    std::copy(bdd_branch_nodes_.begin() + first, bdd_branch_nodes_.begin() + last, bdd_branch_nodes_.begin() + nr_nodes);
+                nr_nodes += last - first;
+            }
+            bdd_branch_nodes_.resize(nr_nodes); // capacity is kept for subsequent additions
+            cur_bdd_variables = {{nr_nodes, std::numeric_limits<size_t>::max()}};
+            new_bdd_variables.push_back(cur_bdd_variables.begin(), cur_bdd_variables.end());
+            std::swap(bdd_variables_, new_bdd_variables);
+            std::swap(simplex_bdd_, new_simplex_bdd);
+
+            bdd_slot_offsets_.clear();
+            variable_slots_.clear();
+            slot_delta_.clear();
+            lb_per_bdd_.clear();
+
+            // hand costs of removed BDDs over to remaining ones
+            for(size_t var=0; var<nr_variables(); ++var)
+            {
+                if(nr_bdds(var) > 0)
+                {
+                    delta_in_[var][0] /= value_type(nr_bdds(var));
+                    delta_in_[var][1] /= value_type(nr_bdds(var));
+                }
+                else
+                {
+                    constant_ += std::min(delta_in_[var][0], delta_in_[var][1]);
+                    delta_in_[var] = {0.0, 0.0};
+                }
+            }
+            distribute_delta();
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        bool bdd_parallel_mma_base<BDD_BRANCH_NODE>::is_simplex_bdd(const size_t bdd_nr) const
+        {
+            const size_t n = nr_variables(bdd_nr);
+            if(n < 2)
+                return false;
+            const size_t first = bdd_range(bdd_nr)[0];
+            for(size_t i=0; i<n; ++i)
+            {
+                const auto [first_bdd_node, last_bdd_node] = bdd_index_range(bdd_nr, i);
+                if(first_bdd_node != (i == 0 ? first : first + 2*i - 1) || last_bdd_node != first + 2*i + 1)
+                    return false;
+            }
+
+            constexpr auto terminal_0 = BDD_BRANCH_NODE::terminal_0_offset;
+            constexpr auto terminal_1 = BDD_BRANCH_NODE::terminal_1_offset;
+            const BDD_BRANCH_NODE* nodes = bdd_branch_nodes_.data() + first;
+            if(nodes[0].offset_low != 1 || nodes[0].offset_high != 2)
+                return false;
+            for(size_t i=1; i+1<n; ++i)
+            {
+                const BDD_BRANCH_NODE& zero_node = nodes[2*i-1];
+                const BDD_BRANCH_NODE& one_node = nodes[2*i];
+                if(zero_node.offset_low != 2 || zero_node.offset_high != 3 || one_node.offset_low != 2 || one_node.offset_high != terminal_0)
+                    return false;
+            }
+            const BDD_BRANCH_NODE& zero_node = nodes[2*n-3];
+            const BDD_BRANCH_NODE& one_node = nodes[2*n-2];
+            return zero_node.offset_low == terminal_0 && zero_node.offset_high == terminal_1 && one_node.offset_low == terminal_1 && one_node.offset_high == terminal_0;
         }
 
     template<typename BDD_BRANCH_NODE>
@@ -491,7 +708,7 @@ namespace LPMP {
                 nr_bdd_variables.push_back(nr_variables(bdd_nr));
             two_dim_variable_array<std::array<double,2>> min_margs(nr_bdd_variables);
 
-//#pragma omp parallel for schedule(guided,128)
+#pragma omp parallel for schedule(guided,128)
             for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
             {
                 // intialize
@@ -524,6 +741,47 @@ namespace LPMP {
 
             return transpose_to_var_order(min_margs);
         }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename ITERATOR>
+        two_dim_variable_array<char> bdd_parallel_mma_base<BDD_BRANCH_NODE>::bdd_feasibility(ITERATOR sol_begin, ITERATOR sol_end) const
+        {
+            assert(std::distance(sol_begin, sol_end) == nr_variables());
+            std::vector<size_t> nr_bdd_variables;
+            nr_bdd_variables.reserve(nr_bdds());
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                nr_bdd_variables.push_back(nr_variables(bdd_nr));
+            two_dim_variable_array<char> bdd_feas(nr_bdd_variables);
+
+#pragma omp parallel for schedule(guided,128)
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+            {
+                // follow the path of the solution from the root until a terminal is reached
+                size_t i = bdd_index_range(bdd_nr, 0)[0];
+                bool feasible = false;
+                for(size_t idx=0; idx<nr_variables(bdd_nr); ++idx)
+                {
+                    assert(i >= bdd_index_range(bdd_nr, idx)[0] && i < bdd_index_range(bdd_nr, idx)[1]);
+                    const auto& bdd = bdd_branch_nodes_[i];
+                    const char x = sol_begin[variable(bdd_nr, idx)];
+                    assert(x == 0 || x == 1);
+                    const auto offset = x ? bdd.offset_high : bdd.offset_low;
+                    if(offset == BDD_BRANCH_NODE::terminal_0_offset)
+                        break;
+                    if(offset == BDD_BRANCH_NODE::terminal_1_offset)
+                    {
+                        assert(idx+1 == nr_variables(bdd_nr));
+                        feasible = true;
+                        break;
+                    }
+                    i = std::distance(&bdd_branch_nodes_[0], bdd.address(offset));
+                }
+                for(size_t idx=0; idx<nr_variables(bdd_nr); ++idx)
+                    bdd_feas(bdd_nr, idx) = feasible;
+            }
+
+            return transpose_to_var_order(bdd_feas);
+        }
     
     template<typename BDD_BRANCH_NODE>
         std::tuple<typename bdd_parallel_mma_base<BDD_BRANCH_NODE>::min_marginal_type, std::vector<char>> bdd_parallel_mma_base<BDD_BRANCH_NODE>::min_marginals_stacked()
@@ -729,6 +987,135 @@ namespace LPMP {
             return costs;
         }
 
+    template<typename BDD_BRANCH_NODE>
+        std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>> bdd_parallel_mma_base<BDD_BRANCH_NODE>::node_costs() const
+        {
+            std::vector<std::array<value_type,2>> costs(bdd_branch_nodes_.size());
+#pragma omp parallel for schedule(guided,128)
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+            {
+                for(size_t bdd_idx=0; bdd_idx<nr_variables(bdd_nr); ++bdd_idx)
+                {
+                    const auto [first_bdd_node, last_bdd_node] = bdd_index_range(bdd_nr, bdd_idx);
+                    const size_t var = variable(bdd_nr, bdd_idx);
+                    const std::array<value_type,2> delta = delta_in_.size() > 0 ? delta_in_[var] : std::array<value_type,2>{0.0, 0.0};
+                    for(size_t i=first_bdd_node; i<last_bdd_node; ++i)
+                        costs[i] = {bdd_branch_nodes_[i].low_cost + delta[0], bdd_branch_nodes_[i].high_cost + delta[1]};
+                }
+            }
+            return costs;
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename ITERATOR>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::set_node_costs(ITERATOR begin, ITERATOR end)
+        {
+            if(std::distance(begin, end) != bdd_branch_nodes_.size())
+                throw std::runtime_error("number of node costs does not match number of bdd branch nodes");
+
+            message_passing_state_ = message_passing_state::none;
+            lower_bound_state_ = lower_bound_state::invalid;
+
+            auto it = begin;
+            for(auto& bdd : bdd_branch_nodes_)
+            {
+                bdd.low_cost = (*it)[0];
+                bdd.high_cost = (*it)[1];
+                ++it;
+            }
+            const std::array<value_type,2> zeros = {0.0, 0.0};
+            std::fill(delta_in_.begin(), delta_in_.end(), zeros);
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>> bdd_parallel_mma_base<BDD_BRANCH_NODE>::get_costs(const size_t bdd_nr) const
+        {
+            assert(bdd_nr < nr_bdds());
+            std::vector<std::array<value_type,2>> costs(nr_variables(bdd_nr), {0.0, 0.0});
+            for(size_t idx=0; idx<nr_variables(bdd_nr); ++idx)
+            {
+                // all arcs of one variable that do not point to the 0-terminal carry the same cost
+                const auto [first,last] = bdd_index_range(bdd_nr, idx);
+                for(size_t i=first; i<last; ++i)
+                    if(bdd_branch_nodes_[i].offset_low != BDD_BRANCH_NODE::terminal_0_offset)
+                    {
+                        costs[idx][0] = bdd_branch_nodes_[i].low_cost;
+                        break;
+                    }
+                for(size_t i=first; i<last; ++i)
+                    if(bdd_branch_nodes_[i].offset_high != BDD_BRANCH_NODE::terminal_0_offset)
+                    {
+                        costs[idx][1] = bdd_branch_nodes_[i].high_cost;
+                        break;
+                    }
+            }
+            return costs;
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename COST_ITERATOR>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::update_costs(const size_t bdd_nr, COST_ITERATOR cost_begin, COST_ITERATOR cost_end)
+        {
+            assert(bdd_nr < nr_bdds());
+            assert(std::distance(cost_begin, cost_end) == nr_variables(bdd_nr));
+            message_passing_state_ = message_passing_state::none;
+            lower_bound_state_ = lower_bound_state::invalid;
+
+            for(size_t idx=0; idx<nr_variables(bdd_nr); ++idx)
+            {
+                const std::array<value_type,2> c = {value_type((*(cost_begin+idx))[0]), value_type((*(cost_begin+idx))[1])};
+                assert(std::isfinite(c[0]) && std::isfinite(c[1]));
+                const auto [first,last] = bdd_index_range(bdd_nr, idx);
+                for(size_t i=first; i<last; ++i)
+                {
+                    if(bdd_branch_nodes_[i].offset_low != BDD_BRANCH_NODE::terminal_0_offset)
+                        bdd_branch_nodes_[i].low_cost += c[0];
+                    if(bdd_branch_nodes_[i].offset_high != BDD_BRANCH_NODE::terminal_0_offset)
+                        bdd_branch_nodes_[i].high_cost += c[1];
+                }
+            }
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        size_t bdd_parallel_mma_base<BDD_BRANCH_NODE>::export_bdd(BDD::bdd_collection& bdd_col, const size_t bdd_nr) const
+        {
+            assert(bdd_nr < nr_bdds());
+            const size_t new_bdd_nr = bdd_col.new_bdd();
+            const auto [first, last] = bdd_range(bdd_nr);
+            std::vector<BDD::bdd_collection_node> nodes;
+            nodes.reserve(last - first);
+            for(size_t idx=0; idx<nr_variables(bdd_nr); ++idx)
+            {
+                const auto [first_node, last_node] = bdd_index_range(bdd_nr, idx);
+                for(size_t i=first_node; i<last_node; ++i)
+                    nodes.push_back(bdd_col.add_bdd_node(variable(bdd_nr, idx)));
+            }
+            assert(nodes.size() == last - first);
+
+            // arcs are stored as offsets relative to the branch node
+            for(size_t i=first; i<last; ++i)
+            {
+                const BDD_BRANCH_NODE& bdd = bdd_branch_nodes_[i];
+                BDD::bdd_collection_node& node = nodes[i - first];
+                if(bdd.offset_low == BDD_BRANCH_NODE::terminal_0_offset)
+                    node.set_lo_to_0_terminal();
+                else if(bdd.offset_low == BDD_BRANCH_NODE::terminal_1_offset)
+                    node.set_lo_to_1_terminal();
+                else
+                    node.set_lo_arc(nodes[i - first + bdd.offset_low]);
+
+                if(bdd.offset_high == BDD_BRANCH_NODE::terminal_0_offset)
+                    node.set_hi_to_0_terminal();
+                else if(bdd.offset_high == BDD_BRANCH_NODE::terminal_1_offset)
+                    node.set_hi_to_1_terminal();
+                else
+                    node.set_hi_arc(nodes[i - first + bdd.offset_high]);
+            }
+
+            bdd_col.close_bdd();
+            return new_bdd_nr;
+        }
+
     template<typename BDD_BRANCH_NODE>
         template<typename COST_ITERATOR> 
         void bdd_parallel_mma_base<BDD_BRANCH_NODE>::update_costs(COST_ITERATOR cost_lo_begin, COST_ITERATOR cost_lo_end, COST_ITERATOR cost_hi_begin, COST_ITERATOR cost_hi_end)
@@ -805,7 +1192,8 @@ namespace LPMP {
         void bdd_parallel_mma_base<BDD_BRANCH_NODE>::update_costs(const two_dim_variable_array<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta)
         {
             message_passing_state_ = message_passing_state::none;
-            assert(delta.size() == nr_bdds());
+            lower_bound_state_ = lower_bound_state::invalid;
+            assert(delta.size() == nr_variables());
             const auto delta_t = transpose_to_bdd_order(delta);
 #pragma omp parallel for schedule(static,512)
             for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
@@ -826,6 +1214,7 @@ namespace LPMP {
         void bdd_parallel_mma_base<BDD_BRANCH_NODE>::update_costs(const min_marginal_type& delta)
         {
             message_passing_state_ = message_passing_state::none;
+            lower_bound_state_ = lower_bound_state::invalid;
             assert(delta.rows() == nr_bdd_variables());
             assert(delta.cols() == 2);
 //#pragma omp parallel for schedule(guided,128)
@@ -848,6 +1237,7 @@ namespace LPMP {
         void bdd_parallel_mma_base<BDD_BRANCH_NODE>::update_costs(const vector_type& delta)
         {
             message_passing_state_ = message_passing_state::none;
+            lower_bound_state_ = lower_bound_state::invalid;
             assert(delta.rows() == nr_bdd_variables());
             assert(delta.cols() == 1);
 //#pragma omp parallel for schedule(guided,128)
@@ -959,12 +1349,28 @@ namespace LPMP {
                 std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_out,
                 std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_in)
         {
-            backward_run();
             assert(delta_out.size() == nr_variables());
+            auto atomic_delta_out = [&](size_t, size_t, const size_t var, const std::array<value_type,2> d) {
+                atomic_add_delta(delta_out, var, d);
+            };
+            forward_mm_impl(bdd_nr, omega, atomic_delta_out, delta_in);
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename DELTA_OUT_FUNC>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::forward_mm_impl(
+                const size_t bdd_nr, const typename BDD_BRANCH_NODE::value_type omega,
+                DELTA_OUT_FUNC delta_out_func,
+                const std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_in)
+        {
+            backward_run();
             assert(delta_in.size() == nr_variables());
             assert(omega > 0.0 && omega <= 1.0);
             assert(bdd_nr < nr_bdds());
 
+            if(simplex_bdd_[bdd_nr])
+                return simplex_forward_mm(bdd_nr, omega, delta_out_func, delta_in);
+
             {
                 const auto [first_bdd_node, last_bdd_node] = bdd_index_range(bdd_nr, 0);
                 assert(first_bdd_node + 1 == last_bdd_node);
@@ -983,20 +1389,19 @@ namespace LPMP {
                     cur_mm[1] = std::min(bdd_mm[1], cur_mm[1]);
                 }
 
+                std::array<value_type,2> d = {0.0, 0.0};
                 if(!std::isfinite(cur_mm[0]))
-                    atomic_store(delta_out[var][0], std::numeric_limits<value_type>::infinity());
+                    d[0] = std::numeric_limits<value_type>::infinity();
                 if(!std::isfinite(cur_mm[1]))
-                    atomic_store(delta_out[var][1], std::numeric_limits<value_type>::infinity());
+                    d[1] = std::numeric_limits<value_type>::infinity();
                 if(std::isfinite(cur_mm[0]) && std::isfinite(cur_mm[1]))
                 {
                     if(cur_mm[0] < cur_mm[1])
-                        atomic_add(delta_out[var][1], omega*(cur_mm[1] - cur_mm[0]));
+                        d[1] = omega*(cur_mm[1] - cur_mm[0]);
                     else
-                        atomic_add(delta_out[var][0], omega*(cur_mm[0] - cur_mm[1]));
+                        d[0] = omega*(cur_mm[0] - cur_mm[1]);
                 }
-
-                assert(delta_out[var][0] >= 0.0);
-                assert(delta_out[var][1] >= 0.0);
+                delta_out_func(bdd_nr, bdd_idx, var, d);
 
                 for(size_t i=first_bdd_node; i<last_bdd_node; ++i)
                 {
@@ -1035,10 +1440,24 @@ namespace LPMP {
         bdd_parallel_mma_base<BDD_BRANCH_NODE>::backward_mm(const size_t bdd_nr, const typename BDD_BRANCH_NODE::value_type omega, std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_out, std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_in)
         {
             assert(delta_out.size() == nr_variables());
+            auto atomic_delta_out = [&](size_t, size_t, const size_t var, const std::array<value_type,2> d) {
+                atomic_add_delta(delta_out, var, d);
+            };
+            return backward_mm_impl(bdd_nr, omega, atomic_delta_out, delta_in);
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename DELTA_OUT_FUNC>
+        typename BDD_BRANCH_NODE::value_type 
+        bdd_parallel_mma_base<BDD_BRANCH_NODE>::backward_mm_impl(const size_t bdd_nr, const typename BDD_BRANCH_NODE::value_type omega, DELTA_OUT_FUNC delta_out_func, const std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_in)
+        {
             assert(delta_in.size() == nr_variables());
             assert(omega > 0.0 && omega <= 1.0);
             assert(bdd_nr < nr_bdds());
 
+            if(simplex_bdd_[bdd_nr])
+                return simplex_backward_mm(bdd_nr, omega, delta_out_func, delta_in);
+
             for(std::ptrdiff_t bdd_idx=nr_variables(bdd_nr)-1; bdd_idx>=0; --bdd_idx)
             {
                 const auto [first_bdd_node, last_bdd_node] = bdd_index_range(bdd_nr, bdd_idx);
@@ -1052,20 +1471,19 @@ namespace LPMP {
                     cur_mm[1] = std::min(bdd_mm[1], cur_mm[1]);
                 }
 
+                std::array<value_type,2> d = {0.0, 0.0};
                 if(!std::isfinite(cur_mm[0]))
-                    atomic_store(delta_out[var][0], std::numeric_limits<value_type>::infinity());
+                    d[0] = std::numeric_limits<value_type>::infinity();
                 if(!std::isfinite(cur_mm[1]))
-                    atomic_store(delta_out[var][1], std::numeric_limits<value_type>::infinity());
+                    d[1] = std::numeric_limits<value_type>::infinity();
                 if(std::isfinite(cur_mm[0]) && std::isfinite(cur_mm[1]))
                 {
                     if(cur_mm[0] < cur_mm[1])
-                        atomic_add(delta_out[var][1], omega*(cur_mm[1] - cur_mm[0]));
+                        d[1] = omega*(cur_mm[1] - cur_mm[0]);
                     else
-                        atomic_add(delta_out[var][0], omega*(cur_mm[0] - cur_mm[1]));
+                        d[0] = omega*(cur_mm[0] - cur_mm[1]);
                 }
-
-                assert(delta_out[var][0] >= 0.0);
-                assert(delta_out[var][1] >= 0.0);
+                delta_out_func(bdd_nr, bdd_idx, var, d);
 
                 for(std::ptrdiff_t i=std::ptrdiff_t(last_bdd_node)-1; i>=std::ptrdiff_t(first_bdd_node); --i)
                 {
@@ -1097,6 +1515,218 @@ namespace LPMP {
             return bdd_branch_nodes_[root_bdd_node_begin].m;
         }
 
+    // The kernels below perform exactly the floating point operations of forward_mm_impl/backward_mm_impl in the same order, hence give identical results.
+    // Node positions are fixed, no offsets need to be decoded and no terminal checks are necessary.
+    // They unroll the two-state recursion instead of computing min-marginals from the two smallest cost differences:
+    // costs of a variable change before the next one is visited, so a closed form over the initial costs does not apply, and differences of infinite costs are undefined.
+    // Cardinality BDDs with k>1 and the sequential bdd_mma_base take the generic path.
+    template<typename BDD_BRANCH_NODE>
+        std::array<typename BDD_BRANCH_NODE::value_type,2> bdd_parallel_mma_base<BDD_BRANCH_NODE>::min_marginal_delta(const std::array<value_type,2> cur_mm, const value_type omega)
+        {
+            std::array<value_type,2> d = {0.0, 0.0};
+            if(!std::isfinite(cur_mm[0]))
+                d[0] = std::numeric_limits<value_type>::infinity();
+            if(!std::isfinite(cur_mm[1]))
+                d[1] = std::numeric_limits<value_type>::infinity();
+            if(std::isfinite(cur_mm[0]) && std::isfinite(cur_mm[1]))
+            {
+                if(cur_mm[0] < cur_mm[1])
+                    d[1] = omega*(cur_mm[1] - cur_mm[0]);
+                else
+                    d[0] = omega*(cur_mm[0] - cur_mm[1]);
+            }
+            return d;
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::update_node_costs(BDD_BRANCH_NODE& node, const std::array<value_type,2> cur_mm, const value_type omega, const std::array<value_type,2> delta_in)
+        {
+            if(!std::isfinite(cur_mm[0]))
+                node.low_cost = std::numeric_limits<value_type>::infinity();
+            if(!std::isfinite(cur_mm[1]))
+                node.high_cost = std::numeric_limits<value_type>::infinity();
+            if(std::isfinite(cur_mm[0]) && std::isfinite(cur_mm[1]))
+            {
+                if(cur_mm[0] < cur_mm[1])
+                    node.high_cost += omega*(cur_mm[0] - cur_mm[1]);
+                else
+                    node.low_cost += omega*(cur_mm[1] - cur_mm[0]);
+            }
+            node.low_cost += delta_in[0];
+            node.high_cost += delta_in[1];
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename DELTA_OUT_FUNC>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::simplex_forward_mm(const size_t bdd_nr, const value_type omega, DELTA_OUT_FUNC delta_out_func, const std::vector<std::array<value_type,2>>& delta_in)
+        {
+            assert(simplex_bdd_[bdd_nr]);
+            const size_t n = nr_variables(bdd_nr);
+            BDD_BRANCH_NODE* nodes = bdd_branch_nodes_.data() + bdd_range(bdd_nr)[0];
+
+            // root
+            {
+                BDD_BRANCH_NODE& root = nodes[0];
+                root.m = 0.0;
+                const size_t var = variable(bdd_nr, 0);
+                const std::array<value_type,2> cur_mm = {root.m + root.low_cost + nodes[1].m, root.m + root.high_cost + nodes[2].m};
+                delta_out_func(bdd_nr, 0, var, min_marginal_delta(cur_mm, omega));
+                update_node_costs(root, cur_mm, omega, delta_in[var]);
+                nodes[1].m = root.m + root.low_cost;
+                nodes[2].m = root.m + root.high_cost;
+            }
+
+            for(size_t i=1; i+1<n; ++i)
+            {
+                BDD_BRANCH_NODE& zero_node = nodes[2*i-1];
+                BDD_BRANCH_NODE& one_node = nodes[2*i];
+                const value_type next_zero_m = nodes[2*i+1].m;
+                const value_type next_one_m = nodes[2*i+2].m;
+                const size_t var = variable(bdd_nr, i);
+                const std::array<value_type,2> cur_mm = {
+                    std::min(one_node.m + one_node.low_cost + next_one_m, zero_node.m + zero_node.low_cost + next_zero_m),
+                    std::min(one_node.m + one_node.high_cost, zero_node.m + zero_node.high_cost + next_one_m)
+                };
+                delta_out_func(bdd_nr, i, var, min_marginal_delta(cur_mm, omega));
+                update_node_costs(zero_node, cur_mm, omega, delta_in[var]);
+                update_node_costs(one_node, cur_mm, omega, delta_in[var]);
+                nodes[2*i+1].m = zero_node.m + zero_node.low_cost;
+                nodes[2*i+2].m = std::min(zero_node.m + zero_node.high_cost, one_node.m + one_node.low_cost);
+            }
+
+            // last variable
+            {
+                BDD_BRANCH_NODE& zero_node = nodes[2*n-3];
+                BDD_BRANCH_NODE& one_node = nodes[2*n-2];
+                const size_t var = variable(bdd_nr, n-1);
+                const std::array<value_type,2> cur_mm = {
+                    std::min(one_node.m + one_node.low_cost, zero_node.m + zero_node.low_cost),
+                    std::min(one_node.m + one_node.high_cost, zero_node.m + zero_node.high_cost)
+                };
+                delta_out_func(bdd_nr, n-1, var, min_marginal_delta(cur_mm, omega));
+                update_node_costs(zero_node, cur_mm, omega, delta_in[var]);
+                update_node_costs(one_node, cur_mm, omega, delta_in[var]);
+            }
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        template<typename DELTA_OUT_FUNC>
+        typename BDD_BRANCH_NODE::value_type 
+        bdd_parallel_mma_base<BDD_BRANCH_NODE>::simplex_backward_mm(const size_t bdd_nr, const value_type omega, DELTA_OUT_FUNC delta_out_func, const std::vector<std::array<value_type,2>>& delta_in)
+        {
+            assert(simplex_bdd_[bdd_nr]);
+            const size_t n = nr_variables(bdd_nr);
+            BDD_BRANCH_NODE* nodes = bdd_branch_nodes_.data() + bdd_range(bdd_nr)[0];
+
+            // last variable
+            {
+                BDD_BRANCH_NODE& zero_node = nodes[2*n-3];
+                BDD_BRANCH_NODE& one_node = nodes[2*n-2];
+                const size_t var = variable(bdd_nr, n-1);
+                const std::array<value_type,2> cur_mm = {
+                    std::min(zero_node.m + zero_node.low_cost, one_node.m + one_node.low_cost),
+                    std::min(zero_node.m + zero_node.high_cost, one_node.m + one_node.high_cost)
+                };
+                delta_out_func(bdd_nr, n-1, var, min_marginal_delta(cur_mm, omega));
+                update_node_costs(zero_node, cur_mm, omega, delta_in[var]);
+                update_node_costs(one_node, cur_mm, omega, delta_in[var]);
+                one_node.m = std::min(one_node.low_cost, one_node.high_cost);
+                zero_node.m = std::min(zero_node.low_cost, zero_node.high_cost);
+            }
+
+            for(size_t i=n-2; i>0; --i)
+            {
+                BDD_BRANCH_NODE& zero_node = nodes[2*i-1];
+                BDD_BRANCH_NODE& one_node = nodes[2*i];
+                const value_type next_zero_m = nodes[2*i+1].m;
+                const value_type next_one_m = nodes[2*i+2].m;
+                const size_t var = variable(bdd_nr, i);
+                const std::array<value_type,2> cur_mm = {
+                    std::min(zero_node.m + zero_node.low_cost + next_zero_m, one_node.m + one_node.low_cost + next_one_m),
+                    std::min(zero_node.m + zero_node.high_cost + next_one_m, one_node.m + one_node.high_cost)
+                };
+                delta_out_func(bdd_nr, i, var, min_marginal_delta(cur_mm, omega));
+                update_node_costs(zero_node, cur_mm, omega, delta_in[var]);
+                update_node_costs(one_node, cur_mm, omega, delta_in[var]);
+                one_node.m = std::min(next_one_m + one_node.low_cost, one_node.high_cost);
+                zero_node.m = std::min(next_zero_m + zero_node.low_cost, next_one_m + zero_node.high_cost);
+            }
+
+            // root
+            BDD_BRANCH_NODE& root = nodes[0];
+            const size_t var = variable(bdd_nr, 0);
+            const std::array<value_type,2> cur_mm = {root.m + root.low_cost + nodes[1].m, root.m + root.high_cost + nodes[2].m};
+            delta_out_func(bdd_nr, 0, var, min_marginal_delta(cur_mm, omega));
+            update_node_costs(root, cur_mm, omega, delta_in[var]);
+            root.m = std::min(nodes[1].m + root.low_cost, nodes[2].m + root.high_cost);
+            return root.m;
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::init_gather_plan()
+        {
+            if(bdd_slot_offsets_.size() == nr_bdds()+1)
+                return;
+
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            bdd_slot_offsets_.clear();
+            bdd_slot_offsets_.reserve(nr_bdds()+1);
+            bdd_slot_offsets_.push_back(0);
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                bdd_slot_offsets_.push_back(bdd_slot_offsets_.back() + nr_variables(bdd_nr));
+
+            two_dim_variable_array<size_t> slots(nr_bdds_per_variable_);
+            std::vector<size_t> counter(nr_variables(), 0);
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+            {
+                for(size_t bdd_idx=0; bdd_idx<nr_variables(bdd_nr); ++bdd_idx)
+                {
+                    const size_t var = variable(bdd_nr, bdd_idx);
+                    slots(var, counter[var]++) = bdd_slot_offsets_[bdd_nr] + bdd_idx;
+                }
+            }
+            variable_slots_ = slots;
+
+            slot_delta_.resize(bdd_slot_offsets_.back(), {0.0, 0.0});
+            bdd_log << "[bdd parallel mma base] initialized gather plan with " << slot_delta_.size() << " slots\n";
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::gather_delta(std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_out) const
+        {
+            MEASURE_CUMULATIVE_FUNCTION_EXECUTION_TIME2("parallel mma gather delta");
+            assert(delta_out.size() == nr_variables());
+            assert(variable_slots_.size() == nr_variables());
+#pragma omp parallel for schedule(static,512)
+            for(size_t var=0; var<nr_variables(); ++var)
+            {
+                std::array<value_type,2> d = {0.0, 0.0};
+                for(const size_t slot : variable_slots_[var])
+                {
+                    d[0] += slot_delta_[slot][0];
+                    d[1] += slot_delta_[slot][1];
+                }
+                assert(d[0] >= 0.0 && d[1] >= 0.0);
+                delta_out[var] = d;
+            }
+        }
+
+    template<typename BDD_BRANCH_NODE>
+        void bdd_parallel_mma_base<BDD_BRANCH_NODE>::atomic_add_delta(std::vector<std::array<typename BDD_BRANCH_NODE::value_type,2>>& delta_out, const size_t var, const std::array<typename BDD_BRANCH_NODE::value_type,2> d)
+        {
+            if(!std::isfinite(d[0]))
+                atomic_store(delta_out[var][0], std::numeric_limits<value_type>::infinity());
+            else
+                atomic_add(delta_out[var][0], d[0]);
+            if(!std::isfinite(d[1]))
+                atomic_store(delta_out[var][1], std::numeric_limits<value_type>::infinity());
+            else
+                atomic_add(delta_out[var][1], d[1]);
+
+            assert(delta_out[var][0] >= 0.0);
+            assert(delta_out[var][1] >= 0.0);
+        }
+
     template<typename BDD_BRANCH_NODE>
         void bdd_parallel_mma_base<BDD_BRANCH_NODE>::forward_mm(
                 const typename BDD_BRANCH_NODE::value_type omega,
@@ -1112,9 +1742,23 @@ namespace LPMP {
                 std::fill(delta_out_.begin(), delta_out_.end(), std::array<value_type,2>{0.0, 0.0});
             }
 
+            if(!gather_deltas())
+            {
 #pragma omp parallel for schedule(dynamic)
-            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
-                forward_mm(bdd_nr, 0.5, delta_out_, delta);
+                for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                    forward_mm(bdd_nr, 0.5, delta_out_, delta);
+            }
+            else
+            {
+                init_gather_plan();
+                auto slot_delta_out = [&](const size_t bdd_nr, const size_t bdd_idx, size_t, const std::array<value_type,2> d) {
+                    slot_delta_[bdd_slot_offsets_[bdd_nr] + bdd_idx] = d;
+                };
+#pragma omp parallel for schedule(dynamic)
+                for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                    forward_mm_impl(bdd_nr, 0.5, slot_delta_out, delta);
+                gather_delta(delta_out_);
+            }
 
             std::swap(delta_out_, delta);
 
@@ -1138,9 +1782,35 @@ namespace LPMP {
             }
 
             double lb = 0.0;
+            if(!gather_deltas())
+            {
 #pragma omp parallel for schedule(dynamic) reduction(+:lb)
-            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
-                lb += backward_mm(bdd_nr, 0.5, delta_out_, delta);
+                for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                    lb += backward_mm(bdd_nr, 0.5, delta_out_, delta);
+            }
+            else
+            {
+                init_gather_plan();
+                auto slot_delta_out = [&](const size_t bdd_nr, const size_t bdd_idx, size_t, const std::array<value_type,2> d) {
+                    slot_delta_[bdd_slot_offsets_[bdd_nr] + bdd_idx] = d;
+                };
+                if(deterministic_)
+                {
+                    // the order of summation in an omp reduction depends on the number of threads
+                    lb_per_bdd_.resize(nr_bdds());
+#pragma omp parallel for schedule(dynamic)
+                    for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                        lb_per_bdd_[bdd_nr] = backward_mm_impl(bdd_nr, 0.5, slot_delta_out, delta);
+                    lb = std::accumulate(lb_per_bdd_.begin(), lb_per_bdd_.end(), 0.0);
+                }
+                else
+                {
+#pragma omp parallel for schedule(dynamic) reduction(+:lb)
+                    for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                        lb += backward_mm_impl(bdd_nr, 0.5, slot_delta_out, delta);
+                }
+                gather_delta(delta_out_);
+            }
 
             std::swap(delta_out_, delta);
 
@@ -1461,7 +2131,7 @@ namespace LPMP {
                         assert(delta_out_.size() == nr_variables());
                         costs[c] += delta_out_[var][1]/nr_bdds_per_var - delta_out_[var][0]/nr_bdds_per_var;
                     }
-                    assert(std::isfinite(costs[c - 1]));
+                    assert(std::isfinite(costs[c]));
                     c++;
                 }
             }
@@ -6,6 +6,7 @@
 #include "two_dimensional_variable_array.hxx"
 #include <cassert>
 #include <vector>
+#include <string>
 
 namespace LPMP {
     
@@ -17,6 +18,11 @@ namespace LPMP {
                 add_ilp(ilp, normalize, split_long_bdds, add_split_implication_bdd, split_length);
             }
 
+            // reuse BDDs compiled in previous runs on the same constraints, see bdd_cache.h
+            void set_cache_directory(const std::string& directory) { cache_directory = directory; }
+            // memory budget of the memo cache used for building BDDs
+            void set_memo_cache_memory(const size_t bytes) { memo_cache_memory = bytes; }
+
             two_dim_variable_array<size_t> add_ilp(const ILP_input& ilp, const bool normalize = false, const bool split_long_bdds = false, const bool add_split_implication_bdd = false, const size_t split_length = std::numeric_limits<size_t>::max());
 
             template<typename VARIABLE_ITERATOR>
@@ -33,6 +39,8 @@ namespace LPMP {
 
             BDD::bdd_collection bdd_collection;
             size_t nr_variables = 0;
+            std::string cache_directory;
+            size_t memo_cache_memory = BDD::memo_cache::default_max_memory;
 
     };
 
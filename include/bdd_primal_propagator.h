@@ -0,0 +1,32 @@
+#pragma once
+
+#include "bdd_collection/bdd_collection.h"
+#include "mm_primal_decoder.h"
+#include "two_dimensional_variable_array.hxx"
+#include <vector>
+
+namespace LPMP {
+
+    // completes primal solutions from min-marginals by constraint propagation through the BDDs of the problem.
+    // Variables with decisive min-marginals are fixed first. Every fixing is propagated through all BDDs containing the variable,
+    // which detects conflicts and variables that can take only one value. Remaining variables are branched on, least certain first, with backtracking.
+    // All BDDs must be QBDDs, i.e. every path from root to topsink visits all variables of the BDD.
+    class bdd_primal_propagator {
+        public:
+            bdd_primal_propagator(const BDD::bdd_collection& bdd_col);
+
+            // returns an empty vector if no solution is found within max_backtracks backtracks. Safe to call concurrently.
+            std::vector<char> complete(const mm_primal_decoder& mms, const size_t max_backtracks = 1000) const;
+
+            size_t nr_variables() const { return variable_bdds_.size(); }
+
+        private:
+            class state;
+
+            BDD::bdd_collection bdd_col_;
+            two_dim_variable_array<size_t> bdd_variables_; // variables of each bdd
+            two_dim_variable_array<size_t> variable_bdds_; // bdds containing each variable
+            size_t max_nr_bdd_nodes_ = 0;
+    };
+
+}
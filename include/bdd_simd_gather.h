@@ -0,0 +1,240 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define LPMP_SIMD_GATHER_X86
+#include <immintrin.h>
+#endif
+
+namespace LPMP {
+
+    // Gather kernels for BDD layers whose nodes are addressed through child slot indices.
+    // AVX2 and AVX-512 versions are compiled through target attributes and selected at runtime, hence no -march flag is needed.
+    // All versions perform the same additions in the same order and produce bitwise identical results.
+    namespace simd_gather {
+
+        enum class instruction_set { generic, avx2, avx512 };
+
+        inline instruction_set detected_instruction_set()
+        {
+#ifdef LPMP_SIMD_GATHER_X86
+            static const instruction_set is = []() {
+                __builtin_cpu_init();
+                if(__builtin_cpu_supports("avx512f"))
+                    return instruction_set::avx512;
+                if(__builtin_cpu_supports("avx2"))
+                    return instruction_set::avx2;
+                return instruction_set::generic;
+            }();
+            return is;
+#else
+            return instruction_set::generic;
+#endif
+        }
+
+        // mm[0] = min_j cfr[j] + lo_cost + cft[lo[j]], mm[1] = min_j cfr[j] + hi_cost + cft[hi[j]]
+        template<typename REAL>
+            std::array<REAL,2> min_marginals_generic(const REAL* cfr, const int* lo, const int* hi, const REAL* cft, const REAL lo_cost, const REAL hi_cost, const int n)
+            {
+                REAL mm_0 = std::numeric_limits<REAL>::infinity();
+                REAL mm_1 = std::numeric_limits<REAL>::infinity();
+#pragma omp simd reduction(min:mm_0,mm_1)
+                for(int j=0; j<n; ++j)
+                {
+                    mm_0 = std::min(mm_0, cfr[j] + lo_cost + cft[lo[j]]);
+                    mm_1 = std::min(mm_1, cfr[j] + hi_cost + cft[hi[j]]);
+                }
+                return {mm_0, mm_1};
+            }
+
+        // out[j] = min(lo_cost + cft[lo[j]], hi_cost + cft[hi[j]])
+        template<typename REAL>
+            void backward_step_generic(REAL* out, const int* lo, const int* hi, const REAL* cft, const REAL lo_cost, const REAL hi_cost, const int n)
+            {
+#pragma omp simd
+                for(int j=0; j<n; ++j)
+                    out[j] = std::min(lo_cost + cft[lo[j]], hi_cost + cft[hi[j]]);
+            }
+
+#ifdef LPMP_SIMD_GATHER_X86
+        __attribute__((target("avx2")))
+        inline std::array<float,2> min_marginals_avx2(const float* cfr, const int* lo, const int* hi, const float* cft, const float lo_cost, const float hi_cost, const int n)
+        {
+            const __m256 lo_c = _mm256_set1_ps(lo_cost);
+            const __m256 hi_c = _mm256_set1_ps(hi_cost);
+            __m256 mm_0 = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+            __m256 mm_1 = mm_0;
+            int j=0;
+            for(; j+8<=n; j+=8)
+            {
+                const __m256 c = _mm256_loadu_ps(cfr + j);
+                const __m256 cft_lo = _mm256_i32gather_ps(cft, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + j)), 4);
+                const __m256 cft_hi = _mm256_i32gather_ps(cft, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + j)), 4);
+                mm_0 = _mm256_min_ps(mm_0, _mm256_add_ps(_mm256_add_ps(c, lo_c), cft_lo));
+                mm_1 = _mm256_min_ps(mm_1, _mm256_add_ps(_mm256_add_ps(c, hi_c), cft_hi));
+            }
+            alignas(32) std::array<float,8> r_0, r_1;
+            _mm256_store_ps(r_0.data(), mm_0);
+            _mm256_store_ps(r_1.data(), mm_1);
+            const auto tail = min_marginals_generic(cfr + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+            return {std::min(tail[0], *std::min_element(r_0.begin(), r_0.end())), std::min(tail[1], *std::min_element(r_1.begin(), r_1.end()))};
+        }
+
+        __attribute__((target("avx2")))
+        inline std::array<double,2> min_marginals_avx2(const double* cfr, const int* lo, const int* hi, const double* cft, const double lo_cost, const double hi_cost, const int n)
+        {
+            const __m256d lo_c = _mm256_set1_pd(lo_cost);
+            const __m256d hi_c = _mm256_set1_pd(hi_cost);
+            __m256d mm_0 = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+            __m256d mm_1 = mm_0;
+            int j=0;
+            for(; j+4<=n; j+=4)
+            {
+                const __m256d c = _mm256_loadu_pd(cfr + j);
+                const __m256d cft_lo = _mm256_i32gather_pd(cft, _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo + j)), 8);
+                const __m256d cft_hi = _mm256_i32gather_pd(cft, _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi + j)), 8);
+                mm_0 = _mm256_min_pd(mm_0, _mm256_add_pd(_mm256_add_pd(c, lo_c), cft_lo));
+                mm_1 = _mm256_min_pd(mm_1, _mm256_add_pd(_mm256_add_pd(c, hi_c), cft_hi));
+            }
+            alignas(32) std::array<double,4> r_0, r_1;
+            _mm256_store_pd(r_0.data(), mm_0);
+            _mm256_store_pd(r_1.data(), mm_1);
+            const auto tail = min_marginals_generic(cfr + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+            return {std::min(tail[0], *std::min_element(r_0.begin(), r_0.end())), std::min(tail[1], *std::min_element(r_1.begin(), r_1.end()))};
+        }
+
+        __attribute__((target("avx2")))
+        inline void backward_step_avx2(float* out, const int* lo, const int* hi, const float* cft, const float lo_cost, const float hi_cost, const int n)
+        {
+            const __m256 lo_c = _mm256_set1_ps(lo_cost);
+            const __m256 hi_c = _mm256_set1_ps(hi_cost);
+            int j=0;
+            for(; j+8<=n; j+=8)
+            {
+                const __m256 cft_lo = _mm256_i32gather_ps(cft, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + j)), 4);
+                const __m256 cft_hi = _mm256_i32gather_ps(cft, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + j)), 4);
+                _mm256_storeu_ps(out + j, _mm256_min_ps(_mm256_add_ps(lo_c, cft_lo), _mm256_add_ps(hi_c, cft_hi)));
+            }
+            backward_step_generic(out + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+        }
+
+        __attribute__((target("avx2")))
+        inline void backward_step_avx2(double* out, const int* lo, const int* hi, const double* cft, const double lo_cost, const double hi_cost, const int n)
+        {
+            const __m256d lo_c = _mm256_set1_pd(lo_cost);
+            const __m256d hi_c = _mm256_set1_pd(hi_cost);
+            int j=0;
+            for(; j+4<=n; j+=4)
+            {
+                const __m256d cft_lo = _mm256_i32gather_pd(cft, _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo + j)), 8);
+                const __m256d cft_hi = _mm256_i32gather_pd(cft, _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi + j)), 8);
+                _mm256_storeu_pd(out + j, _mm256_min_pd(_mm256_add_pd(lo_c, cft_lo), _mm256_add_pd(hi_c, cft_hi)));
+            }
+            backward_step_generic(out + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+        }
+
+        __attribute__((target("avx512f")))
+        inline std::array<float,2> min_marginals_avx512(const float* cfr, const int* lo, const int* hi, const float* cft, const float lo_cost, const float hi_cost, const int n)
+        {
+            const __m512 lo_c = _mm512_set1_ps(lo_cost);
+            const __m512 hi_c = _mm512_set1_ps(hi_cost);
+            __m512 mm_0 = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+            __m512 mm_1 = mm_0;
+            int j=0;
+            for(; j+16<=n; j+=16)
+            {
+                const __m512 c = _mm512_loadu_ps(cfr + j);
+                const __m512 cft_lo = _mm512_i32gather_ps(_mm512_loadu_si512(lo + j), cft, 4);
+                const __m512 cft_hi = _mm512_i32gather_ps(_mm512_loadu_si512(hi + j), cft, 4);
+                mm_0 = _mm512_min_ps(mm_0, _mm512_add_ps(_mm512_add_ps(c, lo_c), cft_lo));
+                mm_1 = _mm512_min_ps(mm_1, _mm512_add_ps(_mm512_add_ps(c, hi_c), cft_hi));
+            }
+            const auto tail = min_marginals_generic(cfr + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+            return {std::min(tail[0], _mm512_reduce_min_ps(mm_0)), std::min(tail[1], _mm512_reduce_min_ps(mm_1))};
+        }
+
+        __attribute__((target("avx512f")))
+        inline std::array<double,2> min_marginals_avx512(const double* cfr, const int* lo, const int* hi, const double* cft, const double lo_cost, const double hi_cost, const int n)
+        {
+            const __m512d lo_c = _mm512_set1_pd(lo_cost);
+            const __m512d hi_c = _mm512_set1_pd(hi_cost);
+            __m512d mm_0 = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+            __m512d mm_1 = mm_0;
+            int j=0;
+            for(; j+8<=n; j+=8)
+            {
+                const __m512d c = _mm512_loadu_pd(cfr + j);
+                const __m512d cft_lo = _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + j)), cft, 8);
+                const __m512d cft_hi = _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + j)), cft, 8);
+                mm_0 = _mm512_min_pd(mm_0, _mm512_add_pd(_mm512_add_pd(c, lo_c), cft_lo));
+                mm_1 = _mm512_min_pd(mm_1, _mm512_add_pd(_mm512_add_pd(c, hi_c), cft_hi));
+            }
+            const auto tail = min_marginals_generic(cfr + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+            return {std::min(tail[0], _mm512_reduce_min_pd(mm_0)), std::min(tail[1], _mm512_reduce_min_pd(mm_1))};
+        }
+
+        __attribute__((target("avx512f")))
+        inline void backward_step_avx512(float* out, const int* lo, const int* hi, const float* cft, const float lo_cost, const float hi_cost, const int n)
+        {
+            const __m512 lo_c = _mm512_set1_ps(lo_cost);
+            const __m512 hi_c = _mm512_set1_ps(hi_cost);
+            int j=0;
+            for(; j+16<=n; j+=16)
+            {
+                const __m512 cft_lo = _mm512_i32gather_ps(_mm512_loadu_si512(lo + j), cft, 4);
+                const __m512 cft_hi = _mm512_i32gather_ps(_mm512_loadu_si512(hi + j), cft, 4);
+                _mm512_storeu_ps(out + j, _mm512_min_ps(_mm512_add_ps(lo_c, cft_lo), _mm512_add_ps(hi_c, cft_hi)));
+            }
+            backward_step_generic(out + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+        }
+
+        __attribute__((target("avx512f")))
+        inline void backward_step_avx512(double* out, const int* lo, const int* hi, const double* cft, const double lo_cost, const double hi_cost, const int n)
+        {
+            const __m512d lo_c = _mm512_set1_pd(lo_cost);
+            const __m512d hi_c = _mm512_set1_pd(hi_cost);
+            int j=0;
+            for(; j+8<=n; j+=8)
+            {
+                const __m512d cft_lo = _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + j)), cft, 8);
+                const __m512d cft_hi = _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + j)), cft, 8);
+                _mm512_storeu_pd(out + j, _mm512_min_pd(_mm512_add_pd(lo_c, cft_lo), _mm512_add_pd(hi_c, cft_hi)));
+            }
+            backward_step_generic(out + j, lo + j, hi + j, cft, lo_cost, hi_cost, n - j);
+        }
+#endif
+
+        template<typename REAL>
+            std::array<REAL,2> min_marginals(const REAL* cfr, const int* lo, const int* hi, const REAL* cft, const REAL lo_cost, const REAL hi_cost, const int n)
+            {
+#ifdef LPMP_SIMD_GATHER_X86
+                switch(detected_instruction_set())
+                {
+                    case instruction_set::avx512: return min_marginals_avx512(cfr, lo, hi, cft, lo_cost, hi_cost, n);
+                    case instruction_set::avx2: return min_marginals_avx2(cfr, lo, hi, cft, lo_cost, hi_cost, n);
+                    default: break;
+                }
+#endif
+                return min_marginals_generic(cfr, lo, hi, cft, lo_cost, hi_cost, n);
+            }
+
+        template<typename REAL>
+            void backward_step(REAL* out, const int* lo, const int* hi, const REAL* cft, const REAL lo_cost, const REAL hi_cost, const int n)
+            {
+#ifdef LPMP_SIMD_GATHER_X86
+                switch(detected_instruction_set())
+                {
+                    case instruction_set::avx512: backward_step_avx512(out, lo, hi, cft, lo_cost, hi_cost, n); return;
+                    case instruction_set::avx2: backward_step_avx2(out, lo, hi, cft, lo_cost, hi_cost, n); return;
+                    default: break;
+                }
+#endif
+                backward_step_generic(out, lo, hi, cft, lo_cost, hi_cost, n);
+            }
+
+    }
+
+}
@@ -0,0 +1,860 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <stdexcept>
+#include "bdd_collection/bdd_collection.h"
+#include "two_dimensional_variable_array.hxx"
+#include "hash_helper.hxx"
+#include "bdd_logging.h"
+#include "bdd_simd_gather.h"
+#include "time_measure_util.h"
+
+namespace LPMP {
+
+    // CPU counterpart of bdd_cuda_base: BDD nodes are stored layer by layer in structure of arrays layout.
+    // Layers are ordered by hop distance from the root, so that the same layer of all BDDs can be processed at once.
+    // Structurally identical BDDs (e.g. simplex constraints of equal length) are stored once as a shape and processed together in lane groups of up to batch_width instances.
+    // Node values of a lane group are interleaved: node j of lane k is at slot first_slot + j*width + k, hence loops over lanes are unit stride.
+    // Lane groups of width one are processed by branch free loops over nodes with gather instructions, see bdd_simd_gather.h.
+    // Children are addressed by int32 slot indices, the batch_width slots after the last node slot stand for the top terminal, the next ones for the bottom terminal.
+    // Loops over lanes are vectorized by the compiler, configure with WITH_NATIVE_ARCH to obtain AVX2/AVX-512 code for them.
+    template<typename REAL>
+        class bdd_simd_parallel_mma_base {
+            public:
+            using value_type = REAL;
+            constexpr static size_t batch_width = 64 / sizeof(REAL); // one cache line, i.e. 16 floats or 8 doubles
+
+            bdd_simd_parallel_mma_base() {}
+            bdd_simd_parallel_mma_base(const BDD::bdd_collection& bdd_col);
+
+            size_t nr_variables() const { return num_bdds_per_var_.size(); }
+            size_t nr_bdds() const { return nr_bdds_; }
+            size_t nr_bdds(const size_t var) const { assert(var < nr_variables()); return num_bdds_per_var_[var]; }
+            size_t nr_layers() const { return primal_variable_index_.size(); }
+            size_t nr_group_layers() const { return group_layer_offsets_.size() - 1; }
+            size_t nr_bdd_nodes() const { return nr_node_slots_; }
+            size_t nr_shape_nodes() const { return lo_bdd_node_index_.size(); }
+            size_t nr_hops() const { return cum_nr_group_layers_per_hop_dist_.size() - 1; }
+            size_t nr_variables(const size_t bdd_nr) const { assert(bdd_nr < nr_bdds()); return bdd_layers_.size(bdd_nr); }
+            std::vector<size_t> variables(const size_t bdd_nr) const;
+
+            // BDDs are appended to present ones. The layered structure is rebuilt, costs of present BDDs are kept.
+            void add_bdds(const BDD::bdd_collection& bdd_col);
+            size_t export_bdd(BDD::bdd_collection& bdd_col, const size_t bdd_nr) const;
+
+            double lower_bound();
+
+            template<typename COST_ITERATOR>
+                void update_costs(COST_ITERATOR cost_lo_begin, COST_ITERATOR cost_lo_end, COST_ITERATOR cost_hi_begin, COST_ITERATOR cost_hi_end);
+            void add_to_constant(const double c) { constant_ += c; }
+            // costs of a single BDD, infinite costs mark infeasible arcs and are reported as zero
+            std::vector<std::array<value_type,2>> get_costs(const size_t bdd_nr) const;
+            template<typename COST_ITERATOR>
+                void update_costs(const size_t bdd_nr, COST_ITERATOR cost_begin, COST_ITERATOR cost_end);
+
+            template<typename ITERATOR>
+                void fix_variables(ITERATOR zero_fixations_begin, ITERATOR zero_fixations_end, ITERATOR one_fixations_begin, ITERATOR one_fixations_end);
+            void fix_variable(const size_t var, const bool value);
+
+            void forward_run();
+            void backward_run();
+            two_dim_variable_array<std::array<double,2>> min_marginals();
+
+            // compute incremental min marginals and perform min-marginal averaging subsequently
+            void iteration();
+            void forward_mm(const value_type omega, std::vector<std::array<value_type,2>>& delta);
+            double backward_mm(const value_type omega, std::vector<std::array<value_type,2>>& delta);
+            void distribute_delta();
+
+            protected:
+            size_t width(const size_t group_layer) const { return group_layer_offsets_[group_layer+1] - group_layer_offsets_[group_layer]; }
+            // min-marginals of all lanes of a group layer, written to mm[0], ..., mm[width-1]
+            void group_layer_min_marginals(const size_t group_layer, std::array<value_type,2>* mm) const;
+            void forward_step(const size_t group_layer);
+            void backward_step(const size_t group_layer);
+            template<typename STEP_FUNC>
+                void mm_group_layer_update(const size_t group_layer, const value_type omega, const std::vector<std::array<value_type,2>>& delta_in, STEP_FUNC step_func);
+            void gather_delta(std::vector<std::array<value_type,2>>& delta_out) const;
+            std::array<size_t,2> hop_range(const size_t hop_index) const { return {size_t(cum_nr_group_layers_per_hop_dist_[hop_index]), size_t(cum_nr_group_layers_per_hop_dist_[hop_index+1])}; }
+            size_t group_layer(const size_t layer) const { return std::upper_bound(group_layer_offsets_.begin(), group_layer_offsets_.end(), int(layer)) - group_layer_offsets_.begin() - 1; }
+
+            // Following arrays have one entry per layer of BDD in each BDD, layers of the same lane group are consecutive:
+            std::vector<int> primal_variable_index_;
+            std::vector<int> bdd_index_;
+            std::vector<value_type> lo_cost_, hi_cost_;
+            std::vector<std::array<value_type,2>> layer_delta_;
+
+            // Following arrays have one entry per layer of a lane group and an extra delimiter at the end:
+            std::vector<int> group_layer_offsets_; // lanes of group layer g are layers [group_layer_offsets_[g], group_layer_offsets_[g+1])
+            std::vector<int> group_layer_node_offsets_; // shape nodes of group layer g are [group_layer_node_offsets_[g], group_layer_node_offsets_[g+1])
+            std::vector<int> group_layer_slot_offsets_; // first node slot of group layer g
+
+            // Following arrays have one entry per shape node and hold the slot of the child in the first lane:
+            std::vector<int> lo_bdd_node_index_;
+            std::vector<int> hi_bdd_node_index_;
+
+            // Following arrays have one entry per node slot and batch_width additional entries for each terminal:
+            std::vector<value_type> cost_from_root_;
+            std::vector<value_type> cost_from_terminal_;
+
+            // Other information:
+            std::vector<size_t> num_bdds_per_var_;
+            two_dim_variable_array<int> variable_layers_; // layers of each variable, in increasing bdd order
+            two_dim_variable_array<int> bdd_layers_; // layers of each bdd, from root to terminals
+            std::vector<int> root_slots_; // slot of root node of each bdd
+            std::vector<int> cum_nr_group_layers_per_hop_dist_; // starts with 0, group layers of hop h are [cum_nr_group_layers_per_hop_dist_[h], cum_nr_group_layers_per_hop_dist_[h+1])
+            size_t nr_bdds_ = 0;
+            size_t nr_node_slots_ = 0;
+            int top_sink_index_ = 0;
+            int bot_sink_index_ = 0;
+
+            std::vector<std::array<value_type,2>> delta_out_;
+            std::vector<std::array<value_type,2>> delta_in_;
+
+            bool forward_state_valid_ = false; // true means cost from root valid.
+            bool backward_state_valid_ = false; // true means cost from terminal are valid.
+            double constant_ = 0.0;
+        };
+
+    ////////////////////
+    // implementation //
+    ////////////////////
+
+    template<typename REAL>
+        bdd_simd_parallel_mma_base<REAL>::bdd_simd_parallel_mma_base(const BDD::bdd_collection& bdd_col)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            nr_bdds_ = bdd_col.nr_bdds();
+            bdd_log << "[bdd simd parallel mma base] # bdds = " << nr_bdds() << "\n";
+
+            const size_t nr_vars = [&]() {
+                size_t max_v=0;
+                for(size_t bdd_nr=0; bdd_nr<bdd_col.nr_bdds(); ++bdd_nr)
+                    max_v = std::max(max_v, bdd_col.min_max_variables(bdd_nr)[1]+1);
+                return max_v;
+            }();
+            bdd_log << "[bdd simd parallel mma base] # vars = " << nr_vars << "\n";
+            num_bdds_per_var_.resize(nr_vars, 0);
+
+            // detect structurally identical bdds through their layer sizes and arcs relative to the first node
+            constexpr size_t botsink_position = std::numeric_limits<size_t>::max();
+            constexpr size_t topsink_position = std::numeric_limits<size_t>::max()-1;
+            auto child_position = [&](const size_t bdd_nr, const size_t child) -> size_t {
+                const auto instr = bdd_col.get_bdd_instruction(child);
+                if(instr.is_botsink())
+                    return botsink_position;
+                if(instr.is_topsink())
+                    return topsink_position;
+                return child - bdd_col.offset(bdd_nr);
+            };
+
+            two_dim_variable_array<size_t> bdd_layers; // position of first node of each layer inside the BDD, with extra delimiter at the end
+            std::unordered_map<std::vector<size_t>, size_t> shape_map;
+            std::vector<std::vector<size_t>> shape_bdds;
+            size_t max_nr_layers = 0;
+            for(size_t bdd_nr=0; bdd_nr<bdd_col.nr_bdds(); ++bdd_nr)
+            {
+                assert(bdd_col.is_qbdd(bdd_nr));
+                assert(bdd_col.is_reordered(bdd_nr));
+                std::vector<size_t> cur_layers;
+                std::vector<size_t> shape;
+                const auto bdd_begin = bdd_col.cbegin(bdd_nr);
+                for(auto bdd_it=bdd_col.cbegin(bdd_nr); bdd_it!=bdd_col.cend(bdd_nr); ++bdd_it)
+                {
+                    assert(!bdd_it->is_terminal());
+                    if(bdd_it == bdd_begin || bdd_it->index != (bdd_it-1)->index)
+                    {
+                        cur_layers.push_back(std::distance(bdd_begin, bdd_it));
+                        num_bdds_per_var_[bdd_it->index]++;
+                    }
+                    shape.push_back(child_position(bdd_nr, bdd_it->lo));
+                    shape.push_back(child_position(bdd_nr, bdd_it->hi));
+                }
+                cur_layers.push_back(std::distance(bdd_col.cbegin(bdd_nr), bdd_col.cend(bdd_nr)));
+                assert(cur_layers.size() >= 2 && cur_layers[1] == 1); // single root node
+                max_nr_layers = std::max(max_nr_layers, cur_layers.size()-1);
+                bdd_layers.push_back(cur_layers.begin(), cur_layers.end());
+
+                shape.insert(shape.end(), cur_layers.begin(), cur_layers.end());
+                const auto [it, inserted] = shape_map.insert({shape, shape_bdds.size()});
+                if(inserted)
+                    shape_bdds.push_back({});
+                shape_bdds[it->second].push_back(bdd_nr);
+            }
+
+            // split bdds of the same shape into lane groups
+            std::vector<std::vector<size_t>> groups;
+            for(const auto& bdds : shape_bdds)
+                for(size_t i=0; i<bdds.size(); i+=batch_width)
+                    groups.push_back(std::vector<size_t>(bdds.begin() + i, bdds.begin() + std::min(i + batch_width, bdds.size())));
+            bdd_log << "[bdd simd parallel mma base] # bdd shapes = " << shape_bdds.size() << ", # lane groups = " << groups.size() << "\n";
+
+            // order group layers by hop distance from root and then by group
+            std::vector<size_t> group_node_offsets = {0}; // first node of each group in a flat numbering of the nodes of all group shapes
+            for(const auto& group : groups)
+                group_node_offsets.push_back(group_node_offsets.back() + bdd_layers(group[0], bdd_layers.size(group[0])-1));
+            std::vector<int> shape_node_index(group_node_offsets.back());
+            std::vector<int> slot_index(group_node_offsets.back());
+            std::vector<size_t> active_groups(groups.size());
+            std::iota(active_groups.begin(), active_groups.end(), 0);
+            cum_nr_group_layers_per_hop_dist_.push_back(0);
+            group_layer_offsets_.push_back(0);
+            group_layer_node_offsets_.push_back(0);
+            group_layer_slot_offsets_.push_back(0);
+            for(size_t hop=0; hop<max_nr_layers; ++hop)
+            {
+                for(const size_t g : active_groups)
+                {
+                    const auto& group = groups[g];
+                    assert(hop+1 < bdd_layers.size(group[0]));
+                    const size_t first = bdd_layers(group[0], hop);
+                    const size_t last = bdd_layers(group[0], hop+1);
+                    for(size_t i=first; i<last; ++i)
+                    {
+                        shape_node_index[group_node_offsets[g] + i] = group_layer_node_offsets_.back() + (i - first);
+                        slot_index[group_node_offsets[g] + i] = group_layer_slot_offsets_.back() + (i - first)*group.size();
+                    }
+                    for(const size_t bdd_nr : group)
+                    {
+                        primal_variable_index_.push_back((bdd_col.cbegin(bdd_nr) + first)->index);
+                        bdd_index_.push_back(bdd_nr);
+                    }
+                    group_layer_offsets_.push_back(primal_variable_index_.size());
+                    group_layer_node_offsets_.push_back(group_layer_node_offsets_.back() + (last - first));
+                    group_layer_slot_offsets_.push_back(group_layer_slot_offsets_.back() + (last - first)*group.size());
+                }
+                cum_nr_group_layers_per_hop_dist_.push_back(nr_group_layers());
+                active_groups.erase(std::remove_if(active_groups.begin(), active_groups.end(), [&](const size_t g) { return bdd_layers.size(groups[g][0]) <= hop+2; }), active_groups.end());
+            }
+            assert(active_groups.empty());
+
+            nr_node_slots_ = group_layer_slot_offsets_.back();
+            if(nr_node_slots_ + 2*batch_width > size_t(std::numeric_limits<int>::max()))
+                throw std::runtime_error("too many bdd nodes for int32 node indices");
+            top_sink_index_ = nr_node_slots_;
+            bot_sink_index_ = nr_node_slots_ + batch_width;
+            bdd_log << "[bdd simd parallel mma base] # hops = " << nr_hops() << ", # layers = " << nr_layers() << ", # group layers = " << nr_group_layers() << "\n";
+            bdd_log << "[bdd simd parallel mma base] # total bdd nodes = " << nr_bdd_nodes() << ", # shape nodes = " << group_node_offsets.back() << "\n";
+
+            lo_bdd_node_index_.resize(group_node_offsets.back(), bot_sink_index_);
+            hi_bdd_node_index_.resize(group_node_offsets.back(), bot_sink_index_);
+            root_slots_.resize(nr_bdds());
+            for(size_t g=0; g<groups.size(); ++g)
+            {
+                const size_t bdd_nr = groups[g][0];
+                auto child_slot = [&](const size_t child) -> int {
+                    const size_t pos = child_position(bdd_nr, child);
+                    if(pos == botsink_position)
+                        return bot_sink_index_;
+                    if(pos == topsink_position)
+                        return top_sink_index_;
+                    return slot_index[group_node_offsets[g] + pos];
+                };
+                const auto bdd_begin = bdd_col.cbegin(bdd_nr);
+                for(auto bdd_it=bdd_col.cbegin(bdd_nr); bdd_it!=bdd_col.cend(bdd_nr); ++bdd_it)
+                {
+                    const size_t pos = std::distance(bdd_begin, bdd_it);
+                    const int j = shape_node_index[group_node_offsets[g] + pos];
+                    lo_bdd_node_index_[j] = child_slot(bdd_it->lo);
+                    hi_bdd_node_index_[j] = child_slot(bdd_it->hi);
+                    assert(lo_bdd_node_index_[j] > slot_index[group_node_offsets[g] + pos] && hi_bdd_node_index_[j] > slot_index[group_node_offsets[g] + pos]);
+                }
+                for(size_t k=0; k<groups[g].size(); ++k)
+                    root_slots_[groups[g][k]] = slot_index[group_node_offsets[g]] + k;
+            }
+
+            lo_cost_.resize(nr_layers(), 0.0);
+            hi_cost_.resize(nr_layers(), 0.0);
+            layer_delta_.resize(nr_layers(), {0.0, 0.0});
+            cost_from_root_.resize(nr_node_slots_ + 2*batch_width, std::numeric_limits<value_type>::infinity());
+            cost_from_terminal_.resize(nr_node_slots_ + 2*batch_width, std::numeric_limits<value_type>::infinity());
+            std::fill(cost_from_terminal_.begin() + top_sink_index_, cost_from_terminal_.begin() + top_sink_index_ + batch_width, 0.0);
+
+            // layers of each variable sorted by bdd for summing up deltas in fixed order
+            variable_layers_ = two_dim_variable_array<int>(num_bdds_per_var_);
+            std::vector<size_t> counter(nr_variables(), 0);
+            for(size_t layer=0; layer<nr_layers(); ++layer)
+            {
+                const size_t var = primal_variable_index_[layer];
+                variable_layers_(var, counter[var]++) = layer;
+            }
+            for(size_t var=0; var<nr_variables(); ++var)
+            {
+                auto layers = variable_layers_[var];
+                std::sort(layers.begin(), layers.end(), [&](const int l1, const int l2) { return bdd_index_[l1] < bdd_index_[l2]; });
+            }
+
+            // layers are ordered by hop distance, hence the layers of each bdd are visited from root to terminals
+            std::vector<size_t> nr_bdd_layers(nr_bdds());
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                nr_bdd_layers[bdd_nr] = bdd_layers.size(bdd_nr)-1;
+            bdd_layers_ = two_dim_variable_array<int>(nr_bdd_layers);
+            std::fill(nr_bdd_layers.begin(), nr_bdd_layers.end(), 0);
+            for(size_t layer=0; layer<nr_layers(); ++layer)
+            {
+                const size_t bdd_nr = bdd_index_[layer];
+                bdd_layers_(bdd_nr, nr_bdd_layers[bdd_nr]++) = layer;
+            }
+        }
+
+    template<typename REAL>
+        std::vector<size_t> bdd_simd_parallel_mma_base<REAL>::variables(const size_t bdd_nr) const
+        {
+            assert(bdd_nr < nr_bdds());
+            std::vector<size_t> vars;
+            vars.reserve(nr_variables(bdd_nr));
+            for(const int layer : bdd_layers_[bdd_nr])
+                vars.push_back(primal_variable_index_[layer]);
+            return vars;
+        }
+
+    template<typename REAL>
+        size_t bdd_simd_parallel_mma_base<REAL>::export_bdd(BDD::bdd_collection& bdd_col, const size_t bdd_nr) const
+        {
+            assert(bdd_nr < nr_bdds());
+            const size_t new_bdd_nr = bdd_col.new_bdd();
+            std::vector<BDD::bdd_collection_node> nodes;
+            std::vector<std::array<int,2>> node_shape_lane; // shape node and lane of each exported node
+            std::unordered_map<int,size_t> slot_to_node;
+            for(const int layer : bdd_layers_[bdd_nr])
+            {
+                const size_t gl = group_layer(layer);
+                const int k = layer - group_layer_offsets_[gl];
+                const int w = width(gl);
+                for(int j=group_layer_node_offsets_[gl]; j<group_layer_node_offsets_[gl+1]; ++j)
+                {
+                    slot_to_node.insert({group_layer_slot_offsets_[gl] + (j - group_layer_node_offsets_[gl])*w + k, nodes.size()});
+                    nodes.push_back(bdd_col.add_bdd_node(primal_variable_index_[layer]));
+                    node_shape_lane.push_back({j, k});
+                }
+            }
+
+            for(size_t i=0; i<nodes.size(); ++i)
+            {
+                const auto [j, k] = node_shape_lane[i];
+                const int lo = lo_bdd_node_index_[j];
+                if(lo == bot_sink_index_)
+                    nodes[i].set_lo_to_0_terminal();
+                else if(lo == top_sink_index_)
+                    nodes[i].set_lo_to_1_terminal();
+                else
+                {
+                    assert(slot_to_node.count(lo + k) > 0);
+                    nodes[i].set_lo_arc(nodes[slot_to_node.find(lo + k)->second]);
+                }
+
+                const int hi = hi_bdd_node_index_[j];
+                if(hi == bot_sink_index_)
+                    nodes[i].set_hi_to_0_terminal();
+                else if(hi == top_sink_index_)
+                    nodes[i].set_hi_to_1_terminal();
+                else
+                {
+                    assert(slot_to_node.count(hi + k) > 0);
+                    nodes[i].set_hi_arc(nodes[slot_to_node.find(hi + k)->second]);
+                }
+            }
+
+            bdd_col.close_bdd();
+            return new_bdd_nr;
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::add_bdds(const BDD::bdd_collection& bdd_col)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            bdd_log << "[bdd simd parallel mma base] add " << bdd_col.nr_bdds() << " bdds to " << nr_bdds() << " present ones\n";
+            if(delta_in_.size() > 0)
+                distribute_delta();
+
+            BDD::bdd_collection all_bdds;
+            std::vector<std::array<value_type,2>> costs;
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+            {
+                // exported bdds are reduced, the quasi-reduced bdd of the reduced one has the same layers as the original
+                const size_t exported_bdd_nr = export_bdd(all_bdds, bdd_nr);
+                if(!all_bdds.is_qbdd(exported_bdd_nr))
+                {
+                    all_bdds.make_qbdd(exported_bdd_nr);
+                    all_bdds.remove(exported_bdd_nr);
+                }
+                if(all_bdds.nr_variables(exported_bdd_nr) != nr_variables(bdd_nr))
+                    throw std::runtime_error("bdd simd parallel mma: cannot add bdds, bdd " + std::to_string(bdd_nr) + " has irrelevant variables");
+                for(const int layer : bdd_layers_[bdd_nr])
+                    costs.push_back({lo_cost_[layer], hi_cost_[layer]});
+            }
+            all_bdds.append(bdd_col);
+
+            const size_t nr_prev_bdds = nr_bdds();
+            const double constant = constant_;
+            *this = bdd_simd_parallel_mma_base<REAL>(all_bdds);
+            constant_ = constant;
+
+            auto cost_it = costs.begin();
+            for(size_t bdd_nr=0; bdd_nr<nr_prev_bdds; ++bdd_nr)
+                for(const int layer : bdd_layers_[bdd_nr])
+                {
+                    lo_cost_[layer] = (*cost_it)[0];
+                    hi_cost_[layer] = (*cost_it)[1];
+                    ++cost_it;
+                }
+            assert(cost_it == costs.end());
+        }
+
+    template<typename REAL>
+        template<typename COST_ITERATOR>
+        void bdd_simd_parallel_mma_base<REAL>::update_costs(COST_ITERATOR cost_lo_begin, COST_ITERATOR cost_lo_end, COST_ITERATOR cost_hi_begin, COST_ITERATOR cost_hi_end)
+        {
+            forward_state_valid_ = false;
+            backward_state_valid_ = false;
+
+            auto get_cost = [&](COST_ITERATOR cost_begin, COST_ITERATOR cost_end, const size_t var) {
+                if(var < size_t(std::distance(cost_begin, cost_end)) && var < nr_variables() && nr_bdds(var) > 0)
+                    return *(cost_begin+var)/double(nr_bdds(var));
+                else
+                    return 0.0;
+            };
+
+#pragma omp parallel for schedule(static,512)
+            for(size_t layer=0; layer<nr_layers(); ++layer)
+            {
+                const size_t var = primal_variable_index_[layer];
+                const double lo_cost = get_cost(cost_lo_begin, cost_lo_end, var);
+                assert(std::isfinite(lo_cost));
+                const double hi_cost = get_cost(cost_hi_begin, cost_hi_end, var);
+                assert(std::isfinite(hi_cost));
+                lo_cost_[layer] += lo_cost;
+                hi_cost_[layer] += hi_cost;
+            }
+        }
+
+    template<typename REAL>
+        std::vector<std::array<REAL,2>> bdd_simd_parallel_mma_base<REAL>::get_costs(const size_t bdd_nr) const
+        {
+            assert(bdd_nr < nr_bdds());
+            std::vector<std::array<value_type,2>> costs;
+            costs.reserve(nr_variables(bdd_nr));
+            for(const int layer : bdd_layers_[bdd_nr])
+                costs.push_back({std::isfinite(lo_cost_[layer]) ? lo_cost_[layer] : value_type(0.0), std::isfinite(hi_cost_[layer]) ? hi_cost_[layer] : value_type(0.0)});
+            return costs;
+        }
+
+    template<typename REAL>
+        template<typename COST_ITERATOR>
+        void bdd_simd_parallel_mma_base<REAL>::update_costs(const size_t bdd_nr, COST_ITERATOR cost_begin, COST_ITERATOR cost_end)
+        {
+            assert(bdd_nr < nr_bdds());
+            assert(size_t(std::distance(cost_begin, cost_end)) == nr_variables(bdd_nr));
+            forward_state_valid_ = false;
+            backward_state_valid_ = false;
+
+            for(size_t idx=0; idx<nr_variables(bdd_nr); ++idx)
+            {
+                const int layer = bdd_layers_(bdd_nr, idx);
+                assert(std::isfinite((*(cost_begin+idx))[0]) && std::isfinite((*(cost_begin+idx))[1]));
+                lo_cost_[layer] += (*(cost_begin+idx))[0];
+                hi_cost_[layer] += (*(cost_begin+idx))[1];
+            }
+        }
+
+    template<typename REAL>
+        template<typename ITERATOR>
+        void bdd_simd_parallel_mma_base<REAL>::fix_variables(ITERATOR zero_fixations_begin, ITERATOR zero_fixations_end, ITERATOR one_fixations_begin, ITERATOR one_fixations_end)
+        {
+            forward_state_valid_ = false;
+            backward_state_valid_ = false;
+
+            for(auto it=zero_fixations_begin; it!=zero_fixations_end; ++it)
+            {
+                assert(nr_bdds(*it) > 0);
+                for(const int layer : variable_layers_[*it])
+                    hi_cost_[layer] = std::numeric_limits<value_type>::infinity();
+            }
+            for(auto it=one_fixations_begin; it!=one_fixations_end; ++it)
+            {
+                assert(nr_bdds(*it) > 0);
+                for(const int layer : variable_layers_[*it])
+                    lo_cost_[layer] = std::numeric_limits<value_type>::infinity();
+            }
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::fix_variable(const size_t var, const bool value)
+        {
+            const std::array<size_t,1> vars = {var};
+            if(value == false)
+                fix_variables(vars.begin(), vars.end(), vars.begin(), vars.begin());
+            else
+                fix_variables(vars.begin(), vars.begin(), vars.begin(), vars.end());
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::group_layer_min_marginals(const size_t group_layer, std::array<value_type,2>* mm) const
+        {
+            const size_t w = width(group_layer);
+            const int first_layer = group_layer_offsets_[group_layer];
+            const int first_node = group_layer_node_offsets_[group_layer];
+            const int last_node = group_layer_node_offsets_[group_layer+1];
+            const int first_slot = group_layer_slot_offsets_[group_layer];
+            const int* lo = lo_bdd_node_index_.data();
+            const int* hi = hi_bdd_node_index_.data();
+            const value_type* cfr = cost_from_root_.data();
+            const value_type* cft = cost_from_terminal_.data();
+
+            if(w == 1)
+            {
+                mm[0] = simd_gather::min_marginals(cfr + first_slot, lo + first_node, hi + first_node, cft, lo_cost_[first_layer], hi_cost_[first_layer], last_node - first_node);
+            }
+            else
+            {
+                std::array<value_type,batch_width> mm_0, mm_1;
+                mm_0.fill(std::numeric_limits<value_type>::infinity());
+                mm_1.fill(std::numeric_limits<value_type>::infinity());
+                const value_type* lo_cost = lo_cost_.data() + first_layer;
+                const value_type* hi_cost = hi_cost_.data() + first_layer;
+                for(int j=first_node; j<last_node; ++j)
+                {
+                    const value_type* cfr_j = cfr + first_slot + (j - first_node)*w;
+                    const value_type* cft_lo = cft + lo[j];
+                    const value_type* cft_hi = cft + hi[j];
+#pragma omp simd
+                    for(size_t k=0; k<w; ++k)
+                    {
+                        mm_0[k] = std::min(mm_0[k], cfr_j[k] + lo_cost[k] + cft_lo[k]);
+                        mm_1[k] = std::min(mm_1[k], cfr_j[k] + hi_cost[k] + cft_hi[k]);
+                    }
+                }
+                for(size_t k=0; k<w; ++k)
+                    mm[k] = {mm_0[k], mm_1[k]};
+            }
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::backward_step(const size_t group_layer)
+        {
+            const size_t w = width(group_layer);
+            const int first_layer = group_layer_offsets_[group_layer];
+            const int first_node = group_layer_node_offsets_[group_layer];
+            const int last_node = group_layer_node_offsets_[group_layer+1];
+            const int first_slot = group_layer_slot_offsets_[group_layer];
+            const int* lo = lo_bdd_node_index_.data();
+            const int* hi = hi_bdd_node_index_.data();
+            value_type* cft = cost_from_terminal_.data();
+
+            // children lie in the next layer, hence reads and writes never overlap
+            if(w == 1)
+            {
+                simd_gather::backward_step(cft + first_slot, lo + first_node, hi + first_node, cft, lo_cost_[first_layer], hi_cost_[first_layer], last_node - first_node);
+            }
+            else
+            {
+                const value_type* lo_cost = lo_cost_.data() + first_layer;
+                const value_type* hi_cost = hi_cost_.data() + first_layer;
+                for(int j=first_node; j<last_node; ++j)
+                {
+                    value_type* cft_j = cft + first_slot + (j - first_node)*w;
+                    const value_type* cft_lo = cft + lo[j];
+                    const value_type* cft_hi = cft + hi[j];
+#pragma omp simd
+                    for(size_t k=0; k<w; ++k)
+                        cft_j[k] = std::min(lo_cost[k] + cft_lo[k], hi_cost[k] + cft_hi[k]);
+                }
+            }
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::forward_step(const size_t group_layer)
+        {
+            const size_t w = width(group_layer);
+            const int first_layer = group_layer_offsets_[group_layer];
+            const int first_node = group_layer_node_offsets_[group_layer];
+            const int last_node = group_layer_node_offsets_[group_layer+1];
+            const int first_slot = group_layer_slot_offsets_[group_layer];
+            value_type* cfr = cost_from_root_.data();
+
+            if(w == 1)
+            {
+                // scatter with conflicts between nodes of the same layer, not vectorized
+                const value_type lo_cost = lo_cost_[first_layer];
+                const value_type hi_cost = hi_cost_[first_layer];
+                for(int j=first_node; j<last_node; ++j)
+                {
+                    const value_type m = cfr[first_slot + (j - first_node)];
+                    const int lo = lo_bdd_node_index_[j];
+                    if(lo < top_sink_index_)
+                        cfr[lo] = std::min(cfr[lo], m + lo_cost);
+                    const int hi = hi_bdd_node_index_[j];
+                    if(hi < top_sink_index_)
+                        cfr[hi] = std::min(cfr[hi], m + hi_cost);
+                }
+            }
+            else
+            {
+                // lanes never conflict
+                const value_type* lo_cost = lo_cost_.data() + first_layer;
+                const value_type* hi_cost = hi_cost_.data() + first_layer;
+                for(int j=first_node; j<last_node; ++j)
+                {
+                    const value_type* m = cfr + first_slot + (j - first_node)*w;
+                    const int lo = lo_bdd_node_index_[j];
+                    if(lo < top_sink_index_)
+                    {
+                        value_type* cfr_lo = cfr + lo;
+#pragma omp simd
+                        for(size_t k=0; k<w; ++k)
+                            cfr_lo[k] = std::min(cfr_lo[k], m[k] + lo_cost[k]);
+                    }
+                    const int hi = hi_bdd_node_index_[j];
+                    if(hi < top_sink_index_)
+                    {
+                        value_type* cfr_hi = cfr + hi;
+#pragma omp simd
+                        for(size_t k=0; k<w; ++k)
+                            cfr_hi[k] = std::min(cfr_hi[k], m[k] + hi_cost[k]);
+                    }
+                }
+            }
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::forward_run()
+        {
+            MEASURE_CUMULATIVE_FUNCTION_EXECUTION_TIME2("simd parallel mma forward_run");
+            if(forward_state_valid_)
+                return;
+
+            std::fill(cost_from_root_.begin(), cost_from_root_.begin() + nr_node_slots_, std::numeric_limits<value_type>::infinity());
+            for(const int root : root_slots_)
+                cost_from_root_[root] = 0.0;
+#pragma omp parallel
+            for(size_t hop=0; hop<nr_hops(); ++hop)
+            {
+                const auto [first_group_layer, last_group_layer] = hop_range(hop);
+#pragma omp for schedule(static)
+                for(size_t group_layer=first_group_layer; group_layer<last_group_layer; ++group_layer)
+                    forward_step(group_layer);
+            }
+            forward_state_valid_ = true;
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::backward_run()
+        {
+            MEASURE_CUMULATIVE_FUNCTION_EXECUTION_TIME2("simd parallel mma backward_run");
+            if(backward_state_valid_)
+                return;
+
+#pragma omp parallel
+            for(std::ptrdiff_t hop=nr_hops()-1; hop>=0; --hop)
+            {
+                const auto [first_group_layer, last_group_layer] = hop_range(hop);
+#pragma omp for schedule(static)
+                for(size_t group_layer=first_group_layer; group_layer<last_group_layer; ++group_layer)
+                    backward_step(group_layer);
+            }
+            backward_state_valid_ = true;
+        }
+
+    template<typename REAL>
+        double bdd_simd_parallel_mma_base<REAL>::lower_bound()
+        {
+            backward_run();
+            double lb = 0.0;
+            for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+                lb += cost_from_terminal_[root_slots_[bdd_nr]];
+            return lb + constant_;
+        }
+
+    template<typename REAL>
+        two_dim_variable_array<std::array<double,2>> bdd_simd_parallel_mma_base<REAL>::min_marginals()
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            backward_run();
+            forward_run();
+
+#pragma omp parallel for schedule(static,512)
+            for(size_t group_layer=0; group_layer<nr_group_layers(); ++group_layer)
+                group_layer_min_marginals(group_layer, layer_delta_.data() + group_layer_offsets_[group_layer]);
+
+            two_dim_variable_array<std::array<double,2>> mms(num_bdds_per_var_);
+            for(size_t var=0; var<nr_variables(); ++var)
+                for(size_t i=0; i<variable_layers_.size(var); ++i)
+                {
+                    const auto mm = layer_delta_[variable_layers_(var, i)];
+                    mms(var, i) = {mm[0], mm[1]};
+                }
+            return mms;
+        }
+
+    template<typename REAL>
+        template<typename STEP_FUNC>
+        void bdd_simd_parallel_mma_base<REAL>::mm_group_layer_update(const size_t group_layer, const value_type omega, const std::vector<std::array<value_type,2>>& delta_in, STEP_FUNC step_func)
+        {
+            std::array<std::array<value_type,2>,batch_width> cur_mms;
+            group_layer_min_marginals(group_layer, cur_mms.data());
+
+            const int first_layer = group_layer_offsets_[group_layer];
+            for(int layer=first_layer; layer<group_layer_offsets_[group_layer+1]; ++layer)
+            {
+                const auto& cur_mm = cur_mms[layer - first_layer];
+                const size_t var = primal_variable_index_[layer];
+
+                std::array<value_type,2> d = {0.0, 0.0};
+                if(!std::isfinite(cur_mm[0]))
+                {
+                    d[0] = std::numeric_limits<value_type>::infinity();
+                    lo_cost_[layer] = std::numeric_limits<value_type>::infinity();
+                }
+                if(!std::isfinite(cur_mm[1]))
+                {
+                    d[1] = std::numeric_limits<value_type>::infinity();
+                    hi_cost_[layer] = std::numeric_limits<value_type>::infinity();
+                }
+                if(std::isfinite(cur_mm[0]) && std::isfinite(cur_mm[1]))
+                {
+                    if(cur_mm[0] < cur_mm[1])
+                    {
+                        d[1] = omega*(cur_mm[1] - cur_mm[0]);
+                        hi_cost_[layer] += omega*(cur_mm[0] - cur_mm[1]);
+                    }
+                    else
+                    {
+                        d[0] = omega*(cur_mm[0] - cur_mm[1]);
+                        lo_cost_[layer] += omega*(cur_mm[1] - cur_mm[0]);
+                    }
+                }
+                layer_delta_[layer] = d;
+
+                lo_cost_[layer] += delta_in[var][0];
+                hi_cost_[layer] += delta_in[var][1];
+            }
+            step_func(group_layer);
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::gather_delta(std::vector<std::array<value_type,2>>& delta_out) const
+        {
+            assert(delta_out.size() == nr_variables());
+#pragma omp parallel for schedule(static,512)
+            for(size_t var=0; var<nr_variables(); ++var)
+            {
+                std::array<value_type,2> d = {0.0, 0.0};
+                for(const int layer : variable_layers_[var])
+                {
+                    d[0] += layer_delta_[layer][0];
+                    d[1] += layer_delta_[layer][1];
+                }
+                delta_out[var] = d;
+            }
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::forward_mm(const value_type omega, std::vector<std::array<value_type,2>>& delta)
+        {
+            MEASURE_CUMULATIVE_FUNCTION_EXECUTION_TIME2("simd parallel mma forward mm");
+            assert(delta.size() == nr_variables());
+            assert(omega > 0.0 && omega <= 1.0);
+            backward_run();
+            delta_out_.resize(nr_variables());
+
+            std::fill(cost_from_root_.begin(), cost_from_root_.begin() + nr_node_slots_, std::numeric_limits<value_type>::infinity());
+            for(const int root : root_slots_)
+                cost_from_root_[root] = 0.0;
+#pragma omp parallel
+            for(size_t hop=0; hop<nr_hops(); ++hop)
+            {
+                const auto [first_group_layer, last_group_layer] = hop_range(hop);
+#pragma omp for schedule(static)
+                for(size_t group_layer=first_group_layer; group_layer<last_group_layer; ++group_layer)
+                    mm_group_layer_update(group_layer, omega, delta, [&](const size_t gl) { forward_step(gl); });
+            }
+            gather_delta(delta_out_);
+            std::swap(delta_out_, delta);
+
+            forward_state_valid_ = true;
+            backward_state_valid_ = false;
+        }
+
+    template<typename REAL>
+        double bdd_simd_parallel_mma_base<REAL>::backward_mm(const value_type omega, std::vector<std::array<value_type,2>>& delta)
+        {
+            MEASURE_CUMULATIVE_FUNCTION_EXECUTION_TIME2("simd parallel mma backward mm");
+            assert(delta.size() == nr_variables());
+            assert(omega > 0.0 && omega <= 1.0);
+            forward_run();
+            delta_out_.resize(nr_variables());
+
+#pragma omp parallel
+            for(std::ptrdiff_t hop=nr_hops()-1; hop>=0; --hop)
+            {
+                const auto [first_group_layer, last_group_layer] = hop_range(hop);
+#pragma omp for schedule(static)
+                for(size_t group_layer=first_group_layer; group_layer<last_group_layer; ++group_layer)
+                    mm_group_layer_update(group_layer, omega, delta, [&](const size_t gl) { backward_step(gl); });
+            }
+            gather_delta(delta_out_);
+            std::swap(delta_out_, delta);
+
+            forward_state_valid_ = false;
+            backward_state_valid_ = true;
+            return lower_bound() - constant_;
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::iteration()
+        {
+            backward_run();
+
+            if(delta_in_.size() == 0)
+                delta_in_.resize(nr_variables(), std::array<value_type,2>{0.0, 0.0});
+            else
+                assert(delta_in_.size() == nr_variables());
+
+            auto average_mms = [&](std::vector<std::array<value_type,2>>& mms) {
+#pragma omp parallel for
+                for(size_t var=0; var<nr_variables(); ++var)
+                {
+                    if(nr_bdds(var) > 0)
+                    {
+                        mms[var][0] /= value_type(nr_bdds(var));
+                        mms[var][1] /= value_type(nr_bdds(var));
+                    }
+                }
+            };
+
+            {
+                MEASURE_CUMULATIVE_FUNCTION_EXECUTION_TIME2("simd parallel mma incremental marginal computation");
+                forward_mm(0.5, delta_in_);
+                average_mms(delta_in_);
+                backward_mm(0.5, delta_in_);
+                average_mms(delta_in_);
+            }
+        }
+
+    template<typename REAL>
+        void bdd_simd_parallel_mma_base<REAL>::distribute_delta()
+        {
+            forward_state_valid_ = false;
+            backward_state_valid_ = false;
+
+            assert(delta_in_.size() == nr_variables());
+#pragma omp parallel for schedule(static,512)
+            for(size_t layer=0; layer<nr_layers(); ++layer)
+            {
+                const size_t var = primal_variable_index_[layer];
+                lo_cost_[layer] += delta_in_[var][0];
+                hi_cost_[layer] += delta_in_[var][1];
+            }
+
+            std::fill(delta_in_.begin(), delta_in_.end(), std::array<value_type,2>{0.0, 0.0});
+        }
+
+}
@@ -8,11 +8,15 @@
 #include "bdd_cuda.h"
 #include "bdd_parallel_mma.h"
 #include "bdd_parallel_mma_smooth.h"
+#include "bdd_simd_parallel_mma.h"
 #include "bdd_multi_parallel_mma.h"
 #include "bdd_lbfgs_parallel_mma.h"
 #include "bdd_lbfgs_cuda_mma.h"
 #include "bdd_subgradient.h"
 #include "incremental_mm_agreement_rounding.hxx"
+#include "bdd_primal_propagator.h"
+#include "bdd_dual_state.h"
+#include "primal_local_search.h"
 #include <variant> 
 #include <optional>
 #include <CLI/CLI.hpp>
@@ -37,6 +41,11 @@ namespace LPMP {
 
         std::string input_file;
         std::string input_string;
+        bool parallel_parse = false;
+        std::string bdd_cache_directory = "";
+        size_t memo_cache_memory_mb = BDD::memo_cache::default_max_memory >> 20;
+        std::string warm_start_file = "";
+        std::string export_dual_state_file = "";
         bool take_cost_logarithms = false;
         enum class optimization_type { minimization, maximization } optimization = optimization_type::minimization;
         ILP_input ilp;
@@ -49,7 +58,7 @@ namespace LPMP {
         double time_limit = 3600;
         //////////////////////////
 
-        enum class bdd_solver_impl { sequential_mma, mma_cuda, parallel_mma, hybrid_parallel_mma, lbfgs_cuda_mma, lbfgs_parallel_mma, subgradient } bdd_solver_impl_;
+        enum class bdd_solver_impl { sequential_mma, mma_cuda, parallel_mma, simd_parallel_mma, hybrid_parallel_mma, lbfgs_cuda_mma, lbfgs_parallel_mma, subgradient, portfolio } bdd_solver_impl_;
         enum class bdd_solver_precision { single_prec, double_prec } bdd_solver_precision_ = bdd_solver_precision::double_prec;
         bool solution_statistics = false;
 
@@ -57,6 +66,18 @@ namespace LPMP {
 
         bool tighten = false;
 
+        // parallel mma solver options //
+        bool parallel_mma_atomic_free = false;
+        bool deterministic = false;
+        // solve connected components with separate solvers and termination criteria concurrently
+        bool decompose = false;
+        /////////////////////////////////
+
+        // solver portfolio options //
+        // seconds between comparisons of lower bound progress of the racing solvers
+        double portfolio_interval = 1.0;
+        //////////////////////////////
+
         // cuda solver options //
         bool cuda_split_long_bdds = false;
         bool cuda_split_long_bdds_implication_bdd = false;
@@ -76,6 +97,9 @@ namespace LPMP {
         double incremental_growth_rate = 1.2;
         int incremental_primal_num_itr_lb = 500;
         int incremental_primal_rounding_num_itr = 500;
+        size_t incremental_primal_trajectories = 1; // for mma, parallel mma and lbfgs parallel mma
+        bool incremental_primal_stop_at_first = false;
+        bool incremental_primal_propagation = false;
         //////////////////////////////////////
 
         // Wedelin rounding //
@@ -89,9 +113,12 @@ namespace LPMP {
         double wedelin_kappa_step = 0.0001; // [10^-4, 10^-2]
         //////////////////////
 
+        double local_search_time = 0.0; // seconds for improving rounded solutions by local search
+
         bool statistics = false;
         std::string export_bdd_lp_file = "";
         std::string export_lp_file = "";
+        std::string export_binary_file = "";
         std::string export_bdd_graph_file = "";
 
         // export difficult part of the problems including zero and undecided min-marginals 
@@ -118,14 +145,20 @@ namespace LPMP {
             void fix_variable(const std::string& var, const bool value);
             two_dim_variable_array<std::array<double,2>> min_marginals();
             void export_difficult_core();
+            // store reparametrized costs for warm starting later runs on the same BDDs
+            void export_dual_state();
 
         private:
             //bdd_preprocessor preprocess(ILP_input& ilp);
             bdd_solver_options options;
+            std::tuple<double, std::vector<char>> round_dual();
+            // min-marginals in the variable order of the solver
+            two_dim_variable_array<std::array<double,2>> solver_min_marginals();
             using solver_type = std::variant<
                 bdd_mma<float>, bdd_mma<double>, bdd_mma_smooth<float>, bdd_mma_smooth<double>,
                 bdd_cuda<float>, bdd_cuda<double>,
                 bdd_parallel_mma<float>, bdd_parallel_mma<double>, bdd_parallel_mma_smooth<float>, bdd_parallel_mma_smooth<double>,
+                bdd_simd_parallel_mma<float>, bdd_simd_parallel_mma<double>,
                 bdd_multi_parallel_mma<float>, bdd_multi_parallel_mma<double>,
                 bdd_lbfgs_parallel_mma<double>,
                 bdd_lbfgs_parallel_mma<float>,
@@ -135,7 +168,32 @@ namespace LPMP {
                 bdd_subgradient<double>
                     >;
             std::optional<solver_type> solver;
+
+            // solvers for independent subproblems in decomposition mode, ordered by decreasing size
+            std::vector<solver_type> component_solvers;
+            std::vector<std::vector<size_t>> component_variables;
+            size_t nr_large_components = 0;
+            double component_constant = 0.0; // constant of ILP and costs of variables not covered by any subproblem
+            bool construct_component_solvers(BDD::bdd_collection& bdd_col);
+            void solve_components();
+
+            // portfolio mode: solver holds the first racing solver and after solving the winner, runners-up that were not dropped are kept for rounding
+            std::vector<solver_type> portfolio_solvers;
+            std::vector<std::string> portfolio_names; // names of solver and portfolio_solvers
+            void construct_portfolio(BDD::bdd_collection& bdd_col);
+            void solve_portfolio();
             std::vector<double> costs;
+            bdd_dual_state::key_type dual_state_key;
+
+            // copies of the solver rounding_solvers_source for running additional incremental rounding trajectories
+            std::vector<solver_type> rounding_solvers;
+            const void* rounding_solvers_source = nullptr;
+
+            // completion of rounded solutions by propagation through the BDDs of the problem
+            std::optional<bdd_primal_propagator> primal_propagator;
+
+            // initialize solver with dual state of an earlier run and apply the difference of objectives
+            void warm_start();
     };
 
 }
@@ -4,7 +4,10 @@
 #include "bdd_collection/bdd_collection.h"
 #include "union_find.hxx"
 #include "min_marginal_utils.h"
+#include "bdd_logging.h"
+#include "time_measure_util.h"
 #include <unordered_set>
+#include <queue>
 #include <fstream> // TODO: remove
 
 namespace LPMP {
@@ -76,7 +79,7 @@ namespace LPMP {
         not_set 
     };
 
-    std::vector<variable_fixation> variable_fixations(const std::vector<float>& min_marg_diffs, const float eps)
+    inline std::vector<variable_fixation> variable_fixations(const std::vector<float>& min_marg_diffs, const float eps)
     {
         // compute variables to relax
         std::vector<variable_fixation> var_fixes;
@@ -271,4 +274,204 @@ namespace LPMP {
             }
         }
 
+    // import BDD from bdd_collection into bdd manager with variables mapped through var_map.
+    // The BDD may have any variable order, the bdd manager orders variables by their index.
+    template<typename VAR_MAP>
+        BDD::node_ref import_bdd(BDD::bdd_mgr& mgr, const BDD::bdd_collection& bdd_col, const size_t bdd_nr, const VAR_MAP& var_map)
+        {
+            const auto [begin, end] = bdd_col.get_bdd_instructions(bdd_nr);
+            const size_t offset = bdd_col.offset(bdd_nr);
+            std::vector<BDD::node_ref> nodes(std::distance(begin, end));
+            for(std::ptrdiff_t i=nodes.size()-1; i>=0; --i)
+            {
+                const BDD::bdd_instruction& instr = *(begin + i);
+                if(instr.is_botsink())
+                    nodes[i] = mgr.botsink();
+                else if(instr.is_topsink())
+                    nodes[i] = mgr.topsink();
+                else
+                {
+                    assert(var_map.count(instr.index) > 0);
+                    nodes[i] = mgr.ite_rec(mgr.projection(var_map.find(instr.index)->second), nodes[instr.hi - offset], nodes[instr.lo - offset]);
+                }
+            }
+            return nodes[0];
+        }
+
+    // tighten the relaxation of solvers derived from bdd_parallel_mma_base.
+    // BDDs covering variables with zero min-marginal difference are grouped along shared such variables, groups are intersected concurrently, each with its own bdd manager.
+    // Intersections are appended to the running solver and receive the costs of the BDDs they were built from, hence the lower bound does not decrease.
+    // Returns number of added BDDs.
+    template<typename BDD_SOLVER>
+        size_t tighten_parallel(BDD_SOLVER& s, const double eps, const size_t max_group_size = 8, const size_t max_nr_bdd_nodes = 10000)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            assert(eps >= 0.0 && max_group_size >= 2);
+            const double lb_before = s.lower_bound();
+
+            const two_dim_variable_array<std::array<double,2>> min_marginals = s.min_marginals();
+            const std::vector<double> min_marg_diffs = min_marginal_differences(min_marginals, eps);
+
+            // BDDs covering undecided variables
+            std::vector<size_t> candidate_bdds;
+            std::vector<std::vector<size_t>> var_candidates(min_marg_diffs.size());
+            for(size_t bdd_nr=0; bdd_nr<s.nr_bdds(); ++bdd_nr)
+            {
+                bool candidate = false;
+                for(const size_t v : s.variables(bdd_nr))
+                    if(std::abs(min_marg_diffs[v]) <= eps)
+                    {
+                        var_candidates[v].push_back(candidate_bdds.size());
+                        candidate = true;
+                    }
+                if(candidate)
+                    candidate_bdds.push_back(bdd_nr);
+            }
+
+            // traverse BDDs along shared undecided variables and cut traversal order into groups
+            std::vector<std::vector<size_t>> groups;
+            std::vector<char> visited(candidate_bdds.size(), false);
+            for(size_t c=0; c<candidate_bdds.size(); ++c)
+            {
+                if(visited[c])
+                    continue;
+                std::vector<size_t> group;
+                std::queue<size_t> q;
+                q.push(c);
+                visited[c] = true;
+                while(!q.empty())
+                {
+                    const size_t i = q.front();
+                    q.pop();
+                    group.push_back(candidate_bdds[i]);
+                    if(group.size() == max_group_size)
+                    {
+                        groups.push_back(group);
+                        group.clear();
+                    }
+                    for(const size_t v : s.variables(candidate_bdds[i]))
+                        for(const size_t j : var_candidates[v])
+                            if(!visited[j])
+                            {
+                                visited[j] = true;
+                                q.push(j);
+                            }
+                }
+                if(group.size() > 1)
+                    groups.push_back(group);
+            }
+            bdd_log << "[tighten] " << candidate_bdds.size() << " BDDs cover undecided variables, intersect " << groups.size() << " groups\n";
+
+            // intersect groups concurrently
+            std::vector<BDD::bdd_collection> intersections(groups.size());
+            std::vector<char> intersected(groups.size(), false);
+#pragma omp parallel for schedule(dynamic)
+            for(size_t g=0; g<groups.size(); ++g)
+            {
+                // variables of the group are numbered contiguously in the bdd manager, preserving their order
+                std::vector<size_t> group_vars;
+                for(const size_t bdd_nr : groups[g])
+                {
+                    const auto vars = s.variables(bdd_nr);
+                    group_vars.insert(group_vars.end(), vars.begin(), vars.end());
+                }
+                std::sort(group_vars.begin(), group_vars.end());
+                group_vars.erase(std::unique(group_vars.begin(), group_vars.end()), group_vars.end());
+                std::unordered_map<size_t,size_t> var_map;
+                for(size_t i=0; i<group_vars.size(); ++i)
+                    var_map.insert({group_vars[i], i});
+
+                BDD::bdd_mgr mgr;
+                BDD::bdd_collection exported;
+                BDD::node_ref intersect = mgr.topsink();
+                bool too_large = false;
+                for(const size_t bdd_nr : groups[g])
+                {
+                    const size_t exported_bdd_nr = s.export_bdd(exported, bdd_nr);
+                    const auto [r, nr_nodes] = mgr.and_rec_limited(intersect, import_bdd(mgr, exported, exported_bdd_nr, var_map), max_nr_bdd_nodes);
+                    if(r.address() == nullptr)
+                    {
+                        too_large = true;
+                        break;
+                    }
+                    intersect = r;
+                }
+                if(too_large || intersect.is_terminal())
+                    continue;
+
+                BDD::bdd_collection& bdd_col = intersections[g];
+                const size_t intersect_bdd_nr = bdd_col.add_bdd(intersect);
+                // costs can only be moved if the intersection covers all variables of the group
+                if(bdd_col.nr_variables(intersect_bdd_nr) != group_vars.size())
+                    continue;
+                bdd_col.rebase(intersect_bdd_nr, group_vars.begin(), group_vars.end());
+                bdd_col.reorder(intersect_bdd_nr);
+                const size_t qbdd_nr = bdd_col.is_qbdd(intersect_bdd_nr) ? intersect_bdd_nr : bdd_col.make_qbdd(intersect_bdd_nr);
+                if(bdd_col.nr_bdd_nodes(qbdd_nr) > max_nr_bdd_nodes)
+                    continue;
+                std::vector<size_t> to_remove;
+                for(size_t bdd_nr=0; bdd_nr<bdd_col.nr_bdds(); ++bdd_nr)
+                    if(bdd_nr != qbdd_nr)
+                        to_remove.push_back(bdd_nr);
+                bdd_col.remove(to_remove.begin(), to_remove.end());
+                assert(bdd_col.nr_bdds() == 1 && bdd_col.is_qbdd(0) && bdd_col.is_reordered(0));
+                intersected[g] = true;
+            }
+
+            std::vector<size_t> added_groups;
+            std::vector<BDD::bdd_collection> added_intersections;
+            for(size_t g=0; g<groups.size(); ++g)
+                if(intersected[g])
+                {
+                    added_groups.push_back(g);
+                    added_intersections.push_back(std::move(intersections[g]));
+                }
+            if(added_groups.empty())
+            {
+                bdd_log << "[tighten] no intersections added\n";
+                return 0;
+            }
+            BDD::bdd_collection new_bdds;
+            new_bdds.append(added_intersections);
+            const size_t first_new_bdd_nr = s.nr_bdds();
+            s.add_bdds(new_bdds);
+
+            // move costs of intersected BDDs to their intersection.
+            // Cost deltas are computed in parallel, but applied sequentially, since solvers do not support concurrent cost updates.
+            std::vector<std::vector<std::array<double,2>>> new_bdd_costs(added_groups.size());
+            std::vector<std::vector<std::vector<std::array<double,2>>>> group_cost_deltas(added_groups.size());
+#pragma omp parallel for schedule(dynamic)
+            for(size_t i=0; i<added_groups.size(); ++i)
+            {
+                const std::vector<size_t> new_bdd_vars = s.variables(first_new_bdd_nr + i);
+                new_bdd_costs[i].resize(new_bdd_vars.size(), {0.0, 0.0});
+                for(const size_t bdd_nr : groups[added_groups[i]])
+                {
+                    const auto costs = s.get_costs(bdd_nr);
+                    const std::vector<size_t> vars = s.variables(bdd_nr);
+                    std::vector<std::array<double,2>> cost_delta(vars.size());
+                    for(size_t idx=0; idx<vars.size(); ++idx)
+                    {
+                        const size_t new_idx = std::lower_bound(new_bdd_vars.begin(), new_bdd_vars.end(), vars[idx]) - new_bdd_vars.begin();
+                        assert(new_idx < new_bdd_vars.size() && new_bdd_vars[new_idx] == vars[idx]);
+                        new_bdd_costs[i][new_idx][0] += costs[idx][0];
+                        new_bdd_costs[i][new_idx][1] += costs[idx][1];
+                        cost_delta[idx] = {-costs[idx][0], -costs[idx][1]};
+                    }
+                    group_cost_deltas[i].push_back(std::move(cost_delta));
+                }
+            }
+
+            for(size_t i=0; i<added_groups.size(); ++i)
+            {
+                const std::vector<size_t>& group = groups[added_groups[i]];
+                for(size_t j=0; j<group.size(); ++j)
+                    s.update_costs(group[j], group_cost_deltas[i][j].begin(), group_cost_deltas[i][j].end());
+                s.update_costs(first_new_bdd_nr + i, new_bdd_costs[i].begin(), new_bdd_costs[i].end());
+            }
+
+            bdd_log << "[tighten] added " << added_groups.size() << " intersection BDDs, lower bound before = " << lb_before << ", after = " << s.lower_bound() << "\n";
+            return added_groups.size();
+        }
+
 }
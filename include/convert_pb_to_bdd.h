@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bdd_manager/bdd.h"
+#include "bdd_collection/bdd_collection.h"
 #include "ILP_input.h"
 #include "hash_helper.hxx"
 #include <tsl/robin_map.h>
@@ -9,9 +10,40 @@
 #include <stack>
 #include <numeric>
 #include <tuple>
+#include <deque>
+#include <atomic>
+#include <shared_mutex>
 #include <iostream> // TODO: remove
 
 namespace LPMP {
+
+    // process-wide cache of BDDs for linear inequalities, keyed by their normal form.
+    // Entries are quasi-reduced BDDs on variables 0,...,n-1 and are shared by the bdd_converters of all threads.
+    class bdd_shape_cache {
+        public:
+            struct shape {
+                bool topsink = false;
+                bool botsink = false;
+                BDD::bdd_collection bdd_col; // holds exactly one BDD if not terminal
+            };
+
+            // return cached shape or nullptr
+            const shape* find(const std::vector<int>& nf, const ILP_input::inequality_type ineq_type) const;
+            // return inserted shape or the one inserted concurrently by another thread
+            const shape& insert(const std::vector<int>& nf, const ILP_input::inequality_type ineq_type, shape&& s);
+
+            size_t nr_hits() const { return nr_hits_; }
+            size_t nr_misses() const { return nr_misses_; }
+            size_t nr_shapes() const;
+
+        private:
+            mutable std::shared_mutex mutex_;
+            tsl::robin_map<std::vector<int>,size_t> equality_shapes_;
+            tsl::robin_map<std::vector<int>,size_t> lower_equal_shapes_;
+            std::deque<shape> shapes_;
+            mutable std::atomic<size_t> nr_hits_ = 0;
+            mutable std::atomic<size_t> nr_misses_ = 0;
+    };
     
     // convert linear inequalities to BDDs
     class bdd_converter {
@@ -26,6 +58,9 @@ namespace LPMP {
 
             BDD::node_ref convert_to_bdd(const std::vector<int>& coefficients, const ILP_input::inequality_type ineq_type, const int right_hand_side);
 
+            // quasi-reduced BDD on variables 0,...,n-1 for the inequality, looked up in and added to the shared cache
+            const bdd_shape_cache::shape& convert_to_bdd(const std::vector<int>& coefficients, const ILP_input::inequality_type ineq_type, const int right_hand_side, bdd_shape_cache& shape_cache);
+
             BDD::node_ref convert_nonlinear_to_bdd(const std::vector<size_t>& monomial_degrees, const std::vector<int>& coefficients, const ILP_input::inequality_type ineq_type, const int right_hand_side);
 
             // use the method from "A new look at BDDs for pseudo-Boolean constraints" from Abio et al for linear inequality conversion.
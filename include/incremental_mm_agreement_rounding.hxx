@@ -8,7 +8,12 @@
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <atomic>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "mm_primal_decoder.h"
+#include "bdd_primal_propagator.h"
 #include "time_measure_util.h"
 #include "two_dimensional_variable_array.hxx"
 #include "run_solver_util.h"
@@ -43,114 +48,224 @@ namespace LPMP {
             auto distribute_delta(S& solver, double) -> void { } 
     }
 
-    template<typename SOLVER>
-        std::vector<char> incremental_mm_agreement_rounding_iter(SOLVER& s, double init_delta = std::numeric_limits<double>::infinity(), const double delta_growth_rate = 1.1, const int num_itr_lb = 100, const int num_rounding_itr = 500)
-        {
-            MEASURE_FUNCTION_EXECUTION_TIME;
-            assert(init_delta > 0.0);
-            assert(delta_growth_rate >= 1.0);
-
-            const auto start_time = std::chrono::steady_clock::now();
-
-            if(init_delta == std::numeric_limits<double>::infinity())
-                init_delta = compute_initial_delta(s.min_marginals());
-
-            std::cout << "[incremental primal rounding] initial perturbation delta = " << init_delta << ", growth rate for perturbation " << delta_growth_rate << "\n";
-
-            double cur_delta = 1.0/delta_growth_rate * init_delta;
-
-            //std::random_device rd;
-            //std::mt19937 gen(rd);
-            std::default_random_engine gen{static_cast<long unsigned int>(0)}; // deterministic seed for repeatable experiments
-
-            for(size_t round=0; round<num_rounding_itr; ++round)
+    namespace detail {
+        // one perturbation trajectory of incremental rounding. Returns early without solution when stop is set by another trajectory.
+        // If a propagator is given, every round first tries to complete the min-marginals to a solution by propagation before perturbing costs.
+        template<typename SOLVER>
+            std::vector<char> incremental_mm_agreement_rounding_trajectory(SOLVER& s, const double init_delta, const double delta_growth_rate, const int num_itr_lb, const int num_rounding_itr, const size_t seed, const std::atomic<bool>& stop, const bool verbose, const bdd_primal_propagator* propagator)
             {
-                cur_delta = std::min(cur_delta*delta_growth_rate, 1e6);
-                const auto time = std::chrono::steady_clock::now();
-                const double time_elapsed = (double) std::chrono::duration_cast<std::chrono::milliseconds>(time - start_time).count() / 1000;
-                std::cout << "[incremental primal rounding] round " << round << ", cost delta " << cur_delta << ", time elapsed = " << time_elapsed << "\n";
+                const auto start_time = std::chrono::steady_clock::now();
 
-                // flush stored computations to get best min marginals
-                detail::distribute_delta(s, 0);
+                double cur_delta = 1.0/delta_growth_rate * init_delta;
 
-                const auto mms = mm_primal_decoder(s.min_marginals());
-                const auto [nr_one_mms, nr_zero_mms, nr_equal_mms, nr_inconsistent_mms] = mms.mm_type_statistics();
-                assert(nr_one_mms + nr_zero_mms + nr_equal_mms + nr_inconsistent_mms == s.nr_variables());
+                //std::random_device rd;
+                //std::mt19937 gen(rd);
+                std::default_random_engine gen{static_cast<long unsigned int>(seed)}; // deterministic seed for repeatable experiments
 
-                const int old_precision = std::cout.precision();
-                std::cout << std::setprecision(2);
-                std::cout << "[incremental primal rounding] " <<
-                    "#one min-marg diffs = " << nr_one_mms << " % " << double(100*nr_one_mms)/double(s.nr_variables()) << ", " <<  
-                    "#zero min-marg diffs = " << nr_zero_mms << " % " << double(100*nr_zero_mms)/double(s.nr_variables()) << ", " << 
-                    "#equal min-marg diffs = " << nr_equal_mms << " % " << double(100*nr_equal_mms)/double(s.nr_variables()) << ", " << 
-                    "#inconsistent min-marg diffs = " << nr_inconsistent_mms << " % " << double(100*nr_inconsistent_mms)/double(s.nr_variables()) << "\n";
-                std::cout << std::setprecision(old_precision);
-
-                std::uniform_real_distribution<> dis(-cur_delta, cur_delta);
-
-                if(nr_one_mms + nr_zero_mms == s.nr_variables())
+                for(size_t round=0; round<num_rounding_itr; ++round)
                 {
-                    std::cout << "[incremental primal rounding] Found feasible solution\n";
-                    return mms.solution_from_mms();
-                }
+                    if(stop)
+                        return {};
+                    cur_delta = std::min(cur_delta*delta_growth_rate, 1e6);
+                    const auto time = std::chrono::steady_clock::now();
+                    const double time_elapsed = (double) std::chrono::duration_cast<std::chrono::milliseconds>(time - start_time).count() / 1000;
+                    if(verbose)
+                        std::cout << "[incremental primal rounding] round " << round << ", cost delta " << cur_delta << ", time elapsed = " << time_elapsed << "\n";
+
+                    // flush stored computations to get best min marginals
+                    detail::distribute_delta(s, 0);
+
+                    const auto mms = mm_primal_decoder(s.min_marginals());
+                    const auto [nr_one_mms, nr_zero_mms, nr_equal_mms, nr_inconsistent_mms] = mms.mm_type_statistics();
+                    assert(nr_one_mms + nr_zero_mms + nr_equal_mms + nr_inconsistent_mms == s.nr_variables());
+
+                    if(verbose)
+                    {
+                        const int old_precision = std::cout.precision();
+                        std::cout << std::setprecision(2);
+                        std::cout << "[incremental primal rounding] " <<
+                            "#one min-marg diffs = " << nr_one_mms << " % " << double(100*nr_one_mms)/double(s.nr_variables()) << ", " <<  
+                            "#zero min-marg diffs = " << nr_zero_mms << " % " << double(100*nr_zero_mms)/double(s.nr_variables()) << ", " << 
+                            "#equal min-marg diffs = " << nr_equal_mms << " % " << double(100*nr_equal_mms)/double(s.nr_variables()) << ", " << 
+                            "#inconsistent min-marg diffs = " << nr_inconsistent_mms << " % " << double(100*nr_inconsistent_mms)/double(s.nr_variables()) << "\n";
+                        std::cout << std::setprecision(old_precision);
+                    }
 
-                std::vector<double> cost_lo_updates(s.nr_variables(), 0.0);
-                std::vector<double> cost_hi_updates(s.nr_variables(), 0.0);
-                for(size_t i=0; i<s.nr_variables(); ++i)
-                {
-                    const mm_type mmt = mms.compute_mm_type(i);
-                    if(mmt == mm_type::one)
+                    std::uniform_real_distribution<> dis(-cur_delta, cur_delta);
+
+                    if(nr_one_mms + nr_zero_mms == s.nr_variables())
                     {
-                        cost_lo_updates[i] = cur_delta;
-                        cost_hi_updates[i] = 0.0;
+                        if(verbose)
+                            std::cout << "[incremental primal rounding] Found feasible solution\n";
+                        return mms.solution_from_mms();
                     }
-                    else if(mmt == mm_type::zero)
+
+                    if(propagator != nullptr)
                     {
-                        cost_lo_updates[i] = 0.0;
-                        cost_hi_updates[i] = cur_delta;
+                        auto sol = propagator->complete(mms);
+                        if(sol.size() > 0)
+                        {
+                            if(verbose)
+                                std::cout << "[incremental primal rounding] Found feasible solution by propagation\n";
+                            return sol;
+                        }
                     }
-                    else if(mmt == mm_type::equal)
+
+                    std::vector<double> cost_lo_updates(s.nr_variables(), 0.0);
+                    std::vector<double> cost_hi_updates(s.nr_variables(), 0.0);
+                    for(size_t i=0; i<s.nr_variables(); ++i)
                     {
-                        const double r = dis(gen);
-                        assert(-cur_delta <= r && r <= cur_delta);
-                        if(r < 0.0)
+                        const mm_type mmt = mms.compute_mm_type(i);
+                        if(mmt == mm_type::one)
                         {
-                            cost_lo_updates[i] = std::abs(r)*cur_delta;
+                            cost_lo_updates[i] = cur_delta;
                             cost_hi_updates[i] = 0.0;
                         }
-                        else
+                        else if(mmt == mm_type::zero)
                         {
                             cost_lo_updates[i] = 0.0;
-                            cost_hi_updates[i] = std::abs(r)*cur_delta;
+                            cost_hi_updates[i] = cur_delta;
                         }
-                    }
-                    else
-                    {
-                        assert(mmt == mm_type::inconsistent);
-                        const std::array<double,2> mm_sum = mms.mm_sum(i);
-                        //const double r = 5.0*dis(gen);
-                        const double r = dis(gen);
-                        if(mm_sum[0] < mm_sum[1])
+                        else if(mmt == mm_type::equal)
                         {
-                            cost_lo_updates[i] = 0.0;
-                            cost_hi_updates[i] = std::abs(r)*cur_delta;
+                            const double r = dis(gen);
+                            assert(-cur_delta <= r && r <= cur_delta);
+                            if(r < 0.0)
+                            {
+                                cost_lo_updates[i] = std::abs(r)*cur_delta;
+                                cost_hi_updates[i] = 0.0;
+                            }
+                            else
+                            {
+                                cost_lo_updates[i] = 0.0;
+                                cost_hi_updates[i] = std::abs(r)*cur_delta;
+                            }
                         }
                         else
                         {
-                            cost_lo_updates[i] = std::abs(r)*cur_delta;
-                            cost_hi_updates[i] = 0.0;
+                            assert(mmt == mm_type::inconsistent);
+                            const std::array<double,2> mm_sum = mms.mm_sum(i);
+                            //const double r = 5.0*dis(gen);
+                            const double r = dis(gen);
+                            if(mm_sum[0] < mm_sum[1])
+                            {
+                                cost_lo_updates[i] = 0.0;
+                                cost_hi_updates[i] = std::abs(r)*cur_delta;
+                            }
+                            else
+                            {
+                                cost_lo_updates[i] = std::abs(r)*cur_delta;
+                                cost_hi_updates[i] = 0.0;
+                            }
                         }
                     }
+                    s.update_costs(cost_lo_updates.begin(), cost_lo_updates.end(), cost_hi_updates.begin(), cost_hi_updates.end());
+                    run_solver(s, num_itr_lb, 1e-7, 0.0001, std::numeric_limits<double>::max(), false);
+                    if(verbose)
+                        std::cout << "[incremental primal rounding] lower bound = " << s.lower_bound() << "\n";
                 }
-                s.update_costs(cost_lo_updates.begin(), cost_lo_updates.end(), cost_hi_updates.begin(), cost_hi_updates.end());
-                run_solver(s, num_itr_lb, 1e-7, 0.0001, std::numeric_limits<double>::max(), false);
-                std::cout << "[incremental primal rounding] lower bound = " << s.lower_bound() << "\n";
+
+                if(verbose)
+                    std::cout << "[incremental primal rounding] No solution found\n";
+                return {};
             }
+    }
 
-            std::cout << "[incremental primal rounding] No solution found\n";
-            return {};
+    template<typename SOLVER>
+        std::vector<char> incremental_mm_agreement_rounding_iter(SOLVER& s, double init_delta = std::numeric_limits<double>::infinity(), const double delta_growth_rate = 1.1, const int num_itr_lb = 100, const int num_rounding_itr = 500, const bdd_primal_propagator* propagator = nullptr)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            assert(init_delta > 0.0);
+            assert(delta_growth_rate >= 1.0);
+
+            if(init_delta == std::numeric_limits<double>::infinity())
+                init_delta = compute_initial_delta(s.min_marginals());
+
+            std::cout << "[incremental primal rounding] initial perturbation delta = " << init_delta << ", growth rate for perturbation " << delta_growth_rate << "\n";
+
+            const std::atomic<bool> stop = false;
+            return detail::incremental_mm_agreement_rounding_trajectory(s, init_delta, delta_growth_rate, num_itr_lb, num_rounding_itr, 0, stop, true, propagator);
+        }
+
+    // Run one perturbation trajectory on each of the given solvers concurrently, each with its own seed and growth rate.
+    // All solvers must hold the same dual state, trajectory 0 uses seed 0 and the given growth rate, i.e. is identical to incremental_mm_agreement_rounding_iter.
+    // The others alternately grow the perturbation slower and faster.
+    // Returns the solution with the smallest objective, or the first one found if stop_at_first_solution is set.
+    template<typename SOLVER, typename OBJECTIVE_FUNC>
+        std::vector<char> parallel_incremental_mm_agreement_rounding(const std::vector<SOLVER*>& solvers, OBJECTIVE_FUNC objective, const bool stop_at_first_solution, double init_delta = std::numeric_limits<double>::infinity(), const double delta_growth_rate = 1.1, const int num_itr_lb = 100, const int num_rounding_itr = 500, const bdd_primal_propagator* propagator = nullptr)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            assert(solvers.size() > 0);
+            assert(init_delta > 0.0);
+            assert(delta_growth_rate >= 1.0);
+
+            if(init_delta == std::numeric_limits<double>::infinity())
+                init_delta = compute_initial_delta(solvers[0]->min_marginals());
+
+            const size_t nr_trajectories = solvers.size();
+            std::vector<double> growth_rates(nr_trajectories);
+            for(size_t k=0; k<nr_trajectories; ++k)
+            {
+                const double factor = k == 0 ? 1.0 : (k % 2 == 1 ? std::pow(0.5, (k+1)/2) : std::pow(2.0, k/2));
+                growth_rates[k] = 1.0 + (delta_growth_rate - 1.0) * factor;
+            }
+
+            std::cout << "[incremental primal rounding] run " << nr_trajectories << " trajectories concurrently, initial perturbation delta = " << init_delta << "\n";
+
+            std::vector<std::vector<char>> sols(nr_trajectories);
+            std::atomic<bool> stop = false;
+            std::atomic<size_t> first_trajectory = nr_trajectories;
+
+#ifdef _OPENMP
+            const int nr_threads = omp_get_max_threads();
+            const int prev_max_active_levels = omp_get_max_active_levels();
+            omp_set_max_active_levels(2);
+#endif
+#pragma omp parallel for num_threads(nr_trajectories) schedule(static, 1)
+            for(size_t k=0; k<nr_trajectories; ++k)
+            {
+#ifdef _OPENMP
+                omp_set_num_threads(std::max(1, nr_threads / int(nr_trajectories)));
+#endif
+                sols[k] = detail::incremental_mm_agreement_rounding_trajectory(*solvers[k], init_delta, growth_rates[k], num_itr_lb, num_rounding_itr, k, stop, false, propagator);
+                if(sols[k].size() > 0)
+                {
+                    size_t no_trajectory = nr_trajectories;
+                    first_trajectory.compare_exchange_strong(no_trajectory, k);
+                    if(stop_at_first_solution)
+                        stop = true;
+                }
+            }
+#ifdef _OPENMP
+            omp_set_max_active_levels(prev_max_active_levels);
+#endif
+
+            size_t best = first_trajectory;
+            double best_obj = std::numeric_limits<double>::infinity();
+            for(size_t k=0; k<nr_trajectories; ++k)
+            {
+                if(sols[k].size() == 0)
+                {
+                    std::cout << "[incremental primal rounding] trajectory " << k << " with growth rate " << growth_rates[k] << ": " << (stop ? "stopped" : "no solution") << "\n";
+                    continue;
+                }
+                const double obj = objective(sols[k]);
+                std::cout << "[incremental primal rounding] trajectory " << k << " with growth rate " << growth_rates[k] << ": objective = " << obj << (k == first_trajectory ? ", found first" : "") << "\n";
+                if(!stop_at_first_solution && obj < best_obj)
+                {
+                    best = k;
+                    best_obj = obj;
+                }
+            }
+
+            if(best == nr_trajectories)
+            {
+                std::cout << "[incremental primal rounding] No solution found\n";
+                return {};
+            }
+            std::cout << "[incremental primal rounding] Found feasible solution in trajectory " << best << "\n";
+            return sols[best];
         }
-        
 
     // rounding inspired by Wedelin's algorithm and its refinement in "Learning parameters of the Wedelin heuristic with application to crew and bus driver scheduling"
     // this implementation does not follow the original sequential 
@@ -4,6 +4,8 @@
 #include "bdd_collection/bdd_collection.h"
 #include "time_measure_util.h"
 #include "bdd_logging.h"
+#include "two_dimensional_variable_array.hxx"
+#include <array>
 #include <deque>
 #ifdef WITH_CUDA
 #include <thrust/for_each.h>
@@ -40,10 +42,23 @@ class lbfgs : public SOLVER
         void update_costs(
             ITERATOR cost_delta_0_begin, ITERATOR cost_delta_0_end,
             ITERATOR cost_delta_1_begin, ITERATOR cost_delta_1_end);
+        // update costs of a single BDD, see bdd_parallel_mma_base::update_costs
+        template <typename COST_ITERATOR>
+        void update_costs(const size_t bdd_nr, COST_ITERATOR cost_begin, COST_ITERATOR cost_end);
+        // update costs per variable and BDD covering it, see bdd_parallel_mma_base::update_costs
+        void update_costs(const two_dim_variable_array<std::array<REAL,2>>& delta);
 #ifdef WITH_CUDA
         template<typename REAL_arg>
         void update_costs(const thrust::device_vector<REAL_arg> &cost_0, const thrust::device_vector<REAL_arg> &cost_1);
 #endif
+        // overwrite costs of all bdd branch nodes, see bdd_parallel_mma_base::set_node_costs
+        template<typename ITERATOR>
+        void set_node_costs(ITERATOR begin, ITERATOR end);
+
+        // add or remove BDDs of the running solver, the LBFGS history is discarded since the dimension of the dual space changes
+        void add_bdds(const BDD::bdd_collection& bdd_col);
+        template<typename ITERATOR>
+        void remove_bdds(ITERATOR bdd_nr_begin, ITERATOR bdd_nr_end);
 
     private:
         void store_iterate(const INT_VECTOR &grad_f);
@@ -379,6 +394,21 @@ lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::lbfgs(const BDD::bdd_collection &bdd_co
         static_cast<SOLVER*>(this)->update_costs(cost_delta_0_begin, cost_delta_0_end, cost_delta_1_begin, cost_delta_1_end);
     }
 
+    template<class SOLVER, typename VECTOR, typename REAL, typename INT_VECTOR>
+    template<typename COST_ITERATOR>
+    void lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::update_costs(const size_t bdd_nr, COST_ITERATOR cost_begin, COST_ITERATOR cost_end)
+    {
+        flush_lbfgs_states();
+        static_cast<SOLVER*>(this)->update_costs(bdd_nr, cost_begin, cost_end);
+    }
+
+    template<class SOLVER, typename VECTOR, typename REAL, typename INT_VECTOR>
+    void lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::update_costs(const two_dim_variable_array<std::array<REAL,2>>& delta)
+    {
+        flush_lbfgs_states();
+        static_cast<SOLVER*>(this)->update_costs(delta);
+    }
+
 #ifdef WITH_CUDA
     template<class SOLVER, typename VECTOR, typename REAL, typename INT_VECTOR>
     template<typename REAL_arg>
@@ -389,6 +419,33 @@ lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::lbfgs(const BDD::bdd_collection &bdd_co
     }
 #endif
 
+    template<class SOLVER, typename VECTOR, typename REAL, typename INT_VECTOR>
+    template<typename ITERATOR>
+    void lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::set_node_costs(ITERATOR begin, ITERATOR end)
+    {
+        flush_lbfgs_states();
+        static_cast<SOLVER*>(this)->set_node_costs(begin, end);
+    }
+
+    template<class SOLVER, typename VECTOR, typename REAL, typename INT_VECTOR>
+    void lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::add_bdds(const BDD::bdd_collection& bdd_col)
+    {
+        flush_lbfgs_states();
+        static_cast<SOLVER*>(this)->add_bdds(bdd_col);
+        prev_x = VECTOR(this->nr_layers());
+        prev_grad_f = INT_VECTOR(this->nr_layers());
+    }
+
+    template<class SOLVER, typename VECTOR, typename REAL, typename INT_VECTOR>
+    template<typename ITERATOR>
+    void lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::remove_bdds(ITERATOR bdd_nr_begin, ITERATOR bdd_nr_end)
+    {
+        flush_lbfgs_states();
+        static_cast<SOLVER*>(this)->remove_bdds(bdd_nr_begin, bdd_nr_end);
+        prev_x = VECTOR(this->nr_layers());
+        prev_grad_f = INT_VECTOR(this->nr_layers());
+    }
+
     template<class SOLVER, typename VECTOR, typename REAL, typename INT_VECTOR>
     void lbfgs<SOLVER, VECTOR, REAL, INT_VECTOR>::mma_iteration()
     {
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace LPMP {
+
+    // read-only memory mapping of a whole file
+    class mmap_file {
+        public:
+            mmap_file(const std::string& filename)
+            {
+                const int fd = open(filename.c_str(), O_RDONLY);
+                if(fd == -1)
+                    throw std::runtime_error("could not open file " + filename);
+                struct stat sb;
+                if(fstat(fd, &sb) == -1)
+                {
+                    close(fd);
+                    throw std::runtime_error("could not stat file " + filename);
+                }
+                size_ = sb.st_size;
+                if(size_ > 0)
+                {
+                    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if(data == MAP_FAILED)
+                    {
+                        close(fd);
+                        throw std::runtime_error("could not memory map file " + filename);
+                    }
+                    madvise(data, size_, MADV_SEQUENTIAL);
+                    data_ = static_cast<const char*>(data);
+                }
+                close(fd);
+            }
+
+            ~mmap_file()
+            {
+                if(data_ != nullptr)
+                    munmap(const_cast<char*>(data_), size_);
+            }
+
+            mmap_file(const mmap_file&) = delete;
+            mmap_file& operator=(const mmap_file&) = delete;
+
+            const char* begin() const { return data_; }
+            const char* end() const { return data_ + size_; }
+            size_t size() const { return size_; }
+
+        private:
+            const char* data_ = nullptr;
+            size_t size_ = 0;
+    };
+
+} // namespace LPMP
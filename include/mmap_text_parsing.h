@@ -0,0 +1,299 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include <cassert>
+#include <tsl/robin_map.h>
+#include "mmap_file.h"
+#include "ILP_input.h"
+#include "bdd_logging.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// building blocks for hand-written parsers of text files that are memory mapped and split into chunks parsed in parallel
+
+namespace LPMP {
+
+namespace parsing {
+
+    // cursor over a character range with the elementary rules of pegtl_parse_rules.h
+    struct scanner {
+        const char* pos;
+        const char* end;
+
+        bool eof() const { return pos == end; }
+        char peek() const { assert(!eof()); return *pos; }
+        bool at(const char c) const { return pos != end && *pos == c; }
+        bool at(const char* str) const
+        {
+            const size_t n = std::strlen(str);
+            return size_t(end - pos) >= n && std::memcmp(pos, str, n) == 0;
+        }
+        bool at_eol() const { return at('\n') || at("\r\n"); }
+        bool at_digit() const { return pos != end && *pos >= '0' && *pos <= '9'; }
+        bool at_alpha() const { return pos != end && ((*pos >= 'a' && *pos <= 'z') || (*pos >= 'A' && *pos <= 'Z')); }
+        bool at_number() const { return at_digit() || (at('.') && pos+1 != end && pos[1] >= '0' && pos[1] <= '9'); }
+
+        bool consume(const char c)
+        {
+            if(!at(c))
+                return false;
+            ++pos;
+            return true;
+        }
+        bool consume(const char* str)
+        {
+            if(!at(str))
+                return false;
+            pos += std::strlen(str);
+            return true;
+        }
+        bool consume_eol() { return consume('\n') || consume("\r\n"); }
+
+        // opt_whitespace
+        void skip_blanks()
+        {
+            while(pos != end && (*pos == ' ' || *pos == '\t'))
+                ++pos;
+        }
+        // opt_invisible
+        void skip_invisible()
+        {
+            while(pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+                ++pos;
+        }
+        void skip_line()
+        {
+            const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+            pos = eol == nullptr ? end : eol+1;
+        }
+
+        // '+' or '-', returns 1 or -1 and 0 if no sign is present
+        int sign()
+        {
+            if(consume('+'))
+                return 1;
+            if(consume('-'))
+                return -1;
+            return 0;
+        }
+
+        // decimal real number without sign, returns its characters
+        std::string_view number()
+        {
+            const char* begin = pos;
+            while(at_digit())
+                ++pos;
+            if(consume('.'))
+                while(at_digit())
+                    ++pos;
+            if(pos != begin && (at('e') || at('E')))
+            {
+                const char* mantissa_end = pos;
+                ++pos;
+                if(!consume('+'))
+                    consume('-');
+                if(!at_digit())
+                    pos = mantissa_end;
+                while(at_digit())
+                    ++pos;
+            }
+            if(pos == begin)
+                throw std::runtime_error("expected number");
+            return std::string_view(begin, pos - begin);
+        }
+
+        // value of a real number as given by std::stod
+        static double to_double(const std::string_view n)
+        {
+            double val;
+            const auto [ptr, ec] = std::from_chars(n.data(), n.data() + n.size(), val);
+            if(ec != std::errc())
+                throw std::runtime_error("could not convert " + std::string(n) + " to floating point number");
+            return val;
+        }
+
+        // value of the integral part of a real number as given by std::stoi
+        static int to_int(const std::string_view n)
+        {
+            int val;
+            const auto [ptr, ec] = std::from_chars(n.data(), n.data() + n.size(), val);
+            if(ec != std::errc())
+                throw std::runtime_error("could not convert " + std::string(n) + " to integer");
+            return val;
+        }
+
+        // identifier starting with a letter, followed by letters, digits and the given special characters
+        std::string_view identifier(const char* special_chars)
+        {
+            if(!at_alpha())
+                throw std::runtime_error("expected identifier");
+            const char* begin = pos;
+            while(pos != end && (at_alpha() || at_digit() || (*pos != '\0' && std::strchr(special_chars, *pos) != nullptr)))
+                ++pos;
+            return std::string_view(begin, pos - begin);
+        }
+    };
+
+    // split [begin,end) into at most nr_chunks ranges of roughly equal size.
+    // Ranges start at line beginnings and every range except the last one ends directly after a line for which is_boundary(line_begin, line_end) holds.
+    template<typename BOUNDARY_PRED>
+        std::vector<const char*> split_into_chunks(const char* begin, const char* end, const size_t nr_chunks, BOUNDARY_PRED is_boundary)
+        {
+            std::vector<const char*> boundaries = {begin};
+            const size_t chunk_size = (end - begin) / std::max(nr_chunks, size_t(1)) + 1;
+            for(size_t c=1; c<nr_chunks; ++c)
+            {
+                const char* pos = std::max(boundaries.back(), begin + std::min(c*chunk_size, size_t(end - begin)));
+                while(pos != end)
+                {
+                    const char* line_end = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+                    if(line_end == nullptr)
+                    {
+                        pos = end;
+                        break;
+                    }
+                    const char* line_begin = pos;
+                    while(line_begin != begin && line_begin[-1] != '\n')
+                        --line_begin;
+                    pos = line_end + 1;
+                    if(is_boundary(line_begin, line_end))
+                        break;
+                }
+                if(pos == end)
+                    break;
+                if(pos != boundaries.back())
+                    boundaries.push_back(pos);
+            }
+            boundaries.push_back(end);
+            return boundaries;
+        }
+
+    // constraints of a contiguous part of the input. Variables are numbered locally in order of first occurrence.
+    struct constraint_chunk {
+        std::vector<std::string_view> var_names;
+        tsl::robin_map<std::string_view, size_t> var_indices;
+
+        std::vector<std::string_view> identifiers; // empty if none given
+        std::vector<ILP_input::inequality_type> ineqs;
+        std::vector<int> right_hand_sides;
+        std::vector<size_t> constraint_offsets = {0}; // into coefficients
+        std::vector<int> coefficients;
+        std::vector<size_t> monomial_offsets = {0}; // into monomial_vars, one monomial per coefficient
+        std::vector<size_t> monomial_vars;
+
+        bool section_end = false; // constraints section ends inside this chunk
+        std::string error;
+
+        size_t nr_constraints() const { return ineqs.size(); }
+
+        void begin_constraint(const std::string_view identifier) { identifiers.push_back(identifier); }
+        void add_to_monomial(const std::string_view var)
+        {
+            auto it = var_indices.find(var);
+            if(it == var_indices.end())
+            {
+                it = var_indices.insert({var, var_names.size()}).first;
+                var_names.push_back(var);
+            }
+            monomial_vars.push_back(it->second);
+        }
+        void end_monomial(const int coefficient)
+        {
+            assert(monomial_vars.size() > monomial_offsets.back());
+            coefficients.push_back(coefficient);
+            monomial_offsets.push_back(monomial_vars.size());
+        }
+        void end_constraint(const ILP_input::inequality_type ineq, const int right_hand_side)
+        {
+            ineqs.push_back(ineq);
+            right_hand_sides.push_back(right_hand_side);
+            constraint_offsets.push_back(coefficients.size());
+        }
+    };
+
+    // Parse the constraints in [begin,end) in parallel and append them to ilp in the order they appear.
+    // is_boundary(line_begin, line_end) must hold only for lines on which a constraint ends.
+    // is_section_end(scanner) is checked before every constraint, parse_constraint(scanner, chunk) reads one constraint.
+    // Variables are numbered in order of first occurrence, as sequential parsing would do.
+    template<typename BOUNDARY_PRED, typename SECTION_END_PRED, typename PARSE_CONSTRAINT_FUNC>
+        void parse_constraints_parallel(ILP_input& ilp, const char* begin, const char* end, BOUNDARY_PRED is_boundary, SECTION_END_PRED is_section_end, PARSE_CONSTRAINT_FUNC parse_constraint)
+        {
+#ifdef _OPENMP
+            const size_t nr_threads = omp_get_max_threads();
+#else
+            const size_t nr_threads = 1;
+#endif
+            const std::vector<const char*> boundaries = split_into_chunks(begin, end, 4*nr_threads, is_boundary);
+            std::vector<constraint_chunk> chunks(boundaries.size()-1);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nr_threads)
+            for(size_t c=0; c<chunks.size(); ++c)
+            {
+                scanner s{boundaries[c], boundaries[c+1]};
+                try
+                {
+                    while(true)
+                    {
+                        s.skip_invisible();
+                        if(s.eof())
+                            break;
+                        if(is_section_end(s))
+                        {
+                            chunks[c].section_end = true;
+                            break;
+                        }
+                        parse_constraint(s, chunks[c]);
+                    }
+                }
+                catch(const std::exception& e)
+                {
+                    const size_t line_nr = std::count(begin, s.pos, '\n') + 1;
+                    chunks[c].error = std::string(e.what()) + " in line " + std::to_string(line_nr) + " of constraints section";
+                }
+            }
+
+            // chunks after the end of the constraints section are discarded
+            std::vector<size_t> var_map;
+            std::vector<size_t> monomial;
+            size_t nr_chunks = 0;
+            for(const constraint_chunk& chunk : chunks)
+            {
+                ++nr_chunks;
+                if(!chunk.error.empty())
+                    throw std::runtime_error(chunk.error);
+
+                var_map.resize(chunk.var_names.size());
+                for(size_t i=0; i<chunk.var_names.size(); ++i)
+                    var_map[i] = ilp.get_or_create_variable_index(std::string(chunk.var_names[i]));
+
+                for(size_t c=0; c<chunk.nr_constraints(); ++c)
+                {
+                    ilp.begin_new_inequality();
+                    ilp.set_inequality_identifier(std::string(chunk.identifiers[c]));
+                    for(size_t m=chunk.constraint_offsets[c]; m<chunk.constraint_offsets[c+1]; ++m)
+                    {
+                        monomial.clear();
+                        for(size_t i=chunk.monomial_offsets[m]; i<chunk.monomial_offsets[m+1]; ++i)
+                            monomial.push_back(var_map[chunk.monomial_vars[i]]);
+                        ilp.add_to_constraint(chunk.coefficients[m], monomial.begin(), monomial.end());
+                    }
+                    ilp.set_inequality_type(chunk.ineqs[c]);
+                    ilp.set_right_hand_side(chunk.right_hand_sides[c]);
+                }
+
+                if(chunk.section_end)
+                    break;
+            }
+            bdd_log << "[parallel parser] parsed " << ilp.nr_constraints() << " constraints in " << nr_chunks << " chunks with " << nr_threads << " threads\n";
+        }
+
+} // namespace parsing
+
+} // namespace LPMP
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "ILP_input.h"
+#include <vector>
+
+namespace LPMP {
+
+    // improves a feasible solution of an ILP by 1-flip and 2-swap moves until a local optimum or the time limit is reached.
+    // Moves must keep the solution feasible and decrease the costs, ties are broken by the reduced costs obtained from the min-marginals of the dual solver.
+    // Every round searches the best move of all variables in parallel and then applies non-conflicting moves in order of their gain.
+    // costs and reduced_costs refer to the first ilp.nr_variables() entries of sol, further entries are left untouched.
+    // Returns sol unchanged if it is not feasible.
+    std::vector<char> primal_local_search(const ILP_input& ilp, const std::vector<double>& costs, const std::vector<double>& reduced_costs, std::vector<char> sol, const double time_limit);
+
+}
@@ -26,6 +26,7 @@ namespace LPMP {
                     two_dim_variable_array(const two_dim_variable_array<I>& o);
 
                 two_dim_variable_array(const two_dim_variable_array<T>& o);
+                two_dim_variable_array<T>& operator=(const two_dim_variable_array<T>& o) = default;
 
                 // iterator holds size of each dimension of the two dimensional array
                 template<typename I>
@@ -44,6 +45,7 @@ namespace LPMP {
                 void clear();
                 template<typename ITERATOR>
                     void push_back(ITERATOR val_begin, ITERATOR val_end);
+                void pop_back();
 
                 template<typename ITERATOR>
                     void resize(ITERATOR begin, ITERATOR end);
@@ -505,4 +507,12 @@ namespace LPMP {
             }
         }
 
+    template<typename T>
+        void two_dim_variable_array<T>::pop_back()
+        {
+            assert(size() > 0);
+            offsets_.pop_back();
+            data_.resize(offsets_.back());
+        }
+
 } // namespace LPMP
@@ -2,6 +2,7 @@
 
 #include "two_dimensional_variable_array.hxx"
 #include "mm_primal_decoder.h"
+#include "ILP_evaluator.h"
 #include "run_solver_util.h"
 
 namespace LPMP {
@@ -23,6 +24,8 @@ namespace LPMP {
             std::cout << "\t\t\tkappa min = " << kappa_min << ", kappa max = " << kappa_max << ", kappa step = " << kappa_step << ", alpha = " << alpha << "\n";
 
             two_dim_variable_array<std::array<double,2>> bdd_cost_updates = s.min_marginals();
+            // all loops below are independent per variable and are run in parallel
+#pragma omp parallel for schedule(static,512)
             for(size_t i=0; i<bdd_cost_updates.size(); ++i)
                 for(size_t j=0; j<bdd_cost_updates.size(i); ++j)
                     bdd_cost_updates(i,j) = {0.0, 0.0};
@@ -31,6 +34,8 @@ namespace LPMP {
             double kappa = kappa_min;
 
             std::vector<char> solution(s.nr_variables());
+            // tracks feasibility of solution, only variables changed since the last iteration need to be flipped
+            ILP_evaluator eval(ilp);
 
             for(size_t iter=0; iter<500; ++iter)
             {
@@ -57,6 +62,7 @@ namespace LPMP {
                     solution = mms.solution_from_mms();
 
                 // initialize current bdd_cost_updates and exponentially decay perturbations
+#pragma omp parallel for schedule(static,512)
                 for(size_t i=0; i<bdd_cost_updates.size(); ++i)
                 {
                     for(size_t j=0; j<bdd_cost_updates.size(i); ++j)
@@ -70,6 +76,7 @@ namespace LPMP {
 
                 const auto bdd_feasibility = s.bdd_feasibility(solution.begin(), solution.end());
 
+#pragma omp parallel for schedule(static,512)
                 for(size_t i=0; i<bdd_feasibility.size(); ++i)
                 {
                     const bool preferred_sol = [&]() -> bool {
@@ -109,17 +116,23 @@ namespace LPMP {
                     }
                 }
 
-                // TODO: possibly bypass through bdd_feasibility from solver?
-                if(ilp.feasible(solution.begin(), solution.end()))
+                if(solution.size() == eval.nr_variables())
                 {
-                    std::cout << "[Wedelin primal heuristic] found primal solution\n";
-                    return solution;
+                    for(size_t i=0; i<solution.size(); ++i)
+                        if(solution[i] != eval.value(i))
+                            eval.flip(i);
+                    if(eval.feasible())
+                    {
+                        std::cout << "[Wedelin primal heuristic] found primal solution\n";
+                        return solution;
+                    }
                 }
 
                 s.update_costs(bdd_cost_updates);
                 run_solver(s, num_itr_lb, 1e-7, 0.0001, std::numeric_limits<double>::max(), false);
 
                 // add current cost updates to history
+#pragma omp parallel for schedule(static,512)
                 for(size_t i=0; i<perturbations.size(); ++i)
                 {
                     for(size_t j=0; j<perturbations.size(i); ++j)
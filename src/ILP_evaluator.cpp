@@ -0,0 +1,137 @@
+#include "ILP_evaluator.h"
+#include "time_measure_util.h"
+
+namespace LPMP {
+
+    ILP_evaluator::ILP_evaluator(const ILP_input& ilp)
+        : x_(ilp.nr_variables(), 0),
+        objective_(ilp.nr_variables(), 0.0),
+        constant_(ilp.constant())
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        std::copy(ilp.objective().begin(), ilp.objective().begin() + std::min(ilp.objective().size(), objective_.size()), objective_.begin());
+
+        std::vector<std::vector<size_t>> monomial_vars;
+        std::vector<std::vector<size_t>> var_monomials(ilp.nr_variables());
+        std::vector<std::vector<size_t>> var_constraints(ilp.nr_variables());
+        constraint_begin_.reserve(ilp.nr_constraints() + 1);
+        for(size_t c=0; c<ilp.nr_constraints(); ++c)
+        {
+            const auto& constr = ilp.constraints()[c];
+            constraint_begin_.push_back(monomial_vars.size());
+            ineq_.push_back(constr.ineq);
+            rhs_.push_back(constr.right_hand_side);
+            for(size_t m=0; m<constr.monomials.size(); ++m)
+            {
+                const size_t monomial = monomial_vars.size();
+                monomial_vars.emplace_back(constr.monomials[m].begin(), constr.monomials[m].end());
+                coefficient_.push_back(constr.coefficients[m]);
+                monomial_constraint_.push_back(c);
+                for(const size_t var : monomial_vars.back())
+                {
+                    assert(var < ilp.nr_variables());
+                    // a variable occurring several times in a monomial is registered once
+                    if(var_monomials[var].empty() || var_monomials[var].back() != monomial)
+                        var_monomials[var].push_back(monomial);
+                    if(var_constraints[var].empty() || var_constraints[var].back() != c)
+                        var_constraints[var].push_back(c);
+                }
+            }
+        }
+        constraint_begin_.push_back(monomial_vars.size());
+
+        monomial_vars_ = two_dim_variable_array<size_t>(monomial_vars);
+        var_monomials_ = two_dim_variable_array<size_t>(var_monomials);
+        var_constraints_ = two_dim_variable_array<size_t>(var_constraints);
+        monomial_value_.resize(monomial_vars_.size());
+        activity_.resize(rhs_.size());
+        violated_pos_.resize(rhs_.size(), no_pos);
+
+        set_solution(x_.begin(), x_.end());
+    }
+
+    bool ILP_evaluator::feasible(const size_t c, const int activity) const
+    {
+        assert(c < rhs_.size());
+        switch(ineq_[c]) {
+            case ILP_input::inequality_type::smaller_equal:
+                return activity <= rhs_[c];
+            case ILP_input::inequality_type::greater_equal:
+                return activity >= rhs_[c];
+            case ILP_input::inequality_type::equal:
+                return activity == rhs_[c];
+            default:
+                throw std::runtime_error("inequality type not supported");
+        }
+    }
+
+    void ILP_evaluator::update_violated(const size_t c)
+    {
+        const bool is_feasible = feasible(c, activity_[c]);
+        if(!is_feasible && violated_pos_[c] == no_pos)
+        {
+            violated_pos_[c] = violated_.size();
+            violated_.push_back(c);
+        }
+        else if(is_feasible && violated_pos_[c] != no_pos)
+        {
+            const size_t last = violated_.back();
+            violated_[violated_pos_[c]] = last;
+            violated_pos_[last] = violated_pos_[c];
+            violated_.pop_back();
+            violated_pos_[c] = no_pos;
+        }
+    }
+
+    void ILP_evaluator::flip(const size_t var)
+    {
+        assert(var < x_.size());
+        x_[var] = 1 - x_[var];
+        objective_value_ += x_[var] ? objective_[var] : -objective_[var];
+        for(const size_t m : var_monomials_[var])
+        {
+            char val = 1;
+            for(const size_t v : monomial_vars_[m])
+                val &= x_[v];
+            activity_[monomial_constraint_[m]] += coefficient_[m] * (val - monomial_value_[m]);
+            monomial_value_[m] = val;
+        }
+        for(const size_t c : var_constraints_[var])
+            update_violated(c);
+    }
+
+    std::vector<double> ILP_evaluator::evaluate(const std::vector<std::vector<char>>& solutions) const
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        std::vector<double> objectives(solutions.size());
+#pragma omp parallel for schedule(dynamic)
+        for(size_t i=0; i<solutions.size(); ++i)
+        {
+            const auto& sol = solutions[i];
+            if(sol.size() != x_.size())
+            {
+                objectives[i] = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            bool is_feasible = true;
+            for(size_t c=0; c<rhs_.size() && is_feasible; ++c)
+            {
+                int activity = 0;
+                for(size_t m=constraint_begin_[c]; m<constraint_begin_[c+1]; ++m)
+                {
+                    char val = 1;
+                    for(const size_t var : monomial_vars_[m])
+                        val &= sol[var];
+                    activity += coefficient_[m] * val;
+                }
+                is_feasible = feasible(c, activity);
+            }
+            double obj = constant_;
+            for(size_t var=0; var<sol.size(); ++var)
+                obj += objective_[var] * sol[var];
+            objectives[i] = is_feasible ? obj : std::numeric_limits<double>::infinity();
+        }
+        return objectives;
+    }
+
+}
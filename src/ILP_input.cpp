@@ -6,9 +6,13 @@
 #include "time_measure_util.h"
 #include "two_dimensional_variable_array.hxx"
 #include "union_find.hxx"
+#include "mmap_file.h"
 #include <iostream>
 #include <limits>
 #include <unordered_set>
+#include <fstream>
+#include <cstring>
+#include <type_traits>
 
 namespace LPMP { 
     bool ILP_input::constraint::monomials_cmp(const two_dim_variable_array<size_t>& monomials, const size_t idx1, const size_t idx2)
@@ -140,6 +144,154 @@ namespace LPMP {
         return vars;
     }
 
+    ILP_input::ILP_input(const ILP_binary::view& binary)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        const size_t nr_vars = binary.nr_variables();
+        var_index_to_name_.reserve(nr_vars);
+        var_name_to_index_.reserve(nr_vars);
+        for(size_t i=0; i<nr_vars; ++i)
+        {
+            var_index_to_name_.emplace_back(binary.variable_name(i));
+            var_name_to_index_.insert({var_index_to_name_.back(), i});
+        }
+        if(var_name_to_index_.size() != nr_vars)
+            throw std::runtime_error("duplicate variable names in binary ILP");
+        objective_.assign(binary.objective(), binary.objective() + nr_vars);
+        constant_ = binary.constant();
+        var_permutation_.assign(binary.variable_permutation(), binary.variable_permutation() + nr_vars);
+
+        // constraints only read from the mapped arrays and fill their own containers, hence can be built in parallel
+        constraints_.resize(binary.nr_constraints());
+#pragma omp parallel
+        {
+            std::vector<size_t> monomial_sizes;
+#pragma omp for schedule(static)
+            for(size_t c=0; c<binary.nr_constraints(); ++c)
+            {
+                constraint& constr = constraints_[c];
+                constr.identifier = binary.identifier(c);
+                constr.ineq = static_cast<inequality_type>(binary.inequality_type(c));
+                constr.right_hand_side = binary.right_hand_side(c);
+
+                const size_t monomials_begin = binary.constraint_offsets()[c];
+                const size_t monomials_end = binary.constraint_offsets()[c+1];
+                constr.coefficients.assign(binary.coefficients() + monomials_begin, binary.coefficients() + monomials_end);
+                monomial_sizes.clear();
+                for(size_t m=monomials_begin; m<monomials_end; ++m)
+                    monomial_sizes.push_back(binary.monomial_offsets()[m+1] - binary.monomial_offsets()[m]);
+                constr.monomials = two_dim_variable_array<size_t>(monomial_sizes.begin(), monomial_sizes.end());
+                const size_t* vars_begin = binary.monomial_variables() + binary.monomial_offsets()[monomials_begin];
+                const size_t* vars_end = binary.monomial_variables() + binary.monomial_offsets()[monomials_end];
+                std::copy(vars_begin, vars_end, constr.monomials.data().begin());
+            }
+        }
+
+        inequality_identifier_to_index_.reserve(binary.nr_constraints());
+        for(size_t c=0; c<constraints_.size(); ++c)
+            if(!constraints_[c].identifier.empty() && !inequality_identifier_to_index_.insert({constraints_[c].identifier, c}).second)
+                throw std::runtime_error("Duplicate inequality identifier " + constraints_[c].identifier);
+
+        for(size_t g=0; g<binary.nr_constraint_groups(); ++g)
+            coalesce_sets_.push_back(binary.constraint_group_begin(g), binary.constraint_group_end(g));
+    }
+
+    namespace ILP_binary {
+
+        view::view(const std::string& filename)
+            : file_(std::make_unique<mmap_file>(filename))
+        {
+            if(file_->size() < sizeof(header))
+                throw std::runtime_error("file " + filename + " too small for binary ILP format");
+            header_ = reinterpret_cast<const header*>(file_->begin());
+            if(std::memcmp(header_->magic, magic, sizeof(magic)) != 0)
+                throw std::runtime_error("file " + filename + " is not in binary ILP format");
+            if(header_->version != version)
+                throw std::runtime_error("binary ILP format version " + std::to_string(header_->version) + " of file " + filename + " not supported, expected version " + std::to_string(version));
+            if(header_->byte_order_mark != byte_order_mark)
+                throw std::runtime_error("file " + filename + " was written with different byte order");
+
+            // every array entry takes at least one byte, hence no valid size exceeds the file size
+            for(const uint64_t n : {header_->nr_variables, header_->nr_constraints, header_->nr_monomials, header_->nr_monomial_variables,
+                    header_->variable_names_size, header_->identifiers_size, header_->nr_constraint_groups, header_->nr_constraint_group_entries})
+                if(n >= file_->size())
+                    throw std::runtime_error("file " + filename + " has corrupt array sizes");
+
+            size_t offset = sizeof(header);
+            auto section = [&](auto*& ptr, const size_t n) {
+                using T = std::remove_const_t<std::remove_pointer_t<std::remove_reference_t<decltype(ptr)>>>;
+                const size_t nr_bytes = n * sizeof(T);
+                if(offset + nr_bytes + padding(nr_bytes) > file_->size())
+                    throw std::runtime_error("file " + filename + " is truncated");
+                ptr = reinterpret_cast<const T*>(file_->begin() + offset);
+                offset += nr_bytes + padding(nr_bytes);
+            };
+            section(objective_, nr_variables());
+            section(variable_permutation_, nr_variables());
+            section(variable_name_offsets_, nr_variables()+1);
+            section(variable_names_, header_->variable_names_size);
+            section(identifier_offsets_, nr_constraints()+1);
+            section(identifiers_, header_->identifiers_size);
+            section(inequality_types_, nr_constraints());
+            section(right_hand_sides_, nr_constraints());
+            section(constraint_offsets_, nr_constraints()+1);
+            section(coefficients_, header_->nr_monomials);
+            section(monomial_offsets_, header_->nr_monomials+1);
+            section(monomial_variables_, header_->nr_monomial_variables);
+            section(constraint_group_offsets_, nr_constraint_groups()+1);
+            section(constraint_group_entries_, header_->nr_constraint_group_entries);
+            if(offset != file_->size())
+                throw std::runtime_error("file " + filename + " has wrong size for binary ILP format");
+
+            validate(filename);
+        }
+
+        view::~view() {}
+
+        void view::validate(const std::string& filename) const
+        {
+            auto check = [&](const bool ok, const char* what) {
+                if(!ok)
+                    throw std::runtime_error("file " + filename + " has corrupt " + what);
+            };
+            // offsets must start at 0, be non-decreasing and end at the size of the array they index
+            auto check_offsets = [&](const size_t* offsets, const size_t n, const size_t size, const char* what) {
+                check(offsets[0] == 0 && offsets[n] == size, what);
+                for(size_t i=0; i<n; ++i)
+                    check(offsets[i] <= offsets[i+1], what);
+            };
+            auto check_indices = [&](const size_t* begin, const size_t n, const size_t bound, const char* what) {
+                check(std::all_of(begin, begin + n, [&](const size_t i) { return i < bound; }), what);
+            };
+
+            check_indices(variable_permutation_, nr_variables(), nr_variables(), "variable permutation");
+            check_offsets(variable_name_offsets_, nr_variables(), header_->variable_names_size, "variable name offsets");
+            check_offsets(identifier_offsets_, nr_constraints(), header_->identifiers_size, "constraint identifier offsets");
+            for(size_t c=0; c<nr_constraints(); ++c)
+                check(inequality_types_[c] <= static_cast<uint8_t>(ILP_input::inequality_type::equal), "inequality types");
+            check_offsets(constraint_offsets_, nr_constraints(), header_->nr_monomials, "constraint offsets");
+            check_offsets(monomial_offsets_, header_->nr_monomials, header_->nr_monomial_variables, "monomial offsets");
+            check_indices(monomial_variables_, header_->nr_monomial_variables, nr_variables(), "monomial variables");
+            check_offsets(constraint_group_offsets_, nr_constraint_groups(), header_->nr_constraint_group_entries, "constraint group offsets");
+            check_indices(constraint_group_entries_, header_->nr_constraint_group_entries, nr_constraints(), "constraint groups");
+        }
+
+        bool is_binary_file(const std::string& filename)
+        {
+            std::ifstream f(filename, std::ios::binary);
+            char m[sizeof(magic)];
+            if(!f.read(m, sizeof(magic)))
+                return false;
+            return std::memcmp(m, magic, sizeof(magic)) == 0;
+        }
+
+        ILP_input parse_file(const std::string& filename)
+        {
+            return ILP_input(view(filename));
+        }
+
+    }
+
     size_t ILP_input::add_new_variable(const std::string& var)
     {
         assert(!var_exists(var));
@@ -149,7 +301,7 @@ namespace LPMP {
         var_index_to_name_.push_back(var);
         if(objective_.size() <= var_index) // variables with 0 objective coefficient need not appear in objective line!
             objective_.resize(var_index+1,0.0);
-        var_permutation_.push_back(var_permutation_.size()-1);
+        var_permutation_.push_back(var_permutation_.size());
         return var_index;
     }
 
@@ -604,7 +756,11 @@ namespace LPMP {
     permutation ILP_input::reorder(ILP_input::variable_order var_ord)
     {
         if(var_ord == variable_order::input)
-            var_permutation_ = permutation(nr_variables());
+        {
+            // keep current order together with the permutation it was obtained with, e.g. when read from binary file
+            if(var_permutation_.size() != nr_variables())
+                var_permutation_ = permutation(nr_variables());
+        }
         else if(var_ord == variable_order::bfs)
             var_permutation_ = this->reorder_bfs();
         else if(var_ord == variable_order::cuthill)
@@ -0,0 +1,220 @@
+#include "ILP_parser.h"
+#include "mmap_text_parsing.h"
+#include "time_measure_util.h"
+#include <cctype>
+
+// hand-written parser for the LP format accepted by the grammar in ILP_parser.cpp.
+// The objective is read sequentially, the constraints are split into chunks parsed in parallel.
+
+namespace LPMP {
+
+    namespace ILP_parser {
+
+        namespace {
+
+            // characters besides alphanumerics allowed in variable names and inequality identifiers
+            constexpr const char* variable_chars = "_-/(){},#;[].'";
+            constexpr const char* identifier_chars = "_-/(){},;@[]#.'";
+
+            bool at_subject_to(const parsing::scanner& s)
+            {
+                constexpr const char* subject_to = "subject to";
+                const size_t n = std::strlen(subject_to);
+                if(size_t(s.end - s.pos) < n)
+                    return false;
+                for(size_t i=0; i<n; ++i)
+                    if(std::tolower(static_cast<unsigned char>(s.pos[i])) != subject_to[i])
+                        return false;
+                return true;
+            }
+
+            // section keywords must start a line and be followed by whitespace, so that variables like End_1 do not end the constraints.
+            // Constraints follow the Subject To line, hence there always is a line break before the current position.
+            bool at_keyword(const parsing::scanner& s, const char* keyword)
+            {
+                if(!s.at(keyword))
+                    return false;
+                for(const char* c=s.pos; c[-1] != '\n'; --c)
+                    if(c[-1] != ' ' && c[-1] != '\t')
+                        return false;
+                const char* next = s.pos + std::strlen(keyword);
+                return next == s.end || *next == ' ' || *next == '\t' || *next == '\n' || *next == '\r';
+            }
+
+            bool at_constraints_end(const parsing::scanner& s)
+            {
+                return at_keyword(s, "End") || at_keyword(s, "Bounds") || at_keyword(s, "Binaries") || at_keyword(s, "Coalesce") || at_keyword(s, "Generals");
+            }
+
+            // a constraint ends on a line with an inequality type and a number as last character
+            bool is_constraint_end_line(const char* line_begin, const char* line_end)
+            {
+                while(line_end != line_begin && (line_end[-1] == ' ' || line_end[-1] == '\t' || line_end[-1] == '\r'))
+                    --line_end;
+                if(line_end == line_begin || line_end[-1] < '0' || line_end[-1] > '9')
+                    return false;
+                for(const char* c=line_begin; c!=line_end; ++c)
+                    if(*c == '<' || *c == '>' || *c == '=')
+                        return true;
+                return false;
+            }
+
+            void parse_objective(parsing::scanner& s, ILP_input& ilp)
+            {
+                bool first_term = true;
+                bool empty = true;
+                while(true)
+                {
+                    s.skip_invisible();
+                    if(s.eof())
+                        throw std::runtime_error("expected Subject To");
+                    if(at_subject_to(s))
+                    {
+                        if(empty)
+                            bdd_log << "[ILP parser] problem has empty objective\n";
+                        s.skip_line();
+                        return;
+                    }
+
+                    const int sign = s.sign();
+                    if(sign == 0 && !first_term)
+                        throw std::runtime_error("expected sign in objective");
+                    s.skip_blanks();
+                    double coeff = sign == 0 ? 1.0 : sign;
+                    if(s.at_number())
+                    {
+                        coeff *= parsing::scanner::to_double(s.number());
+                        s.skip_blanks();
+                        if(!s.consume('*') && !s.at_alpha())
+                        {
+                            if(sign == 0)
+                                throw std::runtime_error("expected sign before objective constant");
+                            ilp.add_to_constant(coeff);
+                            first_term = true;
+                            empty = false;
+                            continue;
+                        }
+                        s.skip_blanks();
+                    }
+                    ilp.add_to_objective(coeff, std::string(s.identifier(variable_chars)));
+                    first_term = false;
+                    empty = false;
+                }
+            }
+
+            void parse_monomial(parsing::scanner& s, parsing::constraint_chunk& chunk, const int coeff)
+            {
+                chunk.add_to_monomial(s.identifier(variable_chars));
+                while(true)
+                {
+                    const char* pos = s.pos;
+                    s.skip_blanks();
+                    if(!s.consume('*'))
+                    {
+                        s.pos = pos;
+                        break;
+                    }
+                    s.skip_blanks();
+                    chunk.add_to_monomial(s.identifier(variable_chars));
+                }
+                chunk.end_monomial(coeff);
+            }
+
+            void parse_constraint(parsing::scanner& s, parsing::constraint_chunk& chunk)
+            {
+                // optional identifier followed by ':'
+                const char* identifier_begin = s.pos;
+                while(!s.eof() && (s.at_alpha() || s.at_digit() || (s.peek() != '\0' && std::strchr(identifier_chars, s.peek()) != nullptr)))
+                    ++s.pos;
+                const char* identifier_end = s.pos;
+                s.skip_blanks();
+                if(identifier_end != identifier_begin && s.consume(':'))
+                    chunk.begin_constraint(std::string_view(identifier_begin, identifier_end - identifier_begin));
+                else
+                {
+                    s.pos = identifier_begin;
+                    chunk.begin_constraint(std::string_view());
+                }
+                s.skip_invisible();
+
+                // first term has optional sign and coefficient
+                {
+                    const int sign = s.sign();
+                    s.skip_blanks();
+                    int coeff = sign == 0 ? 1 : sign;
+                    if(s.at_number())
+                        coeff *= parsing::scanner::to_int(s.number());
+                    s.skip_blanks();
+                    s.consume('*');
+                    s.skip_blanks();
+                    parse_monomial(s, chunk, coeff);
+                }
+
+                // subsequent terms start with a sign
+                while(true)
+                {
+                    s.skip_invisible();
+                    const int sign = s.sign();
+                    if(sign == 0)
+                        break;
+                    s.skip_invisible();
+                    int coeff = sign;
+                    if(s.at_number())
+                    {
+                        coeff *= parsing::scanner::to_int(s.number());
+                        s.skip_invisible();
+                        s.consume('*');
+                        s.skip_blanks();
+                    }
+                    parse_monomial(s, chunk, coeff);
+                }
+
+                ILP_input::inequality_type ineq;
+                if(s.consume("<="))
+                    ineq = ILP_input::inequality_type::smaller_equal;
+                else if(s.consume(">="))
+                    ineq = ILP_input::inequality_type::greater_equal;
+                else if(s.consume('='))
+                    ineq = ILP_input::inequality_type::equal;
+                else
+                    throw std::runtime_error("expected inequality type");
+
+                s.skip_invisible();
+                const int sign = s.sign();
+                s.skip_invisible();
+                const int rhs = (sign == 0 ? 1 : sign) * parsing::scanner::to_int(s.number());
+                s.skip_blanks();
+                if(!s.consume_eol() && !s.eof())
+                    throw std::runtime_error("expected end of line after right hand side");
+
+                chunk.end_constraint(ineq, rhs);
+            }
+
+        }
+
+        ILP_input parse_file_parallel(const std::string& filename)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            const mmap_file file(filename);
+            parsing::scanner s{file.begin(), file.end()};
+            ILP_input ilp;
+
+            while(s.at('\\'))
+                s.skip_line();
+            s.skip_blanks();
+            if(!s.consume("Minimize"))
+                throw std::runtime_error("could not read input file " + filename + ": expected Minimize");
+            s.skip_blanks();
+            if(!s.consume_eol())
+                throw std::runtime_error("could not read input file " + filename + ": expected end of line after Minimize");
+
+            parse_objective(s, ilp);
+            parsing::parse_constraints_parallel(ilp, s.pos, s.end, is_constraint_end_line, at_constraints_end, parse_constraint);
+
+            print_ILP_diagnostics(ilp);
+            return ilp;
+        }
+
+    }
+
+}
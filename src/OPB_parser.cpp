@@ -55,7 +55,7 @@ namespace LPMP {
         tao::pegtl::plus<tao::pegtl::sor<tao::pegtl::alnum, tao::pegtl::string<'_'>, tao::pegtl::string<'-'>, tao::pegtl::string<'/'>, tao::pegtl::string<'('>, tao::pegtl::string<')'>, tao::pegtl::string<'{'>, tao::pegtl::string<'}'>, tao::pegtl::string<','> > >
         > {};
 
-        struct new_inequality : tao::pegtl::seq<opt_whitespace, tao::pegtl::not_at<tao::pegtl::string<';'>>, opt_whitespace> {};
+        struct new_inequality : tao::pegtl::seq<opt_whitespace, tao::pegtl::not_at<tao::pegtl::sor<tao::pegtl::string<';'>, tao::pegtl::string<'*'>, tao::pegtl::eol, tao::pegtl::eof>>, opt_whitespace> {};
 
         struct inequality_coefficient : tao::pegtl::seq<tao::pegtl::digit, tao::pegtl::star<tao::pegtl::digit>> {};
         struct inequality_variable : variable_name {};
@@ -119,6 +119,7 @@ namespace LPMP {
                 static void apply(const INPUT & in, ILP_input& i, tmp_storage& tmp)
                 {
                     i.begin_new_inequality();
+                    tmp = tmp_storage{};
                 }
         };
 
@@ -0,0 +1,132 @@
+#include "OPB_parser.h"
+#include "mmap_text_parsing.h"
+#include "time_measure_util.h"
+
+// hand-written parser for the OPB format accepted by the grammar in OPB_parser.cpp.
+// The objective is read sequentially, the constraints are split into chunks parsed in parallel.
+
+namespace LPMP {
+
+    namespace OPB_parser {
+
+        namespace {
+
+            // characters besides alphanumerics allowed in variable names
+            constexpr const char* variable_chars = "_-/(){},";
+
+            // constraints are terminated by ';' at the end of a line
+            bool is_constraint_end_line(const char* line_begin, const char* line_end)
+            {
+                while(line_end != line_begin && (line_end[-1] == ' ' || line_end[-1] == '\t' || line_end[-1] == '\r'))
+                    --line_end;
+                return line_end != line_begin && line_end[-1] == ';';
+            }
+
+            // a comment line ends the constraints
+            bool at_constraints_end(const parsing::scanner& s)
+            {
+                return s.at('*');
+            }
+
+            int parse_integer(parsing::scanner& s)
+            {
+                const char* begin = s.pos;
+                while(s.at_digit())
+                    ++s.pos;
+                if(s.pos == begin)
+                    throw std::runtime_error("expected integer");
+                return parsing::scanner::to_int(std::string_view(begin, s.pos - begin));
+            }
+
+            void parse_objective(parsing::scanner& s, ILP_input& ilp)
+            {
+                while(true)
+                {
+                    s.skip_blanks();
+                    if(s.consume(';'))
+                        break;
+                    const int sign = s.sign();
+                    s.skip_blanks();
+                    double coeff = sign == 0 ? 1.0 : sign;
+                    if(s.at_number())
+                    {
+                        coeff *= parsing::scanner::to_double(s.number());
+                        s.skip_blanks();
+                        s.consume('*');
+                        s.skip_blanks();
+                    }
+                    ilp.add_to_objective(coeff, std::string(s.identifier(variable_chars)));
+                }
+                s.skip_blanks();
+                if(!s.consume_eol())
+                    throw std::runtime_error("expected end of line after objective");
+            }
+
+            void parse_constraint(parsing::scanner& s, parsing::constraint_chunk& chunk)
+            {
+                chunk.begin_constraint(std::string_view());
+                while(true)
+                {
+                    s.skip_invisible();
+                    if(s.at('<') || s.at('>') || s.at('='))
+                        break;
+                    const int sign = s.sign();
+                    s.skip_blanks();
+                    int coeff = sign == 0 ? 1 : sign;
+                    if(s.at_digit())
+                    {
+                        coeff *= parse_integer(s);
+                        s.skip_blanks();
+                        s.consume('*');
+                        s.skip_blanks();
+                    }
+                    chunk.add_to_monomial(s.identifier(variable_chars));
+                    chunk.end_monomial(coeff);
+                }
+
+                ILP_input::inequality_type ineq;
+                if(s.consume("<="))
+                    ineq = ILP_input::inequality_type::smaller_equal;
+                else if(s.consume(">="))
+                    ineq = ILP_input::inequality_type::greater_equal;
+                else if(s.consume('='))
+                    ineq = ILP_input::inequality_type::equal;
+                else
+                    throw std::runtime_error("expected inequality type");
+
+                s.skip_blanks();
+                const int sign = s.sign();
+                const int rhs = (sign == 0 ? 1 : sign) * parse_integer(s);
+                s.skip_blanks();
+                if(!s.consume(';'))
+                    throw std::runtime_error("expected ; after right hand side");
+                s.skip_blanks();
+                if(!s.consume_eol() && !s.eof())
+                    throw std::runtime_error("expected end of line after constraint");
+
+                chunk.end_constraint(ineq, rhs);
+            }
+
+        }
+
+        ILP_input parse_file_parallel(const std::string& filename)
+        {
+            MEASURE_FUNCTION_EXECUTION_TIME;
+            const mmap_file file(filename);
+            parsing::scanner s{file.begin(), file.end()};
+            ILP_input ilp;
+
+            while(s.at('*'))
+                s.skip_line();
+            s.skip_blanks();
+            if(!s.consume("min:"))
+                throw std::runtime_error("could not read input file " + filename + ": expected min:");
+            parse_objective(s, ilp);
+            parsing::parse_constraints_parallel(ilp, s.pos, s.end, is_constraint_end_line, at_constraints_end, parse_constraint);
+
+            return ilp;
+        }
+
+    }
+
+}
@@ -0,0 +1,192 @@
+#include "bdd_cache.h"
+#include "mmap_file.h"
+#include "hash_helper.hxx"
+#include "bdd_logging.h"
+#include "time_measure_util.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <type_traits>
+#include <unistd.h>
+
+namespace LPMP {
+
+    namespace {
+
+        constexpr char magic[8] = {'L','P','M','P','B','D','D','C'};
+        constexpr uint32_t version = 3;
+        constexpr uint32_t byte_order_mark = 0x01020304;
+
+        struct header {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order_mark;
+            uint64_t key;
+            uint64_t nr_variables;
+            uint64_t nr_constraints;
+            uint64_t nr_key_data;
+            uint64_t nr_bdd_instructions;
+            uint64_t nr_uncompressed_instructions;
+            uint64_t nr_bdds;
+            uint64_t nr_inequalities;
+            uint64_t nr_inequality_bdds;
+        };
+        static_assert(sizeof(header) % 8 == 0);
+        static_assert(sizeof(BDD::compact_bdd_instruction) == 3*sizeof(uint32_t) && std::is_trivially_copyable_v<BDD::compact_bdd_instruction>);
+        static_assert(sizeof(BDD::bdd_instruction) == 3*sizeof(uint64_t) && std::is_trivially_copyable_v<BDD::bdd_instruction>);
+        static_assert(sizeof(size_t) == sizeof(uint64_t));
+
+    }
+
+    bdd_cache::bdd_cache(const std::string& directory)
+        : directory_(directory)
+    {
+        std::filesystem::create_directories(directory_);
+    }
+
+    bdd_cache::key_type bdd_cache::key(const ILP_input& ilp, const bool normalize, const bool split_long_bdds, const bool add_split_implication_bdd, const size_t split_length)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        key_type k;
+        k.nr_variables = ilp.nr_variables();
+        k.nr_constraints = ilp.nr_constraints();
+        std::vector<int64_t>& d = k.data;
+        d.push_back(version);
+        d.push_back(normalize);
+        d.push_back(split_long_bdds);
+        d.push_back(add_split_implication_bdd);
+        d.push_back(static_cast<int64_t>(split_length));
+        for(const auto& constr : ilp.constraints())
+        {
+            d.push_back(static_cast<int64_t>(constr.ineq));
+            d.push_back(constr.right_hand_side);
+            d.push_back(constr.monomials.size());
+            for(size_t m=0; m<constr.monomials.size(); ++m)
+            {
+                d.push_back(constr.coefficients[m]);
+                d.push_back(constr.monomials.size(m));
+                for(size_t i=0; i<constr.monomials.size(m); ++i)
+                    d.push_back(constr.monomials(m,i));
+            }
+        }
+
+        size_t h = hash::hash_combine(k.nr_variables, k.nr_constraints);
+        for(const int64_t x : d)
+            h = hash::hash_combine(h, static_cast<size_t>(x));
+        k.hash = h;
+        return k;
+    }
+
+    std::string bdd_cache::filename(const size_t hash) const
+    {
+        std::stringstream s;
+        s << std::hex << std::setw(16) << std::setfill('0') << hash << ".bdds";
+        return (std::filesystem::path(directory_) / s.str()).string();
+    }
+
+    bool bdd_cache::load(const key_type& key, BDD::bdd_collection& bdd_col, two_dim_variable_array<size_t>& ineq_to_bdd_nrs) const
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        const std::string f = filename(key.hash);
+        if(!std::filesystem::exists(f))
+            return false;
+
+        const mmap_file file(f);
+        if(file.size() < sizeof(header))
+            throw std::runtime_error("BDD cache file " + f + " is corrupt");
+        const header* h = reinterpret_cast<const header*>(file.begin());
+        if(std::memcmp(h->magic, magic, sizeof(magic)) != 0 || h->byte_order_mark != byte_order_mark)
+            throw std::runtime_error("BDD cache file " + f + " is corrupt");
+        if(h->version != version)
+        {
+            bdd_log << "[bdd cache] ignore " << f << " written with format version " << h->version << "\n";
+            return false;
+        }
+        if(h->key != key.hash || h->nr_variables != key.nr_variables || h->nr_constraints != key.nr_constraints || h->nr_key_data != key.data.size())
+        {
+            bdd_log << "[bdd cache] ignore " << f << " built from different constraints\n";
+            return false;
+        }
+        if(file.size() != sizeof(header) + sizeof(int64_t) * h->nr_key_data + sizeof(BDD::compact_bdd_instruction) * h->nr_bdd_instructions + sizeof(BDD::bdd_instruction) * h->nr_uncompressed_instructions + sizeof(size_t) * (h->nr_bdds + 1 + h->nr_inequalities + 1 + h->nr_inequality_bdds))
+            throw std::runtime_error("BDD cache file " + f + " has wrong size");
+
+        const char* pos = file.begin() + sizeof(header);
+        if(std::memcmp(pos, key.data.data(), sizeof(int64_t) * key.data.size()) != 0)
+        {
+            bdd_log << "[bdd cache] ignore " << f << " built from different constraints\n";
+            return false;
+        }
+        pos += sizeof(int64_t) * key.data.size();
+
+        auto read = [&](auto& v, const size_t n) {
+            using T = typename std::remove_reference_t<decltype(v)>::value_type;
+            v.resize(n);
+            std::memcpy(v.data(), pos, n * sizeof(T));
+            pos += n * sizeof(T);
+        };
+
+        assert(bdd_col.nr_bdds() == 0);
+        std::vector<BDD::compact_bdd_instruction> instructions;
+        read(instructions, h->nr_bdd_instructions);
+        std::vector<BDD::bdd_instruction> uncompressed_instructions;
+        read(uncompressed_instructions, h->nr_uncompressed_instructions);
+        std::vector<size_t> delimiters;
+        read(delimiters, h->nr_bdds + 1);
+        bdd_col.assign(BDD::bdd_instruction_vector(std::move(instructions), std::move(uncompressed_instructions)), std::move(delimiters));
+
+        std::vector<size_t> ineq_offsets;
+        read(ineq_offsets, h->nr_inequalities + 1);
+        std::vector<size_t> ineq_sizes(h->nr_inequalities);
+        for(size_t c=0; c<h->nr_inequalities; ++c)
+            ineq_sizes[c] = ineq_offsets[c+1] - ineq_offsets[c];
+        ineq_to_bdd_nrs = two_dim_variable_array<size_t>(ineq_sizes.begin(), ineq_sizes.end());
+        read(ineq_to_bdd_nrs.data(), h->nr_inequality_bdds);
+
+        bdd_log << "[bdd cache] loaded " << bdd_col.nr_bdds() << " BDDs from " << f << "\n";
+        return true;
+    }
+
+    void bdd_cache::store(const key_type& key, const BDD::bdd_collection& bdd_col, const two_dim_variable_array<size_t>& ineq_to_bdd_nrs) const
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        header h;
+        std::copy(std::begin(magic), std::end(magic), h.magic);
+        h.version = version;
+        h.byte_order_mark = byte_order_mark;
+        h.key = key.hash;
+        h.nr_variables = key.nr_variables;
+        h.nr_constraints = key.nr_constraints;
+        h.nr_key_data = key.data.size();
+        h.nr_bdd_instructions = bdd_col.instructions().size();
+        h.nr_uncompressed_instructions = bdd_col.instructions().uncompressed_instructions().size();
+        h.nr_bdds = bdd_col.nr_bdds();
+        h.nr_inequalities = ineq_to_bdd_nrs.size();
+        h.nr_inequality_bdds = ineq_to_bdd_nrs.data().size();
+
+        std::vector<size_t> ineq_offsets = {0};
+        for(size_t c=0; c<ineq_to_bdd_nrs.size(); ++c)
+            ineq_offsets.push_back(ineq_offsets.back() + ineq_to_bdd_nrs.size(c));
+
+        // write into temporary file first so that concurrent runs never see partially written entries
+        const std::string f = filename(key.hash);
+        const std::string tmp_f = f + ".tmp" + std::to_string(getpid());
+        {
+            std::ofstream s(tmp_f, std::ios::binary);
+            auto write = [&](const auto* data, const size_t n) { s.write(reinterpret_cast<const char*>(data), n * sizeof(*data)); };
+            write(&h, 1);
+            write(key.data.data(), key.data.size());
+            write(bdd_col.instructions().compact_instructions().data(), bdd_col.instructions().compact_instructions().size());
+            write(bdd_col.instructions().uncompressed_instructions().data(), bdd_col.instructions().uncompressed_instructions().size());
+            write(bdd_col.delimiters().data(), bdd_col.delimiters().size());
+            write(ineq_offsets.data(), ineq_offsets.size());
+            write(ineq_to_bdd_nrs.data().data(), ineq_to_bdd_nrs.data().size());
+            if(!s)
+                throw std::runtime_error("could not write BDD cache file " + tmp_f);
+        }
+        std::filesystem::rename(tmp_f, f);
+        bdd_log << "[bdd cache] stored " << bdd_col.nr_bdds() << " BDDs in " << f << "\n";
+    }
+
+}
@@ -1,6 +1,7 @@
 #include "bdd_collection/bdd_collection.h"
 #include "bdd_manager/bdd_mgr.h"
 #include "transitive_closure_dag.h"
+#include "union_find.hxx"
 #include <queue>
 #include <cassert>
 #include <unordered_set>
@@ -9,13 +10,6 @@
 
 namespace BDD {
 
-    size_t bdd_collection::offset(const bdd_instruction& instr) const
-    {
-        assert(std::distance(&bdd_instructions[0], &instr) < bdd_instructions.size());
-        assert(std::distance(&bdd_instructions[0], &instr) >= 0);
-        return std::distance(&bdd_instructions[0], &instr); 
-    }
-
     std::vector<size_t> bdd_collection::rebase_to_contiguous(const size_t bdd_nr)
     {
         const auto vars = variables(bdd_nr);
@@ -35,39 +29,8 @@ namespace BDD {
 
     size_t bdd_collection::bdd_and(const size_t i, const size_t j, bdd_collection& o)
     {
-        assert(i < nr_bdds());
-        assert(j < nr_bdds());
-        // TODO: allocate stack etc. locally
-        assert(o.stack.empty());
-        assert(o.generated_nodes.empty());
-        assert(o.reduction.empty());
-
-        // generate terminal vertices
-        o.stack.push_back(bdd_instruction::botsink());
-        o.stack.push_back(bdd_instruction::topsink());
-        const size_t root_idx = bdd_and_impl(bdd_delimiters[i], bdd_delimiters[j], o);
-
-        if(root_idx != std::numeric_limits<size_t>::max())
-        {
-            assert(o.stack.size() > 2);
-            const size_t offset = o.bdd_delimiters.back();
-            for(ptrdiff_t s = o.stack.size()-1; s>=0; --s)
-            {
-                const bdd_instruction bdd_stack = o.stack[s];
-                const size_t lo = offset + o.stack.size() - bdd_stack.lo - 1;
-                const size_t hi = offset + o.stack.size() - bdd_stack.hi - 1;
-                o.bdd_instructions.push_back({lo, hi, o.stack[s].index});
-            }
-            o.bdd_delimiters.push_back(o.bdd_instructions.size());
-            assert(o.is_bdd(o.bdd_delimiters.size()-2));
-        }
-
-        o.generated_nodes.clear();
-        o.reduction.clear();
-        o.stack.clear();
-        if(root_idx == std::numeric_limits<size_t>::max())
-            return std::numeric_limits<size_t>::max();
-        return o.bdd_delimiters.size()-2;
+        const std::array<size_t,2> bdd_nrs = {i, j};
+        return bdd_and_impl(bdd_nrs.data(), bdd_nrs.size(), o);
     }
 
     size_t bdd_collection::bdd_and(const int i, const int j, bdd_collection& o)
@@ -80,237 +43,152 @@ namespace BDD {
         return bdd_and(size_t(i), size_t(j), *this); 
     }
 
-    // given two bdd_instructions indices, compute new melded node, if it has not yet been created. Return index on stack.
-    size_t bdd_collection::bdd_and_impl(const size_t f_i, const size_t g_i, bdd_collection& o)
+    // breadth-first apply: first all requests reachable from the root tuple are generated level by level, then their results are reduced bottom-up.
+    size_t bdd_collection::bdd_and_impl(const size_t* bdd_nrs, const size_t n, bdd_collection& o)
     {
-        // first, check whether node has been generated already
-        if(o.generated_nodes.count({f_i,g_i}) > 0)
-            return o.generated_nodes.find({f_i,g_i})->second;
-
-        const bdd_instruction& f = bdd_instructions[f_i];
-        const bdd_instruction& g = bdd_instructions[g_i];
-
-        // check if instructions are terminals
-        // TODO: more efficient
-        if(f.is_terminal() && g.is_terminal())
-        {
-            if(f.is_topsink() && g.is_topsink())
-                return 1; //topsink position on stack
-            else
-                return 0; //botsink position on stack
-        }
-        else if(f.is_terminal() && !g.is_terminal())
-        {
-            if(f.is_botsink())
-                return 0; //botsink position on stack
-            else if(!f.is_terminal() && g.is_terminal() && g.is_botsink()) // TODO: is superfluous!
-                    return 0; //botsink position on stack
-        }
+        assert(n > 0);
+        bdd_and_arena& a = o.and_arena;
+        a.clear();
+        a.width = n;
 
-        // compute lo and hi and see if they are present already. It not, add new branch instruction
-        const size_t v = std::min(f.index, g.index);
-        const size_t lo = bdd_and_impl(
-                v == f.index ? f.lo : f_i,
-                v == g.index ? g.lo : g_i,
-                o
-                );
-        if(lo == std::numeric_limits<size_t>::max())
-            return std::numeric_limits<size_t>::max();
-        const size_t hi = bdd_and_impl(
-                v == f.index ? f.hi : f_i,
-                v == g.index ? g.hi : g_i,
-                o
-                );
-        if(hi == std::numeric_limits<size_t>::max())
-            return std::numeric_limits<size_t>::max();
-
-        if(lo == hi)
-            return lo;
-
-        if(o.reduction.count({lo,hi,v}) > 0)
-            return o.reduction.find({lo,hi,v})->second;
-
-        o.stack.push_back({lo, hi, v});
-        const size_t meld_idx = o.stack.size()-1;
-        o.generated_nodes.insert(std::make_pair(std::array<size_t,2>{f_i,g_i}, meld_idx));
-        o.reduction.insert(std::make_pair(bdd_instruction{lo,hi,v}, meld_idx));
-
-        return meld_idx;
-    }
-
-    template<size_t N>
-        size_t bdd_collection::bdd_and(const std::array<size_t,N>& bdds)
+        size_t nr_input_nodes = 0;
+        for(size_t k=0; k<n; ++k)
         {
-            return bdd_and(bdds, *this);
+            assert(bdd_nrs[k] < nr_bdds());
+            for(size_t i=bdd_delimiters[bdd_nrs[k]]; i<bdd_delimiters[bdd_nrs[k]+1]; ++i)
+                if(!bdd_instructions[i].is_terminal())
+                    a.variables.push_back(bdd_instructions[i].index);
+            nr_input_nodes += nr_bdd_nodes(bdd_nrs[k]);
         }
+        std::sort(a.variables.begin(), a.variables.end());
+        a.variables.erase(std::unique(a.variables.begin(), a.variables.end()), a.variables.end());
+        if(a.level_requests.size() < a.variables.size())
+            a.level_requests.resize(a.variables.size());
+        a.request_table.clear(nr_input_nodes);
+        a.node_table.clear(nr_input_nodes);
+
+        // requests 0 and 1 stand for the terminals
+        a.request_nodes.resize(2*n, 0);
+        a.request_children.push_back({0,0});
+        a.request_children.push_back({1,1});
+
+        auto request_hash = [&](const size_t* nodes) {
+            size_t h = 0;
+            for(size_t k=0; k<n; ++k)
+                h = index_hash_table::hash_combine(h, nodes[k]);
+            return index_hash_table::finalize(h);
+        };
 
-    template<size_t N>
-        size_t bdd_collection::bdd_and(const std::array<size_t,N>& bdds, bdd_collection& o)
-        {
-            for(const size_t bdd_nr : bdds)
+        // return request for the given instructions and register new requests at the level of their topmost variable.
+        // nodes must not point into a.request_nodes.
+        auto make_request = [&](const size_t* nodes) -> size_t {
+            size_t v = std::numeric_limits<size_t>::max();
+            for(size_t k=0; k<n; ++k)
             {
-                assert(bdd_nr < nr_bdds());
+                const bdd_instruction& instr = bdd_instructions[nodes[k]];
+                if(instr.is_botsink())
+                    return 0;
+                if(!instr.is_topsink())
+                    v = std::min(v, instr.index);
             }
-            assert(o.stack.empty());
-            assert(o.generated_nodes.empty());
-            assert(o.reduction.empty());
-
-            std::array<size_t,N> bdd_indices;
-            for(size_t i=0; i<N; ++i)
-                bdd_indices[i] = bdd_delimiters[bdds[i]];
+            if(v == std::numeric_limits<size_t>::max())
+                return 1;
+
+            const size_t new_r = a.request_children.size();
+            const size_t r = a.request_table.find_or_insert(request_hash(nodes), new_r,
+                    [&](const size_t r) { return std::equal(nodes, nodes + n, a.request_nodes.begin() + r*n); },
+                    [&](const size_t r) { return request_hash(&a.request_nodes[r*n]); });
+            if(r == new_r)
+            {
+                a.request_nodes.insert(a.request_nodes.end(), nodes, nodes + n);
+                a.request_children.push_back({0,0});
+                const size_t level = std::distance(a.variables.begin(), std::lower_bound(a.variables.begin(), a.variables.end(), v));
+                assert(level < a.variables.size() && a.variables[level] == v);
+                a.level_requests[level].push_back(r);
+            }
+            return r;
+        };
 
-            // generate terminal vertices
-            o.stack.push_back(bdd_instruction::botsink());
-            o.stack.push_back(bdd_instruction::topsink());
-            std::unordered_map<std::array<size_t,N>,size_t,array_hasher<N>> generated_nodes;
-            const size_t root_idx = bdd_and_impl(bdd_indices, generated_nodes, o);
+        a.scratch.resize(2*n);
+        for(size_t k=0; k<n; ++k)
+            a.scratch[k] = bdd_delimiters[bdd_nrs[k]];
+        const size_t root_request = make_request(a.scratch.data());
 
-            if(root_idx != std::numeric_limits<size_t>::max())
+        // expand requests top-down. Children have larger variables, hence only deeper levels receive new requests.
+        for(size_t l=0; l<a.variables.size(); ++l)
+        {
+            const size_t v = a.variables[l];
+            for(const size_t r : a.level_requests[l])
             {
-                assert(o.stack.size() > 2);
-                const size_t offset = o.bdd_delimiters.back();
-                for(ptrdiff_t s = o.stack.size()-1; s>=0; --s)
+                for(size_t k=0; k<n; ++k)
                 {
-                    const bdd_instruction bdd_stack = o.stack[s];
-                    const size_t lo = offset + o.stack.size() - bdd_stack.lo - 1;
-                    const size_t hi = offset + o.stack.size() - bdd_stack.hi - 1;
-                    o.bdd_instructions.push_back({lo, hi, o.stack[s].index});
+                    const size_t node = a.request_nodes[r*n + k];
+                    const bdd_instruction& instr = bdd_instructions[node];
+                    const bool branches = !instr.is_terminal() && instr.index == v;
+                    a.scratch[k] = branches ? instr.lo : node;
+                    a.scratch[n + k] = branches ? instr.hi : node;
                 }
-                o.bdd_delimiters.push_back(o.bdd_instructions.size());
-                assert(o.is_bdd(o.bdd_delimiters.size()-2));
+                const size_t lo = make_request(a.scratch.data());
+                const size_t hi = make_request(a.scratch.data() + n);
+                a.request_children[r] = {lo, hi};
             }
-
-            //generated_nodes.clear();
-            o.reduction.clear();
-            o.stack.clear();
-            if(root_idx == std::numeric_limits<size_t>::max())
-                return std::numeric_limits<size_t>::max();
-            return o.bdd_delimiters.size()-2;
         }
 
-    // explicit instantiation of bdd_and
-    template size_t bdd_collection::bdd_and<3>(const std::array<size_t,3>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<4>(const std::array<size_t,4>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<5>(const std::array<size_t,5>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<6>(const std::array<size_t,6>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<7>(const std::array<size_t,7>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<8>(const std::array<size_t,8>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<9>(const std::array<size_t,9>& bdds, bdd_collection& o);
-
-    template size_t bdd_collection::bdd_and<10>(const std::array<size_t,10>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<11>(const std::array<size_t,11>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<12>(const std::array<size_t,12>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<13>(const std::array<size_t,13>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<14>(const std::array<size_t,14>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<15>(const std::array<size_t,15>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<16>(const std::array<size_t,16>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<17>(const std::array<size_t,17>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<18>(const std::array<size_t,18>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<19>(const std::array<size_t,19>& bdds, bdd_collection& o);
-
-    template size_t bdd_collection::bdd_and<20>(const std::array<size_t,20>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<21>(const std::array<size_t,21>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<22>(const std::array<size_t,22>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<23>(const std::array<size_t,23>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<24>(const std::array<size_t,24>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<25>(const std::array<size_t,25>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<26>(const std::array<size_t,26>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<27>(const std::array<size_t,27>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<28>(const std::array<size_t,28>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<29>(const std::array<size_t,29>& bdds, bdd_collection& o);
-
-    template size_t bdd_collection::bdd_and<30>(const std::array<size_t,30>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<31>(const std::array<size_t,31>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<32>(const std::array<size_t,32>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<33>(const std::array<size_t,33>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<34>(const std::array<size_t,34>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<35>(const std::array<size_t,35>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<36>(const std::array<size_t,36>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<37>(const std::array<size_t,37>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<38>(const std::array<size_t,38>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<39>(const std::array<size_t,39>& bdds, bdd_collection& o);
-
-    template size_t bdd_collection::bdd_and<40>(const std::array<size_t,40>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<41>(const std::array<size_t,41>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<42>(const std::array<size_t,42>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<43>(const std::array<size_t,43>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<44>(const std::array<size_t,44>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<45>(const std::array<size_t,45>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<46>(const std::array<size_t,46>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<47>(const std::array<size_t,47>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<48>(const std::array<size_t,48>& bdds, bdd_collection& o);
-    template size_t bdd_collection::bdd_and<49>(const std::array<size_t,49>& bdds, bdd_collection& o);
-
-    // given two bdd_instructions indices, compute new melded node, if it has not yet been created. Return index on stack.
-    template<size_t N>
-    size_t bdd_collection::bdd_and_impl(const std::array<size_t,N>& bdds, std::unordered_map<std::array<size_t,N>,size_t,array_hasher<N>>& generated_nodes, bdd_collection& o)
-    {
-        // first, check whether node has been generated already
-        if(generated_nodes.count(bdds) > 0)
-            return generated_nodes.find(bdds)->second;
-
-        std::array<bdd_instruction,N> bdd_instrs;
-        for(size_t i=0; i<N; ++i)
-            bdd_instrs[i] = bdd_instructions[bdds[i]];
-
-        // check if all instructions are true
-        const bool all_true_terminal = [&]() {
-            for(bdd_instruction& f : bdd_instrs)
-                if(!f.is_topsink())
-                    return false;
-            return true;
-        }();
-        if(all_true_terminal)
-            return 1;
-
-        const bool one_false_terminal = [&]() {
-            for(bdd_instruction& f : bdd_instrs)
-                if(f.is_botsink())
-                    return true;
-            return false; 
-        }();
-        if(one_false_terminal)
-            return 0;
-
-        const size_t v = [&]() {
-            size_t idx = std::numeric_limits<size_t>::max();
-            for(const bdd_instruction& f : bdd_instrs)
-                idx = std::min(idx, f.index);
-            return idx;
-        }();
-
-        std::array<size_t,N> lo_nodes;
-        for(size_t i=0; i<N; ++i)
+        // reduce bottom-up, result nodes are put on the stack in order of decreasing levels
+        a.stack.push_back({0, 0, bdd_instruction::botsink_index});
+        a.stack.push_back({1, 1, bdd_instruction::topsink_index});
+        a.request_results.resize(a.request_children.size());
+        a.request_results[0] = 0;
+        a.request_results[1] = 1;
+        auto node_hash = [](const std::array<size_t,3>& node) {
+            return index_hash_table::finalize(index_hash_table::hash_combine(index_hash_table::hash_combine(node[0], node[1]), node[2]));
+        };
+        for(std::ptrdiff_t l=a.variables.size()-1; l>=0; --l)
         {
-            const bdd_instruction& f = bdd_instrs[i];
-            lo_nodes[i] = f.index == v ? f.lo : bdds[i];
+            const size_t v = a.variables[l];
+            for(const size_t r : a.level_requests[l])
+            {
+                const size_t lo = a.request_results[a.request_children[r][0]];
+                const size_t hi = a.request_results[a.request_children[r][1]];
+                if(lo == hi)
+                {
+                    a.request_results[r] = lo;
+                    continue;
+                }
+                const std::array<size_t,3> node = {lo, hi, v};
+                const size_t new_node = a.stack.size();
+                a.request_results[r] = a.node_table.find_or_insert(node_hash(node), new_node,
+                        [&](const size_t i) { return a.stack[i] == node; },
+                        [&](const size_t i) { return node_hash(a.stack[i]); });
+                if(a.request_results[r] == new_node)
+                    a.stack.push_back(node);
+            }
         }
-        const size_t lo = bdd_and_impl(lo_nodes, generated_nodes, o);
-        if(lo == std::numeric_limits<size_t>::max())
-            return std::numeric_limits<size_t>::max();
+        const size_t root = a.request_results[root_request];
 
-        std::array<size_t,N> hi_nodes;
-        for(size_t i=0; i<N; ++i)
+        // every result node is reachable from the root, hence the root is the topmost and last node on the stack
+        const size_t offset = o.bdd_delimiters.back();
+        if(root < 2)
         {
-            const bdd_instruction& f = bdd_instrs[i];
-            hi_nodes[i] = f.index == v ? f.hi : bdds[i];
+            o.bdd_instructions.push_back(root == 1 ? bdd_instruction::topsink() : bdd_instruction::botsink());
+            o.bdd_instructions.push_back(root == 1 ? bdd_instruction::botsink() : bdd_instruction::topsink());
         }
-        const size_t hi = bdd_and_impl(hi_nodes, generated_nodes, o);
-        if(hi == std::numeric_limits<size_t>::max())
-            return std::numeric_limits<size_t>::max();
-
-        if(lo == hi)
-            return lo;
-
-        if(o.reduction.count({lo,hi,v}) > 0)
-            return o.reduction.find({lo,hi,v})->second;
-
-        o.stack.push_back({lo, hi, v});
-        const size_t meld_idx = o.stack.size()-1;
-        generated_nodes.insert(std::make_pair(bdds, meld_idx));
-        o.reduction.insert(std::make_pair(bdd_instruction{lo,hi,v}, meld_idx));
+        else
+        {
+            assert(root == a.stack.size()-1);
+            for(std::ptrdiff_t s = a.stack.size()-1; s>=2; --s)
+            {
+                const size_t lo = offset + a.stack.size() - a.stack[s][0] - 1;
+                const size_t hi = offset + a.stack.size() - a.stack[s][1] - 1;
+                o.bdd_instructions.push_back({lo, hi, a.stack[s][2]});
+            }
+            o.bdd_instructions.push_back(bdd_instruction::topsink());
+            o.bdd_instructions.push_back(bdd_instruction::botsink());
+        }
+        o.bdd_delimiters.push_back(o.bdd_instructions.size());
+        assert(root < 2 || o.is_bdd(o.bdd_delimiters.size()-2));
 
-        return meld_idx;
+        return o.bdd_delimiters.size()-2;
     }
 
     size_t bdd_collection::add_bdd(node_ref root)
@@ -319,33 +197,31 @@ namespace BDD {
 
         auto nodes = root.nodes_postorder();
         std::reverse(nodes.begin(), nodes.end());
+
+        // record positions first, so that instructions are written once with their final arcs
+        const size_t offset = bdd_delimiters.back();
         for(size_t i=0; i<nodes.size(); ++i)
         {
             assert(!nodes[i].is_terminal());
-            node_ref_hash.insert({nodes[i], bdd_instructions.size()});
-            bdd_instructions.push_back(bdd_instruction{std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), nodes[i].variable()});
+            node_ref_hash.insert({nodes[i], offset + i});
         }
+        node_ref_hash.insert({nodes.back().botsink(), offset + nodes.size()});
+        node_ref_hash.insert({nodes.back().topsink(), offset + nodes.size() + 1});
 
-        // TODO: not most efficient, record top and botsink above
-        node_ref_hash.insert({nodes.back().botsink(), bdd_instructions.size()});
-        bdd_instructions.push_back(bdd_instruction::botsink());
-        assert(bdd_instructions.back().is_botsink());
-
-        node_ref_hash.insert({nodes.back().topsink(), bdd_instructions.size()});
-        bdd_instructions.push_back(bdd_instruction::topsink());
-        assert(bdd_instructions.back().is_topsink());
-
-        const size_t offset = bdd_delimiters.back();
         for(size_t i=0; i<nodes.size(); ++i)
         {
             assert(node_ref_hash.count(nodes[i].low()) > 0);
             assert(node_ref_hash.count(nodes[i].high()) > 0);
-            assert(i < node_ref_hash.find(nodes[i].low())->second);
-            assert(i < node_ref_hash.find(nodes[i].high())->second);
-            bdd_instructions[offset + i].lo = node_ref_hash.find(nodes[i].low())->second;
-            bdd_instructions[offset + i].hi = node_ref_hash.find(nodes[i].high())->second;
+            assert(offset + i < node_ref_hash.find(nodes[i].low())->second);
+            assert(offset + i < node_ref_hash.find(nodes[i].high())->second);
+            bdd_instructions.push_back({node_ref_hash.find(nodes[i].low())->second, node_ref_hash.find(nodes[i].high())->second, nodes[i].variable()});
         }
 
+        bdd_instructions.push_back(bdd_instruction::botsink());
+        assert(bdd_instructions.back().is_botsink());
+        bdd_instructions.push_back(bdd_instruction::topsink());
+        assert(bdd_instructions.back().is_topsink());
+
         bdd_delimiters.push_back(bdd_instructions.size());
 
         // clean-up
@@ -439,40 +315,26 @@ namespace BDD {
         return nr_occurrences;
     }
 
-    bdd_instruction* bdd_collection::begin(const size_t bdd_nr)
+    bdd_collection::const_iterator bdd_collection::begin(const size_t bdd_nr) const
     {
         assert(bdd_nr < nr_bdds());
-        return &bdd_instructions[bdd_delimiters[bdd_nr]];
+        return bdd_instructions.begin() + bdd_delimiters[bdd_nr];
     }
 
-    bdd_instruction* bdd_collection::end(const size_t bdd_nr)
+    bdd_collection::const_iterator bdd_collection::end(const size_t bdd_nr) const
     {
         assert(bdd_nr < nr_bdds());
-        return &bdd_instructions[bdd_delimiters[bdd_nr+1]-2];
+        return bdd_instructions.begin() + (bdd_delimiters[bdd_nr+1]-2);
     } 
 
-    const bdd_instruction* bdd_collection::cbegin(const size_t bdd_nr) const
+    std::reverse_iterator<bdd_collection::const_iterator> bdd_collection::rbegin(const size_t bdd_nr) const
     {
-        assert(bdd_nr < nr_bdds());
-        return &bdd_instructions[bdd_delimiters[bdd_nr]];
+        return std::reverse_iterator<const_iterator>(end(bdd_nr)); 
     }
 
-    const bdd_instruction* bdd_collection::cend(const size_t bdd_nr) const
+    std::reverse_iterator<bdd_collection::const_iterator> bdd_collection::rend(const size_t bdd_nr) const
     {
-        assert(bdd_nr < nr_bdds());
-        return &bdd_instructions[bdd_delimiters[bdd_nr+1]-2];
-    } 
-
-    std::reverse_iterator<bdd_instruction*> bdd_collection::rbegin(const size_t bdd_nr)
-    {
-        assert(bdd_nr < nr_bdds());
-        return std::reverse_iterator<bdd_instruction*>(&bdd_instructions[bdd_delimiters[bdd_nr+1]-2]); 
-    }
-
-    std::reverse_iterator<bdd_instruction*> bdd_collection::rend(const size_t bdd_nr)
-    {
-        assert(bdd_nr < nr_bdds());
-        return std::reverse_iterator<bdd_instruction*>(&bdd_instructions[bdd_delimiters[bdd_nr]]);
+        return std::reverse_iterator<const_iterator>(begin(bdd_nr));
     }
 
     bool bdd_collection::is_bdd(const size_t bdd_nr) const
@@ -1014,11 +876,11 @@ namespace BDD {
                 remove[idx - bdd_delimiters[bdd_nr]] = true;
         }
 
-        for(std::ptrdiff_t idx=bdd_delimiters[bdd_nr+1]-3; idx>=bdd_delimiters[bdd_nr]; --idx)
+        for(std::ptrdiff_t idx=bdd_delimiters[bdd_nr+1]-3; idx>=std::ptrdiff_t(bdd_delimiters[bdd_nr]); --idx)
         {
             if(!remove[idx - bdd_delimiters[bdd_nr]])
             {
-                bdd_instruction& instr = bdd_instructions[idx];
+                auto instr = bdd_instructions[idx];
                 auto transitive_endpoint = [&](size_t i)
                 {
                     while(remove[i - bdd_delimiters[bdd_nr]] == true)
@@ -1054,9 +916,9 @@ namespace BDD {
         bdd_map.insert({bdd_instructions[bdd_delimiters[bdd_nr+1]-1], bdd_delimiters[bdd_nr+1]-1});
         bdd_map.insert({bdd_instructions[bdd_delimiters[bdd_nr+1]-2], bdd_delimiters[bdd_nr+1]-2});
 
-        for(std::ptrdiff_t idx=bdd_delimiters[bdd_nr+1]-3; idx>=bdd_delimiters[bdd_nr]; --idx)
+        for(std::ptrdiff_t idx=bdd_delimiters[bdd_nr+1]-3; idx>=std::ptrdiff_t(bdd_delimiters[bdd_nr]); --idx)
         {
-            bdd_instruction& instr = bdd_instructions[idx];
+            auto instr = bdd_instructions[idx];
             auto it = bdd_map.find(instr);
             if(it == bdd_map.end())
                 bdd_map.insert({instr, idx});
@@ -1077,7 +939,7 @@ namespace BDD {
     {
         assert(nr_bdds() > 0);
         const size_t bdd_nr = nr_bdds() - 1;
-        assert(bdd_basic_check(bdd_nr));
+        // arcs have already been redirected around the nodes to remove, hence these are unreachable and the BDD is only checked after compactification
         assert(remove.size() == nr_bdd_nodes(bdd_nr));
         assert(std::count(remove.begin(), remove.end(), false) > 0); // not all nodes are to be removed
         if(std::count(remove.begin(), remove.end(), true) == 0)
@@ -1484,7 +1346,8 @@ namespace BDD {
         }
 
         // copy back
-        std::copy(new_instructions.begin(), new_instructions.end(), bdd_instructions.begin() + bdd_delimiters[bdd_nr]); 
+        for(size_t i=0; i<new_instructions.size(); ++i)
+            bdd_instructions.set(bdd_delimiters[bdd_nr] + i, new_instructions[i]);
 
         //assert(is_bdd(bdd_nr)); // TODO: only test if it has no isomorphic sugraphs. It can be qbdd!
         assert(is_reordered(bdd_nr));
@@ -1526,7 +1389,7 @@ namespace BDD {
         return bdd_instructions[offset]; 
     }
 
-    const bdd_instruction& bdd_collection::get_bdd_instruction(const size_t i) const
+    bdd_instruction bdd_collection::get_bdd_instruction(const size_t i) const
     {
         assert(i < bdd_instructions.size());
         return bdd_instructions[i];
@@ -1570,7 +1433,7 @@ namespace BDD {
         // go over previous bdd instructions and reroute topsink and botsink entries to correct entries
         for(size_t idx=bdd_delimiters[bdd_delimiters.size()-2]; idx<bdd_instructions.size()-2; ++idx)
         {
-            auto& instr = bdd_instructions[idx];
+            auto instr = bdd_instructions[idx];
 
             if(instr.lo == bdd_instruction::temp_undefined_index)
                 throw std::runtime_error("bdd lo arc not set");
@@ -1753,35 +1616,34 @@ namespace BDD {
             } 
         }
 
-        // add to end of nodes
+        // update offsets and add to end of nodes
+        const size_t first = o.bdd_instructions.size();
+        const size_t topsink_pos = first + new_bdds.size();
+        const size_t botsink_pos = first + new_bdds.size() + 1;
         for(auto& bdd : new_bdds)
-            o.bdd_instructions.push_back(bdd);
-
-        // add terminal nodes
-        o.bdd_instructions.push_back(bdd_instruction::topsink());
-        o.bdd_instructions.push_back(bdd_instruction::botsink());
-        o.bdd_delimiters.push_back(o.bdd_instructions.size());
-
-        // update offsets
-        for(size_t i=o.bdd_delimiters[o.bdd_delimiters.size()-2]; i<o.bdd_delimiters.back()-2; ++i)
         {
-            auto& bdd = o.bdd_instructions[i];
-
             if(bdd.lo == bdd_instruction::temp_botsink_index)
-                bdd.lo = o.bdd_delimiters.back()-1;
+                bdd.lo = botsink_pos;
             else if(bdd.lo == bdd_instruction::temp_topsink_index)
-                bdd.lo = o.bdd_delimiters.back()-2;
+                bdd.lo = topsink_pos;
             else
-                bdd.lo += o.bdd_delimiters[o.bdd_delimiters.size()-2];
+                bdd.lo += first;
 
             if(bdd.hi == bdd_instruction::temp_botsink_index)
-                bdd.hi = o.bdd_delimiters.back()-1;
+                bdd.hi = botsink_pos;
             else if(bdd.hi == bdd_instruction::temp_topsink_index)
-                bdd.hi = o.bdd_delimiters.back()-2;
+                bdd.hi = topsink_pos;
             else
-                bdd.hi += o.bdd_delimiters[o.bdd_delimiters.size()-2];
+                bdd.hi += first;
+
+            o.bdd_instructions.push_back(bdd);
         }
 
+        // add terminal nodes
+        o.bdd_instructions.push_back(bdd_instruction::topsink());
+        o.bdd_instructions.push_back(bdd_instruction::botsink());
+        o.bdd_delimiters.push_back(o.bdd_instructions.size());
+
         const size_t new_bdd_nr = o.bdd_delimiters.size()-2;
         o.reorder(new_bdd_nr);
 
@@ -1799,21 +1661,113 @@ namespace BDD {
 
     void bdd_collection::append(const bdd_collection& o)
     {
+        // arcs are relative, hence instructions are copied verbatim
         const size_t offset = bdd_instructions.size();
+        const size_t nr_o_instructions = o.bdd_delimiters.back();
+        bdd_instructions.resize(offset + nr_o_instructions);
+        bdd_instructions.copy(o.bdd_instructions, 0, nr_o_instructions, offset);
         for(size_t o_bdd_nr=0; o_bdd_nr<o.nr_bdds(); ++o_bdd_nr)
+            bdd_delimiters.push_back(offset + o.bdd_delimiters[o_bdd_nr+1]);
+    }
+
+    std::tuple<std::vector<bdd_collection>, std::vector<std::vector<size_t>>> bdd_collection::connected_components() const
+    {
+        size_t nr_vars = 0;
+        for(const auto& instr : bdd_instructions)
+            if(!instr.is_terminal())
+                nr_vars = std::max(nr_vars, instr.index + 1);
+
+        LPMP::union_find uf(nr_vars);
+        for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+            for(size_t i=bdd_delimiters[bdd_nr]; i<bdd_delimiters[bdd_nr+1]; ++i)
+                if(!bdd_instructions[i].is_terminal())
+                    uf.merge(bdd_instructions[bdd_delimiters[bdd_nr]].index, bdd_instructions[i].index);
+
+        // BDDs without variables are put into the first component
+        std::vector<size_t> root_to_component(nr_vars, std::numeric_limits<size_t>::max());
+        std::vector<size_t> bdd_component(nr_bdds(), 0);
+        std::vector<size_t> component_size;
+        for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
+        {
+            const bdd_instruction& root = bdd_instructions[bdd_delimiters[bdd_nr]];
+            if(root.is_terminal())
+                continue;
+            const size_t r = uf.find(root.index);
+            if(root_to_component[r] == std::numeric_limits<size_t>::max())
+            {
+                root_to_component[r] = component_size.size();
+                component_size.push_back(0);
+            }
+            bdd_component[bdd_nr] = root_to_component[r];
+            component_size[bdd_component[bdd_nr]] += nr_bdd_nodes(bdd_nr);
+        }
+        if(component_size.size() == 0 && nr_bdds() > 0)
+            component_size.push_back(0);
+
+        std::vector<size_t> component_order(component_size.size());
+        std::iota(component_order.begin(), component_order.end(), 0);
+        std::stable_sort(component_order.begin(), component_order.end(), [&](const size_t i, const size_t j) { return component_size[i] > component_size[j]; });
+        std::vector<size_t> component_rank(component_size.size());
+        for(size_t c=0; c<component_order.size(); ++c)
+            component_rank[component_order[c]] = c;
+
+        std::vector<std::vector<size_t>> component_variables(component_size.size());
+        std::vector<size_t> local_variable(nr_vars, std::numeric_limits<size_t>::max());
+        for(size_t v=0; v<nr_vars; ++v)
+        {
+            const size_t c = root_to_component[uf.find(v)];
+            if(c == std::numeric_limits<size_t>::max())
+                continue; // variable is not covered by any BDD
+            local_variable[v] = component_variables[component_rank[c]].size();
+            component_variables[component_rank[c]].push_back(v);
+        }
+
+        std::vector<bdd_collection> components(component_size.size());
+        for(size_t bdd_nr=0; bdd_nr<nr_bdds(); ++bdd_nr)
         {
-            for(size_t j=o.bdd_delimiters[o_bdd_nr]; j<o.bdd_delimiters[o_bdd_nr+1]; ++j)
+            bdd_collection& o = components[component_rank[bdd_component[bdd_nr]]];
+            const size_t first = bdd_delimiters[bdd_nr];
+            const size_t o_first = o.bdd_instructions.size();
+            for(size_t i=first; i<bdd_delimiters[bdd_nr+1]; ++i)
             {
-                assert(j < o.bdd_instructions.size());
-                bdd_instruction o_bdd = o.bdd_instructions[j];
-                if(!o_bdd.is_terminal())
+                bdd_instruction instr = bdd_instructions[i];
+                if(!instr.is_terminal())
                 {
-                    o_bdd.lo += offset;
-                    o_bdd.hi += offset;
+                    instr.lo = instr.lo - first + o_first;
+                    instr.hi = instr.hi - first + o_first;
+                    instr.index = local_variable[instr.index];
                 }
-                bdd_instructions.push_back(o_bdd);
+                o.bdd_instructions.push_back(instr);
             }
-            bdd_delimiters.push_back(bdd_instructions.size());
+            o.bdd_delimiters.push_back(o.bdd_instructions.size());
+        }
+
+        return {std::move(components), std::move(component_variables)};
+    }
+
+    void bdd_collection::append(const std::vector<bdd_collection>& cols)
+    {
+        std::vector<size_t> instruction_offsets = {bdd_instructions.size()};
+        std::vector<size_t> delimiter_offsets = {bdd_delimiters.size()};
+        size_t nr_uncompressed = bdd_instructions.nr_uncompressed();
+        for(const auto& o : cols)
+        {
+            instruction_offsets.push_back(instruction_offsets.back() + o.bdd_instructions.size());
+            delimiter_offsets.push_back(delimiter_offsets.back() + o.nr_bdds());
+            nr_uncompressed += o.bdd_instructions.nr_uncompressed();
+        }
+        bdd_instructions.resize(instruction_offsets.back());
+        bdd_delimiters.resize(delimiter_offsets.back());
+
+        // arcs are relative, hence instructions are copied verbatim. Only uncompressed instructions need to be reallocated, which is done sequentially.
+#pragma omp parallel for schedule(dynamic) if(nr_uncompressed == 0)
+        for(size_t i=0; i<cols.size(); ++i)
+        {
+            const bdd_collection& o = cols[i];
+            const size_t offset = instruction_offsets[i];
+            bdd_instructions.copy(o.bdd_instructions, 0, o.bdd_instructions.size(), offset);
+            for(size_t o_bdd_nr=0; o_bdd_nr<o.nr_bdds(); ++o_bdd_nr)
+                bdd_delimiters[delimiter_offsets[i] + o_bdd_nr] = offset + o.bdd_delimiters[o_bdd_nr+1];
         }
     }
 
@@ -1937,7 +1891,7 @@ namespace BDD {
         assert(i < bce.bdd_col.bdd_instructions.size());
         assert(i < node.i);
         assert(node.i < bce.bdd_col.bdd_instructions.size());
-        auto& instr = bce.bdd_col.bdd_instructions[i];
+        auto instr = bce.bdd_col.bdd_instructions[i];
         instr.lo = node.i;
     }
 
@@ -1946,35 +1900,35 @@ namespace BDD {
         assert(i < bce.bdd_col.bdd_instructions.size());
         assert(i < node.i);
         assert(node.i < bce.bdd_col.bdd_instructions.size());
-        auto& instr = bce.bdd_col.bdd_instructions[i];
+        auto instr = bce.bdd_col.bdd_instructions[i];
         instr.hi = node.i;
     }
 
     void bdd_collection_node::set_lo_to_0_terminal()
     {
         assert(i < bce.bdd_col.bdd_instructions.size());
-        auto& instr = bce.bdd_col.bdd_instructions[i];
+        auto instr = bce.bdd_col.bdd_instructions[i];
         instr.lo = bdd_instruction::temp_botsink_index;
     }
 
     void bdd_collection_node::set_lo_to_1_terminal()
     {
         assert(i < bce.bdd_col.bdd_instructions.size());
-        auto& instr = bce.bdd_col.bdd_instructions[i];
+        auto instr = bce.bdd_col.bdd_instructions[i];
         instr.lo = bdd_instruction::temp_topsink_index;
     }
 
     void bdd_collection_node::set_hi_to_0_terminal()
     {
         assert(i < bce.bdd_col.bdd_instructions.size());
-        auto& instr = bce.bdd_col.bdd_instructions[i];
+        auto instr = bce.bdd_col.bdd_instructions[i];
         instr.hi = bdd_instruction::temp_botsink_index;
     }
 
     void bdd_collection_node::set_hi_to_1_terminal()
     {
         assert(i < bce.bdd_col.bdd_instructions.size());
-        auto& instr = bce.bdd_col.bdd_instructions[i];
+        auto instr = bce.bdd_col.bdd_instructions[i];
         instr.hi = bdd_instruction::temp_topsink_index;
     }
 
@@ -2006,16 +1960,18 @@ namespace BDD {
     void bdd_collection::negate(const size_t bdd_nr)
     {
         assert(bdd_nr < nr_bdds());
-        std::swap(bdd_instructions[bdd_delimiters[bdd_nr+1]-1], bdd_instructions[bdd_delimiters[bdd_nr+1]-2]);
+        const bdd_instruction last = bdd_instructions[bdd_delimiters[bdd_nr+1]-1];
+        bdd_instructions[bdd_delimiters[bdd_nr+1]-1] = bdd_instructions[bdd_delimiters[bdd_nr+1]-2];
+        bdd_instructions[bdd_delimiters[bdd_nr+1]-2] = last;
     }
 
     void bdd_collection::invert(const size_t bdd_nr, const size_t var)
     {
         for (size_t bdd_idx = bdd_delimiters[bdd_nr]; bdd_idx < bdd_delimiters[bdd_nr + 1] - 2; ++bdd_idx)
         {
-            auto &bdd_instr = bdd_instructions[bdd_idx];
+            const bdd_instruction bdd_instr = bdd_instructions[bdd_idx];
             if (var == bdd_instr.index)
-                std::swap(bdd_instr.lo, bdd_instr.hi);
+                bdd_instructions.set(bdd_idx, {bdd_instr.hi, bdd_instr.lo, bdd_instr.index});
         }
     }
 
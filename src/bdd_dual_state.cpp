@@ -0,0 +1,157 @@
+#include "bdd_dual_state.h"
+#include "mmap_file.h"
+#include "hash_helper.hxx"
+#include "bdd_logging.h"
+#include "time_measure_util.h"
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <type_traits>
+#include <unistd.h>
+
+namespace LPMP {
+
+    namespace {
+
+        constexpr char magic[8] = {'L','P','M','P','B','D','D','D'};
+        constexpr uint32_t version = 2;
+        constexpr uint32_t byte_order_mark = 0x01020304;
+
+        struct header {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order_mark;
+            uint64_t key;
+            uint64_t solver_type;
+            uint64_t nr_bdd_instructions;
+            uint64_t nr_uncompressed_instructions;
+            uint64_t nr_bdds;
+            uint64_t nr_variables;
+            uint64_t nr_bdd_nodes;
+        };
+        static_assert(sizeof(header) % 8 == 0);
+        static_assert(sizeof(std::array<double,2>) == 2*sizeof(double));
+        static_assert(sizeof(BDD::compact_bdd_instruction) == 3*sizeof(uint32_t) && std::is_trivially_copyable_v<BDD::compact_bdd_instruction>);
+        static_assert(sizeof(BDD::bdd_instruction) == 3*sizeof(uint64_t) && std::is_trivially_copyable_v<BDD::bdd_instruction>);
+
+        size_t key_size(const bdd_dual_state::key_type& key)
+        {
+            return sizeof(BDD::compact_bdd_instruction) * key.instructions.size() + sizeof(BDD::bdd_instruction) * key.uncompressed_instructions.size() + sizeof(size_t) * key.delimiters.size();
+        }
+
+    }
+
+    bool bdd_dual_state::key_type::operator==(const key_type& o) const
+    {
+        return hash == o.hash && solver_type == o.solver_type
+            && instructions.size() == o.instructions.size()
+            && std::memcmp(instructions.data(), o.instructions.data(), sizeof(BDD::compact_bdd_instruction) * instructions.size()) == 0
+            && uncompressed_instructions == o.uncompressed_instructions
+            && delimiters == o.delimiters;
+    }
+
+    bdd_dual_state::key_type bdd_dual_state::key(const BDD::bdd_collection& bdd_col, const size_t solver_type)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        key_type k;
+        k.solver_type = solver_type;
+        k.instructions = bdd_col.instructions().compact_instructions();
+        k.uncompressed_instructions = bdd_col.instructions().uncompressed_instructions();
+        k.delimiters = bdd_col.delimiters();
+
+        size_t h = hash::hash_combine(version, solver_type);
+        h = hash::hash_combine(h, bdd_col.nr_bdds());
+        for(const size_t d : bdd_col.delimiters())
+            h = hash::hash_combine(h, d);
+        for(const auto& instr : bdd_col.instructions())
+        {
+            h = hash::hash_combine(h, instr.lo);
+            h = hash::hash_combine(h, instr.hi);
+            h = hash::hash_combine(h, instr.index);
+        }
+        k.hash = h;
+        return k;
+    }
+
+    bool bdd_dual_state::load(const std::string& filename, const key_type& key)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        if(!std::filesystem::exists(filename))
+            return false;
+
+        const mmap_file file(filename);
+        if(file.size() < sizeof(header))
+            throw std::runtime_error("dual state file " + filename + " is corrupt");
+        const header* h = reinterpret_cast<const header*>(file.begin());
+        if(std::memcmp(h->magic, magic, sizeof(magic)) != 0 || h->byte_order_mark != byte_order_mark)
+            throw std::runtime_error("dual state file " + filename + " is corrupt");
+        if(h->version != version)
+        {
+            bdd_log << "[bdd dual state] ignore " << filename << " written with format version " << h->version << "\n";
+            return false;
+        }
+        if(h->key != key.hash || h->solver_type != key.solver_type || h->nr_bdd_instructions != key.instructions.size() || h->nr_uncompressed_instructions != key.uncompressed_instructions.size() || h->nr_bdds + 1 != key.delimiters.size())
+        {
+            bdd_log << "[bdd dual state] ignore " << filename << ", it was written for other BDDs or another solver\n";
+            return false;
+        }
+        if(file.size() != sizeof(header) + key_size(key) + sizeof(double) * h->nr_variables + sizeof(std::array<double,2>) * h->nr_bdd_nodes)
+            throw std::runtime_error("dual state file " + filename + " has wrong size");
+
+        const char* pos = file.begin() + sizeof(header);
+        auto equal = [&](const auto& v) {
+            const size_t n = sizeof(typename std::remove_reference_t<decltype(v)>::value_type) * v.size();
+            const bool eq = std::memcmp(pos, v.data(), n) == 0;
+            pos += n;
+            return eq;
+        };
+        if(!equal(key.instructions) || !equal(key.uncompressed_instructions) || !equal(key.delimiters))
+        {
+            bdd_log << "[bdd dual state] ignore " << filename << ", it was written for other BDDs\n";
+            return false;
+        }
+
+        objective.resize(h->nr_variables);
+        std::memcpy(objective.data(), pos, h->nr_variables * sizeof(double));
+        pos += h->nr_variables * sizeof(double);
+        node_costs.resize(h->nr_bdd_nodes);
+        std::memcpy(node_costs.data(), pos, h->nr_bdd_nodes * sizeof(std::array<double,2>));
+
+        bdd_log << "[bdd dual state] loaded costs of " << node_costs.size() << " bdd nodes from " << filename << "\n";
+        return true;
+    }
+
+    void bdd_dual_state::store(const std::string& filename, const key_type& key) const
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        header h;
+        std::copy(std::begin(magic), std::end(magic), h.magic);
+        h.version = version;
+        h.byte_order_mark = byte_order_mark;
+        h.key = key.hash;
+        h.solver_type = key.solver_type;
+        h.nr_bdd_instructions = key.instructions.size();
+        h.nr_uncompressed_instructions = key.uncompressed_instructions.size();
+        h.nr_bdds = key.delimiters.size() - 1;
+        h.nr_variables = objective.size();
+        h.nr_bdd_nodes = node_costs.size();
+
+        // write into temporary file first so that concurrent runs never see partially written states
+        const std::string tmp_f = filename + ".tmp" + std::to_string(getpid());
+        {
+            std::ofstream s(tmp_f, std::ios::binary);
+            auto write = [&](const auto* data, const size_t n) { s.write(reinterpret_cast<const char*>(data), n * sizeof(*data)); };
+            write(&h, 1);
+            write(key.instructions.data(), key.instructions.size());
+            write(key.uncompressed_instructions.data(), key.uncompressed_instructions.size());
+            write(key.delimiters.data(), key.delimiters.size());
+            write(objective.data(), objective.size());
+            write(node_costs.data(), node_costs.size());
+            if(!s)
+                throw std::runtime_error("could not write dual state file " + tmp_f);
+        }
+        std::filesystem::rename(tmp_f, filename);
+        bdd_log << "[bdd dual state] stored costs of " << node_costs.size() << " bdd nodes in " << filename << "\n";
+    }
+
+}
@@ -2,6 +2,7 @@
 #include "lbfgs.h"
 #include "bdd_parallel_mma_base.h"
 #include "bdd_branch_instruction.h"
+#include "bdd_tightening.h"
 #include "time_measure_util.h"
 
 namespace LPMP {
@@ -37,6 +38,11 @@ namespace LPMP {
             _step_size_decrease_factor, _step_size_increase_factor);
     }
 
+    template<typename REAL>
+    bdd_lbfgs_parallel_mma<REAL>::bdd_lbfgs_parallel_mma(const bdd_lbfgs_parallel_mma& o)
+        : pimpl(std::make_unique<impl>(*o.pimpl))
+    {}
+
     template<typename REAL>
     bdd_lbfgs_parallel_mma<REAL>::bdd_lbfgs_parallel_mma(bdd_lbfgs_parallel_mma&& o)
         : pimpl(std::move(o.pimpl))
@@ -107,6 +113,69 @@ namespace LPMP {
         return pimpl->mma.min_marginals();
     }
 
+    template<typename REAL>
+    void bdd_lbfgs_parallel_mma<REAL>::update_costs(const two_dim_variable_array<std::array<double,2>>& delta)
+    {
+        two_dim_variable_array<std::array<REAL,2>> d(delta);
+        for(size_t i=0; i<delta.size(); ++i)
+            for(size_t j=0; j<delta.size(i); ++j)
+                d(i,j) = {REAL(delta(i,j)[0]), REAL(delta(i,j)[1])};
+        pimpl->mma.update_costs(d);
+    }
+
+    template<typename REAL>
+        template<typename ITERATOR>
+        two_dim_variable_array<char> bdd_lbfgs_parallel_mma<REAL>::bdd_feasibility(ITERATOR sol_begin, ITERATOR sol_end)
+        {
+            return pimpl->mma.bdd_feasibility(sol_begin, sol_end);
+        }
+
+    template<typename REAL>
+    std::vector<std::array<double,2>> bdd_lbfgs_parallel_mma<REAL>::node_costs() const
+    {
+        const auto costs = pimpl->mma.node_costs();
+        std::vector<std::array<double,2>> c(costs.size());
+        for(size_t i=0; i<costs.size(); ++i)
+            c[i] = {costs[i][0], costs[i][1]};
+        return c;
+    }
+
+    template<typename REAL>
+    void bdd_lbfgs_parallel_mma<REAL>::set_node_costs(const std::vector<std::array<double,2>>& costs)
+    {
+        std::vector<std::array<REAL,2>> c(costs.size());
+        for(size_t i=0; i<costs.size(); ++i)
+            c[i] = {REAL(costs[i][0]), REAL(costs[i][1])};
+        pimpl->mma.set_node_costs(c.begin(), c.end());
+    }
+
+    template<typename REAL>
+    void bdd_lbfgs_parallel_mma<REAL>::tighten()
+    {
+        tighten_parallel(pimpl->mma, 1e-6);
+    }
+
+    template<typename REAL>
+    void bdd_lbfgs_parallel_mma<REAL>::set_atomic_free_delta_aggregation(const bool atomic_free)
+    {
+        using base_type = bdd_parallel_mma_base<bdd_branch_instruction<REAL, uint16_t>>;
+        pimpl->mma.set_delta_aggregation(atomic_free ? base_type::delta_aggregation::gather : base_type::delta_aggregation::atomic);
+    }
+
+    template<typename REAL>
+    void bdd_lbfgs_parallel_mma<REAL>::set_deterministic(const bool deterministic)
+    {
+        pimpl->mma.set_deterministic(deterministic);
+    }
+
     template class bdd_lbfgs_parallel_mma<float>;
     template class bdd_lbfgs_parallel_mma<double>;
+
+    template two_dim_variable_array<char> bdd_lbfgs_parallel_mma<float>::bdd_feasibility(char*, char*);
+    template two_dim_variable_array<char> bdd_lbfgs_parallel_mma<float>::bdd_feasibility(std::vector<char>::iterator, std::vector<char>::iterator);
+    template two_dim_variable_array<char> bdd_lbfgs_parallel_mma<float>::bdd_feasibility(std::vector<char>::const_iterator, std::vector<char>::const_iterator);
+
+    template two_dim_variable_array<char> bdd_lbfgs_parallel_mma<double>::bdd_feasibility(char*, char*);
+    template two_dim_variable_array<char> bdd_lbfgs_parallel_mma<double>::bdd_feasibility(std::vector<char>::iterator, std::vector<char>::iterator);
+    template two_dim_variable_array<char> bdd_lbfgs_parallel_mma<double>::bdd_feasibility(std::vector<char>::const_iterator, std::vector<char>::const_iterator);
 }
@@ -1,6 +1,7 @@
 #include "bdd_manager/bdd_memo_cache.h"
 #include <cassert>
 #include <algorithm>
+#include <limits>
 
 namespace BDD {
 
@@ -14,9 +15,38 @@ namespace BDD {
         return !(*this == m);
     }
 
-    memo_cache::memo_cache(bdd_node_cache& _node_cache)
+    memo_cache_statistics& memo_cache_statistics::operator+=(const memo_cache_statistics& o)
+    {
+        hits += o.hits;
+        misses += o.misses;
+        inserts += o.inserts;
+        evictions += o.evictions;
+        memory += o.memory;
+        return *this;
+    }
+
+    double memo_cache_statistics::hit_rate() const
+    {
+        if(hits + misses == 0)
+            return 0.0;
+        return double(hits) / double(hits + misses);
+    }
+
+    memo_cache::memo_cache(bdd_node_cache& _node_cache, const size_t max_memory)
         : node_cache(_node_cache)
     {
+        set_max_memory(max_memory);
+    }
+
+    void memo_cache::set_max_memory(const size_t max_memory)
+    {
+        // largest power of two of sets fitting into the budget, but at least one set
+        const size_t set_size = associativity * sizeof(memo_struct);
+        max_nr_sets = 1;
+        while(2 * max_nr_sets * set_size <= max_memory)
+            max_nr_sets *= 2;
+        memos.clear();
+        memos.shrink_to_fit();
         init_cache();
     }
 
@@ -38,109 +68,91 @@ namespace BDD {
         return hash;
     }
 
-    memo_struct& memo_cache::get_memo(const size_t slot)
+    memo_struct* memo_cache::get_set(const size_t hash)
     {
-        assert(memos_mask + 1 == memos.size());
-        const size_t n = slot & memos_mask;
-        assert(n < memos.size());
-        //std::cout << "memo slot = " << n << ", memos size = " << memos.size() << ", cache mask = " << memos_mask << "\n";
-        return memos[n];
+        assert((sets_mask + 1) * associativity == memos.size());
+        return &memos[(hash & sets_mask) * associativity];
     }
 
     node* memo_cache::cache_lookup(node* f, node* g, node* h)
     {
-        /*
-        if(memos2.count({f,g,h}) == 0)
-            return nullptr;
-
-        auto it = memos2.find({f,g,h})->second;
-        std::get<1>(it->second)++;
-        node* r = std::get<0>(it->second);
-        if(cache_inserts++ > threshold)
-        {
-            cache_inserts = 0;
-            for(auto [k, v] : memos)
-            {
-                const size_t ts = std::get<1>(v);
-
-            }
-
-        }
-        return r;
-        */
-        ////////
-
-        const size_t slot = cache_hash(f,g,h);
-        const memo_struct& m = get_memo(slot); 
-        if(m.r == nullptr)
-            return nullptr;
-        if(m.f == f && m.g == g && m.h == h) 
+        memo_struct* set = get_set(cache_hash(f,g,h));
+        for(size_t i=0; i<associativity && set[i].r != nullptr; ++i)
         {
-            assert(m.r != nullptr);
-            if(m.r->xref < 0)
+            if(set[i].f == f && set[i].g == g && set[i].h == h)
             {
-                assert(false);
-                m.r->recursively_revive();
-                return m.r;
+                assert(set[i].r->xref >= 0);
+                // move to front of the set
+                std::rotate(set, set + i, set + i + 1);
+                stats.hits++;
+                return set[0].r;
             }
-            //m.r->xref++;
-            return m.r;
         }
+        stats.misses++;
         return nullptr;
     }
 
     void memo_cache::cache_insert(node* f, node* g, node* h, node* r)
     {
-        //memos2.insert(std::make_pair(std::array<node*,3>({f,g,h}),{r,insert_time_stamp++}));
-        //return;
-        ////////
-
-        const size_t slot = cache_hash(f,g,h);
+        assert(r != nullptr);
         if(++cache_inserts >= threshold)
             double_cache();
-        memo_struct& m = get_memo(cache_hash(f,g,h));
-        m.f = f;
-        m.g = g;
-        m.h = h;
-        m.r = r;
+        stats.inserts++;
+
+        memo_struct* set = get_set(cache_hash(f,g,h));
+        // entry may be present already if it was computed simultaneously by another thread
+        size_t i = 0;
+        for(; i<associativity-1 && set[i].r != nullptr; ++i)
+            if(set[i].f == f && set[i].g == g && set[i].h == h)
+                break;
+        if(i == associativity-1 && set[i].r != nullptr && !(set[i].f == f && set[i].g == g && set[i].h == h))
+            stats.evictions++;
+
+        // entries before i move back by one, the least recently used one is overwritten if the set is full
+        std::move_backward(set, set + i, set + i + 1);
+        set[0] = memo_struct{f, g, h, r};
     }
 
     void memo_cache::init_cache()
     {
         assert(memos.size() == 0);
-        memos.resize(1);
-        memos_mask = 0;
+        memos.resize(associativity);
+        sets_mask = 0;
+        cache_inserts = 0;
+        threshold = 1 + associativity;
+        stats.memory = memos.size() * sizeof(memo_struct);
     }
 
     void memo_cache::double_cache()
     {
-        //std::cout << "double cache size\n";
-        if(memos.size() >= 2<<21)
-            return;
         cache_inserts = 0;
+        // lossy replacement once the budget is exhausted
+        if(nr_sets() >= max_nr_sets)
+        {
+            threshold = std::numeric_limits<size_t>::max();
+            return;
+        }
+
+        std::vector<memo_struct> old_memos(2 * memos.size());
+        std::swap(old_memos, memos);
+        sets_mask = nr_sets() - 1;
         threshold = 1 + memos.size();
-        assert(memos.size() > 0);
-        memos.resize(2 * memos.size());
-        memos_mask = memos.size()-1;
-        //std::cout << "new cache size = " << memos.size() << "\n";
-
-        // rehash items on bottom half
-        size_t occupied_slots = 0;
-        for(size_t k = 0; k < memos.size()/2; ++k)
+        stats.memory = memos.size() * sizeof(memo_struct);
+
+        // rehash, going through old sets in order keeps the recency order within the split sets
+        for(size_t k = 0; k < old_memos.size(); ++k)
         {
-            memo& m = memos[k];
-            if(m.r != nullptr)
-            {
-                ++occupied_slots;
-                memo& mm = get_memo(cache_hash(m.f, m.g, m.h));
-                if(mm != m)
-                {
-                    mm = m;
-                    m.r = nullptr;
-                } 
-            } 
-        } 
-        cache_inserts = occupied_slots;
+            const memo_struct& m = old_memos[k];
+            if(m.r == nullptr)
+                continue;
+            memo_struct* set = get_set(cache_hash(m.f, m.g, m.h));
+            size_t i = 0;
+            while(set[i].r != nullptr)
+                ++i;
+            assert(i < associativity);
+            set[i] = m;
+            ++cache_inserts;
+        }
     }
 
     bool memo_struct::can_be_purged() const
@@ -156,22 +168,6 @@ namespace BDD {
         return false;
     }
 
-    size_t memo_cache::choose_cache_size(const size_t items) const
-    {
-        // size shall be power of 2 such that not more than a quarter of slots are taken
-        size_t count = 0;
-        size_t c = items;
-        while(c != 0)
-        {
-            c >>= 1;  
-            count += 1;  
-        }  
-        size_t n = 1 << (count+2);  
-        assert(4*items >= n);
-        assert(8*items <= n);
-        return n;
-    }
-
     size_t memo_cache::nr_occupied_slots() const
     {
         return std::count_if(memos.begin(), memos.end(), [](const auto& m) { return !m.can_be_purged(); });
@@ -179,31 +175,69 @@ namespace BDD {
 
     void memo_cache::purge()
     {
-        size_t items = 0;
         for(size_t k = 0; k < memos.size(); ++k)
             if(memos[k].can_be_purged())
                 memos[k].r = nullptr;
-            else
-                ++items;
 
-        return;
-        // TODO: resize memo cache? A resize will often not physically deallocate freed memory.
-        cache_inserts = items;
-        const size_t new_cache_size = choose_cache_size(items);
+        // keep valid entries at the front of their set in recency order
+        for(size_t k = 0; k < memos.size(); k += associativity)
+            std::stable_partition(memos.begin() + k, memos.begin() + k + associativity, [](const memo_struct& m) { return m.r != nullptr; });
+        cache_inserts = nr_occupied_slots();
+    }
+
+    concurrent_memo_cache::concurrent_memo_cache(bdd_node_cache& _node_cache, const size_t max_memory)
+    {
+        shards_.reserve(nr_shards);
+        for(size_t i=0; i<nr_shards; ++i)
+            shards_.emplace_back(_node_cache, max_memory / nr_shards);
+    }
+
+    size_t concurrent_memo_cache::shard(node* f, node* g, node* h)
+    {
+        // take high bits after multiplicative hashing, the low bits address slots within the shard
+        return (memo_cache::cache_hash(f,g,h) * 0x9e3779b97f4a7c15ull) >> (64 - log_nr_shards);
+    }
+
+    node* concurrent_memo_cache::cache_lookup(node* f, node* g, node* h)
+    {
+        const size_t s = shard(f,g,h);
+        std::lock_guard<std::mutex> lock(mutexes_[s]);
+        return shards_[s].cache_lookup(f,g,h);
+    }
+
+    void concurrent_memo_cache::cache_insert(node* f, node* g, node* h, node* r)
+    {
+        const size_t s = shard(f,g,h);
+        std::lock_guard<std::mutex> lock(mutexes_[s]);
+        shards_[s].cache_insert(f,g,h,r);
+    }
+
+    void concurrent_memo_cache::purge()
+    {
+        for(size_t s=0; s<nr_shards; ++s)
+        {
+            std::lock_guard<std::mutex> lock(mutexes_[s]);
+            shards_[s].purge();
+        }
+    }
+
+    void concurrent_memo_cache::set_max_memory(const size_t max_memory)
+    {
+        for(size_t s=0; s<nr_shards; ++s)
+        {
+            std::lock_guard<std::mutex> lock(mutexes_[s]);
+            shards_[s].set_max_memory(max_memory / nr_shards);
+        }
+    }
 
-        if(new_cache_size < memos.size())
+    memo_cache_statistics concurrent_memo_cache::statistics() const
+    {
+        memo_cache_statistics stats;
+        for(size_t s=0; s<nr_shards; ++s)
         {
-            size_t memos_mask = new_cache_size - 1;
-            for(size_t k = 0; k < memos.size(); ++k)
-            {
-                if(memos[k].r != nullptr && memos[k].h != nullptr)
-                {
-                    const size_t new_slot = cache_hash(memos[k].f, memos[k].g, memos[k].h) & memos_mask;
-                    if(new_slot != k)
-                        memos[new_slot] = memos[k];
-                }
-            }
-            memos.resize(new_cache_size);
+            std::lock_guard<std::mutex> lock(mutexes_[s]);
+            stats += shards_[s].statistics();
         }
+        return stats;
     }
 }
@@ -2,13 +2,20 @@
 #include "bdd_collection/bdd_collection.h"
 #include <cassert>
 #include <stack>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace BDD {
 
-    bdd_mgr::bdd_mgr()
-        : node_cache_(this),
+    bdd_mgr::bdd_mgr(const bool concurrent)
+        : concurrent_(concurrent),
+        node_cache_(this, concurrent),
         memo_(node_cache_)
-    {}
+    {
+        if(concurrent_)
+            concurrent_memo_ = std::make_unique<concurrent_memo_cache>(node_cache_);
+    }
 
     bdd_mgr::~bdd_mgr()
     {
@@ -18,15 +25,55 @@ namespace BDD {
 
     size_t bdd_mgr::add_variable()
     {
+        auto lock = lock_if_concurrent(vars_mutex_, concurrent_);
         assert(vars.size() < maxvarsize);
-        vars.emplace_back(vars.size(), *this);
+        vars.emplace_back(*this);
         return vars.size()-1;
     }
 
+    void bdd_mgr::add_variables(const size_t nr_vars)
+    {
+        if(vars.size() >= nr_vars)
+            return;
+        auto lock = lock_if_concurrent(vars_mutex_, concurrent_);
+        assert(nr_vars <= maxvarsize);
+        while(vars.size() < nr_vars)
+            vars.emplace_back(*this);
+    }
+
+    node* bdd_mgr::memo_lookup(node* f, node* g, node* h)
+    {
+        if(concurrent_)
+            return concurrent_memo_->cache_lookup(f, g, h);
+        return memo_.cache_lookup(f, g, h);
+    }
+
+    void bdd_mgr::memo_insert(node* f, node* g, node* h, node* r)
+    {
+        if(concurrent_)
+            concurrent_memo_->cache_insert(f, g, h, r);
+        else
+            memo_.cache_insert(f, g, h, r);
+    }
+
+    void bdd_mgr::set_memo_cache_memory(const size_t bytes)
+    {
+        if(concurrent_)
+            concurrent_memo_->set_max_memory(bytes);
+        else
+            memo_.set_max_memory(bytes);
+    }
+
+    memo_cache_statistics bdd_mgr::memo_cache_stats() const
+    {
+        if(concurrent_)
+            return concurrent_memo_->statistics();
+        return memo_.statistics();
+    }
+
     node_ref bdd_mgr::projection(const size_t var)
     {
-        for(size_t i=vars.size(); i<=var; ++i)
-            add_variable();
+        add_variables(var+1);
         assert(var < vars.size());
         return node_ref(vars[var].unique_find(node_cache_.botsink(), node_cache_.topsink()));
         //return vars[var].projection();
@@ -75,18 +122,14 @@ namespace BDD {
         else if(g.ref == node_cache_.botsink())
             return node_ref(node_cache_.botsink()); 
 
-        node* m = memo_.cache_lookup(f.ref, g.ref, memo_struct::and_symb());
+        node* m = memo_lookup(f.ref, g.ref, memo_struct::and_symb());
         if(m != nullptr)
             return node_ref(m);
 
         var& f_var = vars[f.variable()];
         var& g_var = vars[g.variable()];
-        var& v = [&]() -> var& {
-            if(&f_var < &g_var)
-                return f_var;
-            else 
-                return g_var;
-        }();
+        // variables may lie in different segments of var_storage, hence compare indices and not addresses
+        var& v = f.variable() < g.variable() ? f_var : g_var;
 
         node_ref r0 = and_rec(&v == &f_var ? f.low() : f, &v == &g_var ? g.low() : g);
         assert(r0.ref != nullptr);
@@ -96,7 +139,7 @@ namespace BDD {
         node* r = v.unique_find(r0.ref, r1.ref);
         assert(r != nullptr);
         //if(r != nullptr)
-        memo_.cache_insert(f.ref, g.ref, memo_struct::and_symb(), r);
+        memo_insert(f.ref, g.ref, memo_struct::and_symb(), r);
         return node_ref(r); 
     }
 
@@ -123,7 +166,7 @@ namespace BDD {
         else if(g.ref == node_cache_.botsink())
             return {node_ref(node_cache_.botsink()),0};
 
-        node* m = memo_.cache_lookup(f.ref, g.ref, memo_struct::and_symb());
+        node* m = memo_lookup(f.ref, g.ref, memo_struct::and_symb());
         if(m != nullptr)
         {
             const size_t m_nr_nodes = m->nr_nodes();
@@ -138,12 +181,8 @@ namespace BDD {
 
         var& f_var = vars[f.variable()];
         var& g_var = vars[g.variable()];
-        var& v = [&]() -> var& {
-            if(&f_var < &g_var)
-                return f_var;
-            else 
-                return g_var;
-        }();
+        // variables may lie in different segments of var_storage, hence compare indices and not addresses
+        var& v = f.variable() < g.variable() ? f_var : g_var;
 
         auto [r0, r0_nr_nodes] = and_rec_limited(&v == &f_var ? f.low() : f, &v == &g_var ? g.low() : g, node_limit);
         assert((r0 == nullptr) == (r0_nr_nodes == std::numeric_limits<size_t>::max()));
@@ -159,7 +198,7 @@ namespace BDD {
         node* r = v.unique_find(r0.ref, r1.ref);
         assert(r != nullptr);
         //if(r != nullptr)
-        memo_.cache_insert(f.ref, g.ref, memo_struct::and_symb(), r);
+        memo_insert(f.ref, g.ref, memo_struct::and_symb(), r);
         return {node_ref(r),r0_nr_nodes + r1_nr_nodes}; 
     }
 
@@ -192,19 +231,15 @@ namespace BDD {
             return f;
         }
 
-        node* m = memo_.cache_lookup(f.ref, g.ref, memo_struct::or_symb());
+        node* m = memo_lookup(f.ref, g.ref, memo_struct::or_symb());
         if(m != nullptr)
             return m;
 
         // find recursively
         var& f_var = vars[f.variable()];
         var& g_var = vars[g.variable()];
-        var& v = [&]() -> var& {
-            if(&f_var < &g_var)
-                return f_var;
-            else 
-                return g_var;
-        }();
+        // variables may lie in different segments of var_storage, hence compare indices and not addresses
+        var& v = f.variable() < g.variable() ? f_var : g_var;
 
         node_ref r0 = or_rec(&v == &f_var ? f.low() : f, &v == &g_var ? g.low() : g);
         assert(r0.ref != nullptr);
@@ -213,7 +248,7 @@ namespace BDD {
         
         node* r = v.unique_find(r0.ref, r1.ref);
         if(r != nullptr)
-            memo_.cache_insert(f.ref, g.ref, memo_struct::or_symb(), r);
+            memo_insert(f.ref, g.ref, memo_struct::or_symb(), r);
         return node_ref(r); 
     }
 
@@ -235,7 +270,7 @@ namespace BDD {
         else if(g.ref == node_cache_.topsink())
             return negate(f);
 
-        node* m = memo_.cache_lookup(f.ref, g.ref, memo_struct::xor_symb());
+        node* m = memo_lookup(f.ref, g.ref, memo_struct::xor_symb());
         if(m != nullptr)
             return node_ref(m);
 
@@ -244,7 +279,7 @@ namespace BDD {
         var& vf = vars[f.variable()];
         assert(g.variable() < nr_variables());
         var& vg = vars[g.variable()];
-        var& v = *std::max(&vg,&vf);
+        var& v = f.variable() < g.variable() ? vf : vg;
 
         node_ref r0 = xor_rec(&v == &vf ? f.low() : f, &v == &vg ? g.low() : g);
         assert(r0.ref != nullptr);
@@ -253,7 +288,7 @@ namespace BDD {
         
         node* r = v.unique_find(r0.ref, r1.ref);
         if(r != nullptr)
-            memo_.cache_insert(f.ref, g.ref, memo_struct::xor_symb(), r);
+            memo_insert(f.ref, g.ref, memo_struct::xor_symb(), r);
         return node_ref(r); 
     }
 
@@ -276,43 +311,186 @@ namespace BDD {
         if(g.is_botsink() && h.is_topsink())
             return xor_rec(node_ref(get_node_cache().topsink()), f);
 
-        node* m = memo_.cache_lookup(f.ref, g.ref, h.ref);
+        node* m = memo_lookup(f.ref, g.ref, h.ref);
         if(m != nullptr)
             return node_ref(m);
 
-        var& vf = vars[f.variable()];
-        var& vg = g.is_terminal() ? vars.back() : vars[g.variable()];
-        var& vh = h.is_terminal() ? vars.back() : vars[h.variable()];
-
-        //var& v = *std::min({&vf,&vg,&vh}); // compilation error on gcc-8.1?
-        var& v = *std::min(std::min(&vf,&vg),&vh);
+        // terminals have larger indices than all variables
+        const size_t v_idx = std::min(std::min(f.variable(), g.variable()), h.variable());
+        var& v = vars[v_idx];
 
         node_ref r0 = ite_rec(
-                (&vf == &v ? f.low() : f),
-                (&vg == &v ? g.low() : g),
-                (&vh == &v ? h.low() : h)
+                (f.variable() == v_idx ? f.low() : f),
+                (g.variable() == v_idx ? g.low() : g),
+                (h.variable() == v_idx ? h.low() : h)
                 );
         assert(r0.ref != nullptr);
 
         node_ref r1 = ite_rec(
-                (&vf == &v ? f.high() : f),
-                (&vg == &v ? g.high() : g),
-                (&vh == &v ? h.high() : h)
+                (f.variable() == v_idx ? f.high() : f),
+                (g.variable() == v_idx ? g.high() : g),
+                (h.variable() == v_idx ? h.high() : h)
                 );
         assert(r1.ref != nullptr);
 
         node* r = v.unique_find(r0.ref, r1.ref);
         assert(r != nullptr);
-        memo_.cache_insert(f.ref, g.ref, h.ref, r);
+        memo_insert(f.ref, g.ref, h.ref, r);
         return node_ref(r); 
     }
 
+    node_ref bdd_mgr::apply(node* op, node_ref f, node_ref g)
+    {
+        if(op == memo_struct::and_symb())
+            return and_rec(f, g);
+        if(op == memo_struct::or_symb())
+            return or_rec(f, g);
+        assert(op == memo_struct::xor_symb());
+        return xor_rec(f, g);
+    }
+
+    void bdd_mgr::run_parallel(const std::function<void()>& f)
+    {
+#ifdef _OPENMP
+        if(!omp_in_parallel())
+        {
+#pragma omp parallel
+#pragma omp single
+            f();
+            return;
+        }
+#endif
+        f();
+    }
+
+    node_ref bdd_mgr::apply_parallel(node* op, node_ref f, node_ref g, const size_t depth)
+    {
+        // trivial cases and small subproblems are handled by the sequential apply
+        if(!concurrent_ || depth >= parallel_apply_depth_ || f == g || f.is_terminal() || g.is_terminal())
+            return apply(op, f, g);
+
+        if(f.ref > g.ref)
+            std::swap(f, g);
+
+        node* m = memo_lookup(f.ref, g.ref, op);
+        if(m != nullptr)
+            return node_ref(m);
+
+        const size_t v_idx = std::min(f.variable(), g.variable());
+
+        node_ref r0;
+#pragma omp task shared(r0)
+        r0 = apply_parallel(op, f.variable() == v_idx ? f.low() : f, g.variable() == v_idx ? g.low() : g, depth+1);
+        node_ref r1 = apply_parallel(op, f.variable() == v_idx ? f.high() : f, g.variable() == v_idx ? g.high() : g, depth+1);
+#pragma omp taskwait
+        assert(r0.ref != nullptr && r1.ref != nullptr);
+
+        node* r = vars[v_idx].unique_find(r0.ref, r1.ref);
+        assert(r != nullptr);
+        memo_insert(f.ref, g.ref, op, r);
+        return node_ref(r);
+    }
+
+    node_ref bdd_mgr::ite_parallel(node_ref f, node_ref g, node_ref h, const size_t depth)
+    {
+        // trivial cases
+        if(f.is_topsink())
+            return g;
+        if(f.is_botsink())
+            return h;
+
+        if(g == f || g.is_topsink())
+            return apply_parallel(memo_struct::or_symb(), f, h, depth);
+        if(h == f || h.is_botsink())
+            return apply_parallel(memo_struct::and_symb(), f, g, depth);
+
+        if(g == h)
+            return g;
+
+        if(g.is_botsink() && h.is_topsink())
+            return xor_rec(node_ref(get_node_cache().topsink()), f);
+
+        if(!concurrent_ || depth >= parallel_apply_depth_)
+            return ite_rec(f, g, h);
+
+        node* m = memo_lookup(f.ref, g.ref, h.ref);
+        if(m != nullptr)
+            return node_ref(m);
+
+        const size_t v_idx = std::min(std::min(f.variable(), g.variable()), h.variable());
+
+        node_ref r0;
+#pragma omp task shared(r0)
+        r0 = ite_parallel(
+                (f.variable() == v_idx ? f.low() : f),
+                (g.variable() == v_idx ? g.low() : g),
+                (h.variable() == v_idx ? h.low() : h),
+                depth+1);
+        node_ref r1 = ite_parallel(
+                (f.variable() == v_idx ? f.high() : f),
+                (g.variable() == v_idx ? g.high() : g),
+                (h.variable() == v_idx ? h.high() : h),
+                depth+1);
+#pragma omp taskwait
+        assert(r0.ref != nullptr && r1.ref != nullptr);
+
+        node* r = vars[v_idx].unique_find(r0.ref, r1.ref);
+        assert(r != nullptr);
+        memo_insert(f.ref, g.ref, h.ref, r);
+        return node_ref(r);
+    }
+
+    node_ref bdd_mgr::reduce_parallel(node* op, node_ref* nodes, const size_t n)
+    {
+        assert(n >= 1);
+        if(n == 1)
+            return nodes[0];
+
+        const size_t middle = n/2;
+        node_ref lhs;
+#pragma omp task shared(lhs)
+        lhs = reduce_parallel(op, nodes, middle);
+        node_ref rhs = reduce_parallel(op, nodes + middle, n - middle);
+#pragma omp taskwait
+        return apply_parallel(op, lhs, rhs, 0);
+    }
+
+    node_ref bdd_mgr::and_rec_parallel(node_ref f, node_ref g)
+    {
+        node_ref r;
+        run_parallel([&]() { r = apply_parallel(memo_struct::and_symb(), f, g, 0); });
+        return r;
+    }
+
+    node_ref bdd_mgr::or_rec_parallel(node_ref f, node_ref g)
+    {
+        node_ref r;
+        run_parallel([&]() { r = apply_parallel(memo_struct::or_symb(), f, g, 0); });
+        return r;
+    }
+
+    node_ref bdd_mgr::xor_rec_parallel(node_ref f, node_ref g)
+    {
+        node_ref r;
+        run_parallel([&]() { r = apply_parallel(memo_struct::xor_symb(), f, g, 0); });
+        return r;
+    }
+
+    node_ref bdd_mgr::ite_rec_parallel(node_ref f, node_ref g, node_ref h)
+    {
+        node_ref r;
+        run_parallel([&]() { r = ite_parallel(f, g, h, 0); });
+        return r;
+    }
+
     void bdd_mgr::collect_garbage()
     {
         for(size_t i=0; i<vars.size(); ++i)
             vars[i].remove_dead_nodes();
 
         memo_.purge();
+        if(concurrent_)
+            concurrent_memo_->purge();
     }
 
     node_ref bdd_mgr::add_bdd(bdd_collection& bdd_col, const size_t bdd_nr)
@@ -322,18 +500,19 @@ namespace BDD {
         std::unordered_map<size_t, node_ref> bdd_map;
         for(auto bdd_it=bdd_end; bdd_it!=bdd_begin; --bdd_it)
         {
-            const auto& bdd = *std::prev(bdd_it);
+            const auto bdd = *std::prev(bdd_it);
+            const size_t bdd_offset = bdd_col.offset(std::prev(bdd_it));
             if(bdd.is_botsink())
             {
-                bdd_map.insert({bdd_col.offset(bdd), botsink()}); 
+                bdd_map.insert({bdd_offset, botsink()}); 
             }
             else if(bdd.is_topsink())
             {
-                bdd_map.insert({bdd_col.offset(bdd), topsink()}); 
+                bdd_map.insert({bdd_offset, topsink()}); 
             }
             else
             { 
-                assert(bdd_col.offset(bdd) < 1000); // TODO: remove
+                assert(bdd_offset < 1000); // TODO: remove
                 assert(bdd_map.count(bdd.lo) > 0);
                 node_ref lo = bdd_map.find(bdd.lo)->second;
 
@@ -342,11 +521,11 @@ namespace BDD {
 
                 node_ref node = ite_rec(projection(bdd.index), hi, lo);
 
-                bdd_map.insert({bdd_col.offset(bdd), node});
+                bdd_map.insert({bdd_offset, node});
             }
         }
-        assert(bdd_map.count(bdd_col.offset(*bdd_begin)) > 0);
-        return bdd_map.find(bdd_col.offset(*bdd_begin))->second;
+        assert(bdd_map.count(bdd_col.offset(bdd_begin)) > 0);
+        return bdd_map.find(bdd_col.offset(bdd_begin))->second;
     }
 
     node_ref bdd_mgr::simplex(const size_t n)
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <cstring>
 #include <deque>
+#include <tuple>
+#include <unordered_set>
 #include <fstream>
 #include <filesystem>
 #include <cstdlib>
@@ -22,9 +24,10 @@ namespace BDD {
         marked_ = 0;
         xref = 0;
 
-        static std::random_device rd;
-        static std::mt19937 unique_table_gen(rd());
-        static std::uniform_int_distribution<std::size_t> unique_table_distribution(0,hashtablesize-1);
+        // per thread generators, since nodes of a concurrent bdd_mgr are created by several threads
+        static thread_local std::random_device rd;
+        static thread_local std::mt19937 unique_table_gen(rd());
+        static thread_local std::uniform_int_distribution<std::size_t> unique_table_distribution(0,hashtablesize-1);
 
         hash_key = unique_table_distribution(unique_table_gen);
 
@@ -32,6 +35,8 @@ namespace BDD {
 
     size_t node::nr_nodes()
     {
+        if(in_concurrent_mgr())
+            return nodes_postorder_unmarked().size();
         assert(marked_ == 0);
         const size_t n = nr_nodes_impl();
         unmark();
@@ -57,6 +62,8 @@ namespace BDD {
 
     std::vector<node*> node::nodes_postorder()
     {
+        if(in_concurrent_mgr())
+            return nodes_postorder_unmarked();
         assert(marked_ == 0);
         std::vector<node*> n;
         nodes_postorder_impl(n);
@@ -81,6 +88,8 @@ namespace BDD {
 
     std::vector<node*> node::nodes_bfs()
     {
+        if(in_concurrent_mgr())
+            return nodes_bfs_unmarked();
         assert(marked_ == 0);
         std::vector<node*> nodes;
         std::deque<node*> dq;
@@ -111,6 +120,58 @@ namespace BDD {
         return nodes; 
     }
 
+    bool node::in_concurrent_mgr()
+    {
+        bdd_mgr* mgr = find_bdd_mgr();
+        return mgr != nullptr && mgr->concurrent();
+    }
+
+    std::vector<node*> node::nodes_postorder_unmarked()
+    {
+        std::vector<node*> n;
+        std::unordered_set<node*> visited;
+        // second entry tells whether children have already been pushed
+        std::vector<std::tuple<node*,bool>> s = {{this, false}};
+        while(!s.empty())
+        {
+            const auto [p, expanded] = s.back();
+            s.pop_back();
+            if(p->is_terminal())
+                continue;
+            if(expanded)
+            {
+                n.push_back(p);
+                continue;
+            }
+            if(!visited.insert(p).second)
+                continue;
+            // lo is popped first, as in nodes_postorder_impl
+            s.push_back({p, true});
+            s.push_back({p->hi, false});
+            s.push_back({p->lo, false});
+        }
+        return n;
+    }
+
+    std::vector<node*> node::nodes_bfs_unmarked()
+    {
+        std::vector<node*> nodes;
+        std::unordered_set<node*> visited = {this};
+        std::deque<node*> dq = {this};
+        while(!dq.empty())
+        {
+            node* n = dq.front();
+            dq.pop_front();
+            nodes.push_back(n);
+
+            if(!n->lo->is_terminal() && visited.insert(n->lo).second)
+                dq.push_back(n->lo);
+            if(!n->hi->is_terminal() && visited.insert(n->hi).second)
+                dq.push_back(n->hi);
+        }
+        return nodes;
+    }
+
     size_t node::nr_solutions()
     {
         std::unordered_map<node*, size_t> nr_solutions;
@@ -172,6 +233,7 @@ namespace BDD {
         this->bdd_mgr_2 = mgr;
         this->xref = 1;
         this->index = botsink_index;
+        this->marked_ = 0;
     }
 
     bool node::is_botsink() const
@@ -186,6 +248,7 @@ namespace BDD {
         this->bdd_mgr_2 = mgr;
         this->xref = 1;
         this->index = topsink_index;
+        this->marked_ = 0;
 
     }
 
@@ -234,8 +297,16 @@ namespace BDD {
     std::vector<size_t> node_struct::variables()
     {
         std::vector<size_t> v;
-        variables_impl(v);
-        unmark();
+        if(in_concurrent_mgr())
+        {
+            for(const node* p : nodes_postorder_unmarked())
+                v.push_back(p->index);
+        }
+        else
+        {
+            variables_impl(v);
+            unmark();
+        }
         std::sort(v.begin(), v.end());
         v.erase( std::unique(v.begin(), v.end() ), v.end());
         return v; 
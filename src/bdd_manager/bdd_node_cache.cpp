@@ -1,9 +1,14 @@
 #include "bdd_manager/bdd_node_cache.h"
 #include <cassert>
+#include <tuple>
 
 namespace BDD {
 
-    bdd_node_cache::bdd_node_cache(bdd_mgr* mgr)
+    static std::atomic<size_t> next_bdd_node_cache_id = 1;
+
+    bdd_node_cache::bdd_node_cache(bdd_mgr* mgr, const bool concurrent)
+        : concurrent_(concurrent),
+        id_(next_bdd_node_cache_id++)
     {
         static_assert(bdd_node_page_size > 2);
         mem_node = std::unique_ptr<bdd_node_page>(new bdd_node_page);
@@ -33,6 +38,22 @@ namespace BDD {
 
     node* bdd_node_cache::reserve_node()
     {
+        if(concurrent_)
+        {
+            arena& a = local_arena();
+            a.nr_reserved.store(a.nr_reserved.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if(a.avail == nullptr && a.next == a.end)
+                refill(a);
+            if(a.avail != nullptr)
+            {
+                node* r = a.avail;
+                a.avail = a.avail->next_available;
+                return r;
+            }
+            assert(a.next < a.end);
+            return a.next++;
+        }
+
         total_nodes++;
         node* r = nodeavail;
         if(r != nullptr)
@@ -70,10 +91,66 @@ namespace BDD {
         p->lo->xref--;
         assert(p->hi->xref > 0);
         p->hi->xref--;
+        auto lock = lock_if_concurrent(mutex_, concurrent_);
         p->next_available = nodeavail;
         nodeavail = p;
         total_nodes--;
     }
 
+    size_t bdd_node_cache::nr_nodes() const
+    {
+        auto lock = lock_if_concurrent(mutex_, concurrent_);
+        size_t n = total_nodes;
+        for(const arena& a : arenas_)
+            n += a.nr_reserved.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    bdd_node_cache::arena& bdd_node_cache::local_arena()
+    {
+        // every thread remembers its arenas of the node caches it has most recently reserved nodes from
+        constexpr static size_t nr_cached_arenas = 8;
+        thread_local std::array<std::tuple<size_t, arena*>, nr_cached_arenas> cached_arenas = {};
+        thread_local size_t next_cached_arena = 0;
+
+        for(const auto [id, a] : cached_arenas)
+            if(id == id_)
+                return *a;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        arena& a = arenas_.emplace_back();
+        cached_arenas[next_cached_arena] = {id_, &a};
+        next_cached_arena = (next_cached_arena + 1) % nr_cached_arenas;
+        return a;
+    }
+
+    void bdd_node_cache::refill(arena& a)
+    {
+        assert(a.avail == nullptr && a.next == a.end);
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // prefer freed nodes
+        if(nodeavail != nullptr)
+        {
+            for(size_t i=0; i<bdd_node_page_size && nodeavail != nullptr; ++i)
+            {
+                node* p = nodeavail;
+                nodeavail = nodeavail->next_available;
+                p->next_available = a.avail;
+                a.avail = p;
+            }
+            return;
+        }
+
+        node* page_end = &(mem_node.get()->data[0]) + mem_node.get()->data.size();
+        if(nodeptr == page_end)
+        {
+            increase_cache();
+            page_end = &(mem_node.get()->data[0]) + mem_node.get()->data.size();
+        }
+        a.next = nodeptr;
+        a.end = page_end;
+        nodeptr = page_end;
+    }
 
 }
@@ -37,6 +37,7 @@ namespace BDD {
     node** var_struct::new_page(const size_t new_mask)
     {
         unique_table_page_caches& cache = bdd_mgr_.get_unique_table_page_cache();
+        auto lock = lock_if_concurrent(cache.mutex, bdd_mgr_.concurrent());
         switch(new_mask) {
             case 63: return reinterpret_cast<node**>(cache.cache_128.reserve_page()); 
             case 127: return reinterpret_cast<node**>(cache.cache_256.reserve_page());
@@ -92,6 +93,7 @@ namespace BDD {
             return;
 
         auto& cache = bdd_mgr_.get_unique_table_page_cache();
+        auto lock = lock_if_concurrent(cache.mutex, bdd_mgr_.concurrent());
         switch(p_mask) {
             case 63: return cache.cache_64.free_page(reinterpret_cast<unique_table_page<64>*>(p));
             case 127: return cache.cache_128.free_page(reinterpret_cast<unique_table_page<128>*>(p));
@@ -117,6 +119,7 @@ namespace BDD {
         : var(index),
         bdd_mgr_(_bdd_mgr)
     {
+        auto lock = lock_if_concurrent(_bdd_mgr.get_unique_table_page_cache().mutex, _bdd_mgr.concurrent());
         base_64 = _bdd_mgr.get_unique_table_page_cache().cache_64.reserve_page();
         mask = 64-1;
         free = 64;
@@ -282,6 +285,12 @@ namespace BDD {
         if(l==h)
             return l;
 
+        auto lock = lock_if_concurrent(mutex_, bdd_mgr_.concurrent());
+        return unique_find_impl(index, l, h);
+    }
+
+    node* var_struct::unique_find_impl(const size_t index, node* l, node* h)
+    {
         node* p = unique_table_lookup(l, h);
 
         if(p != nullptr) // node present
@@ -309,7 +318,7 @@ namespace BDD {
             {
                 // TODO: implement
                 //remove_dead_nodes();
-                return unique_find(l, h);
+                return unique_find_impl(index, l, h);
             }
         }
 
@@ -24,6 +24,11 @@ namespace LPMP {
         pimpl = std::make_unique<impl>(bdd_col);
     }
 
+    template<typename REAL>
+    bdd_mma<REAL>::bdd_mma(const bdd_mma& o)
+        : pimpl(std::make_unique<impl>(*o.pimpl))
+    {}
+
     template<typename REAL>
     bdd_mma<REAL>::bdd_mma(bdd_mma&& o)
         : pimpl(std::move(o.pimpl))
@@ -107,6 +112,25 @@ namespace LPMP {
         pimpl->mma.fix_variable(var, value);
     }
 
+    template<typename REAL>
+    std::vector<std::array<double,2>> bdd_mma<REAL>::node_costs() const
+    {
+        const auto costs = pimpl->mma.node_costs();
+        std::vector<std::array<double,2>> c(costs.size());
+        for(size_t i=0; i<costs.size(); ++i)
+            c[i] = {costs[i][0], costs[i][1]};
+        return c;
+    }
+
+    template<typename REAL>
+    void bdd_mma<REAL>::set_node_costs(const std::vector<std::array<double,2>>& costs)
+    {
+        std::vector<std::array<REAL,2>> c(costs.size());
+        for(size_t i=0; i<costs.size(); ++i)
+            c[i] = {REAL(costs[i][0]), REAL(costs[i][1])};
+        pimpl->mma.set_node_costs(c.begin(), c.end());
+    }
+
     template<typename REAL>
     void bdd_mma<REAL>::tighten()
     {
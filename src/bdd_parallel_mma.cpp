@@ -1,6 +1,7 @@
 #include "bdd_parallel_mma.h"
 #include "bdd_parallel_mma_base.h"
 #include "bdd_branch_instruction.h"
+#include "bdd_tightening.h"
 #include "time_measure_util.h"
 
 namespace LPMP {
@@ -22,6 +23,11 @@ namespace LPMP {
         pimpl = std::make_unique<impl>(bdd_col);
     }
 
+    template<typename REAL>
+    bdd_parallel_mma<REAL>::bdd_parallel_mma(const bdd_parallel_mma<REAL>& o)
+        : pimpl(std::make_unique<impl>(*o.pimpl))
+    {}
+
     template<typename REAL>
     bdd_parallel_mma<REAL>::bdd_parallel_mma(bdd_parallel_mma<REAL>&& o)
         : pimpl(std::move(o.pimpl))
@@ -93,6 +99,23 @@ namespace LPMP {
         return pimpl->base.min_marginals();
     }
 
+    template<typename REAL>
+    void bdd_parallel_mma<REAL>::update_costs(const two_dim_variable_array<std::array<double,2>>& delta)
+    {
+        two_dim_variable_array<std::array<REAL,2>> d(delta);
+        for(size_t i=0; i<delta.size(); ++i)
+            for(size_t j=0; j<delta.size(i); ++j)
+                d(i,j) = {REAL(delta(i,j)[0]), REAL(delta(i,j)[1])};
+        pimpl->base.update_costs(d);
+    }
+
+    template<typename REAL>
+        template<typename ITERATOR>
+        two_dim_variable_array<char> bdd_parallel_mma<REAL>::bdd_feasibility(ITERATOR sol_begin, ITERATOR sol_end)
+        {
+            return pimpl->base.bdd_feasibility(sol_begin, sol_end);
+        }
+
     template<typename REAL>
     void bdd_parallel_mma<REAL>::fix_variable(const size_t var, const bool value)
     {
@@ -110,10 +133,42 @@ namespace LPMP {
         pimpl->base.fix_variables(zero_fixations_begin, zero_fixations_end, one_fixations_begin, one_fixations_end);
     }
 
+    template<typename REAL>
+    std::vector<std::array<double,2>> bdd_parallel_mma<REAL>::node_costs() const
+    {
+        const auto costs = pimpl->base.node_costs();
+        std::vector<std::array<double,2>> c(costs.size());
+        for(size_t i=0; i<costs.size(); ++i)
+            c[i] = {costs[i][0], costs[i][1]};
+        return c;
+    }
+
+    template<typename REAL>
+    void bdd_parallel_mma<REAL>::set_node_costs(const std::vector<std::array<double,2>>& costs)
+    {
+        std::vector<std::array<REAL,2>> c(costs.size());
+        for(size_t i=0; i<costs.size(); ++i)
+            c[i] = {REAL(costs[i][0]), REAL(costs[i][1])};
+        pimpl->base.set_node_costs(c.begin(), c.end());
+    }
+
     template<typename REAL>
     void bdd_parallel_mma<REAL>::tighten()
     {
-        throw std::runtime_error("not implemented");
+        tighten_parallel(pimpl->base, 1e-6);
+    }
+
+    template<typename REAL>
+    void bdd_parallel_mma<REAL>::set_atomic_free_delta_aggregation(const bool atomic_free)
+    {
+        using base_type = decltype(pimpl->base);
+        pimpl->base.set_delta_aggregation(atomic_free ? base_type::delta_aggregation::gather : base_type::delta_aggregation::atomic);
+    }
+
+    template<typename REAL>
+    void bdd_parallel_mma<REAL>::set_deterministic(const bool deterministic)
+    {
+        pimpl->base.set_deterministic(deterministic);
     }
 
     // explicitly instantiate templates
@@ -139,4 +194,12 @@ namespace LPMP {
     template void bdd_parallel_mma<double>::fix_variables(size_t*, size_t*, size_t*, size_t*);
     template void bdd_parallel_mma<double>::fix_variables(std::vector<size_t>::iterator,std::vector<size_t>::iterator,std::vector<size_t>::iterator,   std::vector<size_t>::iterator);
     template void bdd_parallel_mma<double>::fix_variables(std::vector<size_t>::const_iterator,std::vector<size_t>::const_iterator,std::vector<size_t>::const_iterator,std::vector<size_t>::const_iterator);
+
+    template two_dim_variable_array<char> bdd_parallel_mma<float>::bdd_feasibility(char*, char*);
+    template two_dim_variable_array<char> bdd_parallel_mma<float>::bdd_feasibility(std::vector<char>::iterator, std::vector<char>::iterator);
+    template two_dim_variable_array<char> bdd_parallel_mma<float>::bdd_feasibility(std::vector<char>::const_iterator, std::vector<char>::const_iterator);
+
+    template two_dim_variable_array<char> bdd_parallel_mma<double>::bdd_feasibility(char*, char*);
+    template two_dim_variable_array<char> bdd_parallel_mma<double>::bdd_feasibility(std::vector<char>::iterator, std::vector<char>::iterator);
+    template two_dim_variable_array<char> bdd_parallel_mma<double>::bdd_feasibility(std::vector<char>::const_iterator, std::vector<char>::const_iterator);
 }
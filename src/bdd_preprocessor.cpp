@@ -1,4 +1,5 @@
 #include "bdd_preprocessor.h"
+#include "bdd_cache.h"
 #include <iostream>
 #include <chrono>
 #include <limits>
@@ -6,6 +7,8 @@
 #include <tsl/robin_set.h>
 #include <cmath>
 #include <atomic>
+#include <numeric>
+#include <algorithm>
 #include "bdd_logging.h"
 #include "time_measure_util.h"
 #include "two_dimensional_variable_array.hxx"
@@ -120,6 +123,20 @@ namespace LPMP {
         return split_length;
     }
 
+    // estimated time for converting a constraint into a BDD.
+    // Grows with the number of variables and, for weighted constraints, with the magnitude of the coefficients.
+    double estimated_conversion_cost(const ILP_input::constraint& constr)
+    {
+        if(constr.coefficients.empty())
+            return 1.0;
+        if(constr.is_simplex())
+            return constr.monomials.size();
+        int max_coeff = 0;
+        for(const int coeff : constr.coefficients)
+            max_coeff = std::max(max_coeff, std::abs(coeff));
+        return constr.monomials.data().size() * (1.0 + std::log2(1.0 + max_coeff));
+    }
+
     two_dim_variable_array<size_t> bdd_preprocessor::add_ilp(const ILP_input& input, const bool normalize, const bool split_long_bdds, const bool add_split_implication_bdd, const size_t split_length)
     {
         MEASURE_FUNCTION_EXECUTION_TIME;
@@ -129,8 +146,16 @@ namespace LPMP {
         if(normalize)
             bdd_log << "[bdd preprocessor] normalize constraints\n";
 
-        std::vector<size_t> ineq_nrs;
-        two_dim_variable_array<size_t> bdd_nrs;
+        const bdd_cache::key_type cache_key = cache_directory.empty() ? bdd_cache::key_type{} : bdd_cache::key(input, normalize, split_long_bdds, add_split_implication_bdd, split_length);
+        if(!cache_directory.empty())
+        {
+            two_dim_variable_array<size_t> ineq_to_bdd_nrs;
+            if(bdd_cache(cache_directory).load(cache_key, bdd_collection, ineq_to_bdd_nrs))
+            {
+                bdd_log << "[bdd preprocessor] final #BDDs = " << bdd_collection.nr_bdds() << "\n";
+                return ineq_to_bdd_nrs;
+            }
+        }
 
 #ifdef _OPENMP
         const size_t nr_threads = omp_get_max_threads();
@@ -142,86 +167,86 @@ namespace LPMP {
         // for variable copies when using coefficient decomposition transformation to BDDs
         std::atomic<size_t> extra_var_counter = input.nr_variables();
 
-        // TODO: tid based construction not needed anymore, do directly through openmp for loop sharing
-#pragma omp parallel for ordered schedule(static) num_threads(nr_threads)
-        for(size_t tid=0; tid<nr_threads; ++tid)
+        // partition constraints into contiguous chunks of roughly equal estimated conversion cost
+        std::vector<double> constraint_costs(input.constraints().size());
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+        for(size_t c=0; c<input.constraints().size(); ++c)
+            constraint_costs[c] = estimated_conversion_cost(input.constraints()[c]);
+        const double total_cost = std::accumulate(constraint_costs.begin(), constraint_costs.end(), 0.0);
+        constexpr size_t chunks_per_thread = 16;
+        const double chunk_cost_target = total_cost / double(nr_threads * chunks_per_thread);
+
+        std::vector<size_t> chunk_offsets = {0};
+        std::vector<double> chunk_costs = {0.0};
+        for(size_t c=0; c<input.constraints().size(); ++c)
         {
-            std::vector<int> coefficients;
-            std::vector<std::size_t> variables;
-            std::vector<size_t> cur_ineq_nrs;
-            two_dim_variable_array<size_t> cur_bdd_nrs;
-            std::vector<size_t> cur_bdds_to_remove;
-            BDD::bdd_mgr bdd_mgr;
-            bdd_converter converter(bdd_mgr);
-            BDD::bdd_collection cur_bdd_collection;
+            if(chunk_costs.back() > 0.0 && chunk_costs.back() + constraint_costs[c] > chunk_cost_target)
+            {
+                chunk_offsets.push_back(c);
+                chunk_costs.push_back(0.0);
+            }
+            chunk_costs.back() += constraint_costs[c];
+        }
+        chunk_offsets.push_back(input.constraints().size());
+        const size_t nr_chunks = chunk_offsets.size() - 1;
 
-            auto make_qbdd = [&](const size_t bdd_nr) {
-                assert(bdd_nr + 1 == cur_bdd_collection.nr_bdds());
-                if(!cur_bdd_collection.is_qbdd(bdd_nr))
-                {
-                    const size_t new_bdd_nr = cur_bdd_collection.make_qbdd(bdd_nr);
-                    cur_bdd_collection.remove(bdd_nr);
-                    assert(cur_bdd_collection.is_qbdd(bdd_nr));
-                }
-            };
+        // hand out expensive chunks first, so that threads finishing early pick up the cheap remaining ones
+        std::vector<size_t> chunk_order(nr_chunks);
+        std::iota(chunk_order.begin(), chunk_order.end(), 0);
+        std::sort(chunk_order.begin(), chunk_order.end(), [&](const size_t i, const size_t j) { return chunk_costs[i] > chunk_costs[j]; });
+        bdd_log << "[bdd preprocessor] #constraint chunks = " << nr_chunks << ", max chunk cost = " << (nr_chunks > 0 ? chunk_costs[chunk_order[0]] : 0.0) << ", avg chunk cost = " << total_cost / std::max(nr_chunks, size_t(1)) << "\n";
 
-            const size_t first_constr = input.constraints().size()/nr_threads * tid;
-            const size_t last_constr = (tid+1 == nr_threads) ? input.constraints().size() : (input.constraints().size()/nr_threads) * (tid+1);
-            if(tid + 1 == nr_threads)
-                assert(last_constr == input.constraints().size());
+        // BDDs of linear inequalities with equal normal form are built once and shared between threads
+        bdd_shape_cache shape_cache;
 
-            for(size_t c=first_constr; c<last_constr; ++c)
+        std::vector<BDD::bdd_collection> chunk_bdd_collections(nr_chunks);
+        std::vector<std::vector<size_t>> chunk_ineq_nrs(nr_chunks);
+        std::vector<two_dim_variable_array<size_t>> chunk_bdd_nrs(nr_chunks);
+
+        // all threads build their BDDs in one node space, so that common subgraphs are created only once
+        BDD::bdd_mgr bdd_mgr(nr_threads > 1);
+        bdd_mgr.set_memo_cache_memory(memo_cache_memory);
+
+#pragma omp parallel num_threads(nr_threads)
+        {
+            std::vector<std::size_t> variables;
+            bdd_converter converter(bdd_mgr);
+
+#pragma omp for schedule(dynamic, 1)
+            for(size_t i=0; i<nr_chunks; ++i)
             {
-                const auto constraint = [&]() {
-                    auto constraint = input.constraints()[c];
-                    if(normalize && !constraint.is_normalized())
-                        constraint.normalize();
-                    return constraint;
-                }();
-                variables.clear();
-                if(constraint.is_simplex())
-                {
-                    const size_t bdd_nr = cur_bdd_collection.simplex_constraint(constraint.coefficients.size());
-                    for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
+                const size_t chunk = chunk_order[i];
+                std::vector<size_t>& cur_ineq_nrs = chunk_ineq_nrs[chunk];
+                two_dim_variable_array<size_t>& cur_bdd_nrs = chunk_bdd_nrs[chunk];
+                BDD::bdd_collection& cur_bdd_collection = chunk_bdd_collections[chunk];
+
+                auto make_qbdd = [&](const size_t bdd_nr) {
+                    assert(bdd_nr + 1 == cur_bdd_collection.nr_bdds());
+                    if(!cur_bdd_collection.is_qbdd(bdd_nr))
                     {
-                        const size_t var = constraint.monomials(monomial_idx, 0);
-                        variables.push_back(var);
+                        cur_bdd_collection.make_qbdd(bdd_nr);
+                        cur_bdd_collection.remove(bdd_nr);
+                        assert(cur_bdd_collection.is_qbdd(bdd_nr));
                     }
-                    cur_bdd_collection.rebase(bdd_nr, variables.begin(), variables.end());
-                    assert(cur_bdd_collection.is_qbdd(bdd_nr));
-                    assert(cur_bdd_collection.variables(bdd_nr) == variables);
+                };
 
-                    cur_ineq_nrs.push_back(c);
-                    std::array<size_t,1> bdd_nr_array = {bdd_nr};
-                    cur_bdd_nrs.push_back(bdd_nr_array.begin(), bdd_nr_array.end());
-                }
-                else if(constraint.is_linear())
+                for(size_t c=chunk_offsets[chunk]; c<chunk_offsets[chunk+1]; ++c)
                 {
-                    assert(constraint.monomials.size() == constraint.coefficients.size());
-                    for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
-                    {
-                        const size_t var = constraint.monomials(monomial_idx, 0);
-                        const int coeff = constraint.coefficients[monomial_idx];
-                        variables.push_back(var);
-                    }
-
-                    const size_t nr_vars = constraint.coefficients.size();
-                    assert(constraint.coefficients.size() > 0);
-                    const int max_coeff = std::max(
-                            *std::max_element(constraint.coefficients.begin(), constraint.coefficients.end()),
-                            - *std::min_element(constraint.coefficients.begin(), constraint.coefficients.end())
-                            );
-                    if(nr_vars <= 64 || max_coeff <= 100) // convert to BDD directly
+                    const auto constraint = [&]() {
+                        auto constraint = input.constraints()[c];
+                        if(normalize && !constraint.is_normalized())
+                            constraint.normalize();
+                        return constraint;
+                    }();
+                    variables.clear();
+                    if(constraint.is_simplex())
                     {
-                        BDD::node_ref bdd = converter.convert_to_bdd(constraint.coefficients, constraint.ineq, constraint.right_hand_side);
-                        if(bdd.is_topsink())
-                            continue;
-                        else if(bdd.is_botsink())
-                            throw std::runtime_error("problem is infeasible");
-                        const size_t bdd_nr = cur_bdd_collection.add_bdd(bdd);
-                        cur_bdd_collection.reorder(bdd_nr);
-                        make_qbdd(bdd_nr);
-                        assert(cur_bdd_collection.is_reordered(bdd_nr));
+                        const size_t bdd_nr = cur_bdd_collection.simplex_constraint(constraint.coefficients.size());
+                        for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
+                        {
+                            const size_t var = constraint.monomials(monomial_idx, 0);
+                            variables.push_back(var);
+                        }
                         cur_bdd_collection.rebase(bdd_nr, variables.begin(), variables.end());
                         assert(cur_bdd_collection.is_qbdd(bdd_nr));
                         assert(cur_bdd_collection.variables(bdd_nr) == variables);
@@ -230,142 +255,186 @@ namespace LPMP {
                         std::array<size_t,1> bdd_nr_array = {bdd_nr};
                         cur_bdd_nrs.push_back(bdd_nr_array.begin(), bdd_nr_array.end());
                     }
-                    else // use coefficient decomposition
+                    else if(constraint.is_linear())
                     {
-                        if(normalize)
-                            throw std::runtime_error("coefficient decomposition BDDs may not be sorted w.r.t. variable indices"); 
-
-                        bdd_log << "[bdd preprocessor] convert inequality " << constraint.identifier << " through coefficient decomposition. max coeff: "<< max_coeff << ", nr_vars: " << nr_vars << "\n";
-                        input.write_lp(bdd_log, constraint);
-                        auto [bdd, var_split] = converter.coefficient_decomposition_convert_to_bdd(constraint.coefficients, constraint.ineq, constraint.right_hand_side);
-
-                        if(bdd.is_topsink())
+                        assert(constraint.monomials.size() == constraint.coefficients.size());
+                        for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
                         {
-                            assert(false); // bdd nrs must be recorded
-                            continue;
+                            const size_t var = constraint.monomials(monomial_idx, 0);
+                            variables.push_back(var);
                         }
-                        else if(bdd.is_botsink())
-                            throw std::runtime_error("problem is infeasible");
 
-                        const size_t bdd_nr = cur_bdd_collection.add_bdd(bdd);
-                        cur_bdd_collection.reorder(bdd_nr);
-                        make_qbdd(bdd_nr);
-                        assert(cur_bdd_collection.is_reordered(bdd_nr));
+                        const size_t nr_vars = constraint.coefficients.size();
+                        assert(constraint.coefficients.size() > 0);
+                        const int max_coeff = std::max(
+                                *std::max_element(constraint.coefficients.begin(), constraint.coefficients.end()),
+                                - *std::min_element(constraint.coefficients.begin(), constraint.coefficients.end())
+                                );
+                        if(nr_vars <= 64 || max_coeff <= 100) // convert to BDD directly
+                        {
+                            const bdd_shape_cache::shape& shape = converter.convert_to_bdd(constraint.coefficients, constraint.ineq, constraint.right_hand_side, shape_cache);
+                            if(shape.topsink)
+                                continue;
+                            else if(shape.botsink)
+                                throw std::runtime_error("problem is infeasible");
+                            cur_bdd_collection.append(shape.bdd_col);
+                            const size_t bdd_nr = cur_bdd_collection.nr_bdds() - 1;
+                            assert(cur_bdd_collection.is_reordered(bdd_nr));
+                            cur_bdd_collection.rebase(bdd_nr, variables.begin(), variables.end());
+                            assert(cur_bdd_collection.is_qbdd(bdd_nr));
+                            assert(cur_bdd_collection.variables(bdd_nr) == variables);
+
+                            cur_ineq_nrs.push_back(c);
+                            std::array<size_t,1> bdd_nr_array = {bdd_nr};
+                            cur_bdd_nrs.push_back(bdd_nr_array.begin(), bdd_nr_array.end());
+                        }
+                        else // use coefficient decomposition
+                        {
+                            if(normalize)
+                                throw std::runtime_error("coefficient decomposition BDDs may not be sorted w.r.t. variable indices"); 
 
-                        std::vector<size_t> copy_variables(var_split.data().size(), std::numeric_limits<size_t>::max());
+                            bdd_log << "[bdd preprocessor] convert inequality " << constraint.identifier << " through coefficient decomposition. max coeff: "<< max_coeff << ", nr_vars: " << nr_vars << "\n";
+                            input.write_lp(bdd_log, constraint);
+                            auto [bdd, var_split] = converter.coefficient_decomposition_convert_to_bdd(constraint.coefficients, constraint.ineq, constraint.right_hand_side);
 
-                        assert(variables.size() == var_split.size());
-                        for(size_t i=0; i<variables.size(); ++i)
-                        {
-                            std::vector<size_t> var_copy_equal_vars;
-                            assert(var_split.size(i) > 0);
-                            if(var_split.size(i) == 1)
+                            if(bdd.is_topsink())
                             {
-                                assert(var_split(i,0) < copy_variables.size());
-                                copy_variables[var_split(i,0)] = variables[i];
+                                assert(false); // bdd nrs must be recorded
+                                continue;
                             }
-                            else
+                            else if(bdd.is_botsink())
+                                throw std::runtime_error("problem is infeasible");
+
+                            const size_t bdd_nr = cur_bdd_collection.add_bdd(bdd);
+                            cur_bdd_collection.reorder(bdd_nr);
+                            make_qbdd(bdd_nr);
+                            assert(cur_bdd_collection.is_reordered(bdd_nr));
+
+                            std::vector<size_t> copy_variables(var_split.data().size(), std::numeric_limits<size_t>::max());
+
+                            assert(variables.size() == var_split.size());
+                            for(size_t i=0; i<variables.size(); ++i)
                             {
-                                // additionally add BDDs for equality between decomposed variables
-                                var_copy_equal_vars.push_back(variables[i]);
-                                for(size_t j=0; j<var_split.size(i); ++j)
+                                std::vector<size_t> var_copy_equal_vars;
+                                assert(var_split.size(i) > 0);
+                                if(var_split.size(i) == 1)
+                                {
+                                    assert(var_split(i,0) < copy_variables.size());
+                                    copy_variables[var_split(i,0)] = variables[i];
+                                }
+                                else
                                 {
-                                    const size_t new_var = extra_var_counter++;
-                                    assert(var_split(i,j) < copy_variables.size());
-                                    assert(copy_variables[var_split(i,j)] == std::numeric_limits<size_t>::max());
-                                    copy_variables[var_split(i,j)] = new_var;
-                                    var_copy_equal_vars.push_back(new_var);
+                                    // additionally add BDDs for equality between decomposed variables
+                                    var_copy_equal_vars.push_back(variables[i]);
+                                    for(size_t j=0; j<var_split.size(i); ++j)
+                                    {
+                                        const size_t new_var = extra_var_counter++;
+                                        assert(var_split(i,j) < copy_variables.size());
+                                        assert(copy_variables[var_split(i,j)] == std::numeric_limits<size_t>::max());
+                                        copy_variables[var_split(i,j)] = new_var;
+                                        var_copy_equal_vars.push_back(new_var);
+                                    }
+                                    std::sort(var_copy_equal_vars.begin(), var_copy_equal_vars.end());
+                                    assert(std::unique(var_copy_equal_vars.begin(), var_copy_equal_vars.end()) == var_copy_equal_vars.end());
+                                    const size_t equal_bdd_nr = cur_bdd_collection.all_equal_constraint(var_copy_equal_vars.size());
+                                    cur_bdd_collection.rebase(equal_bdd_nr, var_copy_equal_vars.begin(), var_copy_equal_vars.end());
+                                    assert(cur_bdd_collection.is_reordered(equal_bdd_nr));
+                                    assert(cur_bdd_collection.is_qbdd(equal_bdd_nr));
                                 }
-                                std::sort(var_copy_equal_vars.begin(), var_copy_equal_vars.end());
-                                assert(std::unique(var_copy_equal_vars.begin(), var_copy_equal_vars.end()) == var_copy_equal_vars.end());
-                                const size_t equal_bdd_nr = cur_bdd_collection.all_equal_constraint(var_copy_equal_vars.size());
-                                cur_bdd_collection.rebase(equal_bdd_nr, var_copy_equal_vars.begin(), var_copy_equal_vars.end());
-                                assert(cur_bdd_collection.is_reordered(equal_bdd_nr));
-                                assert(cur_bdd_collection.is_qbdd(equal_bdd_nr));
                             }
-                        }
 
-                        for(size_t i=0; i<copy_variables.size(); ++i)
-                            assert(copy_variables[i] != std::numeric_limits<size_t>::max());
+                            for(size_t i=0; i<copy_variables.size(); ++i)
+                                assert(copy_variables[i] != std::numeric_limits<size_t>::max());
 
-                        cur_bdd_collection.rebase(bdd_nr, copy_variables.begin(), copy_variables.end());
-                        assert(cur_bdd_collection.is_qbdd(bdd_nr));
+                            cur_bdd_collection.rebase(bdd_nr, copy_variables.begin(), copy_variables.end());
+                            assert(cur_bdd_collection.is_qbdd(bdd_nr));
 
-                        cur_ineq_nrs.push_back(c);
-                        std::vector<size_t> new_bdd_nrs;
-                        for(size_t i=0; i<cur_bdd_collection.nr_bdds(); ++i)
-                            new_bdd_nrs.push_back(bdd_nr + i);
-                        cur_bdd_nrs.push_back(new_bdd_nrs.begin(), new_bdd_nrs.end());
+                            cur_ineq_nrs.push_back(c);
+                            std::vector<size_t> new_bdd_nrs;
+                            for(size_t i=0; i<cur_bdd_collection.nr_bdds(); ++i)
+                                new_bdd_nrs.push_back(bdd_nr + i);
+                            cur_bdd_nrs.push_back(new_bdd_nrs.begin(), new_bdd_nrs.end());
+                        }
                     }
-                }
-                else if(constraint.distinct_variables()) // nonlinear BDD
-                {
-                    if(normalize)
-                        throw std::runtime_error("nonlinear BDDs may not be sorted w.r.t. variable indices"); 
-                    std::vector<size_t> monomial_degrees;
-                    monomial_degrees.reserve(constraint.coefficients.size());
-                    for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
-                        monomial_degrees.push_back(constraint.monomials.size(monomial_idx));
-                    BDD::node_ref bdd = converter.convert_nonlinear_to_bdd(monomial_degrees, constraint.coefficients, constraint.ineq, constraint.right_hand_side);
-
-                    assert(!bdd.is_terminal());
-                    const size_t bdd_nr = cur_bdd_collection.add_bdd(bdd);
-                    cur_bdd_collection.reorder(bdd_nr);
-                    assert(cur_bdd_collection.is_reordered(bdd_nr));
-
-                    for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
+                    else if(constraint.distinct_variables()) // nonlinear BDD
                     {
-                        for(size_t i=0; i<constraint.monomials.size(monomial_idx); ++i)
+                        if(normalize)
+                            throw std::runtime_error("nonlinear BDDs may not be sorted w.r.t. variable indices"); 
+                        std::vector<size_t> monomial_degrees;
+                        monomial_degrees.reserve(constraint.coefficients.size());
+                        for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
+                            monomial_degrees.push_back(constraint.monomials.size(monomial_idx));
+                        BDD::node_ref bdd = converter.convert_nonlinear_to_bdd(monomial_degrees, constraint.coefficients, constraint.ineq, constraint.right_hand_side);
+
+                        assert(!bdd.is_terminal());
+                        const size_t bdd_nr = cur_bdd_collection.add_bdd(bdd);
+                        cur_bdd_collection.reorder(bdd_nr);
+                        assert(cur_bdd_collection.is_reordered(bdd_nr));
+
+                        for(size_t monomial_idx=0; monomial_idx<constraint.monomials.size(); ++monomial_idx)
                         {
-                            const size_t var = constraint.monomials(monomial_idx, i);
-                            variables.push_back(var);
+                            for(size_t i=0; i<constraint.monomials.size(monomial_idx); ++i)
+                            {
+                                const size_t var = constraint.monomials(monomial_idx, i);
+                                variables.push_back(var);
+                            }
                         }
-                    }
-
-                    make_qbdd(bdd_nr);
-                    cur_bdd_collection.rebase(bdd_nr, variables.begin(), variables.end());
 
-                    cur_ineq_nrs.push_back(c);
-                    std::array<size_t,2> bdd_nr_array = {bdd_nr};
-                    cur_bdd_nrs.push_back(bdd_nr_array.begin(), bdd_nr_array.end());
-                }
-                else
-                {
-                    throw std::runtime_error("only linear constraints supported");
-                }
-            }
-            // add everything to one bdd collection, store mapping from inequalities to bdd numbers
-#pragma omp ordered 
-            {
-                const size_t bdd_nr_offset = bdd_collection.nr_bdds();
-                bdd_collection.append(cur_bdd_collection);
-                assert(bdd_collection.nr_bdds() == cur_bdd_collection.nr_bdds() + bdd_nr_offset);
-
-                assert(cur_ineq_nrs.size() == cur_bdd_nrs.size());
+                        make_qbdd(bdd_nr);
+                        cur_bdd_collection.rebase(bdd_nr, variables.begin(), variables.end());
 
-                // record corresponding inequality of each BDD
-                for(size_t c=0; c<cur_bdd_nrs.size(); ++c)
-                {
-                    for(size_t j=0; j<cur_bdd_nrs.size(c); ++j)
+                        cur_ineq_nrs.push_back(c);
+                        std::array<size_t,2> bdd_nr_array = {bdd_nr};
+                        cur_bdd_nrs.push_back(bdd_nr_array.begin(), bdd_nr_array.end());
+                    }
+                    else
                     {
-                        cur_bdd_nrs(c,j) += bdd_nr_offset;
-                        assert(cur_bdd_nrs(c,j) >= bdd_nr_offset);
+                        throw std::runtime_error("only linear constraints supported");
                     }
-                    bdd_nrs.push_back(cur_bdd_nrs.begin(c), cur_bdd_nrs.end(c));
                 }
-                ineq_nrs.insert(ineq_nrs.end(), cur_ineq_nrs.begin(), cur_ineq_nrs.end());
-                assert(ineq_nrs.size() == bdd_nrs.size());
             }
         }
 
-        // reorder bdd nrs to make them consecutive w.r.t. inequality numbers
-        two_dim_variable_array<size_t> ineq_to_bdd_nrs;
-        std::vector<size_t> inv_ineq_nrs(ineq_nrs.size());
-        for(size_t c=0; c<ineq_nrs.size(); ++c)
-            inv_ineq_nrs[ineq_nrs[c]] = c;
-
-        for(size_t c=0; c<ineq_nrs.size(); ++c)
-            ineq_to_bdd_nrs.push_back(bdd_nrs.begin(inv_ineq_nrs[c]), bdd_nrs.end(inv_ineq_nrs[c]));
+        if(shape_cache.nr_hits() + shape_cache.nr_misses() > 0)
+            bdd_log << "[bdd preprocessor] BDD shape cache: #distinct normal forms = " << shape_cache.nr_shapes()
+                << ", #hits = " << shape_cache.nr_hits() << ", #misses = " << shape_cache.nr_misses()
+                << ", hit rate = " << 100.0 * double(shape_cache.nr_hits()) / double(shape_cache.nr_hits() + shape_cache.nr_misses()) << "%\n";
+
+        const BDD::memo_cache_statistics memo_stats = bdd_mgr.memo_cache_stats();
+        if(memo_stats.hits + memo_stats.misses > 0)
+            bdd_log << "[bdd preprocessor] memo cache: #hits = " << memo_stats.hits << ", #misses = " << memo_stats.misses
+                << ", #evictions = " << memo_stats.evictions << ", hit rate = " << 100.0 * memo_stats.hit_rate() << "%"
+                << ", memory = " << double(memo_stats.memory) / double(1 << 20) << " MiB\n";
+
+        // add everything to one bdd collection, store mapping from inequalities to bdd numbers.
+        // Chunks consist of consecutive inequalities, hence concatenating them in chunk order keeps bdd nrs consecutive w.r.t. inequality numbers.
+        std::vector<size_t> bdd_nr_offsets = {0};
+        std::vector<size_t> ineq_offsets = {0};
+        for(size_t chunk=0; chunk<nr_chunks; ++chunk)
+        {
+            assert(chunk_ineq_nrs[chunk].size() == chunk_bdd_nrs[chunk].size());
+            bdd_nr_offsets.push_back(bdd_nr_offsets.back() + chunk_bdd_collections[chunk].nr_bdds());
+            ineq_offsets.push_back(ineq_offsets.back() + chunk_ineq_nrs[chunk].size());
+        }
+        bdd_collection.append(chunk_bdd_collections);
+        assert(bdd_collection.nr_bdds() == bdd_nr_offsets.back());
+
+        std::vector<size_t> ineq_sizes(ineq_offsets.back());
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+        for(size_t chunk=0; chunk<nr_chunks; ++chunk)
+            for(size_t c=0; c<chunk_bdd_nrs[chunk].size(); ++c)
+                ineq_sizes[ineq_offsets[chunk] + c] = chunk_bdd_nrs[chunk].size(c);
+        two_dim_variable_array<size_t> ineq_to_bdd_nrs(ineq_sizes.begin(), ineq_sizes.end());
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+        for(size_t chunk=0; chunk<nr_chunks; ++chunk)
+        {
+            for(size_t c=0; c<chunk_bdd_nrs[chunk].size(); ++c)
+            {
+                assert(c == 0 || chunk_ineq_nrs[chunk][c-1] < chunk_ineq_nrs[chunk][c]);
+                for(size_t j=0; j<chunk_bdd_nrs[chunk].size(c); ++j)
+                    ineq_to_bdd_nrs(ineq_offsets[chunk] + c, j) = chunk_bdd_nrs[chunk](c,j) + bdd_nr_offsets[chunk];
+            }
+        }
 
         assert(ineq_to_bdd_nrs.size() == input.constraints().size());
 
@@ -419,6 +488,9 @@ namespace LPMP {
 
         bdd_log << "[bdd preprocessor] final #BDDs = " << bdd_collection.nr_bdds() << "\n";
 
+        if(!cache_directory.empty())
+            bdd_cache(cache_directory).store(cache_key, bdd_collection, ineq_to_bdd_nrs);
+
         return ineq_to_bdd_nrs;
     }
 
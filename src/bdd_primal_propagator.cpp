@@ -0,0 +1,262 @@
+#include "bdd_primal_propagator.h"
+#include "time_measure_util.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
+
+namespace LPMP {
+
+    bdd_primal_propagator::bdd_primal_propagator(const BDD::bdd_collection& bdd_col)
+        : bdd_col_(bdd_col)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        std::vector<std::vector<size_t>> bdd_variables;
+        bdd_variables.reserve(bdd_col_.nr_bdds());
+        size_t nr_vars = 0;
+        for(size_t bdd_nr=0; bdd_nr<bdd_col_.nr_bdds(); ++bdd_nr)
+        {
+            if(!bdd_col_.contiguous_vars(bdd_nr))
+                throw std::runtime_error("primal propagation needs QBDDs");
+            bdd_variables.push_back(bdd_col_.variables(bdd_nr));
+            for(const size_t v : bdd_variables.back())
+                nr_vars = std::max(nr_vars, v+1);
+            max_nr_bdd_nodes_ = std::max(max_nr_bdd_nodes_, bdd_col_.nr_bdd_nodes(bdd_nr));
+        }
+        bdd_variables_ = two_dim_variable_array<size_t>(bdd_variables);
+
+        std::vector<std::vector<size_t>> variable_bdds(nr_vars);
+        for(size_t bdd_nr=0; bdd_nr<bdd_variables_.size(); ++bdd_nr)
+            for(size_t j=0; j<bdd_variables_.size(bdd_nr); ++j)
+                variable_bdds[bdd_variables_(bdd_nr,j)].push_back(bdd_nr);
+        variable_bdds_ = two_dim_variable_array<size_t>(variable_bdds);
+    }
+
+    // partial assignment together with a trail for undoing assignments on backtracking
+    class bdd_primal_propagator::state {
+        public:
+            static constexpr char unassigned = 2;
+
+            state(const bdd_primal_propagator& p, const size_t nr_variables)
+                : p_(p),
+                assignment_(nr_variables, unassigned),
+                reachable_(p.max_nr_bdd_nodes_),
+                alive_(p.max_nr_bdd_nodes_),
+                support_(nr_variables, 0),
+                bdd_queued_(p.bdd_col_.nr_bdds(), false)
+            {}
+
+            char value(const size_t var) const { return assignment_[var]; }
+            size_t trail_size() const { return trail_.size(); }
+
+            // assign variable and propagate, returns false on conflict
+            bool assign(const size_t var, const char val)
+            {
+                assert(assignment_[var] == unassigned);
+                set(var, val);
+                return propagate();
+            }
+
+            // enqueue all bdds and propagate
+            bool propagate_all()
+            {
+                for(size_t bdd_nr=0; bdd_nr<p_.bdd_col_.nr_bdds(); ++bdd_nr)
+                    enqueue(bdd_nr);
+                return propagate();
+            }
+
+            void undo(const size_t trail_size)
+            {
+                while(trail_.size() > trail_size)
+                {
+                    assignment_[trail_.back()] = unassigned;
+                    trail_.pop_back();
+                }
+            }
+
+            const std::vector<char>& assignment() const { return assignment_; }
+
+        private:
+            void set(const size_t var, const char val)
+            {
+                assignment_[var] = val;
+                trail_.push_back(var);
+                if(var < p_.variable_bdds_.size())
+                    for(size_t j=0; j<p_.variable_bdds_.size(var); ++j)
+                        enqueue(p_.variable_bdds_(var,j));
+            }
+
+            void enqueue(const size_t bdd_nr)
+            {
+                if(bdd_queued_[bdd_nr])
+                    return;
+                bdd_queued_[bdd_nr] = true;
+                queue_.push_back(bdd_nr);
+            }
+
+            bool propagate()
+            {
+                bool feasible = true;
+                // queue is processed in fifo order
+                for(size_t i=0; i<queue_.size(); ++i)
+                {
+                    bdd_queued_[queue_[i]] = false;
+                    if(feasible && !propagate(queue_[i]))
+                        feasible = false;
+                }
+                queue_.clear();
+                return feasible;
+            }
+
+            // compute nodes lying on root-topsink paths consistent with the current assignment and fix variables that take only one value on them
+            bool propagate(const size_t bdd_nr)
+            {
+                const auto& bdd_col = p_.bdd_col_;
+                const size_t first = bdd_col.offset(bdd_nr);
+                const size_t last = first + bdd_col.nr_bdd_nodes(bdd_nr);
+                auto instr = [&](const size_t i) { return bdd_col.get_bdd_instruction(i); };
+
+                std::fill(reachable_.begin(), reachable_.begin() + (last - first), false);
+                reachable_[0] = true;
+                for(size_t i=first; i<last; ++i)
+                {
+                    const auto& bdd = instr(i);
+                    if(!reachable_[i-first] || bdd.is_terminal())
+                        continue;
+                    const char val = assignment_[bdd.index];
+                    if(val != 1)
+                        reachable_[bdd.lo-first] = true;
+                    if(val != 0)
+                        reachable_[bdd.hi-first] = true;
+                }
+
+                for(size_t i=last; i-- > first;)
+                {
+                    const auto& bdd = instr(i);
+                    if(bdd.is_terminal())
+                    {
+                        alive_[i-first] = bdd.is_topsink();
+                        continue;
+                    }
+                    const char val = assignment_[bdd.index];
+                    alive_[i-first] = (val != 1 && alive_[bdd.lo-first]) || (val != 0 && alive_[bdd.hi-first]);
+                }
+
+                if(!alive_[0])
+                    return false;
+
+                // bit 0 resp. 1 is set if value 0 resp. 1 is supported
+                for(size_t j=0; j<p_.bdd_variables_.size(bdd_nr); ++j)
+                    support_[p_.bdd_variables_(bdd_nr,j)] = 0;
+                for(size_t i=first; i<last; ++i)
+                {
+                    const auto& bdd = instr(i);
+                    if(bdd.is_terminal() || !reachable_[i-first] || !alive_[i-first])
+                        continue;
+                    const char val = assignment_[bdd.index];
+                    if(val != 1 && alive_[bdd.lo-first])
+                        support_[bdd.index] |= 1;
+                    if(val != 0 && alive_[bdd.hi-first])
+                        support_[bdd.index] |= 2;
+                }
+
+                for(size_t j=0; j<p_.bdd_variables_.size(bdd_nr); ++j)
+                {
+                    const size_t var = p_.bdd_variables_(bdd_nr,j);
+                    assert(support_[var] != 0);
+                    if(assignment_[var] == unassigned && support_[var] != 3)
+                        set(var, support_[var] == 2);
+                }
+                return true;
+            }
+
+            const bdd_primal_propagator& p_;
+            std::vector<char> assignment_;
+            std::vector<size_t> trail_;
+            std::vector<char> reachable_;
+            std::vector<char> alive_;
+            std::vector<char> support_;
+            std::vector<size_t> queue_;
+            std::vector<char> bdd_queued_;
+    };
+
+    std::vector<char> bdd_primal_propagator::complete(const mm_primal_decoder& mms, const size_t max_backtracks) const
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        const size_t nr_vars = std::max(mms.size(), nr_variables());
+        state s(*this, nr_vars);
+
+        // value suggested by min-marginals and how certain it is
+        std::vector<char> preferred(nr_vars, 0);
+        std::vector<double> certainty(nr_vars, 0.0);
+        std::vector<char> decisive(nr_vars, false);
+        for(size_t i=0; i<mms.size(); ++i)
+        {
+            const auto mm_sum = mms.mm_sum(i);
+            preferred[i] = mm_sum[1] < mm_sum[0];
+            certainty[i] = std::abs(mm_sum[1] - mm_sum[0]);
+            const mm_type mmt = mms.compute_mm_type(i);
+            decisive[i] = mmt == mm_type::one || mmt == mm_type::zero;
+        }
+
+        if(!s.propagate_all())
+            return {};
+
+        // fix decisive variables, most certain first. Fixings leading to a conflict are skipped, the variables are branched on later.
+        std::vector<size_t> order(nr_vars);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](const size_t i, const size_t j) { return certainty[i] > certainty[j]; });
+        for(const size_t var : order)
+        {
+            if(!decisive[var] || s.value(var) != state::unassigned)
+                continue;
+            const size_t trail_size = s.trail_size();
+            if(!s.assign(var, preferred[var]))
+                s.undo(trail_size);
+        }
+
+        // branch on remaining variables, least certain first, trying the preferred value first
+        std::reverse(order.begin(), order.end());
+        struct decision {
+            size_t order_pos;
+            size_t trail_size;
+            bool flipped;
+        };
+        std::vector<decision> decisions;
+        size_t nr_backtracks = 0;
+        size_t pos = 0;
+        while(true)
+        {
+            while(pos < order.size() && s.value(order[pos]) != state::unassigned)
+                ++pos;
+            if(pos == order.size())
+                break;
+
+            const size_t var = order[pos];
+            decisions.push_back({pos, s.trail_size(), false});
+            bool feasible = s.assign(var, preferred[var]);
+            while(!feasible)
+            {
+                // undo decisions whose both values have been tried
+                s.undo(decisions.back().trail_size);
+                while(!decisions.empty() && decisions.back().flipped)
+                {
+                    s.undo(decisions.back().trail_size);
+                    decisions.pop_back();
+                }
+                if(decisions.empty() || nr_backtracks++ >= max_backtracks)
+                    return {};
+                s.undo(decisions.back().trail_size);
+                decisions.back().flipped = true;
+                const size_t flip_var = order[decisions.back().order_pos];
+                feasible = s.assign(flip_var, 1 - preferred[flip_var]);
+                pos = decisions.back().order_pos;
+            }
+        }
+
+        std::vector<char> sol(s.assignment().begin(), s.assignment().begin() + mms.size());
+        assert(std::count(sol.begin(), sol.end(), state::unassigned) == 0);
+        return sol;
+    }
+
+}
@@ -1,6 +1,7 @@
 #include "bdd_solver.h"
 #include "ILP_parser.h"
 #include "OPB_parser.h"
+#include "ILP_binary.h"
 #include "min_marginal_utils.h"
 #include "incremental_mm_agreement_rounding_cuda.h"
 #include "incremental_mm_agreement_rounding.hxx"
@@ -20,6 +21,8 @@
 #include "time_measure_util.h"
 #include "run_solver_util.h"
 #include "mm_primal_decoder.h"
+#include "ILP_evaluator.h"
+#include "bdd_dual_state.h"
 #include <string>
 #include <regex>
 
@@ -59,18 +62,23 @@ namespace LPMP {
         
     }
 
-    ILP_input parse_ilp_file(const std::string& filename)
+    ILP_input parse_ilp_file(const std::string& filename, const bool parallel = false)
     {
-        // determine whether file is in LP format or in opb one.
-        if(filename.substr(filename.find_last_of(".") + 1) == "opb")
+        // determine whether file is in binary format, LP format or in opb one.
+        if(ILP_binary::is_binary_file(filename))
         {
-            bdd_log << "[bdd solver] Parse opb file\n";
-            return OPB_parser::parse_file(filename);
+            bdd_log << "[bdd solver] Read binary ILP file\n";
+            return ILP_binary::parse_file(filename);
+        }
+        else if(filename.substr(filename.find_last_of(".") + 1) == "opb")
+        {
+            bdd_log << "[bdd solver] Parse opb file" << (parallel ? " in parallel" : "") << "\n";
+            return parallel ? OPB_parser::parse_file_parallel(filename) : OPB_parser::parse_file(filename);
         }
         else if(filename.substr(filename.find_last_of(".") + 1) == "lp")
         {
-            bdd_log << "[bdd solver] Parse lp file\n";
-            return ILP_parser::parse_file(filename);
+            bdd_log << "[bdd solver] Parse lp file" << (parallel ? " in parallel" : "") << "\n";
+            return parallel ? ILP_parser::parse_file_parallel(filename) : ILP_parser::parse_file(filename);
         }
         else // peek into file
         {
@@ -101,7 +109,7 @@ namespace LPMP {
         {
             if(!options.input_file.empty())
             {
-                return parse_ilp_file(options.input_file);
+                return parse_ilp_file(options.input_file, options.parallel_parse);
             }
             else if(!options.input_string.empty())
             {
@@ -124,6 +132,17 @@ namespace LPMP {
 
         auto input_string_arg = input_group->add_option("--input_string", input_string, "ILP input in string");
 
+        app.add_flag("--parallel_parse", parallel_parse, "parse input file with memory mapped multithreaded parser");
+
+        app.add_option("--bdd_cache", bdd_cache_directory, "directory for caching BDDs compiled from constraints across runs");
+
+        app.add_option("--memo_cache_memory", memo_cache_memory_mb, "memory budget in MiB of the memo cache used when building BDDs from constraints")
+            ->check(CLI::PositiveNumber);
+
+        app.add_option("--warm_start", warm_start_file, "filename of dual state exported by an earlier run on the same BDDs, used for initializing the solver if present");
+
+        app.add_option("--export_dual_state", export_dual_state_file, "filename for export of reparametrized BDD costs after solving");
+
         input_group->require_option(1); // either as string or as filename
 
         app.add_flag("--logarithms", take_cost_logarithms, "");
@@ -159,12 +178,14 @@ namespace LPMP {
             {"mma",bdd_solver_impl::sequential_mma},
             {"sequential_mma",bdd_solver_impl::sequential_mma},
             {"parallel_mma",bdd_solver_impl::parallel_mma},
+            {"simd_parallel_mma",bdd_solver_impl::simd_parallel_mma},
             {"mma_cuda",bdd_solver_impl::mma_cuda},
             {"cuda_mma",bdd_solver_impl::mma_cuda},
             {"hybrid_parallel_mma",bdd_solver_impl::hybrid_parallel_mma},
             {"lbfgs_cuda_mma", bdd_solver_impl::lbfgs_cuda_mma},
             {"lbfgs_parallel_mma", bdd_solver_impl::lbfgs_parallel_mma},
-            {"subgradient", bdd_solver_impl::subgradient}
+            {"subgradient", bdd_solver_impl::subgradient},
+            {"portfolio", bdd_solver_impl::portfolio}
         };
 
         auto solver_group = app.add_option_group("solver", "solver either a BDD solver, output of statistics or export of LP solved by BDD relaxation");
@@ -185,6 +206,15 @@ namespace LPMP {
         app.add_option("--smoothing", smoothing, "smoothing, default value = 0 (no smoothing)")
                 ->check(CLI::PositiveNumber);
 
+        app.add_flag("--parallel_mma_atomic_free", parallel_mma_atomic_free, "accumulate min-marginal differences in parallel mma through per BDD slots instead of atomic operations, contention-free and deterministic");
+
+        app.add_flag("--deterministic", deterministic, "make lower bounds of parallel mma iterations reproducible, i.e. independent of the number of threads");
+
+        app.add_flag("--decompose", decompose, "solve disconnected subproblems with separate solvers and termination criteria concurrently");
+
+        app.add_option("--portfolio_interval", portfolio_interval, "seconds between comparisons of lower bound progress of the solvers racing in the portfolio, default value = " + std::to_string(portfolio_interval))
+            ->check(CLI::PositiveNumber);
+
         app.add_flag("--cuda_split_long_bdds", cuda_split_long_bdds, "split long BDDs into short ones, might make cuda mma faster for problems with a few long inequalities");
         app.add_flag("--cuda_split_long_bdds_with_implication_bdd", cuda_split_long_bdds_implication_bdd, "split long BDDs into short ones and additionally construct implication BDD");
         app.add_option("--cuda_split_long_bdds_length", cuda_split_long_bdds_length, "split long BDDs into shorter ones of the specified length");
@@ -201,6 +231,9 @@ namespace LPMP {
         auto wedelin_primal_arg = primal_group->add_flag("--wedelin_primal", wedelin_primal_rounding, "Wedelin primal rounding flag");
         primal_group->require_option(0,1); 
 
+        app.add_option("--local_search_time", local_search_time, "time in seconds for improving the rounded primal solution by 1-flip and 2-swap local search, default value = 0")
+            ->check(CLI::NonNegativeNumber);
+
         auto incremental_rounding_param_group = app.add_option_group("incremental primal rounding parameters", "parameters for rounding a primal solution");
         incremental_rounding_param_group->needs(incremental_primal_arg);
 
@@ -216,6 +249,13 @@ namespace LPMP {
         incremental_rounding_param_group->add_option("--incremental_primal_rounding_num_itr", incremental_primal_rounding_num_itr, "maximum number of incremental primal rounding iterations")
             ->check(CLI::Range(1,std::numeric_limits<int>::max()));
 
+        incremental_rounding_param_group->add_option("--incremental_primal_trajectories", incremental_primal_trajectories, "number of perturbation trajectories with different seeds and growth rates run concurrently by incremental primal rounding, default value = 1")
+            ->check(CLI::Range(size_t(1),std::numeric_limits<size_t>::max()));
+
+        incremental_rounding_param_group->add_flag("--incremental_primal_propagation", incremental_primal_propagation, "complete min-marginals to a primal solution by propagation through the BDDs and backtracking search before perturbing costs");
+
+        incremental_rounding_param_group->add_flag("--incremental_primal_stop_at_first", incremental_primal_stop_at_first, "stop all trajectories of incremental primal rounding as soon as one finds a solution instead of returning the best one");
+
         auto wedelin_rounding_param_group = app.add_option_group("Wedelin primal rounding parameters", "parameters for rounding a primal solution");
         wedelin_rounding_param_group->needs(wedelin_primal_arg);
 
@@ -241,6 +281,8 @@ namespace LPMP {
 
         solver_group->add_option("--export_lp", export_lp_file, "filename for export of LP");
 
+        solver_group->add_option("--export_binary", export_binary_file, "filename for export of ILP in binary format, can be read again as input file");
+
         solver_group->add_option("--export_bdd_graph", export_bdd_graph_file, "filename for export of BDD representation in .dot format");
 
         solver_group->require_option(1); // either a solver or statistics
@@ -332,7 +374,18 @@ namespace LPMP {
             return false;
         }();
 
-        bdd_preprocessor bdd_pre(options.ilp, normalize_constraints, options.cuda_split_long_bdds, options.cuda_split_long_bdds_implication_bdd, options.cuda_split_long_bdds_length);
+        bdd_preprocessor bdd_pre;
+        if(!options.bdd_cache_directory.empty())
+            bdd_pre.set_cache_directory(options.bdd_cache_directory);
+        bdd_pre.set_memo_cache_memory(options.memo_cache_memory_mb << 20);
+        bdd_pre.add_ilp(options.ilp, normalize_constraints, options.cuda_split_long_bdds, options.cuda_split_long_bdds_implication_bdd, options.cuda_split_long_bdds_length);
+
+        if(options.incremental_primal_propagation)
+            primal_propagator.emplace(bdd_pre.get_bdd_collection());
+
+        // node order of the solver depends on the BDDs as well as on solver type and precision
+        if(!options.warm_start_file.empty() || !options.export_dual_state_file.empty())
+            dual_state_key = bdd_dual_state::key(bdd_pre.get_bdd_collection(), 2*static_cast<size_t>(options.bdd_solver_impl_) + static_cast<size_t>(options.bdd_solver_precision_));
 
         bdd_log << std::setprecision(10);
 
@@ -365,6 +418,15 @@ namespace LPMP {
             f.close(); 
             exit(0);
         }
+        else if(!options.export_binary_file.empty())
+        {
+            std::ofstream f(options.export_binary_file, std::ios::binary);
+            options.ilp.write_binary(f);
+            f.close();
+            if(!f)
+                throw std::runtime_error("could not write binary ILP file " + options.export_binary_file);
+            exit(0);
+        }
         else if(!options.export_bdd_graph_file.empty())
         {
 
@@ -398,6 +460,10 @@ namespace LPMP {
             }
             exit(0);
         }
+        else if(options.decompose && construct_component_solvers(bdd_pre.get_bdd_collection()))
+        {
+            bdd_log << "[bdd solver] constructed " << component_solvers.size() << " solvers for disconnected subproblems\n";
+        }
         else if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::sequential_mma)
         {
             if(options.smoothing == 0)
@@ -442,6 +508,18 @@ namespace LPMP {
                 bdd_log << "[bdd solver] constructed smooth parallel mma solver\n"; 
             }
         }
+        else if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::simd_parallel_mma)
+        {
+            if(options.smoothing != 0)
+                throw std::runtime_error("no smoothing implemented for simd parallel mma");
+            if(options.bdd_solver_precision_ == bdd_solver_options::bdd_solver_precision::single_prec)
+                solver = std::move(bdd_simd_parallel_mma<float>(bdd_pre.get_bdd_collection(), costs.begin(), costs.end()));
+            else if(options.bdd_solver_precision_ == bdd_solver_options::bdd_solver_precision::double_prec)
+                solver = std::move(bdd_simd_parallel_mma<double>(bdd_pre.get_bdd_collection(), costs.begin(), costs.end()));
+            else
+                throw std::runtime_error("only float and double precision allowed");
+            bdd_log << "[bdd solver] constructed simd parallel mma solver\n"; 
+        }
         else if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::mma_cuda)
         {
             if(options.smoothing != 0)
@@ -518,11 +596,25 @@ namespace LPMP {
                 throw std::runtime_error("only float and double precision allowed");
             bdd_log << "[bdd solver] constructed subgradient solver\n"; 
         }
+        else if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::portfolio)
+        {
+            construct_portfolio(bdd_pre.get_bdd_collection());
+            bdd_log << "[bdd solver] constructed portfolio of " << portfolio_names.size() << " solvers\n"; 
+        }
         else
         {
             throw std::runtime_error("no solver nor output of statistics or export of lp selected");
         }
 
+        // the portfolio sets up its solvers itself and accounts for the constant in lower_bound()
+        if(!component_solvers.empty() || options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::portfolio)
+        {
+            auto setup_time = (double) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000;
+            bdd_log << "[bdd solver] setup time = " << setup_time << " s" << "\n";
+            options.time_limit -= setup_time;
+            return;
+        }
+
         // set smoothing
         if(options.smoothing != 0.0)
             std::visit([&](auto&& s) { 
@@ -537,6 +629,34 @@ namespace LPMP {
                     throw std::runtime_error("smoothing not implemented for chosen solver");
                     }, *solver);
 
+        // set delta aggregation of parallel mma
+        if(options.parallel_mma_atomic_free)
+            std::visit([&](auto&& s) { 
+                    if constexpr(
+                            std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<double>>
+                            )
+                    s.set_atomic_free_delta_aggregation(true);
+                    else
+                    throw std::runtime_error("atomic free delta aggregation only implemented for parallel mma solvers");
+            }, *solver);
+
+        if(options.deterministic)
+            std::visit([&](auto&& s) { 
+                    if constexpr(
+                            std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<double>>
+                            )
+                    s.set_deterministic(true);
+                    else if constexpr(
+                            std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<double>>
+                            )
+                    {} // sequential and layered solvers are deterministic anyway
+                    else
+                    throw std::runtime_error("deterministic mode only implemented for parallel mma solvers");
+            }, *solver);
+
         // set constant
         if(options.ilp.constant() != 0.0)
             std::visit([&](auto&& s) { 
@@ -545,12 +665,16 @@ namespace LPMP {
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma_smooth<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma_smooth<double>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma_smooth<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma_smooth<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<double>>
                             )
                     s.add_to_constant(options.ilp.constant());
                     else
                     throw std::runtime_error("constants not implemented for chosen solver");
             }, *solver);
 
+        if(!options.warm_start_file.empty())
+            warm_start();
+
         auto setup_time = (double) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000;
         bdd_log << "[bdd solver] setup time = " << setup_time << " s" << "\n";
         options.time_limit -= setup_time;
@@ -564,10 +688,15 @@ namespace LPMP {
             bdd_log << "[bdd_solver] Time limit exceeded.\n";
             return;
         }
-        std::visit([&](auto&& s) {
+        if(!component_solvers.empty())
+            solve_components();
+        else if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::portfolio)
+            solve_portfolio();
+        else
+            std::visit([&](auto&& s) {
 
-                run_solver(s, options.max_iter, options.tolerance, options.improvement_slope, options.time_limit);
-                }, *solver);
+                    run_solver(s, options.max_iter, options.tolerance, options.improvement_slope, options.time_limit);
+                    }, *solver);
 
         // TODO: improve, do periodic tightening
         if(options.tighten)
@@ -582,6 +711,9 @@ namespace LPMP {
             }
         }
 
+        if(!options.export_dual_state_file.empty())
+            export_dual_state();
+
         if(options.solution_statistics)
         {
             bdd_log << "[bdd solver] print solution statistics:\n";
@@ -606,24 +738,125 @@ namespace LPMP {
 
     two_dim_variable_array<std::array<double,2>> bdd_solver::min_marginals()
     {
-        const auto mms = std::visit([&](auto&& s) { 
+        return permute_min_marginals(solver_min_marginals(), options.ilp.get_variable_permutation());
+    }
+
+    two_dim_variable_array<std::array<double,2>> bdd_solver::solver_min_marginals()
+    {
+        if(!component_solvers.empty())
+        {
+            std::vector<std::vector<std::array<double,2>>> mms(costs.size());
+            for(size_t c=0; c<component_solvers.size(); ++c)
+            {
+                const auto c_mms = std::visit([&](auto&& s) { 
+                        return s.min_marginals();
+                        }, component_solvers[c]); 
+                assert(c_mms.size() == component_variables[c].size());
+                for(size_t i=0; i<c_mms.size(); ++i)
+                    for(size_t j=0; j<c_mms.size(i); ++j)
+                        mms[component_variables[c][i]].push_back(c_mms(i,j));
+            }
+            return two_dim_variable_array<std::array<double,2>>(mms);
+        }
+
+        return std::visit([&](auto&& s) { 
                 return s.min_marginals();
                 }, *solver); 
-        return permute_min_marginals(mms, options.ilp.get_variable_permutation());
     }
 
     std::tuple<double, std::vector<char>> bdd_solver::round()
+    {
+        if(options.local_search_time <= 0.0)
+            return round_dual();
+
+        // reduced costs are taken before rounding perturbs the costs of the solver
+        std::vector<double> reduced_costs;
+        {
+            const mm_primal_decoder mms(solver_min_marginals());
+            reduced_costs.reserve(mms.size());
+            for(size_t i=0; i<mms.size(); ++i)
+            {
+                const auto mm_sum = mms.mm_sum(i);
+                const double diff = mm_sum[1] - mm_sum[0];
+                reduced_costs.push_back(std::isfinite(diff) ? diff : 0.0);
+            }
+        }
+
+        auto [obj, sol] = round_dual();
+        if(obj == std::numeric_limits<double>::infinity())
+            return {obj, sol};
+
+        sol = primal_local_search(options.ilp, costs, reduced_costs, sol, options.local_search_time);
+        obj = options.ilp.evaluate(sol.begin(), sol.begin() + options.ilp.nr_variables());
+        bdd_log << "[local search] solution objective = " << obj << "\n";
+        return {obj, sol};
+    }
+
+    std::tuple<double, std::vector<char>> bdd_solver::round_dual()
     {
         if(options.incremental_primal_rounding)
         {
             bdd_log << "[incremental primal rounding] start rounding\n";
-            const auto sol = std::visit([&](auto &&s)
+
+            // further trajectories run on copies of the solver that are kept for subsequent roundings and then only receive the current branch node costs
+            auto trajectory_solvers = [&](auto& s) {
+                using solver_type = std::remove_reference_t<decltype(s)>;
+                if(rounding_solvers_source != &s)
+                {
+                    rounding_solvers.clear();
+                    rounding_solvers_source = &s;
+                }
+                const size_t nr_copies = options.incremental_primal_trajectories - 1;
+                std::vector<std::array<double,2>> node_costs;
+                if(rounding_solvers.size() > 0)
+                    node_costs = s.node_costs();
+                for(size_t k=0; k<nr_copies; ++k)
+                {
+                    if(k < rounding_solvers.size())
+                        std::get<solver_type>(rounding_solvers[k]).set_node_costs(node_costs);
+                    else
+                        rounding_solvers.push_back(solver_type(s));
+                }
+                std::vector<solver_type*> solvers = {&s};
+                for(size_t k=0; k<nr_copies; ++k)
+                    solvers.push_back(&std::get<solver_type>(rounding_solvers[k]));
+                return solvers;
+            };
+
+            // solutions are compared w.r.t. the minimized costs of the variables covered by the solver
+            auto incremental_rounding = [&](auto &&s, const std::vector<double>& rounding_costs)
                                         {
+                    if constexpr( // parallel CPU rounding with several trajectories
+                            std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<float>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<float>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<double>>
+                            )
+                    {
+                        if(options.incremental_primal_trajectories > 1)
+                        {
+                            auto objective = [&](const std::vector<char>& sol) {
+                                assert(sol.size() >= rounding_costs.size());
+                                double obj = 0.0;
+                                for(size_t i=0; i<rounding_costs.size(); ++i)
+                                    obj += rounding_costs[i] * sol[i];
+                                return obj;
+                            };
+                            return parallel_incremental_mm_agreement_rounding(trajectory_solvers(s), objective, options.incremental_primal_stop_at_first,
+                                    options.incremental_initial_perturbation, options.incremental_growth_rate, options.incremental_primal_num_itr_lb, options.incremental_primal_rounding_num_itr,
+                                    primal_propagator ? &*primal_propagator : nullptr);
+                        }
+                    }
+
                     if constexpr( // CPU rounding
                             std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<float>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<double>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<float>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<double>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<float>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<double>>
                             // TODO: remove for cuda rounding again //
@@ -632,7 +865,8 @@ namespace LPMP {
                             //////////////////////////////////////////
                             )
                             {
-                    return incremental_mm_agreement_rounding_iter(s, options.incremental_initial_perturbation, options.incremental_growth_rate, options.incremental_primal_num_itr_lb, options.incremental_primal_rounding_num_itr);
+                    return incremental_mm_agreement_rounding_iter(s, options.incremental_initial_perturbation, options.incremental_growth_rate, options.incremental_primal_num_itr_lb, options.incremental_primal_rounding_num_itr,
+                            primal_propagator ? &*primal_propagator : nullptr);
                             }
                     else if constexpr( // GPU rounding
                             std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_cuda<float>>
@@ -647,8 +881,79 @@ namespace LPMP {
                     {
                     throw std::runtime_error("solver not supported for incremental rounding");
                     return std::vector<char>{};
-                    } },
-                                        *solver);
+                    } };
+
+            if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::portfolio)
+            {
+                // round with all solvers that were not dropped from the portfolio and keep the best solution
+                std::vector<std::vector<char>> sols;
+                std::vector<size_t> sol_solvers;
+                for(size_t i=0; i<portfolio_names.size(); ++i)
+                {
+                    auto& s = i == 0 ? *solver : portfolio_solvers[i-1];
+                    const bool cpu_rounding = std::visit([](auto&& s) {
+                            using solver_type = std::remove_reference_t<decltype(s)>;
+                            return std::is_same_v<solver_type, bdd_parallel_mma<float>> || std::is_same_v<solver_type, bdd_parallel_mma<double>>
+                            || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<double>>;
+                            }, s);
+                    if(!cpu_rounding)
+                        continue;
+                    auto sol = std::visit([&](auto&& s) { return incremental_rounding(s, costs); }, s);
+                    if(sol.size() < options.ilp.nr_variables())
+                        continue;
+                    sol.resize(options.ilp.nr_variables());
+                    sols.push_back(std::move(sol));
+                    sol_solvers.push_back(i);
+                }
+
+                const auto objs = ILP_evaluator(options.ilp).evaluate(sols);
+                double best_obj = std::numeric_limits<double>::infinity();
+                double best_cost = std::numeric_limits<double>::infinity();
+                std::vector<char> best_sol;
+                for(size_t k=0; k<sols.size(); ++k)
+                {
+                    bdd_log << "[incremental primal rounding] " << portfolio_names[sol_solvers[k]] << " solution objective = " << objs[k] << "\n";
+                    if(objs[k] == std::numeric_limits<double>::infinity())
+                        continue;
+                    // compare costs in minimization sense
+                    double cost = 0.0;
+                    for(size_t j=0; j<costs.size(); ++j)
+                        cost += costs[j] * sols[k][j];
+                    if(best_sol.empty() || cost < best_cost)
+                    {
+                        best_obj = objs[k];
+                        best_cost = cost;
+                        best_sol = sols[k];
+                    }
+                }
+                bdd_log << "[incremental primal rounding] best solution objective = " << best_obj << "\n";
+                return {best_obj, best_sol};
+            }
+
+            const auto sol = [&]() {
+                if(component_solvers.empty())
+                    return std::visit([&](auto&& s) { return incremental_rounding(s, costs); }, *solver);
+
+                // variables not covered by any BDD take their cheaper value
+                std::vector<char> sol(costs.size());
+                for(size_t i=0; i<costs.size(); ++i)
+                    sol[i] = costs[i] < 0.0;
+                for(size_t c=0; c<component_solvers.size(); ++c)
+                {
+                    std::vector<double> c_costs;
+                    for(const size_t v : component_variables[c])
+                        c_costs.push_back(costs[v]);
+                    const auto c_sol = std::visit([&](auto&& s) { return incremental_rounding(s, c_costs); }, component_solvers[c]);
+                    if(c_sol.size() < component_variables[c].size())
+                    {
+                        bdd_log << "[incremental primal rounding] no solution found for subproblem " << c << "\n";
+                        return std::vector<char>{};
+                    }
+                    for(size_t i=0; i<component_variables[c].size(); ++i)
+                        sol[component_variables[c][i]] = c_sol[i];
+                }
+                return sol;
+            }();
 
             double obj = std::numeric_limits<double>::infinity();
             if (sol.size() >= options.ilp.nr_variables())
@@ -663,8 +968,10 @@ namespace LPMP {
                     if constexpr( // CPU rounding
                             std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<float>>
                             || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<double>>
-                            //|| std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>>
-                            //|| std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<float>>
+                            || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_lbfgs_parallel_mma<double>>
                             // TODO: remove for cuda rounding again //
                             //|| std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_cuda<float>>
                             //|| std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_cuda<double>>
@@ -711,9 +1018,19 @@ namespace LPMP {
             return;
         }
 
+        if(!component_solvers.empty())
+            throw std::runtime_error("tightening not implemented for disconnected subproblems");
+        // copies for rounding trajectories do not contain the new BDDs
+        rounding_solvers.clear();
+        rounding_solvers_source = nullptr;
+
         bdd_log << "Tighten...\n";
         std::visit([](auto&& s) {
-            if constexpr(std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<float>>)
+            using solver_type = std::remove_reference_t<decltype(s)>;
+            if constexpr(std::is_same_v<solver_type, bdd_mma<float>> || std::is_same_v<solver_type, bdd_mma<double>>
+                    || std::is_same_v<solver_type, bdd_parallel_mma<float>> || std::is_same_v<solver_type, bdd_parallel_mma<double>>
+                    || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<double>>
+                    || std::is_same_v<solver_type, bdd_simd_parallel_mma<float>> || std::is_same_v<solver_type, bdd_simd_parallel_mma<double>>)
             s.tighten();
             else
                 throw std::runtime_error("tighten not implemented");
@@ -722,11 +1039,15 @@ namespace LPMP {
 
     void bdd_solver::fix_variable(const size_t var, const bool value)
     {
+        if(!component_solvers.empty())
+            throw std::runtime_error("fixing variables not implemented for disconnected subproblems");
         std::visit([var, value](auto&& s) {
             if constexpr(
                     std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_mma<double>>
                     ||
                     std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma<double>>
+                    ||
+                    std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_simd_parallel_mma<double>>
                     )
             s.fix_variable(var, value);
             else
@@ -742,9 +1063,423 @@ namespace LPMP {
 
     double bdd_solver::lower_bound()
     {
-        return std::visit([](auto&& s) {
+        if(!component_solvers.empty())
+        {
+            double lb = component_constant;
+            for(auto& cs : component_solvers)
+                lb += std::visit([](auto&& s) {
+                        return s.lower_bound(); 
+                        }, cs);
+            return lb;
+        }
+
+        const double lb = std::visit([](auto&& s) {
                 return s.lower_bound(); 
                 }, *solver);
+        if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::portfolio)
+            return lb + options.ilp.constant();
+        return lb;
+    }
+
+    bool bdd_solver::construct_component_solvers(BDD::bdd_collection& bdd_col)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        auto [components, component_vars] = bdd_col.connected_components();
+        if(components.size() <= 1)
+        {
+            bdd_log << "[bdd solver] problem has no disconnected subproblems, solve it as a whole\n";
+            return false;
+        }
+        if(options.smoothing != 0 || options.tighten || options.wedelin_primal_rounding || options.incremental_primal_propagation || !options.warm_start_file.empty() || !options.export_dual_state_file.empty())
+            throw std::runtime_error("smoothing, tightening, Wedelin rounding, primal propagation and dual states not implemented for disconnected subproblems");
+        bdd_log << "[bdd solver] problem decomposes into " << components.size() << " disconnected subproblems\n";
+
+        component_variables = std::move(component_vars);
+        component_constant = options.ilp.constant();
+        std::vector<char> covered(costs.size(), false);
+        for(const auto& vars : component_variables)
+            for(const size_t v : vars)
+                covered[v] = true;
+        for(size_t i=0; i<costs.size(); ++i)
+            if(!covered[i])
+                component_constant += std::min(costs[i], 0.0);
+
+        const bool single_prec = options.bdd_solver_precision_ == bdd_solver_options::bdd_solver_precision::single_prec;
+        std::vector<double> component_costs;
+        for(size_t c=0; c<components.size(); ++c)
+        {
+            component_costs.clear();
+            for(const size_t v : component_variables[c])
+                component_costs.push_back(costs[v]);
+            if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::sequential_mma)
+            {
+                if(single_prec)
+                    component_solvers.push_back(bdd_mma<float>(components[c], component_costs.begin(), component_costs.end()));
+                else
+                    component_solvers.push_back(bdd_mma<double>(components[c], component_costs.begin(), component_costs.end()));
+            }
+            else if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::parallel_mma)
+            {
+                if(single_prec)
+                    component_solvers.push_back(bdd_parallel_mma<float>(components[c], component_costs.begin(), component_costs.end()));
+                else
+                    component_solvers.push_back(bdd_parallel_mma<double>(components[c], component_costs.begin(), component_costs.end()));
+            }
+            else if(options.bdd_solver_impl_ == bdd_solver_options::bdd_solver_impl::lbfgs_parallel_mma)
+            {
+                if(single_prec)
+                    component_solvers.push_back(bdd_lbfgs_parallel_mma<float>(
+                                components[c], component_costs.begin(), component_costs.end(),
+                                options.lbfgs_history_size,
+                                options.lbfgs_step_size, options.lbfgs_required_relative_lb_increase, 
+                                options.lbfgs_step_size_decrease_factor, options.lbfgs_step_size_increase_factor));
+                else
+                    component_solvers.push_back(bdd_lbfgs_parallel_mma<double>(
+                                components[c], component_costs.begin(), component_costs.end(),
+                                options.lbfgs_history_size,
+                                options.lbfgs_step_size, options.lbfgs_required_relative_lb_increase, 
+                                options.lbfgs_step_size_decrease_factor, options.lbfgs_step_size_increase_factor));
+            }
+            else
+                throw std::runtime_error("disconnected subproblems only implemented for mma, parallel mma and lbfgs parallel mma");
+
+            std::visit([&](auto&& s) { 
+                    using solver_type = std::remove_reference_t<decltype(s)>;
+                    if constexpr(std::is_same_v<solver_type, bdd_parallel_mma<float>> || std::is_same_v<solver_type, bdd_parallel_mma<double>>
+                            || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<double>>)
+                    {
+                        if(options.parallel_mma_atomic_free)
+                            s.set_atomic_free_delta_aggregation(true);
+                        if(options.deterministic)
+                            s.set_deterministic(true);
+                    }
+                    }, component_solvers.back());
+        }
+
+        // subproblems holding at least a thread's share of all BDD nodes are solved one after another with all threads, the remaining ones concurrently
+#ifdef _OPENMP
+        const size_t nr_threads = omp_get_max_threads();
+#else
+        const size_t nr_threads = 1;
+#endif
+        const size_t nr_bdd_nodes = bdd_col.instructions().size();
+        nr_large_components = 0;
+        while(nr_large_components < components.size() && components[nr_large_components].instructions().size() * nr_threads >= nr_bdd_nodes)
+            ++nr_large_components;
+
+        return true;
+    }
+
+    void bdd_solver::solve_components()
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        bdd_log << "[bdd solver] solve " << nr_large_components << " large subproblems one after another and " << component_solvers.size() - nr_large_components << " small ones concurrently\n";
+        bdd_log << "[bdd solver] initial lower bound = " << lower_bound() << "\n";
+
+        // every subproblem stops on its own termination criteria
+        const auto start_time = std::chrono::steady_clock::now();
+        auto solve_component = [&](const size_t c) {
+            const double time_spent = (double) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count() / 1000;
+            std::visit([&](auto&& s) {
+                    run_solver(s, options.max_iter, options.tolerance, options.improvement_slope, std::max(options.time_limit - time_spent, 0.0), false);
+                    }, component_solvers[c]);
+        };
+
+        for(size_t c=0; c<nr_large_components; ++c)
+            solve_component(c);
+
+        // subproblems are ordered by decreasing size, idle threads pick up the next one
+#pragma omp parallel for schedule(dynamic, 1)
+        for(size_t c=nr_large_components; c<component_solvers.size(); ++c)
+            solve_component(c);
+
+        bdd_log << "[bdd solver] final lower bound = " << lower_bound() << "\n";
+    }
+
+    void bdd_solver::construct_portfolio(BDD::bdd_collection& bdd_col)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        if(!options.warm_start_file.empty() || !options.export_dual_state_file.empty())
+            throw std::runtime_error("dual states not implemented for solver portfolio");
+
+        const bool single_prec = options.bdd_solver_precision_ == bdd_solver_options::bdd_solver_precision::single_prec;
+        auto add_solver = [&](solver_type&& s, const std::string& name) {
+            if(!solver)
+                solver = std::move(s);
+            else
+                portfolio_solvers.push_back(std::move(s));
+            portfolio_names.push_back(name);
+        };
+
+        if(single_prec)
+            add_solver(bdd_parallel_mma<float>(bdd_col, costs.begin(), costs.end()), "parallel_mma");
+        else
+            add_solver(bdd_parallel_mma<double>(bdd_col, costs.begin(), costs.end()), "parallel_mma");
+
+        if(single_prec)
+            add_solver(bdd_lbfgs_parallel_mma<float>(
+                        bdd_col, costs.begin(), costs.end(),
+                        options.lbfgs_history_size,
+                        options.lbfgs_step_size, options.lbfgs_required_relative_lb_increase, 
+                        options.lbfgs_step_size_decrease_factor, options.lbfgs_step_size_increase_factor), "lbfgs_parallel_mma");
+        else
+            add_solver(bdd_lbfgs_parallel_mma<double>(
+                        bdd_col, costs.begin(), costs.end(),
+                        options.lbfgs_history_size,
+                        options.lbfgs_step_size, options.lbfgs_required_relative_lb_increase, 
+                        options.lbfgs_step_size_decrease_factor, options.lbfgs_step_size_increase_factor), "lbfgs_parallel_mma");
+
+        if(single_prec)
+            add_solver(bdd_subgradient<float>(bdd_col, costs.begin(), costs.end()), "subgradient");
+        else
+            add_solver(bdd_subgradient<double>(bdd_col, costs.begin(), costs.end()), "subgradient");
+
+        // a good smoothing value depends on the scale of the costs, hence the smoothed variant only races when one is given
+        if(options.smoothing != 0)
+        {
+            if(single_prec)
+                add_solver(bdd_parallel_mma_smooth<float>(bdd_col, costs.begin(), costs.end()), "parallel_mma_smooth");
+            else
+                add_solver(bdd_parallel_mma_smooth<double>(bdd_col, costs.begin(), costs.end()), "parallel_mma_smooth");
+            std::visit([&](auto&& s) {
+                    if constexpr(std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma_smooth<float>> || std::is_same_v<std::remove_reference_t<decltype(s)>, bdd_parallel_mma_smooth<double>>)
+                    s.set_smoothing(options.smoothing);
+                    }, portfolio_solvers.back());
+        }
+
+        auto set_parallel_mma_options = [&](auto&& s) {
+            using solver_type = std::remove_reference_t<decltype(s)>;
+            if constexpr(std::is_same_v<solver_type, bdd_parallel_mma<float>> || std::is_same_v<solver_type, bdd_parallel_mma<double>>
+                    || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<double>>)
+            {
+                if(options.parallel_mma_atomic_free)
+                    s.set_atomic_free_delta_aggregation(true);
+                if(options.deterministic)
+                    s.set_deterministic(true);
+            }
+        };
+        std::visit(set_parallel_mma_options, *solver);
+        for(auto& s : portfolio_solvers)
+            std::visit(set_parallel_mma_options, s);
+    }
+
+    void bdd_solver::solve_portfolio()
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        // solvers are moved around below
+        rounding_solvers.clear();
+        rounding_solvers_source = nullptr;
+        std::vector<solver_type*> solvers = {&*solver};
+        for(auto& s : portfolio_solvers)
+            solvers.push_back(&s);
+
+        struct racer {
+            size_t nr_threads = 0;
+            bool active = true; // false after termination criteria are met or after being dropped
+            bool dropped = false;
+            size_t iter = 0;
+            double lb_initial;
+            double lb_first_iter = std::numeric_limits<double>::max();
+            double lb_prev;
+            double lb;
+            double rate = 0.0; // lower bound increase per second during last round
+        };
+        std::vector<racer> racers(solvers.size());
+
+#ifdef _OPENMP
+        const size_t nr_threads = omp_get_max_threads();
+        const int prev_max_active_levels = omp_get_max_active_levels();
+        omp_set_max_active_levels(2);
+#else
+        const size_t nr_threads = 1;
+#endif
+        for(size_t i=0; i<racers.size(); ++i)
+        {
+            racers[i].nr_threads = std::max(size_t(1), nr_threads / racers.size() + (i < nr_threads % racers.size()));
+            racers[i].lb_initial = std::visit([](auto&& s) { return s.lower_bound(); }, *solvers[i]);
+            racers[i].lb_prev = racers[i].lb_initial;
+            racers[i].lb = racers[i].lb_initial;
+        }
+        bdd_log << "[bdd solver portfolio] race " << racers.size() << " solvers on " << nr_threads << " threads, compare progress every " << options.portfolio_interval << " s\n";
+
+        const auto start_time = std::chrono::steady_clock::now();
+        auto seconds_since = [](const auto t) {
+            return (double) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t).count() / 1000;
+        };
+
+        std::vector<size_t> active;
+        for(size_t round=0;; ++round)
+        {
+            active.clear();
+            for(size_t i=0; i<racers.size(); ++i)
+                if(racers[i].active)
+                    active.push_back(i);
+            if(active.empty())
+                break;
+
+            // every solver iterates with its share of threads for one interval, using the same termination criteria as run_solver
+#pragma omp parallel for num_threads(active.size()) schedule(static, 1)
+            for(size_t a=0; a<active.size(); ++a)
+            {
+                racer& r = racers[active[a]];
+#ifdef _OPENMP
+                omp_set_num_threads(r.nr_threads);
+#endif
+                const auto round_start = std::chrono::steady_clock::now();
+                const double lb_round_start = r.lb;
+                std::visit([&](auto&& s) {
+                        do {
+                            s.iteration();
+                            r.lb_prev = r.lb;
+                            r.lb = s.lower_bound();
+                            if(r.iter++ == 0)
+                                r.lb_first_iter = r.lb;
+                            if(r.iter >= options.max_iter
+                                    || seconds_since(start_time) > options.time_limit
+                                    || std::abs(r.lb_prev - r.lb) < std::abs(options.tolerance * r.lb_prev)
+                                    || std::abs(r.lb_prev - r.lb) < options.improvement_slope * std::abs(r.lb_initial - r.lb_first_iter)
+                                    || r.lb == std::numeric_limits<double>::infinity())
+                                r.active = false;
+                        } while(r.active && seconds_since(round_start) < options.portfolio_interval);
+                        }, *solvers[active[a]]);
+                r.rate = (r.lb - lb_round_start) / std::max(seconds_since(round_start), 1e-3);
+            }
+
+            // solvers that cannot catch up with the best lower bound within the next round are behind,
+            // the leader is the solver expected to have the best lower bound after the next round
+            double best_lb = -std::numeric_limits<double>::infinity();
+            for(const racer& r : racers)
+                if(!r.dropped)
+                    best_lb = std::max(best_lb, r.lb);
+            auto projected_lb = [&](const racer& r) { return r.lb + r.rate * options.portfolio_interval; };
+            auto behind = [&](const racer& r) { return r.lb < best_lb && projected_lb(r) < best_lb; };
+            size_t leader = racers.size();
+            for(const size_t i : active)
+                if(racers[i].active && !behind(racers[i]) && (leader == racers.size() || projected_lb(racers[i]) > projected_lb(racers[leader])))
+                    leader = i;
+
+            for(const size_t i : active)
+            {
+                racer& r = racers[i];
+                bdd_log << "[bdd solver portfolio] round " << round << ", " << portfolio_names[i] << ": lower bound = " << r.lb << ", progress = " << r.rate << "/s, threads = " << r.nr_threads << (r.active ? "" : ", terminated") << "\n";
+                if(i == leader)
+                    continue;
+                // terminated solvers pass all their threads to the leader, solvers behind pass half of them and are dropped when none are left
+                if(!r.active)
+                {
+                    if(leader < racers.size())
+                        racers[leader].nr_threads += r.nr_threads;
+                    r.nr_threads = 0;
+                }
+                else if(leader == racers.size())
+                {
+                    // the best lower bound is attained by a terminated solver which no running solver can catch up with
+                    r.active = false;
+                    bdd_log << "[bdd solver portfolio] stop " << portfolio_names[i] << ", it is behind\n";
+                }
+                else if(behind(r))
+                {
+                    const size_t nr_moved_threads = r.nr_threads > 1 ? r.nr_threads / 2 : 1;
+                    racers[leader].nr_threads += nr_moved_threads;
+                    r.nr_threads -= nr_moved_threads;
+                    if(r.nr_threads == 0)
+                    {
+                        r.active = false;
+                        r.dropped = true;
+                        bdd_log << "[bdd solver portfolio] drop " << portfolio_names[i] << "\n";
+                    }
+                }
+            }
+        }
+#ifdef _OPENMP
+        omp_set_max_active_levels(prev_max_active_levels);
+#endif
+
+        size_t winner = 0;
+        for(size_t i=1; i<racers.size(); ++i)
+            if(racers[i].lb > racers[winner].lb)
+                winner = i;
+        bdd_log << "[bdd solver portfolio] " << portfolio_names[winner] << " attained best lower bound " << racers[winner].lb + options.ilp.constant() << " after " << racers[winner].iter << " iterations, time = " << seconds_since(start_time) << " s\n";
+
+        // the winner becomes the solver, runners-up that were not dropped are kept for rounding
+        std::vector<solver_type> all_solvers;
+        all_solvers.push_back(std::move(*solver));
+        for(auto& s : portfolio_solvers)
+            all_solvers.push_back(std::move(s));
+        std::vector<std::string> all_names = std::move(portfolio_names);
+        portfolio_solvers.clear();
+        portfolio_names.clear();
+
+        solver = std::move(all_solvers[winner]);
+        portfolio_names.push_back(all_names[winner]);
+        for(size_t i=0; i<all_solvers.size(); ++i)
+        {
+            if(i == winner || racers[i].dropped)
+                continue;
+            portfolio_solvers.push_back(std::move(all_solvers[i]));
+            portfolio_names.push_back(all_names[i]);
+        }
+    }
+
+    void bdd_solver::warm_start()
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        bdd_dual_state state;
+        if(!state.load(options.warm_start_file, dual_state_key))
+        {
+            bdd_log << "[bdd solver] no dual state for warm start found in " << options.warm_start_file << "\n";
+            return;
+        }
+        if(state.objective.size() != costs.size())
+        {
+            bdd_log << "[bdd solver] dual state has " << state.objective.size() << " variables, ILP has " << costs.size() << ", skip warm start\n";
+            return;
+        }
+
+        std::visit([&](auto&& s) {
+            using solver_type = std::remove_reference_t<decltype(s)>;
+            if constexpr(std::is_same_v<solver_type, bdd_mma<float>> || std::is_same_v<solver_type, bdd_mma<double>>
+                    || std::is_same_v<solver_type, bdd_parallel_mma<float>> || std::is_same_v<solver_type, bdd_parallel_mma<double>>
+                    || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<double>>)
+            {
+                // dual states exported after tightening contain additional BDDs
+                const size_t nr_bdd_nodes = s.node_costs().size();
+                if(state.node_costs.size() != nr_bdd_nodes)
+                {
+                    bdd_log << "[bdd solver] dual state has " << state.node_costs.size() << " bdd nodes, solver has " << nr_bdd_nodes << ", skip warm start\n";
+                    return;
+                }
+                s.set_node_costs(state.node_costs);
+                std::vector<double> cost_delta(costs.size());
+                for(size_t i=0; i<costs.size(); ++i)
+                    cost_delta[i] = costs[i] - state.objective[i];
+                s.update_costs(cost_delta.begin(), cost_delta.begin(), cost_delta.begin(), cost_delta.end());
+                s.backward_run();
+                bdd_log << "[bdd solver] warm started from " << options.warm_start_file << "\n";
+            }
+            else
+                throw std::runtime_error("warm start not implemented for chosen solver");
+            }, *solver);
+    }
+
+    void bdd_solver::export_dual_state()
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        bdd_dual_state state;
+        state.objective = costs;
+        state.node_costs = std::visit([](auto&& s) {
+            using solver_type = std::remove_reference_t<decltype(s)>;
+            if constexpr(std::is_same_v<solver_type, bdd_mma<float>> || std::is_same_v<solver_type, bdd_mma<double>>
+                    || std::is_same_v<solver_type, bdd_parallel_mma<float>> || std::is_same_v<solver_type, bdd_parallel_mma<double>>
+                    || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<float>> || std::is_same_v<solver_type, bdd_lbfgs_parallel_mma<double>>)
+                return s.node_costs();
+            else
+            {
+                throw std::runtime_error("export of dual state not implemented for chosen solver");
+                return std::vector<std::array<double,2>>{};
+            }
+            }, *solver);
+        state.store(options.export_dual_state_file, dual_state_key);
     }
 
     void bdd_solver::export_difficult_core()
@@ -39,6 +39,7 @@ PYBIND11_MODULE(bdd_solver_py, m) {
         .def_readwrite("wedelin_kappa_min", &LPMP::bdd_solver_options::wedelin_kappa_min)
         .def_readwrite("wedelin_kappa_max", &LPMP::bdd_solver_options::wedelin_kappa_max)
         .def_readwrite("wedelin_kappa_step", &LPMP::bdd_solver_options::wedelin_kappa_step)
+        .def_readwrite("local_search_time", &LPMP::bdd_solver_options::local_search_time)
         .def_readwrite("lbfgs_step_size", &LPMP::bdd_solver_options::lbfgs_step_size)
         .def_readwrite("lbfgs_history_size", &LPMP::bdd_solver_options::lbfgs_history_size)
         .def_readwrite("lbfgs_required_relative_lb_increase", &LPMP::bdd_solver_options::lbfgs_required_relative_lb_increase)
@@ -52,6 +53,7 @@ PYBIND11_MODULE(bdd_solver_py, m) {
         .value("sequential_mma", LPMP::bdd_solver_options::bdd_solver_impl::sequential_mma)
         .value("mma_cuda", LPMP::bdd_solver_options::bdd_solver_impl::mma_cuda)
         .value("parallel_mma", LPMP::bdd_solver_options::bdd_solver_impl::parallel_mma)
+        .value("simd_parallel_mma", LPMP::bdd_solver_options::bdd_solver_impl::simd_parallel_mma)
         .value("hybrid_parallel_mma", LPMP::bdd_solver_options::bdd_solver_impl::hybrid_parallel_mma)
         .value("lbfgs_parallel_mma", LPMP::bdd_solver_options::bdd_solver_impl::lbfgs_parallel_mma)
         .value("lbfgs_cuda_mma", LPMP::bdd_solver_options::bdd_solver_impl::lbfgs_cuda_mma)
@@ -1,9 +1,71 @@
 #include "convert_pb_to_bdd.h"
 #include "two_dimensional_variable_array.hxx"
 #include <iostream> // TODO: remove
+#include <mutex>
 
 namespace LPMP {
 
+    const bdd_shape_cache::shape* bdd_shape_cache::find(const std::vector<int>& nf, const ILP_input::inequality_type ineq_type) const
+    {
+        assert(ineq_type == ILP_input::inequality_type::equal || ineq_type == ILP_input::inequality_type::smaller_equal);
+        const auto& shapes = ineq_type == ILP_input::inequality_type::equal ? equality_shapes_ : lower_equal_shapes_;
+        std::shared_lock lock(mutex_);
+        auto it = shapes.find(nf);
+        if(it == shapes.end())
+        {
+            ++nr_misses_;
+            return nullptr;
+        }
+        ++nr_hits_;
+        return &shapes_[it->second];
+    }
+
+    const bdd_shape_cache::shape& bdd_shape_cache::insert(const std::vector<int>& nf, const ILP_input::inequality_type ineq_type, shape&& s)
+    {
+        assert(ineq_type == ILP_input::inequality_type::equal || ineq_type == ILP_input::inequality_type::smaller_equal);
+        auto& shapes = ineq_type == ILP_input::inequality_type::equal ? equality_shapes_ : lower_equal_shapes_;
+        std::unique_lock lock(mutex_);
+        auto [it, inserted] = shapes.insert({nf, shapes_.size()});
+        if(inserted)
+            shapes_.push_back(std::move(s));
+        // deque does not invalidate references to existing elements on push_back
+        return shapes_[it->second];
+    }
+
+    size_t bdd_shape_cache::nr_shapes() const
+    {
+        std::shared_lock lock(mutex_);
+        return shapes_.size();
+    }
+
+    const bdd_shape_cache::shape& bdd_converter::convert_to_bdd(const std::vector<int>& coefficients, const ILP_input::inequality_type ineq_type, const int right_hand_side, bdd_shape_cache& shape_cache)
+    {
+        if(coefficients.size() == 0)
+            throw std::runtime_error("Expected non-empty coefficients");
+        const auto [nf, nf_ineq_type] = bdd_.normal_form(coefficients.begin(), coefficients.end(), ineq_type, right_hand_side);
+        if(const bdd_shape_cache::shape* cached = shape_cache.find(nf, nf_ineq_type); cached != nullptr)
+            return *cached;
+
+        bdd_shape_cache::shape s;
+        BDD::node_ref bdd = convert_to_bdd(coefficients, ineq_type, right_hand_side);
+        if(bdd.is_topsink())
+            s.topsink = true;
+        else if(bdd.is_botsink())
+            s.botsink = true;
+        else
+        {
+            const size_t bdd_nr = s.bdd_col.add_bdd(bdd);
+            s.bdd_col.reorder(bdd_nr);
+            if(!s.bdd_col.is_qbdd(bdd_nr))
+            {
+                s.bdd_col.make_qbdd(bdd_nr);
+                s.bdd_col.remove(bdd_nr);
+            }
+            assert(s.bdd_col.nr_bdds() == 1 && s.bdd_col.is_qbdd(0) && s.bdd_col.is_reordered(0));
+        }
+        return shape_cache.insert(nf, nf_ineq_type, std::move(s));
+    }
+
     BDD::node_ref bdd_converter::convert_to_bdd(const std::vector<int>& coefficients, const ILP_input::inequality_type ineq_type, const int right_hand_side)
     {
         if(coefficients.size() == 0)
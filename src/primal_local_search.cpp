@@ -0,0 +1,240 @@
+#include "primal_local_search.h"
+#include "ILP_evaluator.h"
+#include "bdd_logging.h"
+#include "time_measure_util.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace LPMP {
+
+    namespace {
+
+        // number of partners for 2-swaps evaluated per variable and round
+        constexpr size_t max_swap_candidates = 32;
+        constexpr double eps = 1e-9;
+        constexpr size_t no_var = std::numeric_limits<size_t>::max();
+
+        // flip of variable i, or of variables i and j with different values
+        struct move {
+            size_t i = no_var;
+            size_t j = no_var;
+            double cost_delta = 0.0;
+            double reduced_cost_delta = 0.0;
+
+            bool improving() const { return i != no_var && (cost_delta < -eps || (cost_delta <= eps && reduced_cost_delta < -eps)); }
+            bool operator<(const move& o) const
+            {
+                if(std::abs(cost_delta - o.cost_delta) > eps)
+                    return cost_delta < o.cost_delta;
+                return reduced_cost_delta < o.reduced_cost_delta;
+            }
+        };
+
+        // evaluator holding the current solution, together with the costs guiding the moves
+        class local_search_state {
+            public:
+                // per thread buffers for evaluating moves
+                struct scratch {
+                    std::vector<int> delta;
+                    std::vector<char> touched_mark;
+                    std::vector<size_t> touched;
+                };
+
+                local_search_state(const ILP_input& ilp, const std::vector<double>& costs, const std::vector<double>& reduced_costs, const std::vector<char>& sol);
+
+                size_t nr_variables() const { return eval_.nr_variables(); }
+                char value(const size_t var) const { return eval_.value(var); }
+                bool feasible() const { return eval_.feasible(); }
+                double cost() const;
+
+                scratch make_scratch() const;
+                // returns false if the move violates some constraint. first_violated is set to the first violated constraint.
+                bool evaluate(move& m, scratch& s, size_t& first_violated) const;
+                move best_move(const size_t i, scratch& s) const;
+                void apply(const move& m);
+
+            private:
+                ILP_evaluator eval_;
+                std::vector<double> costs_;
+                std::vector<double> reduced_costs_;
+                two_dim_variable_array<size_t> constraint_vars_; // sorted by increasing reduced costs
+        };
+
+        local_search_state::local_search_state(const ILP_input& ilp, const std::vector<double>& costs, const std::vector<double>& reduced_costs, const std::vector<char>& sol)
+            : eval_(ilp),
+            costs_(ilp.nr_variables(), 0.0),
+            reduced_costs_(ilp.nr_variables(), 0.0)
+        {
+            const size_t n = ilp.nr_variables();
+            eval_.set_solution(sol.begin(), sol.begin() + n);
+            std::copy(costs.begin(), costs.begin() + std::min(n, costs.size()), costs_.begin());
+            std::copy(reduced_costs.begin(), reduced_costs.begin() + std::min(n, reduced_costs.size()), reduced_costs_.begin());
+
+            std::vector<std::vector<size_t>> constraint_vars(eval_.nr_constraints());
+            for(size_t var=0; var<n; ++var)
+                for(const size_t c : eval_.variable_constraints()[var])
+                    constraint_vars[c].push_back(var);
+            for(auto& vars : constraint_vars)
+                std::sort(vars.begin(), vars.end(), [&](const size_t v1, const size_t v2) { return reduced_costs_[v1] < reduced_costs_[v2]; });
+            constraint_vars_ = two_dim_variable_array<size_t>(constraint_vars);
+        }
+
+        double local_search_state::cost() const
+        {
+            double c = 0.0;
+            for(size_t i=0; i<nr_variables(); ++i)
+                c += costs_[i] * value(i);
+            return c;
+        }
+
+        local_search_state::scratch local_search_state::make_scratch() const
+        {
+            scratch s;
+            s.delta.resize(eval_.nr_constraints(), 0);
+            s.touched_mark.resize(eval_.nr_constraints(), 0);
+            return s;
+        }
+
+        bool local_search_state::evaluate(move& m, scratch& s, size_t& first_violated) const
+        {
+            const std::array<size_t,2> vars = {m.i, m.j};
+            const size_t nr_vars = m.j != no_var ? 2 : 1;
+            m.cost_delta = 0.0;
+            m.reduced_cost_delta = 0.0;
+            for(size_t k=0; k<nr_vars; ++k)
+            {
+                m.cost_delta += costs_[vars[k]] * (value(vars[k]) ? -1.0 : 1.0);
+                m.reduced_cost_delta += reduced_costs_[vars[k]] * (value(vars[k]) ? -1.0 : 1.0);
+            }
+
+            eval_.flip_deltas(vars.begin(), vars.begin() + nr_vars, [&](const size_t c, const int d) {
+                    if(!s.touched_mark[c])
+                    {
+                        s.touched_mark[c] = 1;
+                        s.touched.push_back(c);
+                    }
+                    s.delta[c] += d;
+                    });
+
+            first_violated = no_var;
+            for(const size_t c : s.touched)
+            {
+                if(first_violated == no_var && !eval_.feasible(c, eval_.activity(c) + s.delta[c]))
+                    first_violated = c;
+                s.delta[c] = 0;
+                s.touched_mark[c] = 0;
+            }
+            s.touched.clear();
+            return first_violated == no_var;
+        }
+
+        move local_search_state::best_move(const size_t i, scratch& s) const
+        {
+            move best;
+            move m;
+            m.i = i;
+            size_t first_violated;
+            if(evaluate(m, s, first_violated) && m.improving())
+                best = m;
+
+            // partners must repair the constraint violated by flipping i, otherwise they come from all constraints of i.
+            // Partners are tried in the order of their reduced costs w.r.t. their new value.
+            const size_t* c_begin = first_violated != no_var ? &first_violated : eval_.variable_constraints()[i].begin();
+            const size_t* c_end = first_violated != no_var ? &first_violated + 1 : eval_.variable_constraints()[i].end();
+            size_t nr_candidates = 0;
+            for(const size_t* c = c_begin; c != c_end && nr_candidates < max_swap_candidates; ++c)
+            {
+                const auto vars = constraint_vars_[*c];
+                for(size_t k=0; k<vars.size() && nr_candidates < max_swap_candidates; ++k)
+                {
+                    const size_t j = value(i) ? vars[k] : vars[vars.size()-1-k];
+                    if(value(j) == value(i))
+                        continue;
+                    ++nr_candidates;
+                    m.j = j;
+                    size_t violated;
+                    if(evaluate(m, s, violated) && m.improving() && (best.i == no_var || m < best))
+                        best = m;
+                }
+            }
+            return best;
+        }
+
+        void local_search_state::apply(const move& m)
+        {
+            eval_.flip(m.i);
+            if(m.j != no_var)
+                eval_.flip(m.j);
+        }
+
+    }
+
+    std::vector<char> primal_local_search(const ILP_input& ilp, const std::vector<double>& costs, const std::vector<double>& reduced_costs, std::vector<char> sol, const double time_limit)
+    {
+        MEASURE_FUNCTION_EXECUTION_TIME;
+        const size_t n = ilp.nr_variables();
+        if(sol.size() < n)
+        {
+            bdd_log << "[local search] solution has too few variables, skip local search\n";
+            return sol;
+        }
+
+        const auto start_time = std::chrono::steady_clock::now();
+        auto time_left = [&]() {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() < time_limit;
+        };
+
+        local_search_state state(ilp, costs, reduced_costs, sol);
+        if(!state.feasible())
+        {
+            bdd_log << "[local search] solution is not feasible, skip local search\n";
+            return sol;
+        }
+        const double initial_cost = state.cost();
+        size_t nr_rounds = 0;
+        size_t nr_moves = 0;
+        std::vector<move> moves(n);
+        while(time_left())
+        {
+            ++nr_rounds;
+#pragma omp parallel
+            {
+                auto s = state.make_scratch();
+#pragma omp for schedule(dynamic, 64)
+                for(size_t i=0; i<n; ++i)
+                    moves[i] = state.best_move(i, s);
+            }
+
+            std::vector<move> candidates;
+            for(const auto& m : moves)
+                if(m.improving())
+                    candidates.push_back(m);
+            std::sort(candidates.begin(), candidates.end());
+
+            // earlier moves may have changed activities, hence every move is checked again against the current state
+            auto s = state.make_scratch();
+            size_t nr_applied = 0;
+            for(auto m : candidates)
+            {
+                size_t violated;
+                if(!state.evaluate(m, s, violated) || !m.improving())
+                    continue;
+                state.apply(m);
+                ++nr_applied;
+            }
+            nr_moves += nr_applied;
+            if(nr_applied == 0)
+                break;
+        }
+
+        for(size_t i=0; i<n; ++i)
+            sol[i] = state.value(i);
+        assert(state.feasible());
+        bdd_log << "[local search] cost " << initial_cost << " -> " << state.cost() << " after " << nr_moves << " moves in " << nr_rounds << " rounds\n";
+        return sol;
+    }
+
+}
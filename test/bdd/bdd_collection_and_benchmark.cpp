@@ -0,0 +1,101 @@
+#include "bdd_manager/bdd_mgr.h"
+#include "bdd_collection/bdd_collection.h"
+#include "convert_pb_to_bdd.h"
+#include "../test.h"
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+using namespace BDD;
+using namespace LPMP;
+
+// conjoins the given BDDs in the bdd_collection and with bdd_mgr::and_rec, reports timings and checks that both results agree
+void benchmark(const std::string& name, bdd_mgr& mgr, const std::vector<node_ref>& bdds, const bool compare_to_mgr = true)
+{
+    bdd_collection collection;
+    std::vector<size_t> bdd_nrs;
+    for(const node_ref& bdd : bdds)
+        bdd_nrs.push_back(collection.add_bdd(bdd));
+
+    const auto collection_begin = std::chrono::steady_clock::now();
+    const size_t and_nr = bdd_nrs.size() == 2 ? collection.bdd_and(bdd_nrs[0], bdd_nrs[1]) : collection.bdd_and(bdd_nrs.begin(), bdd_nrs.end());
+    const auto collection_end = std::chrono::steady_clock::now();
+    test(collection.is_bdd(and_nr), name + ": bdd_and result is not a bdd");
+    std::cout << "[bdd_and benchmark] " << name << ": " << bdds.size() << " bdds, " << collection.nr_bdd_nodes(and_nr) << " nodes, bdd_collection::bdd_and "
+        << std::chrono::duration<double>(collection_end - collection_begin).count() << " s";
+
+    if(compare_to_mgr)
+    {
+        const auto mgr_begin = std::chrono::steady_clock::now();
+        node_ref mgr_and = mgr.and_rec(bdds.begin(), bdds.end());
+        const auto mgr_end = std::chrono::steady_clock::now();
+        std::cout << ", bdd_mgr::and_rec " << std::chrono::duration<double>(mgr_end - mgr_begin).count() << " s";
+        test(collection.export_bdd(mgr, and_nr) == mgr_and, name + ": bdd_and differs from bdd_mgr::and_rec");
+    }
+    std::cout << "\n";
+
+    // check random assignments against the operands
+    std::mt19937 gen(0);
+    const auto vars = collection.variables(and_nr);
+    std::vector<char> labeling(vars.back()+1);
+    for(size_t iter=0; iter<100; ++iter)
+    {
+        for(auto& x : labeling)
+            x = std::bernoulli_distribution(0.05)(gen);
+        bool all_true = true;
+        for(const size_t bdd_nr : bdd_nrs)
+            all_true &= collection.evaluate(bdd_nr, labeling.begin(), labeling.end());
+        test(collection.evaluate(and_nr, labeling.begin(), labeling.end()) == all_true, name + ": bdd_and evaluates wrongly");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bdd_mgr mgr;
+    bdd_converter converter(mgr);
+    auto cardinality = [&](const size_t nr_vars, const ILP_input::inequality_type ineq, const int rhs) {
+        const std::vector<int> coefficients(nr_vars, 1);
+        return converter.convert_to_bdd(coefficients.begin(), coefficients.end(), ineq, rhs);
+    };
+
+    // two long cardinality constraints
+    {
+        const node_ref at_most = cardinality(2000, ILP_input::inequality_type::smaller_equal, 10);
+        const node_ref at_least = cardinality(1000, ILP_input::inequality_type::greater_equal, 3);
+        benchmark("cardinality pair", mgr, {at_most, at_least});
+    }
+
+    // overlapping simplex constraints as arising in tightening
+    {
+        std::vector<node_ref> simplices;
+        const node_ref simplex = cardinality(40, ILP_input::inequality_type::equal, 1);
+        for(size_t i=0; i<20; ++i)
+        {
+            std::vector<size_t> var_map(40);
+            std::iota(var_map.begin(), var_map.end(), 10*i);
+            simplices.push_back(mgr.rebase(simplex, var_map.begin(), var_map.end()));
+        }
+        benchmark("20 overlapping simplices", mgr, simplices);
+    }
+
+    // more operands than are conjoined at once
+    {
+        std::vector<node_ref> at_most_ones;
+        const node_ref at_most_one = cardinality(12, ILP_input::inequality_type::smaller_equal, 1);
+        for(size_t i=0; i<60; ++i)
+        {
+            std::vector<size_t> var_map(12);
+            std::iota(var_map.begin(), var_map.end(), 5*i);
+            at_most_ones.push_back(mgr.rebase(at_most_one, var_map.begin(), var_map.end()));
+        }
+        benchmark("60 overlapping at most one constraints", mgr, at_most_ones);
+    }
+
+    // BDDs spanning so many variables that recursive apply would need a very deep call stack
+    {
+        const node_ref at_most_one = cardinality(100000, ILP_input::inequality_type::smaller_equal, 1);
+        const node_ref at_least_one = cardinality(100000, ILP_input::inequality_type::greater_equal, 1);
+        benchmark("deep simplex", mgr, {at_most_one, at_least_one}, false);
+    }
+}
@@ -0,0 +1,49 @@
+#include "bdd_collection/bdd_collection.h"
+#include "../test.h"
+#include <unordered_map>
+#include <random>
+
+using namespace LPMP;
+
+int main(int argc, char** argv)
+{
+    BDD::bdd_collection bdd_col;
+
+    const size_t simplex_nr_3 = bdd_col.simplex_constraint(3);
+    const size_t simplex_nr_4 = bdd_col.simplex_constraint(4);
+    bdd_col.rebase(simplex_nr_4, std::unordered_map<size_t,size_t>{{0,3}, {1,4}, {2,5}, {3,6}});
+    const size_t simplex_nr_2 = bdd_col.simplex_constraint(2);
+    bdd_col.rebase(simplex_nr_2, std::unordered_map<size_t,size_t>{{0,2}, {1,7}});
+
+    const auto [components, component_variables] = bdd_col.connected_components();
+    test(components.size() == 2);
+    test(component_variables.size() == 2);
+
+    // larger component first
+    test(components[0].nr_bdds() == 2);
+    test(component_variables[0] == std::vector<size_t>({0,1,2,7}));
+    test(components[0].variables(0) == std::vector<size_t>({0,1,2}));
+    test(components[0].variables(1) == std::vector<size_t>({2,3}));
+    test(components[1].nr_bdds() == 1);
+    test(component_variables[1] == std::vector<size_t>({3,4,5,6}));
+    test(components[1].variables(0) == std::vector<size_t>({0,1,2,3}));
+
+    // BDDs of components evaluate like the original ones
+    const std::array<std::array<size_t,2>,3> bdd_map = {{{0,0}, {1,0}, {0,1}}};
+    std::mt19937 gen(0);
+    std::bernoulli_distribution dist(0.3);
+    for(size_t iter=0; iter<100; ++iter)
+    {
+        std::vector<char> sol(8);
+        for(auto& x : sol)
+            x = dist(gen);
+        for(size_t bdd_nr=0; bdd_nr<bdd_col.nr_bdds(); ++bdd_nr)
+        {
+            const auto [c, c_bdd_nr] = bdd_map[bdd_nr];
+            std::vector<char> c_sol;
+            for(const size_t v : component_variables[c])
+                c_sol.push_back(sol[v]);
+            test(bdd_col.evaluate(bdd_nr, sol.begin(), sol.end()) == components[c].evaluate(c_bdd_nr, c_sol.begin(), c_sol.end()));
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#include "bdd_manager/bdd_mgr.h"
+#include "bdd_collection/bdd_collection.h"
+#include "../test.h"
+
+using namespace BDD;
+using namespace LPMP;
+
+// conjoin in the bdd_collection and with bdd_mgr::and_rec, both results must agree
+void test_and(const std::string& name, bdd_mgr& mgr, const std::vector<node_ref>& bdds)
+{
+    bdd_collection collection;
+    std::vector<size_t> bdd_nrs;
+    for(const node_ref& bdd : bdds)
+        bdd_nrs.push_back(collection.add_bdd(bdd));
+
+    const size_t and_nr = bdd_nrs.size() == 2 ? collection.bdd_and(bdd_nrs[0], bdd_nrs[1]) : collection.bdd_and(bdd_nrs.begin(), bdd_nrs.end());
+    test(collection.is_bdd(and_nr), name + ": bdd_and result is not a bdd");
+    test(collection.export_bdd(mgr, and_nr) == mgr.and_rec(bdds.begin(), bdds.end()), name + ": bdd_and differs from bdd_mgr::and_rec");
+}
+
+int main(int argc, char** argv)
+{
+    bdd_mgr mgr;
+    std::vector<node_ref> vars;
+    for(size_t i=0; i<120; ++i)
+    {
+        mgr.add_variable();
+        vars.push_back(mgr.projection(i));
+    }
+
+    test_and("cardinality pair", mgr, {mgr.cardinality(vars.begin(), vars.begin()+20, 3), mgr.at_least_one(vars.begin()+5, vars.begin()+15)});
+
+    {
+        std::vector<node_ref> simplices;
+        for(size_t i=0; i<5; ++i)
+            simplices.push_back(mgr.simplex(vars.begin() + 3*i, vars.begin() + 3*i + 8));
+        test_and("overlapping simplices", mgr, simplices);
+    }
+
+    // more operands than are conjoined at once
+    {
+        std::vector<node_ref> at_most_ones;
+        for(size_t i=0; i<55; ++i)
+            at_most_ones.push_back(mgr.at_most_one(vars.begin() + 2*i, vars.begin() + 2*i + 4));
+        test_and("overlapping at most one constraints", mgr, at_most_ones);
+    }
+}
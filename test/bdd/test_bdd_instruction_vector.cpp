@@ -0,0 +1,86 @@
+#include "bdd_collection/bdd_collection.h"
+#include "bdd_collection/bdd_instruction_vector.h"
+#include "../test.h"
+#include <vector>
+
+using namespace BDD;
+using namespace LPMP;
+
+int main(int argc, char** argv)
+{
+    // plain round trip of compressible and uncompressible instructions
+    {
+        bdd_instruction_vector v;
+        v.push_back({1, 2, 7});
+        v.push_back({5ull << 40, 3, 1ull << 33});
+        v.push_back(bdd_instruction::botsink());
+        v.push_back(bdd_instruction::topsink());
+        v.push_back({});
+
+        test(v.size() == 5);
+        test(v[0] == bdd_instruction{1, 2, 7});
+        test(v[1] == bdd_instruction{5ull << 40, 3, 1ull << 33});
+        test(v[2].is_botsink() && v.is_botsink(2));
+        test(v[3].is_topsink() && v.is_topsink(3));
+        test(v[4] == bdd_instruction{});
+        test(v.nr_uncompressed() == 1);
+
+        // field assignment through proxies
+        v[0].hi = 4;
+        v[0].index += 1;
+        test(v[0] == bdd_instruction{1, 4, 8});
+        v[1].lo = 0;
+        v[1].index = 2;
+        test(v[1] == bdd_instruction{0, 3, 2});
+        test(v.nr_uncompressed() == 0, "instruction not compressed after it fits again");
+
+        // relative arcs stay valid when moving instructions
+        v.set(0, {2, 3, 0});
+        v.set(1, {2, 3, 1ull << 33});
+        v.resize(9);
+        v.copy(v, 0, 4, 5);
+        test(v[5] == bdd_instruction{7, 8, 0});
+        test(v[6] == bdd_instruction{7, 8, 1ull << 33});
+        test(v[7].is_botsink() && v[8].is_topsink());
+        test(v.nr_uncompressed() == 2);
+        v.resize(5);
+        test(v.nr_uncompressed() == 1);
+    }
+
+    // bdd collection with variables beyond 32 bits
+    {
+        bdd_collection bdd_col;
+        const size_t simplex_nr = bdd_col.simplex_constraint(4);
+        const size_t other_simplex_nr = bdd_col.simplex_constraint(3);
+        const std::vector<size_t> var_map = {2, 1ull << 33, (1ull << 33) + 1, (1ull << 34)};
+        bdd_col.rebase(simplex_nr, var_map.begin(), var_map.end());
+        test(bdd_col.variables(simplex_nr) == var_map);
+        test(bdd_col.is_bdd(simplex_nr));
+
+        bdd_collection bdd_col_2;
+        bdd_col_2.simplex_constraint(5);
+        bdd_col_2.append(bdd_col);
+        test(bdd_col_2.nr_bdds() == 3);
+        test(bdd_col_2.variables(1) == var_map);
+        test(bdd_col_2.is_bdd(1) && bdd_col_2.is_bdd(2));
+        for(size_t i=0; i<bdd_col.nr_bdd_nodes(simplex_nr); ++i)
+            test(bdd_col.get_bdd_instruction(bdd_col.offset(simplex_nr) + i).index == bdd_col_2.get_bdd_instruction(bdd_col_2.offset(1) + i).index);
+
+        bdd_col_2.remove(0);
+        test(bdd_col_2.nr_bdds() == 2);
+        test(bdd_col_2.variables(0) == var_map);
+        test(bdd_col_2.is_bdd(0) && bdd_col_2.is_bdd(1));
+        test(bdd_col_2.nr_bdd_nodes(1) == bdd_col.nr_bdd_nodes(other_simplex_nr));
+    }
+
+    // compact storage takes half of the memory of plain 64 bit instructions
+    {
+        bdd_collection bdd_col;
+        for(size_t i=0; i<100; ++i)
+            bdd_col.simplex_constraint(100);
+        const size_t nr_instructions = bdd_col.instructions().size();
+        test(bdd_col.instructions().nr_uncompressed() == 0);
+        test(bdd_col.instructions().memory_usage() <= 2 * nr_instructions * sizeof(compact_bdd_instruction));
+        test(sizeof(compact_bdd_instruction) * 2 == sizeof(bdd_instruction));
+    }
+}
@@ -0,0 +1,67 @@
+#include "bdd_manager/bdd_mgr.h"
+#include "bdd_collection/bdd_collection.h"
+#include "../test.h"
+#include <vector>
+
+using namespace BDD;
+using namespace LPMP;
+
+node_ref build(bdd_mgr& mgr)
+{
+    std::vector<node_ref> vars;
+    for(size_t i=0; i<30; ++i)
+        vars.push_back(mgr.projection(i));
+    std::vector<node_ref> constraints;
+    for(size_t i=0; i+8<=vars.size(); i+=2)
+        constraints.push_back(mgr.at_most(vars.begin() + i, vars.begin() + i + 8, 3));
+    return mgr.and_rec(constraints.begin(), constraints.end());
+}
+
+int main(int argc, char** argv)
+{
+    // lookups and least recently used replacement within one set
+    {
+        bdd_mgr mgr;
+        std::vector<node_ref> vars;
+        for(size_t i=0; i<64; ++i)
+            vars.push_back(mgr.projection(i));
+
+        memo_cache memo(mgr.get_node_cache(), 0);
+        test(memo.max_memory() == memo_cache::associativity * sizeof(memo_struct), "budget must hold at least one set");
+        node* r = vars[0].address();
+        for(size_t i=1; i<=memo_cache::associativity; ++i)
+            memo.cache_insert(vars[i].address(), vars[i].address(), memo_struct::and_symb(), r);
+        test(memo.statistics().evictions == 0);
+        test(memo.cache_lookup(vars[1].address(), vars[1].address(), memo_struct::and_symb()) == r);
+        test(memo.cache_lookup(vars[2].address(), vars[2].address(), memo_struct::or_symb()) == nullptr);
+
+        // entry 2 is least recently used now
+        memo.cache_insert(vars[10].address(), vars[10].address(), memo_struct::and_symb(), r);
+        test(memo.statistics().evictions == 1);
+        test(memo.cache_lookup(vars[2].address(), vars[2].address(), memo_struct::and_symb()) == nullptr, "least recently used entry not evicted");
+        test(memo.cache_lookup(vars[1].address(), vars[1].address(), memo_struct::and_symb()) == r);
+        test(memo.cache_lookup(vars[10].address(), vars[10].address(), memo_struct::and_symb()) == r);
+        test(memo.statistics().hits == 3 && memo.statistics().misses == 2);
+        test(memo.statistics().memory <= memo.max_memory());
+    }
+
+    // small budgets give the same bdds
+    for(const bool concurrent : {false, true})
+    {
+        bdd_mgr mgr(concurrent);
+        const size_t budget = size_t(1) << 13;
+        mgr.set_memo_cache_memory(budget);
+        node_ref r = build(mgr);
+        const memo_cache_statistics stats = mgr.memo_cache_stats();
+        test(stats.memory <= budget, "memo cache exceeds memory budget");
+        test(stats.evictions > 0);
+        test(stats.hits > 0 && stats.misses > 0);
+
+        bdd_mgr ref_mgr;
+        node_ref ref_r = build(ref_mgr);
+        test(ref_mgr.memo_cache_stats().evictions < stats.evictions);
+        bdd_collection bdd_col;
+        const size_t bdd_nr = bdd_col.add_bdd(r);
+        test(bdd_col.export_bdd(ref_mgr, bdd_nr) == ref_r, "bdd built with bounded memo cache differs");
+    }
+}
@@ -0,0 +1,82 @@
+#include "bdd_manager/bdd_mgr.h"
+#include "bdd_collection/bdd_collection.h"
+#include "../test.h"
+#include <vector>
+#include <numeric>
+
+using namespace BDD;
+using namespace LPMP;
+
+constexpr static size_t nr_groups = 8;
+constexpr static size_t nr_tasks = 64;
+
+// builds the same function for all tasks of a group, groups overlap in their variables
+node_ref build(bdd_mgr& mgr, const size_t group)
+{
+    std::vector<node_ref> vars;
+    for(size_t i=0; i<12; ++i)
+        vars.push_back(mgr.projection(4*group + i));
+    node_ref simplex = mgr.simplex(vars.begin(), vars.begin() + 6);
+    node_ref at_most_two = mgr.at_most(vars.begin() + 3, vars.end(), 2);
+    node_ref cardinality = mgr.cardinality(vars.begin() + 6, vars.end(), 3);
+    node_ref conj = mgr.and_rec(simplex, at_most_two);
+    node_ref disj = mgr.or_rec(conj, cardinality);
+
+    // copy to variables of the next group
+    std::vector<size_t> var_map(4*group + 12);
+    std::iota(var_map.begin(), var_map.end(), 4);
+    node_ref shifted = mgr.rebase(disj, var_map.begin(), var_map.end());
+    return mgr.ite_rec(mgr.projection(0), shifted, disj);
+}
+
+int main(int argc, char** argv)
+{
+    bdd_mgr mgr(true);
+    test(mgr.concurrent());
+
+    std::vector<node_ref> results(nr_tasks);
+    std::vector<size_t> nr_nodes(nr_tasks);
+#pragma omp parallel for schedule(dynamic)
+    for(size_t i=0; i<nr_tasks; ++i)
+    {
+        results[i] = build(mgr, i % nr_groups);
+        nr_nodes[i] = results[i].nr_nodes();
+    }
+
+    // canonicity: all threads must have found the same nodes
+    for(size_t i=nr_groups; i<nr_tasks; ++i)
+    {
+        test(results[i] == results[i % nr_groups], "threads built different nodes for the same function");
+        test(nr_nodes[i] == nr_nodes[i % nr_groups]);
+    }
+
+    // compare to a sequential bdd manager
+    bdd_mgr seq_mgr;
+    test(!seq_mgr.concurrent());
+    bdd_collection bdd_col;
+    for(size_t g=0; g<nr_groups; ++g)
+    {
+        node_ref seq_result = build(seq_mgr, g);
+        test(seq_result.nr_nodes() == nr_nodes[g], "concurrent and sequential bdd have different sizes");
+        test(seq_result.variables() == results[g].variables());
+        const size_t bdd_nr = bdd_col.add_bdd(results[g]);
+        test(bdd_col.export_bdd(seq_mgr, bdd_nr) == seq_result, "concurrent and sequential bdd differ");
+    }
+
+    // traversals of shared nodes from several threads
+    std::vector<char> traversal_ok(nr_tasks, 0);
+#pragma omp parallel for schedule(dynamic)
+    for(size_t i=0; i<nr_tasks; ++i)
+    {
+        node_ref r = results[i];
+        traversal_ok[i] = r.nodes_postorder().size() == nr_nodes[i] && r.nodes_bfs().size() == nr_nodes[i] && r.nr_nodes() == nr_nodes[i];
+    }
+    for(const char ok : traversal_ok)
+        test(ok, "concurrent traversal visited wrong number of nodes");
+
+    // variables added concurrently keep their indices
+#pragma omp parallel for
+    for(size_t i=0; i<4096; ++i)
+        test(mgr.projection(i).variable() == i);
+    test(mgr.nr_variables() == 4096);
+}
@@ -0,0 +1,78 @@
+#include "bdd_manager/bdd_mgr.h"
+#include "bdd_collection/bdd_collection.h"
+#include "../test.h"
+#include <vector>
+
+using namespace BDD;
+using namespace LPMP;
+
+// overlapping cardinality constraints on consecutive windows of variables
+std::vector<node_ref> build_constraints(bdd_mgr& mgr)
+{
+    std::vector<node_ref> vars;
+    for(size_t i=0; i<40; ++i)
+        vars.push_back(mgr.projection(i));
+
+    std::vector<node_ref> constraints;
+    for(size_t i=0; i+10<=vars.size(); i+=3)
+    {
+        if(i % 2 == 0)
+            constraints.push_back(mgr.at_most(vars.begin() + i, vars.begin() + i + 10, 4));
+        else
+            constraints.push_back(mgr.at_least(vars.begin() + i, vars.begin() + i + 10, 3));
+    }
+    return constraints;
+}
+
+int main(int argc, char** argv)
+{
+    bdd_mgr mgr(true);
+    mgr.set_parallel_apply_depth(4);
+    bdd_mgr seq_mgr;
+    bdd_collection bdd_col;
+
+    std::vector<node_ref> constraints = build_constraints(mgr);
+    std::vector<node_ref> seq_constraints = build_constraints(seq_mgr);
+    test(constraints.size() == seq_constraints.size());
+
+    auto test_equal = [&](node_ref r, node_ref seq_r, const std::string& msg) {
+        test(r.is_topsink() == seq_r.is_topsink() && r.is_botsink() == seq_r.is_botsink(), msg + ": different terminals");
+        if(r.is_terminal())
+            return;
+        test(r.nr_nodes() == seq_r.nr_nodes(), msg + ": different bdd sizes");
+        const size_t bdd_nr = bdd_col.add_bdd(r);
+        test(bdd_col.export_bdd(seq_mgr, bdd_nr) == seq_r, msg + ": different bdds");
+    };
+
+    // binary apply
+    for(size_t i=0; i+1<constraints.size(); ++i)
+    {
+        test_equal(mgr.and_rec_parallel(constraints[i], constraints[i+1]), seq_mgr.and_rec(seq_constraints[i], seq_constraints[i+1]), "parallel and");
+        test_equal(mgr.or_rec_parallel(constraints[i], constraints[i+1]), seq_mgr.or_rec(seq_constraints[i], seq_constraints[i+1]), "parallel or");
+        test_equal(mgr.xor_rec_parallel(constraints[i], constraints[i+1]), seq_mgr.xor_rec(seq_constraints[i], seq_constraints[i+1]), "parallel xor");
+    }
+
+    // if-then-else
+    for(size_t i=0; i+2<constraints.size(); ++i)
+        test_equal(
+                mgr.ite_rec_parallel(constraints[i], constraints[i+1], constraints[i+2]),
+                seq_mgr.ite_rec(seq_constraints[i], seq_constraints[i+1], seq_constraints[i+2]),
+                "parallel ite");
+
+    // balanced tree reduction over ranges
+    test_equal(mgr.and_rec(constraints.begin(), constraints.end()), seq_mgr.and_rec(seq_constraints.begin(), seq_constraints.end()), "parallel and reduction");
+    test_equal(mgr.or_rec(constraints.begin(), constraints.end()), seq_mgr.or_rec(seq_constraints.begin(), seq_constraints.end()), "parallel or reduction");
+    test_equal(mgr.xor_rec(constraints.begin(), constraints.end()), seq_mgr.xor_rec(seq_constraints.begin(), seq_constraints.end()), "parallel xor reduction");
+    test_equal(
+            mgr.and_rec(constraints[0], constraints[1], constraints[2], constraints[3]),
+            seq_mgr.and_rec(seq_constraints[0], seq_constraints[1], seq_constraints[2], seq_constraints[3]),
+            "variadic and");
+
+    // parallel apply called from within a parallel region
+    std::vector<node_ref> results(constraints.size());
+#pragma omp parallel for
+    for(size_t i=0; i<constraints.size(); ++i)
+        results[i] = mgr.and_rec_parallel(constraints[i], constraints[(i+1) % constraints.size()]);
+    for(size_t i=0; i<constraints.size(); ++i)
+        test(results[i] == mgr.and_rec(constraints[i], constraints[(i+1) % constraints.size()]), "nested parallel apply differs");
+}
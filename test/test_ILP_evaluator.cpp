@@ -0,0 +1,124 @@
+#include "ILP_evaluator.h"
+#include "test.h"
+#include <array>
+#include <cmath>
+#include <random>
+
+using namespace LPMP;
+
+// random ILP with linear and quadratic monomials and all inequality types
+ILP_input random_ilp(const size_t nr_vars, const size_t nr_constraints, std::mt19937& gen)
+{
+    ILP_input ilp;
+    std::uniform_int_distribution<size_t> var_dist(0, nr_vars-1);
+    std::uniform_int_distribution<int> coeff_dist(-3, 3);
+    for(size_t i=0; i<nr_vars; ++i)
+    {
+        ilp.add_new_variable("x" + std::to_string(i));
+        ilp.add_to_objective(coeff_dist(gen), i);
+    }
+    ilp.add_to_constant(2.0);
+
+    for(size_t c=0; c<nr_constraints; ++c)
+    {
+        ilp.begin_new_inequality();
+        for(size_t m=0; m<4; ++m)
+        {
+            if(m % 2 == 0)
+                ilp.add_to_constraint(coeff_dist(gen), var_dist(gen));
+            else
+            {
+                const size_t v1 = var_dist(gen);
+                const size_t v2 = (v1 + 1 + var_dist(gen) % (nr_vars-1)) % nr_vars;
+                const std::array<size_t,2> vars = {v1, v2};
+                ilp.add_to_constraint(coeff_dist(gen), vars.begin(), vars.end());
+            }
+        }
+        ilp.set_inequality_type(c % 3 == 0 ? ILP_input::inequality_type::smaller_equal : c % 3 == 1 ? ILP_input::inequality_type::greater_equal : ILP_input::inequality_type::equal);
+        // loose right hand sides so that random solutions are feasible sometimes
+        const int rhs = std::abs(coeff_dist(gen));
+        ilp.set_right_hand_side(c % 3 == 0 ? rhs : c % 3 == 1 ? -rhs : 0);
+    }
+    return ilp;
+}
+
+size_t nr_violated(const ILP_input& ilp, const std::vector<char>& sol)
+{
+    size_t nr = 0;
+    for(const auto& constr : ilp.constraints())
+    {
+        ILP_input single;
+        for(size_t i=0; i<ilp.nr_variables(); ++i)
+            single.add_new_variable(ilp.get_var_name(i));
+        single.add_constraint(constr);
+        nr += !single.feasible(sol.begin(), sol.end());
+    }
+    return nr;
+}
+
+int main(int argc, char** argv)
+{
+    std::mt19937 gen(17);
+    const size_t nr_vars = 12;
+    const ILP_input ilp = random_ilp(nr_vars, 8, gen);
+
+    // incremental updates agree with checking all constraints
+    {
+        ILP_evaluator eval(ilp);
+        std::vector<char> sol(nr_vars, 0);
+        std::uniform_int_distribution<size_t> var_dist(0, nr_vars-1);
+        for(size_t iter=0; iter<500; ++iter)
+        {
+            const size_t var = var_dist(gen);
+            eval.flip(var);
+            sol[var] = 1 - sol[var];
+            test(eval.solution() == sol);
+            test(eval.feasible() == ilp.feasible(sol.begin(), sol.end()));
+            test(eval.violated_constraints().size() == nr_violated(ilp, sol));
+            const double obj = ilp.evaluate(sol.begin(), sol.end());
+            test(obj == eval.evaluate() || std::abs(obj - eval.evaluate()) <= 1e-8);
+        }
+
+        const std::vector<char> ones(nr_vars, 1);
+        eval.set_solution(ones.begin(), ones.end());
+        test(eval.solution() == ones);
+        test(eval.violated_constraints().size() == nr_violated(ilp, ones));
+    }
+
+    // activity changes of simultaneous flips
+    {
+        ILP_evaluator eval(ilp);
+        const std::array<size_t,3> flipped = {0, 3, 5};
+        std::vector<int> delta(ilp.nr_constraints(), 0);
+        eval.flip_deltas(flipped.begin(), flipped.end(), [&](const size_t c, const int d) { delta[c] += d; });
+        for(const size_t var : flipped)
+            eval.flip(var);
+        for(size_t c=0; c<ilp.nr_constraints(); ++c)
+            test(eval.activity(c) == delta[c]);
+    }
+
+    // batch evaluation
+    {
+        const ILP_evaluator eval(ilp);
+        std::vector<std::vector<char>> sols;
+        for(size_t k=0; k<200; ++k)
+        {
+            std::vector<char> sol(nr_vars);
+            for(auto& x : sol)
+                x = gen() % 2;
+            sols.push_back(sol);
+        }
+        sols.push_back(std::vector<char>(nr_vars-1, 0));
+        const auto objs = eval.evaluate(sols);
+        test(objs.size() == sols.size());
+        size_t nr_feasible = 0;
+        for(size_t k=0; k+1<sols.size(); ++k)
+        {
+            const double obj = ilp.evaluate(sols[k].begin(), sols[k].end());
+            test(obj == objs[k] || std::abs(obj - objs[k]) <= 1e-8);
+            nr_feasible += obj < std::numeric_limits<double>::infinity();
+        }
+        test(objs.back() == std::numeric_limits<double>::infinity());
+        test(nr_feasible > 0 && nr_feasible + 1 < sols.size());
+    }
+}
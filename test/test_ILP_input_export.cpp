@@ -3,6 +3,12 @@
 #include "bdd_solver.h"
 #include <string>
 #include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+#include <cstring>
+#include <cstddef>
+#include <limits>
 #include "test.h"
 
 using namespace LPMP;
@@ -71,6 +77,15 @@ const std::string export_opb(const std::string& problem)
     return opb_exported.str();
 }
 
+const std::string export_binary(const std::string& problem)
+{
+    const ILP_input input_orig = ILP_parser::parse_string(problem);
+    const std::string filename = (std::filesystem::temp_directory_path() / "test_ILP_input_export.bin").string();
+    std::ofstream f(filename, std::ios::binary);
+    input_orig.write_binary(f);
+    return filename;
+}
+
 void test_export(const std::string& problem, const double lb)
 {
     auto compute_lp = [&](const std::string& problem) {
@@ -107,13 +122,81 @@ void test_export(const std::string& problem, const double lb)
 
     test(ILP_parser::parse_string(problem).nr_variables() == ILP_parser::parse_string(export_lp(problem)).nr_variables());
 
+    const std::string binary_file = export_binary(problem);
+    {
+        const ILP_input input_orig = ILP_parser::parse_string(problem);
+        const ILP_input input_binary = ILP_binary::parse_file(binary_file);
+        test(input_orig.var_index_to_name() == input_binary.var_index_to_name());
+        test(input_orig.objective() == input_binary.objective());
+        test(input_orig.nr_constraints() == input_binary.nr_constraints());
+        for(size_t c=0; c<input_orig.nr_constraints(); ++c)
+        {
+            test(input_orig.constraints()[c].identifier == input_binary.constraints()[c].identifier);
+            test(input_orig.constraints()[c].coefficients == input_binary.constraints()[c].coefficients);
+            test(input_orig.constraints()[c].monomials.data() == input_binary.constraints()[c].monomials.data());
+            test(input_orig.constraints()[c].ineq == input_binary.constraints()[c].ineq);
+            test(input_orig.constraints()[c].right_hand_side == input_binary.constraints()[c].right_hand_side);
+        }
+
+        // truncated and corrupt files are rejected
+        auto throws = [](const std::string& filename) {
+            try { ILP_binary::parse_file(filename); }
+            catch(const std::runtime_error&) { return true; }
+            return false;
+        };
+        std::string bytes;
+        {
+            std::ifstream f(binary_file, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        }
+        const std::string corrupt_file = binary_file + ".corrupt";
+        auto write_corrupt = [&](const std::string& b) {
+            std::ofstream f(corrupt_file, std::ios::binary);
+            f.write(b.data(), b.size());
+        };
+        write_corrupt(bytes.substr(0, bytes.size() - 8));
+        test(throws(corrupt_file), "truncated binary file not detected");
+
+        // without constraint groups the file ends with the last monomial variable followed by the single constraint group offset
+        test(input_orig.nr_constraint_groups() == 0);
+        std::string corrupt_bytes = bytes;
+        const size_t last_monomial_var_pos = bytes.size() - 2 * sizeof(size_t);
+        const size_t invalid_var = input_orig.nr_variables();
+        std::memcpy(corrupt_bytes.data() + last_monomial_var_pos, &invalid_var, sizeof(size_t));
+        write_corrupt(corrupt_bytes);
+        test(throws(corrupt_file), "out of range variable in binary file not detected");
+
+        corrupt_bytes = bytes;
+        const size_t huge_size = std::numeric_limits<size_t>::max();
+        std::memcpy(corrupt_bytes.data() + offsetof(ILP_binary::header, nr_monomials), &huge_size, sizeof(size_t));
+        write_corrupt(corrupt_bytes);
+        test(throws(corrupt_file), "corrupt array size in binary file not detected");
+        std::filesystem::remove(corrupt_file);
+    }
+
     const double orig_lb = compute_lp(problem);
     const double exported_lp_lb = compute_lp(export_lp(problem));
     const double exported_opb_lb = compute_opb(export_opb(problem));
 
+    const double exported_binary_lb = [&]() {
+        std::vector<std::string> solver_input = {
+            "-i", binary_file,
+            "-s", "mma",
+            "--max_iter", "1000",
+            "--tolerance", "1e-10"
+        };
+
+        bdd_solver solver((bdd_solver_options(solver_input))); 
+        solver.solve();
+
+        return solver.lower_bound();
+    }();
+    std::filesystem::remove(binary_file);
+
     test(std::abs(orig_lb - lb) <= 1e-6);
     test(std::abs(exported_lp_lb - lb) <= 1e-6);
     test(std::abs(exported_opb_lb - lb) <= 1e-6);
+    test(std::abs(exported_binary_lb - lb) <= 1e-6);
 }
 
 int main(int argc, char** arv)
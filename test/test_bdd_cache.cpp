@@ -0,0 +1,109 @@
+#include "ILP_input.h"
+#include "ILP_parser.h"
+#include "bdd_preprocessor.h"
+#include "bdd_cache.h"
+#include "two_dimensional_variable_array.hxx"
+#include "test.h"
+#include <filesystem>
+#include <limits>
+
+using namespace LPMP;
+
+const std::string ilp_string =
+R"(Minimize
+a + b + 2 c + d
+Subject To
+a + b + c + d = 1
+a + b + c  <= 1
+b + c <= 1
+2 a + 3 b - c + d >= 1
+End)";
+
+const std::string ilp_string_costs_changed =
+R"(Minimize
+- a + 3 b + c - d
+Subject To
+a + b + c + d = 1
+a + b + c  <= 1
+b + c <= 1
+2 a + 3 b - c + d >= 1
+End)";
+
+const std::string ilp_string_constraints_changed =
+R"(Minimize
+a + b + 2 c + d
+Subject To
+a + b + c + d = 1
+a + b + c  <= 1
+b + c <= 1
+2 a + 3 b - c + d >= 2
+End)";
+
+bool equal(const two_dim_variable_array<size_t>& a, const two_dim_variable_array<size_t>& b)
+{
+    if(a.size() != b.size())
+        return false;
+    for(size_t i=0; i<a.size(); ++i)
+    {
+        if(a.size(i) != b.size(i))
+            return false;
+        for(size_t j=0; j<a.size(i); ++j)
+            if(a(i,j) != b(i,j))
+                return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const std::filesystem::path cache_dir = std::filesystem::temp_directory_path() / "test_bdd_cache";
+    std::filesystem::remove_all(cache_dir);
+
+    const ILP_input ilp = ILP_parser::parse_string(ilp_string);
+
+    bdd_preprocessor bdd_pre_uncached;
+    const two_dim_variable_array<size_t> ineq_to_bdd_nrs_uncached = bdd_pre_uncached.add_ilp(ilp);
+
+    // first run fills the cache
+    bdd_preprocessor bdd_pre_store;
+    bdd_pre_store.set_cache_directory(cache_dir.string());
+    const two_dim_variable_array<size_t> ineq_to_bdd_nrs_store = bdd_pre_store.add_ilp(ilp);
+    test(std::distance(std::filesystem::directory_iterator(cache_dir), std::filesystem::directory_iterator{}) == 1, "expected one cache entry");
+
+    // second run loads from the cache
+    bdd_preprocessor bdd_pre_load;
+    bdd_pre_load.set_cache_directory(cache_dir.string());
+    const two_dim_variable_array<size_t> ineq_to_bdd_nrs_load = bdd_pre_load.add_ilp(ilp);
+
+    test(equal(ineq_to_bdd_nrs_uncached, ineq_to_bdd_nrs_store));
+    test(equal(ineq_to_bdd_nrs_store, ineq_to_bdd_nrs_load));
+    const BDD::bdd_collection& stored = bdd_pre_store.get_bdd_collection();
+    const BDD::bdd_collection& loaded = bdd_pre_load.get_bdd_collection();
+    test(stored.nr_bdds() == loaded.nr_bdds());
+    test(stored.delimiters() == loaded.delimiters());
+    test(stored.instructions() == loaded.instructions(), "loaded bdd instructions differ from stored ones");
+
+    // costs do not enter the cache key, constraints do
+    const ILP_input ilp_costs_changed = ILP_parser::parse_string(ilp_string_costs_changed);
+    const ILP_input ilp_constraints_changed = ILP_parser::parse_string(ilp_string_constraints_changed);
+    const bdd_cache::key_type k = bdd_cache::key(ilp, false, false, false, std::numeric_limits<size_t>::max());
+    test(k == bdd_cache::key(ilp_costs_changed, false, false, false, std::numeric_limits<size_t>::max()));
+    test(k != bdd_cache::key(ilp_constraints_changed, false, false, false, std::numeric_limits<size_t>::max()));
+    test(k != bdd_cache::key(ilp, true, true, true, 8));
+
+    // entries of different constraints whose hash collides are not loaded
+    {
+        bdd_cache cache(cache_dir.string());
+        BDD::bdd_collection bdd_col;
+        two_dim_variable_array<size_t> ineq_to_bdd_nrs;
+        test(cache.load(k, bdd_col, ineq_to_bdd_nrs), "expected cache hit");
+
+        bdd_cache::key_type colliding_key = bdd_cache::key(ilp_constraints_changed, false, false, false, std::numeric_limits<size_t>::max());
+        colliding_key.hash = k.hash;
+        BDD::bdd_collection colliding_bdd_col;
+        test(!cache.load(colliding_key, colliding_bdd_col, ineq_to_bdd_nrs), "cache entry of different constraints must not be loaded");
+        test(colliding_bdd_col.nr_bdds() == 0);
+    }
+
+    std::filesystem::remove_all(cache_dir);
+}
@@ -0,0 +1,132 @@
+#include "bdd_mma.h"
+#include "bdd_parallel_mma.h"
+#include "bdd_lbfgs_parallel_mma.h"
+#include "bdd_dual_state.h"
+#include "ILP_parser.h"
+#include "bdd_preprocessor.h"
+#include "test.h"
+#include <filesystem>
+#include <cmath>
+
+using namespace LPMP;
+
+// binary graphical model triplet with negative Potts
+const char* triplet_instance = R"(Minimize
+- mu_12_01 - mu_12_10 - mu_13_01 - mu_13_10 - mu_23_01 - mu_23_10
++ 0.3 mu_1_0 - 0.2 mu_2_1 + 0.1 mu_3_0
+Subject To
+mu_1_0 + mu_1_1 = 1
+mu_2_0 + mu_2_1 = 1
+mu_3_0 + mu_3_1 = 1
+mu_12_00 + mu_12_01 + mu_12_10 + mu_12_11 = 1
+mu_13_00 + mu_13_01 + mu_13_10 + mu_13_11 = 1
+mu_23_00 + mu_23_01 + mu_23_10 + mu_23_11 = 1
+mu_1_0 - mu_12_00 - mu_12_01 = 0
+mu_1_1 - mu_12_10 - mu_12_11 = 0
+mu_2_0 - mu_12_00 - mu_12_10 = 0
+mu_2_1 - mu_12_01 - mu_12_11 = 0
+mu_1_0 - mu_13_00 - mu_13_01 = 0
+mu_1_1 - mu_13_10 - mu_13_11 = 0
+mu_3_0 - mu_13_00 - mu_13_10 = 0
+mu_3_1 - mu_13_01 - mu_13_11 = 0
+mu_2_0 - mu_23_00 - mu_23_01 = 0
+mu_2_1 - mu_23_10 - mu_23_11 = 0
+mu_3_0 - mu_23_00 - mu_23_10 = 0
+mu_3_1 - mu_23_01 - mu_23_11 = 0
+End)";
+
+template<typename SOLVER>
+size_t iterations_to_bound(SOLVER& s, const double lb, const size_t max_iter)
+{
+    for(size_t iter=0; iter<max_iter; ++iter)
+    {
+        if(s.lower_bound() >= lb - 1e-6)
+            return iter;
+        s.iteration();
+    }
+    return max_iter;
+}
+
+template<typename SOLVER, typename MAKE_SOLVER>
+void test_dual_state(MAKE_SOLVER make_solver, BDD::bdd_collection& bdd_col, const std::vector<double>& costs, const size_t solver_type)
+{
+    const std::string filename = "test_bdd_dual_state.dual";
+    const bdd_dual_state::key_type key = bdd_dual_state::key(bdd_col, solver_type);
+    test(key == bdd_dual_state::key(bdd_col, solver_type));
+    test(key != bdd_dual_state::key(bdd_col, solver_type + 1));
+
+    SOLVER s = make_solver(costs);
+    for(size_t iter=0; iter<100; ++iter)
+        s.iteration();
+    const double lb = s.lower_bound();
+
+    bdd_dual_state state;
+    state.objective = costs;
+    state.node_costs = s.node_costs();
+    state.store(filename, key);
+
+    bdd_dual_state loaded;
+    bdd_dual_state::key_type other_hash = key;
+    other_hash.hash += 1;
+    test(!loaded.load(filename, other_hash));
+    // other BDDs with colliding hash
+    bdd_dual_state::key_type collision = key;
+    collision.instructions[0].index ^= 1;
+    test(!loaded.load(filename, collision));
+    test(loaded.load(filename, key));
+    test(loaded.objective == costs);
+    test(loaded.node_costs == state.node_costs);
+
+    // restoring the dual state restores the reparametrization. Pending deltas of parallel solvers are included, hence the lower bound can only increase.
+    {
+        SOLVER r = make_solver(costs);
+        r.set_node_costs(loaded.node_costs);
+        test(r.node_costs() == loaded.node_costs);
+        r.backward_run();
+        test(r.lower_bound() >= lb - 1e-6, "restored lower bound is smaller");
+    }
+
+    // warm start with shifted objective needs no more iterations than a cold start
+    std::vector<double> shifted_costs = costs;
+    for(size_t i=0; i<shifted_costs.size(); ++i)
+        shifted_costs[i] += 0.01 * double(i % 3);
+
+    SOLVER cold = make_solver(shifted_costs);
+    for(size_t iter=0; iter<200; ++iter)
+        cold.iteration();
+    const double shifted_lb = cold.lower_bound();
+
+    SOLVER cold_again = make_solver(shifted_costs);
+    const size_t cold_iters = iterations_to_bound(cold_again, shifted_lb, 200);
+
+    SOLVER warm = make_solver(shifted_costs);
+    warm.set_node_costs(loaded.node_costs);
+    std::vector<double> cost_delta(costs.size());
+    for(size_t i=0; i<costs.size(); ++i)
+        cost_delta[i] = shifted_costs[i] - costs[i];
+    warm.update_costs(cost_delta.begin(), cost_delta.begin(), cost_delta.begin(), cost_delta.end());
+    warm.backward_run();
+    const size_t warm_iters = iterations_to_bound(warm, shifted_lb, 200);
+    test(warm_iters <= cold_iters, "warm start needs more iterations than cold start");
+
+    std::filesystem::remove(filename);
+}
+
+int main(int argc, char** argv)
+{
+    const ILP_input ilp = ILP_parser::parse_string(triplet_instance);
+    const std::vector<double> costs = ilp.objective();
+
+    {
+        bdd_preprocessor pre(ilp, true);
+        BDD::bdd_collection& bdd_col = pre.get_bdd_collection();
+        test_dual_state<bdd_mma<double>>([&](const std::vector<double>& c) { return bdd_mma<double>(bdd_col, c.begin(), c.end()); }, bdd_col, costs, 0);
+    }
+
+    {
+        bdd_preprocessor pre(ilp);
+        BDD::bdd_collection& bdd_col = pre.get_bdd_collection();
+        test_dual_state<bdd_parallel_mma<double>>([&](const std::vector<double>& c) { return bdd_parallel_mma<double>(bdd_col, c.begin(), c.end()); }, bdd_col, costs, 1);
+        test_dual_state<bdd_lbfgs_parallel_mma<double>>([&](const std::vector<double>& c) { return bdd_lbfgs_parallel_mma<double>(bdd_col, c.begin(), c.end(), 5); }, bdd_col, costs, 2);
+    }
+}
@@ -3,7 +3,11 @@
 #include "ILP_parser.h"
 #include "bdd_preprocessor.h"
 #include "test_problem_generator.h"
+#include "test_problems.h"
 #include "test.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace LPMP;
 
@@ -83,6 +87,25 @@ std::vector<std::array<float,2>> test_mm(const ILP_input& ilp, const std::string
     return mms_to_collect;
 }
 
+std::vector<double> test_delta_aggregation(const std::string& problem, const bdd_parallel_mma_base<bdd_branch_instruction<double,uint16_t>>::delta_aggregation a)
+{
+    using bdd_base_type = bdd_parallel_mma_base<bdd_branch_instruction<double,uint16_t>>;
+    ILP_input ilp = ILP_parser::parse_string(problem);
+    ilp.normalize();
+    bdd_preprocessor pre(ilp);
+    bdd_base_type solver(pre.get_bdd_collection());
+    solver.set_delta_aggregation(a);
+    solver.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+
+    std::vector<double> lbs;
+    for(size_t iter=0; iter<20; ++iter)
+    {
+        solver.iteration();
+        lbs.push_back(solver.lower_bound());
+    }
+    return lbs;
+}
+
 int main(int argc, char** argv)
 {
     using bdd_base_type = bdd_parallel_mma_base<bdd_branch_instruction<float,uint16_t>>;
@@ -123,4 +146,21 @@ int main(int argc, char** argv)
         test_mm(ilp, "forward");
         test_mm(ilp, "backward");
     }
+
+    // atomic free delta aggregation must agree with atomic one and not depend on the number of threads
+    using delta_aggregation = bdd_parallel_mma_base<bdd_branch_instruction<double,uint16_t>>::delta_aggregation;
+    for(const std::string& problem : test_problems)
+    {
+        const auto lbs_atomic = test_delta_aggregation(problem, delta_aggregation::atomic);
+        const auto lbs_gather = test_delta_aggregation(problem, delta_aggregation::gather);
+        for(size_t i=0; i<lbs_atomic.size(); ++i)
+            test(std::abs(lbs_atomic[i] - lbs_gather[i]) <= 1e-6);
+#ifdef _OPENMP
+        const int nr_threads = omp_get_max_threads();
+        omp_set_num_threads(3);
+        const auto lbs_gather_3 = test_delta_aggregation(problem, delta_aggregation::gather);
+        omp_set_num_threads(nr_threads);
+        test(lbs_gather == lbs_gather_3);
+#endif
+    }
 }
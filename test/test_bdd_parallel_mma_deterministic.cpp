@@ -0,0 +1,66 @@
+#include "bdd_parallel_mma_base.h"
+#include "bdd_branch_instruction.h"
+#include "bdd_preprocessor.h"
+#include "ILP_parser.h"
+#include "test_problems.h"
+#include "test.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace LPMP;
+
+constexpr size_t nr_iterations = 20;
+
+std::tuple<std::vector<double>, two_dim_variable_array<std::array<double,2>>> run_iterations(const BDD::bdd_collection& bdd_col, const ILP_input& ilp, const bool deterministic)
+{
+    bdd_parallel_mma_base<bdd_branch_instruction<double,uint16_t>> solver(bdd_col);
+    solver.set_deterministic(deterministic);
+    solver.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+
+    std::vector<double> lbs;
+    for(size_t iter=0; iter<nr_iterations; ++iter)
+    {
+        solver.iteration();
+        lbs.push_back(solver.lower_bound());
+    }
+    return {lbs, solver.min_marginals()};
+}
+
+void test_problem(const std::string& problem)
+{
+    const ILP_input ilp = ILP_parser::parse_string(problem);
+    bdd_preprocessor pre(ilp);
+
+    const auto [lbs_atomic, mms_atomic] = run_iterations(pre.get_bdd_collection(), ilp, false);
+    const auto [lbs_deterministic, mms_deterministic] = run_iterations(pre.get_bdd_collection(), ilp, true);
+
+    // results are equal up to floating point reordering
+    for(size_t i=0; i<nr_iterations; ++i)
+        test(std::abs(lbs_atomic[i] - lbs_deterministic[i]) <= 1e-6 * std::max(1.0, std::abs(lbs_atomic[i])), "atomic and deterministic lower bounds differ");
+
+#ifdef _OPENMP
+    // deterministic mode must give bitwise identical results for any number of threads
+    const int max_nr_threads = omp_get_max_threads();
+    for(const int nr_threads : {1, 2, 3, 8})
+    {
+        omp_set_num_threads(nr_threads);
+        const auto [lbs, mms] = run_iterations(pre.get_bdd_collection(), ilp, true);
+        test(lbs == lbs_deterministic, "deterministic lower bounds differ for " + std::to_string(nr_threads) + " threads");
+        test(mms.size() == mms_deterministic.size());
+        for(size_t var=0; var<mms.size(); ++var)
+        {
+            test(mms.size(var) == mms_deterministic.size(var));
+            for(size_t i=0; i<mms.size(var); ++i)
+                test(mms(var,i) == mms_deterministic(var,i), "deterministic min-marginals differ for " + std::to_string(nr_threads) + " threads");
+        }
+    }
+    omp_set_num_threads(max_nr_threads);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    for(const std::string& problem : test_problems)
+        test_problem(problem);
+}
@@ -0,0 +1,124 @@
+#include "bdd_parallel_mma_base.h"
+#include "bdd_branch_instruction.h"
+#include "ILP_parser.h"
+#include "bdd_preprocessor.h"
+#include "test.h"
+
+using namespace LPMP;
+
+// binary graphical model triplet with negative Potts, the first nine constraints cover all variables
+const char* triplet_instance = R"(Minimize
+- mu_12_01 - mu_12_10 - mu_13_01 - mu_13_10 - mu_23_01 - mu_23_10
+Subject To
+mu_1_0 + mu_1_1 = 1
+mu_2_0 + mu_2_1 = 1
+mu_3_0 + mu_3_1 = 1
+mu_12_00 + mu_12_01 + mu_12_10 + mu_12_11 = 1
+mu_13_00 + mu_13_01 + mu_13_10 + mu_13_11 = 1
+mu_23_00 + mu_23_01 + mu_23_10 + mu_23_11 = 1
+mu_1_0 - mu_12_00 - mu_12_01 = 0
+mu_1_0 - mu_13_00 - mu_13_01 = 0
+mu_2_0 - mu_23_00 - mu_23_01 = 0
+mu_1_1 - mu_12_10 - mu_12_11 = 0
+mu_2_0 - mu_12_00 - mu_12_10 = 0
+mu_2_1 - mu_12_01 - mu_12_11 = 0
+mu_1_1 - mu_13_10 - mu_13_11 = 0
+mu_3_0 - mu_13_00 - mu_13_10 = 0
+mu_3_1 - mu_13_01 - mu_13_11 = 0
+mu_2_1 - mu_23_10 - mu_23_11 = 0
+mu_3_0 - mu_23_00 - mu_23_10 = 0
+mu_3_1 - mu_23_01 - mu_23_11 = 0
+End)";
+
+using solver_type = bdd_parallel_mma_base<bdd_branch_instruction<float,uint16_t>>;
+
+void set_costs(solver_type& s, const ILP_input& ilp)
+{
+    s.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+}
+
+void test_equal_structure(const solver_type& s1, const solver_type& s2)
+{
+    test(s1.nr_bdds() == s2.nr_bdds());
+    test(s1.nr_variables() == s2.nr_variables());
+    for(size_t bdd_nr=0; bdd_nr<s1.nr_bdds(); ++bdd_nr)
+        test(s1.variables(bdd_nr) == s2.variables(bdd_nr));
+    for(size_t var=0; var<s1.nr_variables(); ++var)
+        test(s1.nr_bdds(var) == s2.nr_bdds(var));
+}
+
+int main(int argc, char** argv)
+{
+    const ILP_input ilp = ILP_parser::parse_string(triplet_instance);
+    bdd_preprocessor pre(ilp);
+    const BDD::bdd_collection& bdd_col = pre.get_bdd_collection();
+    const size_t nr_first_bdds = 9;
+
+    solver_type s_full(bdd_col);
+    BDD::bdd_collection first_bdds, second_bdds;
+    for(size_t bdd_nr=0; bdd_nr<s_full.nr_bdds(); ++bdd_nr)
+        s_full.export_bdd(bdd_nr < nr_first_bdds ? first_bdds : second_bdds, bdd_nr);
+    test(first_bdds.nr_bdds() + second_bdds.nr_bdds() == bdd_col.nr_bdds());
+    std::vector<size_t> second_bdd_nrs;
+    for(size_t bdd_nr=nr_first_bdds; bdd_nr<s_full.nr_bdds(); ++bdd_nr)
+        second_bdd_nrs.push_back(bdd_nr);
+
+    // adding BDDs incrementally gives the same problem as adding them at once
+    {
+        solver_type s_incremental(first_bdds);
+        s_incremental.add_bdds(second_bdds);
+        test_equal_structure(s_incremental, s_full);
+
+        solver_type s(bdd_col);
+        set_costs(s, ilp);
+        set_costs(s_incremental, ilp);
+        for(size_t iter=0; iter<20; ++iter)
+        {
+            s.iteration();
+            s_incremental.iteration();
+        }
+        test(std::abs(s.lower_bound() - s_incremental.lower_bound()) <= 1e-5);
+    }
+
+    // removing BDDs gives the same problem as not adding them
+    {
+        solver_type s_first(first_bdds);
+        solver_type s(bdd_col);
+        s.remove_bdds(second_bdd_nrs.begin(), second_bdd_nrs.end());
+        test_equal_structure(s, s_first);
+
+        set_costs(s, ilp);
+        set_costs(s_first, ilp);
+        for(size_t iter=0; iter<20; ++iter)
+        {
+            s.iteration();
+            s_first.iteration();
+        }
+        test(std::abs(s.lower_bound() - s_first.lower_bound()) <= 1e-5);
+
+        // BDDs can be added again after removal
+        s.add_bdds(second_bdds);
+        test_equal_structure(s, s_full);
+    }
+
+    // costs of removed BDDs are handed over to the remaining ones
+    {
+        solver_type s(bdd_col);
+        set_costs(s, ilp);
+        for(size_t iter=0; iter<20; ++iter)
+            s.iteration();
+        s.remove_bdds(second_bdd_nrs.begin(), second_bdd_nrs.end());
+        test(s.nr_bdds() == nr_first_bdds);
+
+        std::vector<double> hi_minus_lo(s.nr_variables(), 0.0);
+        for(size_t bdd_nr=0; bdd_nr<s.nr_bdds(); ++bdd_nr)
+        {
+            const auto costs = s.get_costs(bdd_nr);
+            const auto vars = s.variables(bdd_nr);
+            for(size_t idx=0; idx<vars.size(); ++idx)
+                hi_minus_lo[vars[idx]] += costs[idx][1] - costs[idx][0];
+        }
+        for(size_t var=0; var<s.nr_variables(); ++var)
+            test(std::abs(hi_minus_lo[var] - ilp.objective()[var]) <= 1e-4, "costs are not preserved by bdd removal");
+    }
+}
@@ -0,0 +1,64 @@
+#include "bdd_parallel_mma_base.h"
+#include "bdd_simd_parallel_mma_base.h"
+#include "bdd_branch_instruction.h"
+#include "bdd_preprocessor.h"
+#include "ILP_parser.h"
+#include "test_problems.h"
+#include "test.h"
+
+using namespace LPMP;
+
+const char* mixed_problem = 
+R"(Minimize
+2 x_1 - 1 x_2 + 3 x_3 - 2 x_4 + 1 x_5 - 1 x_6
+Subject To
+x_1 + x_2 + x_3 = 1
+x_3 + x_4 + x_5 + x_6 = 1
+x_1 + x_4 + x_6 <= 2
+x_2 + x_5 = 1
+2 x_1 + x_3 + x_5 - x_6 >= 1
+End)";
+
+// specialized kernels for simplex BDDs must give the same results as the generic BDD path of the layered solver
+template<typename REAL>
+void test_problem(const ILP_input& ilp, const size_t expected_nr_simplex_bdds, const size_t nr_iterations)
+{
+    bdd_preprocessor pre(ilp);
+    bdd_parallel_mma_base<bdd_branch_instruction<REAL,uint16_t>> parallel_mma(pre.get_bdd_collection());
+    parallel_mma.set_deterministic(true);
+    parallel_mma.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+    bdd_simd_parallel_mma_base<REAL> simd_mma(pre.get_bdd_collection());
+    simd_mma.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+
+    test(parallel_mma.nr_simplex_bdds() == expected_nr_simplex_bdds, "expected " + std::to_string(expected_nr_simplex_bdds) + " simplex bdds, found " + std::to_string(parallel_mma.nr_simplex_bdds()));
+
+    for(size_t iter=0; iter<nr_iterations; ++iter)
+    {
+        parallel_mma.iteration();
+        simd_mma.iteration();
+        test(parallel_mma.lower_bound() == simd_mma.lower_bound(), "lower bounds of simplex kernels and bdd path differ");
+    }
+
+    const auto mms = parallel_mma.min_marginals();
+    const auto simd_mms = simd_mma.min_marginals();
+    for(size_t var=0; var<mms.size(); ++var)
+        for(size_t i=0; i<mms.size(var); ++i)
+            test(mms(var,i) == simd_mms(var,i), "min-marginals of simplex kernels and bdd path differ");
+}
+
+int main(int argc, char** argv)
+{
+    {
+        ILP_input ilp = ILP_parser::parse_string(mixed_problem);
+        ilp.normalize();
+        test_problem<float>(ilp, 3, 20);
+        test_problem<double>(ilp, 3, 20);
+    }
+
+    {
+        ILP_input ilp = ILP_parser::parse_string(mrf_grid_graph_3x3);
+        ilp.normalize();
+        test_problem<float>(ilp, 21, 50);
+        test_problem<double>(ilp, 21, 50);
+    }
+}
@@ -0,0 +1,112 @@
+#include "bdd_parallel_mma_base.h"
+#include "bdd_simd_parallel_mma_base.h"
+#include "bdd_branch_instruction.h"
+#include "bdd_tightening.h"
+#include "bdd_lbfgs_parallel_mma.h"
+#include "ILP_parser.h"
+#include "bdd_preprocessor.h"
+#include "test.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace LPMP;
+
+// binary graphical model triplet with negative Potts, the local polytope relaxation is not tight
+const char* triplet_instance = R"(Minimize
+- mu_12_01 - mu_12_10 - mu_13_01 - mu_13_10 - mu_23_01 - mu_23_10
+Subject To
+mu_1_0 + mu_1_1 = 1
+mu_2_0 + mu_2_1 = 1
+mu_3_0 + mu_3_1 = 1
+mu_12_00 + mu_12_01 + mu_12_10 + mu_12_11 = 1
+mu_13_00 + mu_13_01 + mu_13_10 + mu_13_11 = 1
+mu_23_00 + mu_23_01 + mu_23_10 + mu_23_11 = 1
+mu_1_0 - mu_12_00 - mu_12_01 = 0
+mu_1_1 - mu_12_10 - mu_12_11 = 0
+mu_2_0 - mu_12_00 - mu_12_10 = 0
+mu_2_1 - mu_12_01 - mu_12_11 = 0
+mu_1_0 - mu_13_00 - mu_13_01 = 0
+mu_1_1 - mu_13_10 - mu_13_11 = 0
+mu_3_0 - mu_13_00 - mu_13_10 = 0
+mu_3_1 - mu_13_01 - mu_13_11 = 0
+mu_2_0 - mu_23_00 - mu_23_01 = 0
+mu_2_1 - mu_23_10 - mu_23_11 = 0
+mu_3_0 - mu_23_00 - mu_23_10 = 0
+mu_3_1 - mu_23_01 - mu_23_11 = 0
+End)";
+
+using solver_type = bdd_parallel_mma_base<bdd_branch_instruction<float,uint16_t>>;
+
+void set_costs(solver_type& s, const ILP_input& ilp)
+{
+    s.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+}
+
+int main(int argc, char** argv)
+{
+    const ILP_input ilp = ILP_parser::parse_string(triplet_instance);
+    bdd_preprocessor pre(ilp);
+    const BDD::bdd_collection& bdd_col = pre.get_bdd_collection();
+
+    // intersecting all BDDs closes the gap of the local polytope relaxation
+    {
+        solver_type s(bdd_col);
+        set_costs(s, ilp);
+        for(size_t iter=0; iter<100; ++iter)
+            s.iteration();
+        const double lb_before = s.lower_bound();
+        test(lb_before < -2.0 + 1e-3, "local polytope relaxation should not be tight");
+
+        const size_t nr_bdds_before = s.nr_bdds();
+        // all variables count as undecided
+        const size_t nr_added = tighten_parallel(s, std::numeric_limits<double>::infinity(), nr_bdds_before);
+        test(nr_added == 1);
+        test(s.nr_bdds() == nr_bdds_before + 1);
+        test(s.lower_bound() >= lb_before - 1e-4, "tightening must not decrease the lower bound");
+
+        for(size_t iter=0; iter<100; ++iter)
+            s.iteration();
+        test(std::abs(s.lower_bound() - (-2.0)) <= 1e-3, "intersection of all BDDs should give tight relaxation");
+    }
+
+    // layered solver rebuilds its structure when the intersection is added
+    {
+        bdd_simd_parallel_mma_base<double> s(bdd_col);
+        s.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+        for(size_t iter=0; iter<100; ++iter)
+            s.iteration();
+        const double lb_before = s.lower_bound();
+        test(lb_before < -2.0 + 1e-3, "local polytope relaxation should not be tight");
+
+        const size_t nr_bdds_before = s.nr_bdds();
+        const size_t nr_added = tighten_parallel(s, std::numeric_limits<double>::infinity(), nr_bdds_before);
+        test(nr_added == 1);
+        test(s.nr_bdds() == nr_bdds_before + 1);
+        test(s.lower_bound() >= lb_before - 1e-4, "tightening must not decrease the lower bound");
+
+        for(size_t iter=0; iter<100; ++iter)
+            s.iteration();
+        test(std::abs(s.lower_bound() - (-2.0)) <= 1e-3, "intersection of all BDDs should give tight relaxation");
+    }
+
+    // lbfgs solver moves costs with several threads
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(4);
+#endif
+        BDD::bdd_collection lbfgs_bdd_col = bdd_col;
+        bdd_lbfgs_parallel_mma<double> s(lbfgs_bdd_col, ilp.objective().begin(), ilp.objective().end(), 5);
+        for(size_t iter=0; iter<100; ++iter)
+            s.iteration();
+        const double lb_before = s.lower_bound();
+        test(lb_before < -2.0 + 1e-3, "local polytope relaxation should not be tight");
+
+        s.tighten();
+        test(s.lower_bound() >= lb_before - 1e-4, "tightening must not decrease the lower bound");
+
+        for(size_t iter=0; iter<100; ++iter)
+            s.iteration();
+        test(s.lower_bound() >= lb_before - 1e-4, "iterations after tightening must not decrease the lower bound");
+    }
+}
@@ -14,6 +14,16 @@ a + b + c  <= 1
 b + c <= 1
 End)";
 
+// inequalities with the same normal form on different variables share their BDD shape
+const std::string shape_ilp_string =
+R"(Minimize
+Subject To
+2 a + b + c <= 2
+4 d + 2 e + 2 f <= 4
+- 2 g - h - i >= -2
+2 a + b + d <= 2
+End)";
+
 int main(int argc, char** argv)
 {
     // test if inequalities were correctly translated in bdd preprocessor
@@ -24,4 +34,19 @@ int main(int argc, char** argv)
     test(ineq_to_bdd_nrs.size(0) == 1 && ineq_to_bdd_nrs(0,0) == 0);
     test(ineq_to_bdd_nrs.size(1) == 1 && ineq_to_bdd_nrs(1,0) == 1);
     test(ineq_to_bdd_nrs.size(2) == 1 && ineq_to_bdd_nrs(2,0) == 2);
+
+    // BDDs built from the shared shape cache must be rebased onto the variables of each inequality
+    {
+        ILP_input ilp = ILP_parser::parse_string(shape_ilp_string);
+        bdd_preprocessor bdd_pre;
+        const two_dim_variable_array<size_t> ineq_to_bdd_nrs = bdd_pre.add_ilp(ilp);
+        const BDD::bdd_collection& bdd_col = bdd_pre.get_bdd_collection();
+        test(ineq_to_bdd_nrs.size() == 4);
+        for(size_t c=0; c<4; ++c)
+        {
+            test(ineq_to_bdd_nrs.size(c) == 1);
+            test(bdd_col.variables(ineq_to_bdd_nrs(c,0)) == ilp.variables(c));
+            test(bdd_col.nr_bdd_nodes(ineq_to_bdd_nrs(c,0)) == bdd_col.nr_bdd_nodes(ineq_to_bdd_nrs(0,0)));
+        }
+    }
 }
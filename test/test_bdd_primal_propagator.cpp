@@ -0,0 +1,87 @@
+#include "bdd_primal_propagator.h"
+#include "ILP_parser.h"
+#include "bdd_preprocessor.h"
+#include "test.h"
+#include <cmath>
+
+using namespace LPMP;
+
+const char* assignment_instance = R"(Minimize
+x_0_0 + x_0_1 + x_0_2 + x_1_0 + x_1_1 + x_1_2 + x_2_0 + x_2_1 + x_2_2
+Subject To
+x_0_0 + x_0_1 + x_0_2 = 1
+x_1_0 + x_1_1 + x_1_2 = 1
+x_2_0 + x_2_1 + x_2_2 = 1
+x_0_0 + x_1_0 + x_2_0 = 1
+x_0_1 + x_1_1 + x_2_1 = 1
+x_0_2 + x_1_2 + x_2_2 = 1
+End)";
+
+// one min-marginal per variable, negative values prefer one
+mm_primal_decoder make_mms(const std::vector<double>& mm_diffs)
+{
+    std::vector<std::vector<std::array<double,2>>> mms;
+    for(const double d : mm_diffs)
+        mms.push_back({{0.0, d}});
+    return mm_primal_decoder(two_dim_variable_array<std::array<double,2>>(mms));
+}
+
+int main(int argc, char** argv)
+{
+    const ILP_input ilp = ILP_parser::parse_string(assignment_instance);
+    bdd_preprocessor pre(ilp);
+    const bdd_primal_propagator propagator(pre.get_bdd_collection());
+    const size_t n = ilp.nr_variables();
+    test(propagator.nr_variables() == n);
+
+    auto feasible = [&](const std::vector<char>& sol) {
+        return sol.size() == n && ilp.evaluate(sol.begin(), sol.end()) < std::numeric_limits<double>::infinity();
+    };
+
+    // undecided min-marginals: branching alone finds a permutation
+    {
+        const auto sol = propagator.complete(make_mms(std::vector<double>(n, 0.0)));
+        test(feasible(sol));
+    }
+
+    // a single decisive variable forces the rest of its row and column to zero
+    {
+        std::vector<double> mm_diffs(n, 0.0);
+        const size_t x_1_2 = ilp.get_var_index("x_1_2");
+        mm_diffs[x_1_2] = -1.0;
+        const auto sol = propagator.complete(make_mms(mm_diffs));
+        test(feasible(sol));
+        test(sol[x_1_2] == 1);
+    }
+
+    // all variables decisively prefer one: conflicting fixings are skipped
+    {
+        const auto sol = propagator.complete(make_mms(std::vector<double>(n, -1.0)));
+        test(feasible(sol));
+    }
+
+    // decisive min-marginals of an optimal permutation are reproduced
+    {
+        std::vector<double> mm_diffs(n, 1.0);
+        for(const std::string var : {"x_0_1", "x_1_2", "x_2_0"})
+            mm_diffs[ilp.get_var_index(var)] = -1.0;
+        const auto sol = propagator.complete(make_mms(mm_diffs));
+        test(feasible(sol));
+        for(const std::string var : {"x_0_1", "x_1_2", "x_2_0"})
+            test(sol[ilp.get_var_index(var)] == 1);
+    }
+
+    // problem without solution
+    {
+        const ILP_input infeasible_ilp = ILP_parser::parse_string(R"(Minimize
+x + y + z
+Subject To
+x + y = 1
+y + z = 1
+x + z = 1
+End)");
+        bdd_preprocessor infeasible_pre(infeasible_ilp);
+        const bdd_primal_propagator infeasible_propagator(infeasible_pre.get_bdd_collection());
+        test(infeasible_propagator.complete(make_mms(std::vector<double>(3, 0.0))).empty());
+    }
+}
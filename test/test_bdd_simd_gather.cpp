@@ -0,0 +1,65 @@
+#include "bdd_simd_gather.h"
+#include "test.h"
+#include <vector>
+#include <random>
+
+using namespace LPMP;
+
+// all instruction set specific kernels must agree bitwise with the generic one
+template<typename REAL>
+void test_gather_kernels(const int n)
+{
+    std::mt19937 gen(n);
+    std::uniform_real_distribution<REAL> cost_dist(-1.0, 1.0);
+    std::uniform_int_distribution<int> index_dist(0, 2*n);
+
+    std::vector<REAL> cfr(n), cft(2*n+1);
+    std::vector<int> lo(n), hi(n);
+    for(auto& x : cfr)
+        x = cost_dist(gen);
+    for(auto& x : cft)
+        x = cost_dist(gen);
+    cft[0] = std::numeric_limits<REAL>::infinity();
+    for(int j=0; j<n; ++j)
+    {
+        lo[j] = index_dist(gen);
+        hi[j] = index_dist(gen);
+    }
+    const REAL lo_cost = cost_dist(gen);
+    const REAL hi_cost = cost_dist(gen);
+
+    const auto mm = simd_gather::min_marginals_generic(cfr.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n);
+    std::vector<REAL> out(n);
+    simd_gather::backward_step_generic(out.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n);
+
+    auto check = [&](const std::array<REAL,2> other_mm, const std::vector<REAL>& other_out) {
+        test(other_mm == mm, "gathered min-marginals differ from generic kernel");
+        test(other_out == out, "gathered backward step differs from generic kernel");
+    };
+
+    std::vector<REAL> other_out(n);
+    simd_gather::backward_step(other_out.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n);
+    check(simd_gather::min_marginals(cfr.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n), other_out);
+
+#ifdef LPMP_SIMD_GATHER_X86
+    if(simd_gather::detected_instruction_set() != simd_gather::instruction_set::generic)
+    {
+        simd_gather::backward_step_avx2(other_out.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n);
+        check(simd_gather::min_marginals_avx2(cfr.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n), other_out);
+    }
+    if(simd_gather::detected_instruction_set() == simd_gather::instruction_set::avx512)
+    {
+        simd_gather::backward_step_avx512(other_out.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n);
+        check(simd_gather::min_marginals_avx512(cfr.data(), lo.data(), hi.data(), cft.data(), lo_cost, hi_cost, n), other_out);
+    }
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    for(const int n : {0, 1, 3, 8, 17, 100})
+    {
+        test_gather_kernels<float>(n);
+        test_gather_kernels<double>(n);
+    }
+}
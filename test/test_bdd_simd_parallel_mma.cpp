@@ -0,0 +1,87 @@
+#include "bdd_simd_parallel_mma_base.h"
+#include "bdd_parallel_mma_base.h"
+#include "bdd_branch_instruction.h"
+#include "ILP_parser.h"
+#include "bdd_preprocessor.h"
+#include "test_problems.h"
+#include "test.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace LPMP;
+
+// the layered solver performs the same operations as deterministic parallel mma, only in different order
+template<typename REAL>
+void test_problem(const ILP_input& ilp)
+{
+    bdd_preprocessor pre(ilp);
+    bdd_parallel_mma_base<bdd_branch_instruction<REAL,uint16_t>> parallel_mma(pre.get_bdd_collection());
+    parallel_mma.set_deterministic(true);
+    parallel_mma.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+    bdd_simd_parallel_mma_base<REAL> simd_mma(pre.get_bdd_collection());
+    simd_mma.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+
+    test(simd_mma.nr_variables() == parallel_mma.nr_variables());
+    test(simd_mma.nr_bdds() == parallel_mma.nr_bdds());
+    test(simd_mma.nr_layers() == parallel_mma.nr_bdd_variables());
+    test(simd_mma.lower_bound() == parallel_mma.lower_bound());
+
+    for(size_t iter=0; iter<20; ++iter)
+    {
+        parallel_mma.iteration();
+        simd_mma.iteration();
+        test(simd_mma.lower_bound() == parallel_mma.lower_bound(), "lower bounds of layered and parallel mma differ");
+    }
+
+    const auto mms = simd_mma.min_marginals();
+    const auto parallel_mms = parallel_mma.min_marginals();
+    test(mms.size() == parallel_mms.size());
+    for(size_t var=0; var<mms.size(); ++var)
+    {
+        test(mms.size(var) == parallel_mms.size(var));
+        for(size_t i=0; i<mms.size(var); ++i)
+            test(mms(var,i) == parallel_mms(var,i), "min-marginals of layered and parallel mma differ");
+    }
+
+#ifdef _OPENMP
+    // results must not depend on the number of threads
+    const int max_nr_threads = omp_get_max_threads();
+    for(const int nr_threads : {1, 3})
+    {
+        omp_set_num_threads(nr_threads);
+        bdd_simd_parallel_mma_base<REAL> s(pre.get_bdd_collection());
+        s.update_costs(ilp.objective().begin(), ilp.objective().begin(), ilp.objective().begin(), ilp.objective().end());
+        for(size_t iter=0; iter<20; ++iter)
+            s.iteration();
+        test(s.lower_bound() == simd_mma.lower_bound(), "lower bounds differ for " + std::to_string(nr_threads) + " threads");
+    }
+    omp_set_num_threads(max_nr_threads);
+#endif
+}
+
+// the grid graph has many simplex and marginalization constraints of equal size, their bdds are batched into lane groups
+template<typename REAL>
+void test_lane_groups()
+{
+    ILP_input ilp = ILP_parser::parse_string(mrf_grid_graph_3x3);
+    ilp.normalize();
+    bdd_preprocessor pre(ilp);
+    bdd_simd_parallel_mma_base<REAL> simd_mma(pre.get_bdd_collection());
+    test(simd_mma.nr_group_layers() < simd_mma.nr_layers(), "structurally identical bdds were not batched");
+    test(simd_mma.nr_shape_nodes() < simd_mma.nr_bdd_nodes(), "structurally identical bdds were not batched");
+}
+
+int main(int argc, char** argv)
+{
+    test_lane_groups<float>();
+    test_lane_groups<double>();
+
+    for(const std::string& problem : test_problems)
+    {
+        ILP_input ilp = ILP_parser::parse_string(problem);
+        ilp.normalize();
+        test_problem<float>(ilp);
+        test_problem<double>(ilp);
+    }
+}
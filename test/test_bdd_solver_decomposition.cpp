@@ -0,0 +1,67 @@
+#include "bdd_solver.h"
+#include "test.h"
+
+using namespace LPMP;
+
+// two copies of a short chain and a simplex constraint, i.e. three disconnected subproblems with optimal values 1, 1 and 1
+const char * disconnected_problem = 
+R"(Minimize
+3 a_1_0 + 1 a_1_1
+- 1 a_2_0 + 0 a_2_1
++ 1 a_00 + 2 a_10 + 1 a_01 + 0 a_11
++ 3 b_1_0 + 1 b_1_1
+- 1 b_2_0 + 0 b_2_1
++ 1 b_00 + 2 b_10 + 1 b_01 + 0 b_11
++ 2 c_1 + 1 c_2 + 3 c_3
+Subject To
+a_1_0 + a_1_1 = 1
+a_2_0 + a_2_1 = 1
+a_00 + a_10 + a_01 + a_11 = 1
+a_1_0 - a_00 - a_01 = 0
+a_1_1 - a_10 - a_11 = 0
+a_2_0 - a_00 - a_10 = 0
+a_2_1 - a_01 - a_11 = 0
+b_1_0 + b_1_1 = 1
+b_2_0 + b_2_1 = 1
+b_00 + b_10 + b_01 + b_11 = 1
+b_1_0 - b_00 - b_01 = 0
+b_1_1 - b_10 - b_11 = 0
+b_2_0 - b_00 - b_10 = 0
+b_2_1 - b_01 - b_11 = 0
+c_1 + c_2 + c_3 = 1
+End)";
+
+void decomposition_test(const std::string& solver_name)
+{
+    std::vector<std::string> args {
+        "--input_string", disconnected_problem,
+        "-s", solver_name,
+        "--incremental_primal"
+    };
+
+    bdd_solver solver((bdd_solver_options(args)));
+    solver.solve();
+
+    args.push_back("--decompose");
+    bdd_solver decomposed_solver((bdd_solver_options(args)));
+    decomposed_solver.solve();
+
+    test(std::abs(solver.lower_bound() - 3.0) <= 1e-6);
+    test(std::abs(decomposed_solver.lower_bound() - 3.0) <= 1e-6);
+
+    const auto mms = solver.min_marginals();
+    const auto decomposed_mms = decomposed_solver.min_marginals();
+    test(mms.size() == decomposed_mms.size());
+    for(size_t i=0; i<mms.size(); ++i)
+        test(mms.size(i) == decomposed_mms.size(i));
+
+    const auto [obj, sol] = decomposed_solver.round();
+    test(std::abs(obj - 3.0) <= 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+    decomposition_test("mma");
+    decomposition_test("parallel_mma");
+    decomposition_test("lbfgs_parallel_mma");
+}
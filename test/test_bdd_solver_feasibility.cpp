@@ -45,8 +45,8 @@ int main(int argc, char** argv)
 {
     test_bdd_feasibility_on_short_mrf_chain<bdd_mma<double>>();
     test_bdd_feasibility_on_short_mrf_chain<bdd_mma<float>>();
-    //test_bdd_feasibility_on_short_mrf_chain<bdd_parallel_mma<double>>();
-    //test_bdd_feasibility_on_short_mrf_chain<bdd_parallel_mma<float>>();
+    test_bdd_feasibility_on_short_mrf_chain<bdd_parallel_mma<double>>();
+    test_bdd_feasibility_on_short_mrf_chain<bdd_parallel_mma<float>>();
     //test_bdd_feasibility_on_short_mrf_chain<bdd_cuda_parallel_mma<double>>();
     //test_bdd_feasibility_on_short_mrf_chain<bdd_cuda_parallel_mma<float>>();
 }
@@ -0,0 +1,45 @@
+#include "bdd_solver.h"
+#include "test.h"
+
+using namespace LPMP;
+
+// short chain with optimal value 1
+const char * chain_problem = 
+R"(Minimize
+3 x_1_0 + 1 x_1_1
+- 1 x_2_0 + 0 x_2_1
++ 1 x_00 + 2 x_10 + 1 x_01 + 0 x_11
+Subject To
+x_1_0 + x_1_1 = 1
+x_2_0 + x_2_1 = 1
+x_00 + x_10 + x_01 + x_11 = 1
+x_1_0 - x_00 - x_01 = 0
+x_1_1 - x_10 - x_11 = 0
+x_2_0 - x_00 - x_10 = 0
+x_2_1 - x_01 - x_11 = 0
+End)";
+
+void portfolio_test(const std::vector<std::string>& extra_args)
+{
+    std::vector<std::string> args {
+        "--input_string", chain_problem,
+        "-s", "portfolio",
+        "--portfolio_interval", "0.01",
+        "--incremental_primal"
+    };
+    args.insert(args.end(), extra_args.begin(), extra_args.end());
+
+    bdd_solver solver((bdd_solver_options(args)));
+    solver.solve();
+    test(std::abs(solver.lower_bound() - 1.0) <= 1e-6);
+
+    const auto [obj, sol] = solver.round();
+    test(std::abs(obj - 1.0) <= 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+    portfolio_test({});
+    portfolio_test({"--precision", "float"});
+    portfolio_test({"--smoothing", "0.1"});
+}
@@ -0,0 +1,51 @@
+#include "bdd_solver.h"
+#include "test.h"
+
+using namespace LPMP;
+
+// assignment problem with two optimal solutions of cost 3, rounding needs to break ties
+const char * assignment_problem = 
+R"(Minimize
+1 x_0_0 + 1 x_0_1 + 2 x_0_2
++ 1 x_1_0 + 1 x_1_1 + 2 x_1_2
++ 2 x_2_0 + 2 x_2_1 + 1 x_2_2
+Subject To
+x_0_0 + x_0_1 + x_0_2 = 1
+x_1_0 + x_1_1 + x_1_2 = 1
+x_2_0 + x_2_1 + x_2_2 = 1
+x_0_0 + x_1_0 + x_2_0 = 1
+x_0_1 + x_1_1 + x_2_1 = 1
+x_0_2 + x_1_2 + x_2_2 = 1
+End)";
+
+void rounding_trajectories_test(const std::string& solver_name, const std::vector<std::string>& extra_args)
+{
+    std::vector<std::string> args {
+        "--input_string", assignment_problem,
+        "-s", solver_name,
+        "--incremental_primal",
+        "--incremental_primal_trajectories", "4",
+        "--incremental_initial_perturbation", "0.1"
+    };
+    args.insert(args.end(), extra_args.begin(), extra_args.end());
+
+    bdd_solver solver((bdd_solver_options(args)));
+    solver.solve();
+    test(std::abs(solver.lower_bound() - 3.0) <= 1e-6);
+
+    const auto [obj, sol] = solver.round();
+    test(std::abs(obj - 3.0) <= 1e-6);
+
+    // second rounding reuses the solver copies of the first one
+    const auto [obj_2, sol_2] = solver.round();
+    test(std::abs(obj_2 - 3.0) <= 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+    for(const std::string solver_name : {"mma", "parallel_mma", "lbfgs_parallel_mma"})
+    {
+        rounding_trajectories_test(solver_name, {});
+        rounding_trajectories_test(solver_name, {"--incremental_primal_stop_at_first"});
+    }
+}
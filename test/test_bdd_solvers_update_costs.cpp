@@ -57,7 +57,7 @@ int main(int argc, char** argv)
     for(const std::string problem_str : test_problems)
     {
         test_update_costs<bdd_mma<double>>(problem_str);
-        //test_update_costs<bdd_parallel_mma<double>>(problem_str);
+        test_update_costs<bdd_parallel_mma<double>>(problem_str);
         //test_update_costs<bdd_cuda<double>>(problem_str);
 
     }
@@ -85,6 +85,19 @@ int main(int argc, char** argv)
         test(std::abs(solver.lower_bound() - 2.0) <= 1e-4);
     }
 
+    {
+        std::vector<std::string> solver_input = {
+            "--input_string", test_instance,
+            "-s", "simd_parallel_mma",
+            "--max_iter", "1000",
+            "--tighten"
+        };
+
+        bdd_solver solver((bdd_solver_options(solver_input))); 
+        solver.solve();
+        test(std::abs(solver.lower_bound() - 2.0) <= 1e-4);
+    }
+
 
     {
         std::vector<std::string> solver_input = {
@@ -0,0 +1,143 @@
+#include "ILP_parser.h"
+#include "OPB_parser.h"
+#include "test.h"
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <random>
+
+using namespace LPMP;
+
+const std::string ILP_example =
+R"(\ comment
+Minimize
+x1 + 2*x2 + 1.5 * x3 - 0.5*x4 - x5 + 3
+Subject To
+c1: x1 + 2*x2 + 3 * x3 - 5*x4 - x5 >= 1
+ b_cuta_;0;14_1;@41d: -x#3 + x2
+   + x5 <= -2
+x1*x2 + 2*x3*x4 + 3 * x5*x6 - 5*x7*x8 - x9*x10 >= 1
+2 x1 - 3 x6 = 0
+Bounds
+ x1 <= 1
+ x2 >= 0
+End)";
+
+const std::string OPB_example =
+R"(* #variable= 6 #constraint= 4
+min: +1 x1 +2 x2 -1.5 x3 -x4 ;
++1 x1 +2 x2 >= 1;
+-1 x1 -1 x3 >= -1 ;
+x4 +2 x5
+ -3 x6 = 0 ;
++1 x2 +1 x6 <= 1 ;
+)";
+
+std::string write_tmp_file(const std::string& content, const std::string& extension)
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / ("test_parallel_parser" + extension)).string();
+    std::ofstream f(filename);
+    f << content;
+    return filename;
+}
+
+// large set covering problem with random weights spanning many chunks
+std::string random_lp(const size_t nr_vars, const size_t nr_constraints)
+{
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> var_dist(0, nr_vars-1);
+    std::uniform_int_distribution<int> coeff_dist(1, 5);
+    std::string s = "Minimize\n";
+    for(size_t i=0; i<nr_vars; ++i)
+        s += (i > 0 ? " + " : "") + std::to_string(coeff_dist(gen)) + " x" + std::to_string(i);
+    s += "\nSubject To\n";
+    for(size_t c=0; c<nr_constraints; ++c)
+    {
+        s += "cover_" + std::to_string(c) + ": ";
+        for(size_t j=0; j<5; ++j)
+            s += (j > 0 ? " + " : "") + std::to_string(coeff_dist(gen)) + " x" + std::to_string(var_dist(gen));
+        s += c % 2 == 0 ? " >= 1\n" : " <= 7\n";
+    }
+    s += "End\n";
+    return s;
+}
+
+void test_equal(const ILP_input& a, const ILP_input& b)
+{
+    test(a.var_index_to_name() == b.var_index_to_name(), "variables differ");
+    test(a.objective() == b.objective(), "objectives differ");
+    test(a.constant() == b.constant(), "constants differ");
+    test(a.nr_constraints() == b.nr_constraints(), "number of constraints differs");
+    for(size_t c=0; c<a.nr_constraints(); ++c)
+    {
+        const auto& ca = a.constraints()[c];
+        const auto& cb = b.constraints()[c];
+        test(ca.identifier == cb.identifier, "constraint identifiers differ");
+        test(ca.coefficients == cb.coefficients, "constraint coefficients differ");
+        test(ca.ineq == cb.ineq && ca.right_hand_side == cb.right_hand_side, "constraint right hand sides differ");
+        test(ca.monomials.size() == cb.monomials.size());
+        for(size_t m=0; m<ca.monomials.size(); ++m)
+            test(std::equal(ca.monomials[m].begin(), ca.monomials[m].end(), cb.monomials[m].begin(), cb.monomials[m].end()), "monomials differ");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    {
+        const std::string filename = write_tmp_file(ILP_example, ".lp");
+        const ILP_input ilp = ILP_parser::parse_file_parallel(filename);
+        test(ilp.nr_variables() == 11);
+        test(ilp.nr_constraints() == 4);
+        test(ilp.objective("x3") == 1.5);
+        test(ilp.constant() == 3.0);
+        test(ilp.constraints()[0].identifier == "c1");
+        test(ilp.constraints()[1].identifier == "b_cuta_;0;14_1;@41d");
+        test(ilp.constraints()[1].coefficients == std::vector<int>({-1, 1, 1}));
+        test(ilp.constraints()[1].right_hand_side == -2);
+        test(ilp.constraints()[2].monomials.size() == 5 && ilp.constraints()[2].monomials.size(0) == 2);
+        test(ilp.constraints()[3].ineq == ILP_input::inequality_type::equal);
+        test_equal(ilp, ILP_parser::parse_file(filename));
+        std::filesystem::remove(filename);
+    }
+
+    {
+        const std::string filename = write_tmp_file(OPB_example, ".opb");
+        const ILP_input ilp = OPB_parser::parse_file_parallel(filename);
+        test(ilp.nr_variables() == 6);
+        test(ilp.nr_constraints() == 4);
+        test(ilp.objective("x3") == -1.5);
+        test(ilp.constraints()[1].coefficients == std::vector<int>({-1, -1}));
+        test(ilp.constraints()[1].right_hand_side == -1);
+        test(ilp.constraints()[2].coefficients == std::vector<int>({1, 2, -3}));
+        test_equal(ilp, OPB_parser::parse_file(filename));
+        std::filesystem::remove(filename);
+    }
+
+    {
+        const std::string filename = write_tmp_file(random_lp(10000, 200000), ".lp");
+        const ILP_input ilp_parallel = ILP_parser::parse_file_parallel(filename);
+        const ILP_input ilp = ILP_parser::parse_file(filename);
+        test(ilp_parallel.nr_constraints() == 200000);
+        test_equal(ilp_parallel, ilp);
+        std::filesystem::remove(filename);
+    }
+
+    // section keywords only end the constraints as whole words at the beginning of a line
+    {
+        const std::string filename = write_tmp_file("Minimize\nx1 + End_1\nSubject To\nEnd_1 + Bounds2 >= 1\nx1 - Endx <= 0\n  End  \n", ".lp");
+        const ILP_input ilp = ILP_parser::parse_file_parallel(filename);
+        test(ilp.nr_constraints() == 2);
+        test(ilp.nr_variables() == 4);
+        std::filesystem::remove(filename);
+    }
+
+    // malformed constraints are reported
+    {
+        const std::string filename = write_tmp_file("Minimize\nx1 + x2\nSubject To\nx1 + x2 >= 1\nx1 x2 >= 1\nEnd\n", ".lp");
+        bool thrown = false;
+        try { ILP_parser::parse_file_parallel(filename); }
+        catch(const std::exception& e) { thrown = true; }
+        test(thrown, "malformed constraint not detected");
+        std::filesystem::remove(filename);
+    }
+}
@@ -0,0 +1,83 @@
+#include "primal_local_search.h"
+#include "ILP_parser.h"
+#include "test.h"
+#include <array>
+#include <cmath>
+
+using namespace LPMP;
+
+const char* simplex_instance = R"(Minimize
+3 a + 1 b + 2 c
+Subject To
+a + b + c = 1
+End)";
+
+const char* covering_instance = R"(Minimize
+x + y + z
+Subject To
+x + y >= 1
+y + z >= 1
+End)";
+
+double cost(const ILP_input& ilp, const std::vector<char>& sol)
+{
+    return ilp.evaluate(sol.begin(), sol.end());
+}
+
+int main(int argc, char** argv)
+{
+    // 2-swap moves the one of a simplex constraint to the cheapest variable
+    {
+        const ILP_input ilp = ILP_parser::parse_string(simplex_instance);
+        std::vector<char> sol(3, 0);
+        sol[ilp.get_var_index("a")] = 1;
+        const auto improved = primal_local_search(ilp, ilp.objective(), std::vector<double>(3, 0.0), sol, 10.0);
+        test(std::abs(cost(ilp, improved) - 1.0) <= 1e-8);
+        test(improved[ilp.get_var_index("b")] == 1);
+    }
+
+    // 1-flips on a covering problem. Flipping x or z is as good as flipping y, reduced costs favour keeping y.
+    // Moves found in the same round are checked again before being applied, so only one of y and the pair x, z is flipped.
+    {
+        const ILP_input ilp = ILP_parser::parse_string(covering_instance);
+        const size_t x = ilp.get_var_index("x");
+        const size_t y = ilp.get_var_index("y");
+        const size_t z = ilp.get_var_index("z");
+        std::vector<double> reduced_costs(3);
+        reduced_costs[x] = 1.0;
+        reduced_costs[y] = -1.0;
+        reduced_costs[z] = 1.0;
+        const auto improved = primal_local_search(ilp, ilp.objective(), reduced_costs, std::vector<char>(3, 1), 10.0);
+        test(std::abs(cost(ilp, improved) - 1.0) <= 1e-8);
+        test(improved[y] == 1);
+    }
+
+    // non-linear constraint x*y - z <= 0: z can only be flipped to zero after x
+    {
+        ILP_input ilp;
+        const size_t x = ilp.add_new_variable("x");
+        const size_t y = ilp.add_new_variable("y");
+        const size_t z = ilp.add_new_variable("z");
+        ilp.add_to_objective(1.0, x);
+        ilp.add_to_objective(-2.0, y);
+        ilp.add_to_objective(1.0, z);
+        ilp.begin_new_inequality();
+        const std::array<size_t,2> xy = {x, y};
+        ilp.add_to_constraint(1, xy.begin(), xy.end());
+        ilp.add_to_constraint(-1, z);
+        ilp.set_inequality_type(ILP_input::inequality_type::smaller_equal);
+        ilp.set_right_hand_side(0);
+        const auto improved = primal_local_search(ilp, ilp.objective(), std::vector<double>(3, 0.0), std::vector<char>(3, 1), 10.0);
+        test(std::abs(cost(ilp, improved) + 2.0) <= 1e-8);
+    }
+
+    // infeasible solutions and exhausted time budgets leave the solution unchanged
+    {
+        const ILP_input ilp = ILP_parser::parse_string(simplex_instance);
+        const std::vector<char> infeasible = {1, 1, 0};
+        test(primal_local_search(ilp, ilp.objective(), {}, infeasible, 10.0) == infeasible);
+        std::vector<char> sol(3, 0);
+        sol[ilp.get_var_index("a")] = 1;
+        test(primal_local_search(ilp, ilp.objective(), {}, sol, 0.0) == sol);
+    }
+}